@@ -0,0 +1,8 @@
+#! /usr/bin/env python
+
+# Programs that are runnable.
+ns3_runnable_programs = ['build/src/config-store/examples/ns3.26-config-store-save-debug', 'build/src/core/examples/ns3.26-main-callback-debug', 'build/src/core/examples/ns3.26-sample-simulator-debug', 'build/src/core/examples/ns3.26-main-ptr-debug', 'build/src/core/examples/ns3.26-main-random-variable-debug', 'build/src/core/examples/ns3.26-main-random-variable-stream-debug', 'build/src/core/examples/ns3.26-sample-random-variable-debug', 'build/src/core/examples/ns3.26-sample-random-variable-stream-debug', 'build/src/core/examples/ns3.26-command-line-example-debug', 'build/src/core/examples/ns3.26-hash-example-debug', 'build/src/core/examples/ns3.26-test-string-value-formatting-debug', 'build/src/core/examples/ns3.26-bench-scheduler-debug', 'build/src/core/examples/ns3.26-main-test-sync-debug', 'build/src/energy/examples/ns3.26-li-ion-energy-source-debug', 'build/src/energy/examples/ns3.26-rv-battery-model-test-debug', 'build/src/energy/examples/ns3.26-basic-energy-model-test-debug', 'build/src/internet/examples/ns3.26-main-simple-debug', 'build/src/mobility/examples/ns3.26-main-grid-topology-debug', 'build/src/mobility/examples/ns3.26-main-random-topology-debug', 'build/src/mobility/examples/ns3.26-main-random-walk-debug', 'build/src/mobility/examples/ns3.26-mobility-trace-example-debug', 'build/src/mobility/examples/ns3.26-ns2-mobility-trace-debug', 'build/src/mobility/examples/ns3.26-bonnmotion-ns2-example-debug', 'build/src/mpi/examples/ns3.26-simple-multithreaded-debug', 'build/src/network/examples/ns3.26-main-packet-header-debug', 'build/src/network/examples/ns3.26-main-packet-tag-debug', 'build/src/network/examples/ns3.26-packet-socket-apps-debug', 'build/src/point-to-point/examples/ns3.26-main-attribute-value-debug', 'build/src/propagation/examples/ns3.26-main-propagation-loss-debug', 'build/src/propagation/examples/ns3.26-jakes-propagation-model-example-debug', 'build/src/spectrum/examples/ns3.26-adhoc-aloha-ideal-phy-debug', 'build/src/spectrum/examples/ns3.26-adhoc-aloha-ideal-phy-matrix-propagation-loss-model-debug', 'build/src/spectrum/examples/ns3.26-adhoc-aloha-ideal-phy-with-microwave-oven-debug', 'build/src/spectrum/examples/ns3.26-tv-trans-example-debug', 'build/src/spectrum/examples/ns3.26-tv-trans-regional-example-debug', 'build/src/stats/examples/ns3.26-gnuplot-example-debug', 'build/src/stats/examples/ns3.26-double-probe-example-debug', 'build/src/stats/examples/ns3.26-time-probe-example-debug', 'build/src/stats/examples/ns3.26-gnuplot-aggregator-example-debug', 'build/src/stats/examples/ns3.26-gnuplot-helper-example-debug', 'build/src/stats/examples/ns3.26-file-aggregator-example-debug', 'build/src/stats/examples/ns3.26-file-helper-example-debug', 'build/src/traffic-control/examples/ns3.26-red-tests-debug', 'build/src/traffic-control/examples/ns3.26-adaptive-red-tests-debug', 'build/src/traffic-control/examples/ns3.26-codel-vs-pfifo-basic-test-debug', 'build/src/traffic-control/examples/ns3.26-codel-vs-pfifo-asymmetric-debug', 'build/src/traffic-control/examples/ns3.26-pie-example-debug', 'build/src/wifi/examples/ns3.26-wifi-phy-test-debug', 'build/src/wifi/examples/ns3.26-test-interference-helper-debug', 'build/src/wifi/examples/ns3.26-ideal-wifi-manager-example-debug', 'build/src/wifi/examples/ns3.26-minstrel-ht-wifi-manager-example-debug', 'build/src/wifi/examples/ns3.26-wifi-phy-configuration-debug', 'build/examples/tcp/ns3.26-tcp-large-transfer-debug', 'build/examples/tcp/ns3.26-tcp-nsc-lfn-debug', 'build/examples/tcp/ns3.26-tcp-star-server-debug', 'build/examples/tcp/ns3.26-tcp-bulk-send-debug', 'build/examples/tcp/ns3.26-tcp-pcap-nanosec-example-debug', 'build/examples/tcp/ns3.26-tcp-nsc-comparison-debug', 'build/examples/tcp/ns3.26-tcp-variants-comparison-debug', 'build/examples/energy/ns3.26-energy-model-example-debug', 'build/examples/energy/ns3.26-energy-model-with-harvesting-example-debug', 'build/examples/routing/ns3.26-simple-global-routing-debug', 'build/examples/routing/ns3.26-simple-alternate-routing-debug', 'build/examples/stats/ns3.26-wifi-example-sim-debug', 'build/examples/error-model/ns3.26-simple-error-model-debug', 'build/examples/wireless/ns3.26-wifi-adhoc-debug', 'build/examples/wireless/ns3.26-wifi-clear-channel-cmu-debug', 'build/examples/wireless/ns3.26-wifi-ap-debug', 'build/examples/wireless/ns3.26-wifi-simple-adhoc-debug', 'build/examples/wireless/ns3.26-wifi-simple-infra-debug', 'build/examples/wireless/ns3.26-wifi-simple-interference-debug', 'build/examples/wireless/ns3.26-wifi-blockack-debug', 'build/examples/wireless/ns3.26-ofdm-validation-debug', 'build/examples/wireless/ns3.26-ofdm-ht-validation-debug', 'build/examples/wireless/ns3.26-ofdm-vht-validation-debug', 'build/examples/wireless/ns3.26-wifi-hidden-terminal-debug', 'build/examples/wireless/ns3.26-ht-wifi-network-debug', 'build/examples/wireless/ns3.26-vht-wifi-network-debug', 'build/examples/wireless/ns3.26-wifi-timing-attributes-debug', 'build/examples/wireless/ns3.26-wifi-sleep-debug', 'build/examples/wireless/ns3.26-power-adaptation-distance-debug', 'build/examples/wireless/ns3.26-power-adaptation-interference-debug', 'build/examples/wireless/ns3.26-rate-adaptation-distance-debug', 'build/examples/wireless/ns3.26-wifi-aggregation-debug', 'build/examples/wireless/ns3.26-simple-ht-hidden-stations-debug', 'build/examples/wireless/ns3.26-80211n-mimo-debug', 'build/examples/wireless/ns3.26-mixed-bg-network-debug', 'build/examples/wireless/ns3.26-wifi-tcp-debug', 'build/examples/wireless/ns3.26-80211e-txop-debug', 'build/examples/wireless/ns3.26-wifi-spectrum-per-example-debug', 'build/examples/wireless/ns3.26-wifi-spectrum-per-interference-debug', 'build/examples/wireless/ns3.26-wifi-spectrum-saturation-example-debug', 'build/examples/tutorial/ns3.26-hello-simulator-debug', 'build/examples/tutorial/ns3.26-first-debug', 'build/examples/tutorial/ns3.26-fourth-debug', 'build/examples/tutorial/ns3.26-fifth-debug', 'build/examples/tutorial/ns3.26-sixth-debug', 'build/examples/tutorial/ns3.26-seventh-debug', 'build/examples/ipv6/ns3.26-test-ipv6-debug', 'build/examples/traffic-control/ns3.26-traffic-control-debug', 'build/examples/traffic-control/ns3.26-queue-discs-benchmark-debug', 'build/scratch/subdir/ns3.26-subdir-debug', 'build/scratch/ns3.26-adhoc-debug', 'build/scratch/ns3.26-scratch-simulator-debug']
+
+# Scripts that are runnable.
+ns3_runnable_scripts = ['sample-simulator.py', 'wifi-ap.py', 'first.py']
+
@@ -0,0 +1,137 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef AQM_FIXED_POINT_H
+#define AQM_FIXED_POINT_H
+
+#include <stdint.h>
+#include <limits>
+
+namespace ns3 {
+
+/**
+ * \ingroup traffic-control
+ *
+ * \brief Unsigned fixed point arithmetic for the control laws of AQM queue discs
+ *
+ * As in the Linux implementation of RED (include/net/red.h), values are
+ * stored in 64 bit unsigned integers scaled by a power of two: weights and
+ * probabilities have PROB_SHIFT fractional bits (hence ONE stands for 1.0),
+ * average queue sizes and arrival counts have QUEUE_SHIFT fractional bits.
+ * Only integer operations are used after the parameters are converted, so
+ * that the results are the same with every compiler and floating point
+ * unit, and products are truncated, as a hardware implementation would do.
+ */
+class AqmFixedPoint
+{
+public:
+  static const uint32_t PROB_SHIFT = 32;    //!< Fractional bits of weights and probabilities
+  static const uint32_t QUEUE_SHIFT = 24;   //!< Fractional bits of queue sizes
+  static const uint64_t ONE = 1ULL << PROB_SHIFT;  //!< 1.0 as a probability
+
+  /**
+   * \brief Convert a non negative number to fixed point, rounding to nearest
+   * \param x the number, negative numbers are converted to 0
+   * \param shift the number of fractional bits
+   * \return the fixed point value, saturated to the largest value
+   */
+  static uint64_t FromDouble (double x, uint32_t shift)
+  {
+    double scaled = x * (double) (1ULL << shift) + 0.5;
+    if (!(scaled > 0))
+      {
+        return 0;
+      }
+    if (scaled >= 18446744073709551615.0)
+      {
+        return std::numeric_limits<uint64_t>::max ();
+      }
+    return (uint64_t) scaled;
+  }
+
+  /**
+   * \brief Convert a fixed point value to a double
+   * \param x the fixed point value
+   * \param shift the number of fractional bits
+   * \return the number
+   */
+  static double ToDouble (uint64_t x, uint32_t shift)
+  {
+    return x / (double) (1ULL << shift);
+  }
+
+  /**
+   * \brief Compute (a * b) >> shift without losing the high bits of the product
+   * \param a the first factor
+   * \param b the second factor
+   * \param shift the number of bits to shift the 128 bit product by, at most 64
+   * \return the truncated result, saturated to the largest value
+   */
+  static uint64_t MulShift (uint64_t a, uint64_t b, uint32_t shift)
+  {
+    const uint64_t mask = 0xffffffffULL;
+    uint64_t ll = (a & mask) * (b & mask);
+    uint64_t lh = (a & mask) * (b >> 32);
+    uint64_t hl = (a >> 32) * (b & mask);
+    uint64_t hh = (a >> 32) * (b >> 32);
+    uint64_t mid = (ll >> 32) + (lh & mask) + (hl & mask);
+    uint64_t lo = (ll & mask) | (mid << 32);
+    uint64_t hi = hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+
+    if (shift == 0)
+      {
+        return hi ? std::numeric_limits<uint64_t>::max () : lo;
+      }
+    if (shift >= 64)
+      {
+        return hi >> (shift - 64);
+      }
+    if (hi >> shift)
+      {
+        return std::numeric_limits<uint64_t>::max ();
+      }
+    return (hi << (64 - shift)) | (lo >> shift);
+  }
+
+  /**
+   * \brief Raise a probability to an integer power by repeated squaring
+   * \param x the base, with PROB_SHIFT fractional bits
+   * \param n the exponent
+   * \return x^n with PROB_SHIFT fractional bits, or ONE if x is at least ONE
+   */
+  static uint64_t Pow (uint64_t x, uint32_t n)
+  {
+    if (x >= ONE)
+      {
+        return ONE;
+      }
+    uint64_t result = ONE;
+    while (n > 0)
+      {
+        if (n & 1)
+          {
+            result = MulShift (result, x, PROB_SHIFT);
+          }
+        x = MulShift (x, x, PROB_SHIFT);
+        n >>= 1;
+      }
+    return result;
+  }
+};
+
+} // namespace ns3
+
+#endif /* AQM_FIXED_POINT_H */
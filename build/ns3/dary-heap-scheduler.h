@@ -0,0 +1,145 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef DARY_HEAP_SCHEDULER_H
+#define DARY_HEAP_SCHEDULER_H
+
+#include "scheduler.h"
+#include <stdint.h>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * Declaration of ns3::DaryHeapScheduler class template.
+ */
+
+namespace ns3 {
+
+class EventImpl;
+
+/**
+ * \ingroup scheduler
+ * \brief a d-ary heap event scheduler
+ *
+ * The heap only holds compact keys: the timestamp and the uid of the
+ * events, and the index of a slot holding their EventImpl pointer and
+ * their context. The key array is aligned so that the D children of a
+ * node are adjacent and, with D equal to 2 or 4, share a single cache
+ * line: moving down the heap touches one cache line per level, and
+ * a d-ary heap has log2(D) times fewer levels than a binary heap. While
+ * the children are compared, the cache lines of the grandchildren are
+ * prefetched. The slots are only touched to insert and to remove an event.
+ *
+ * Unlike HeapScheduler, Remove restores the heap order in both
+ * directions, hence this class is also correct when an event in the
+ * middle of the heap is removed.
+ *
+ * The variants DaryHeapScheduler<2> and DaryHeapScheduler<4> are
+ * registered with the TypeIds "ns3::DaryHeapScheduler<2>" and
+ * "ns3::DaryHeapScheduler<4>".
+ *
+ * \tparam D The arity of the heap.
+ */
+template <uint32_t D>
+class DaryHeapScheduler : public Scheduler
+{
+public:
+  /**
+   *  Register this type.
+   *  \return The object TypeId.
+   */
+  static TypeId GetTypeId (void);
+
+  /** Constructor. */
+  DaryHeapScheduler ();
+  /** Destructor. */
+  virtual ~DaryHeapScheduler ();
+
+  // Inherited
+  virtual void Insert (const Scheduler::Event &ev);
+  virtual bool IsEmpty (void) const;
+  virtual Scheduler::Event PeekNext (void) const;
+  virtual Scheduler::Event RemoveNext (void);
+  virtual void Remove (const Scheduler::Event &ev);
+
+private:
+  /** The size of a cache line, in bytes. */
+  static const uint32_t CACHE_LINE = 64;
+
+  /** The key of an event in the heap. */
+  struct Key
+  {
+    uint64_t ts;    //!< The timestamp of the event
+    uint32_t uid;   //!< The uid of the event
+    uint32_t slot;  //!< The index of the slot of the event
+  };
+
+  /** The slot of an event. */
+  struct Slot
+  {
+    EventImpl *impl;   //!< The event
+    uint32_t context;  //!< The context of the event
+  };
+
+  /**
+   * Compare two keys.
+   * \param [in] a The first key.
+   * \param [in] b The second key.
+   * \returns \c true if \p a comes before \p b.
+   */
+  static bool Less (const Key &a, const Key &b);
+  /**
+   * Grow the key array.
+   * \param [in] capacity The new number of keys the array can hold.
+   */
+  void Grow (uint32_t capacity);
+  /**
+   * Move a key up from a hole until the heap order is restored.
+   * \param [in] hole The index of the hole.
+   * \param [in] key The key.
+   */
+  void SiftUp (uint32_t hole, Key key);
+  /**
+   * Move a key down from a hole until the heap order is restored.
+   * \param [in] hole The index of the hole.
+   * \param [in] key The key.
+   */
+  void SiftDown (uint32_t hole, Key key);
+  /**
+   * Get the event of a key and free its slot.
+   * \param [in] key The key.
+   * \returns The event.
+   */
+  Scheduler::Event Release (const Key &key);
+
+  /** The memory of the key array. */
+  char *m_buffer;
+  /** The keys, with the children of node i at D * i + 1 to D * i + D. */
+  Key *m_keys;
+  /** The number of keys. */
+  uint32_t m_size;
+  /** The number of keys the array can hold. */
+  uint32_t m_capacity;
+  /** The slots. */
+  std::vector<Slot> m_slots;
+  /** The indexes of the free slots. */
+  std::vector<uint32_t> m_freeSlots;
+};
+
+} // namespace ns3
+
+#endif /* DARY_HEAP_SCHEDULER_H */
@@ -0,0 +1,15 @@
+
+#ifdef NS3_MODULE_COMPILATION
+# error "Do not include ns3 module aggregator headers from other modules; these are meant only for end user scripts."
+#endif
+
+#ifndef NS3_MODULE_DSDV
+    
+
+// Module headers:
+#include "dsdv-helper.h"
+#include "dsdv-packet-queue.h"
+#include "dsdv-packet.h"
+#include "dsdv-routing-protocol.h"
+#include "dsdv-rtable.h"
+#endif
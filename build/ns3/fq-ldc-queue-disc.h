@@ -0,0 +1,244 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef FQ_LDC_QUEUE_DISC
+#define FQ_LDC_QUEUE_DISC
+
+#include "ns3/queue-disc.h"
+#include "ns3/nstime.h"
+#include "ns3/data-rate.h"
+#include "ns3/random-variable-stream.h"
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup traffic-control
+ *
+ * \brief A FqLdc packet queue disc
+ *
+ * Packets are hashed into flow queues, each with its own LDC state, and
+ * the flow queues are served by Deficit Round Robin as in FqCoDel. The
+ * load factor and the delay average are thus kept per flow, so that the
+ * flows that send more than their share do not raise the drop
+ * probability of the others.
+ *
+ * A flow is a small record holding the DRR state and the LDC state, on
+ * which this queue disc runs the control law of LdcQueueDisc in lazy mode
+ * with UseSojournTime: no event is scheduled per flow, the missed control
+ * intervals are run when the flow is accessed, and the load factor is
+ * relative to the measured rate at which the scheduler serves the flow.
+ * The packets of all the flows are stored in a shared pool of slots, and
+ * the flows are kept in a heap ordered by backlog, so that the fattest
+ * flow is found in constant time when the queue disc is full. Enqueue and
+ * dequeue therefore take at most logarithmic time in the number of
+ * backlogged flows.
+ */
+class FqLdcQueueDisc : public QueueDisc {
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  /**
+   * \brief FqLdcQueueDisc constructor
+   */
+  FqLdcQueueDisc ();
+
+  virtual ~FqLdcQueueDisc ();
+
+   /**
+    * \brief Set the quantum value.
+    *
+    * \param quantum The number of bytes each queue gets to dequeue on each round of the scheduling algorithm
+    */
+   void SetQuantum (uint32_t quantum);
+
+   /**
+    * \brief Get the quantum value.
+    *
+    * \returns The number of bytes each queue gets to dequeue on each round of the scheduling algorithm
+    */
+   uint32_t GetQuantum (void) const;
+
+   /**
+    * \brief Get the number of packets dropped from the fattest flow because
+    * the queue disc was full
+    *
+    * \returns The number of overlimit dropped packets.
+    */
+   uint32_t GetOverlimitDroppedPackets (void) const;
+
+  /**
+   * Assign a fixed random variable stream number to the random variables
+   * used by this model.  Return the number of streams (possibly zero) that
+   * have been assigned.
+   *
+   * \param stream first stream index to use
+   * \return the number of stream indices assigned by this model
+   */
+  int64_t AssignStreams (int64_t stream);
+
+protected:
+  /**
+   * \brief Dispose of the object
+   */
+  virtual void DoDispose (void);
+
+private:
+  /// Status of a flow
+  enum FlowStatus
+  {
+    INACTIVE,   //!< The flow is in neither list
+    NEW_FLOW,   //!< The flow is in the list of new flows
+    OLD_FLOW    //!< The flow is in the list of old flows
+  };
+
+  /// The state of a flow queue
+  struct Flow
+  {
+    uint32_t head;          //!< Slot of the first packet
+    uint32_t tail;          //!< Slot of the last packet
+    uint32_t nPackets;      //!< Number of packets
+    uint32_t nBytes;        //!< Number of bytes
+    int32_t deficit;        //!< DRR deficit
+    FlowStatus status;      //!< DRR status
+    uint32_t next;          //!< Next flow in the list of new or old flows
+    uint32_t heapIndex;     //!< Position in the heap of backlogged flows
+    // LDC state, see LdcQueueDisc
+    uint32_t nIncome;       //!< Packets arrived in the current interval
+    bool idle;              //!< Whether the flow was found empty by the scheduler
+    bool inMeasurement;     //!< Whether a departure rate measurement cycle is in progress
+    uint32_t dqCount;       //!< Bytes departed since the start of the measurement cycle
+    Time idleTime;          //!< Start of the current idle period
+    Time nextTimeout;       //!< Expiration time of the next control interval
+    Time sojourn;           //!< Sojourn time of the last dequeued packet
+    Time dqStart;           //!< Start of the current measurement cycle
+    double nPkt;            //!< Average arrivals per interval
+    double dAvg;            //!< Average sojourn time in seconds
+    double avgDqRate;       //!< Average departure rate in bytes/second, 0 until measured
+    double prob;            //!< Drop probability
+  };
+
+  /// A packet stored in the pool
+  struct Slot
+  {
+    Ptr<QueueDiscItem> item;  //!< The packet, null if the slot is free
+    Time arrival;             //!< Time at which the packet was enqueued
+    uint32_t next;            //!< Next packet of the flow, or next free slot
+  };
+
+  /// A list of flows linked through Flow::next
+  struct FlowList
+  {
+    uint32_t head;          //!< First flow
+    uint32_t tail;          //!< Last flow
+  };
+
+  virtual bool DoEnqueue (Ptr<QueueDiscItem> item);
+  virtual Ptr<QueueDiscItem> DoDequeue (void);
+  virtual Ptr<const QueueDiscItem> DoPeek (void) const;
+  virtual bool CheckConfig (void);
+  virtual void InitializeParams (void);
+
+  /**
+   * \brief Drop packets from the head of the flow with the largest current byte count
+   * \return the index of the flow with the largest current byte count
+   */
+  uint32_t FqLdcDrop (void);
+
+  /**
+   * \brief Run the control intervals of a flow expired since its last update
+   * \param flow the flow
+   */
+  void CatchUp (Flow &flow);
+  /**
+   * \brief Remove the first packet of a flow
+   * \param index the index of the flow
+   * \returns the packet, or 0 if the flow is empty
+   */
+  Ptr<QueueDiscItem> RemoveHead (uint32_t index);
+  /**
+   * \brief Dequeue a packet from a flow and update its LDC state
+   * \param index the index of the flow
+   * \returns the packet, or 0 if the flow is empty
+   */
+  Ptr<QueueDiscItem> DequeueFromFlow (uint32_t index);
+  /**
+   * \brief Update the departure rate estimate of a flow with a dequeued packet
+   * \param flow the flow
+   * \param item the dequeued item
+   */
+  void UpdateDepartureRate (Flow &flow, Ptr<QueueDiscItem> item);
+
+  /**
+   * \brief Append a flow to a list
+   * \param list the list
+   * \param index the index of the flow
+   */
+  void PushBack (FlowList &list, uint32_t index);
+  /**
+   * \brief Remove the first flow of a list
+   * \param list the list
+   * \returns the index of the flow
+   */
+  uint32_t PopFront (FlowList &list);
+
+  /**
+   * \brief Restore the heap of backlogged flows after the backlog of a flow changed
+   * \param index the index of the flow
+   */
+  void UpdateHeap (uint32_t index);
+  /**
+   * \brief Swap two entries of the heap of backlogged flows
+   * \param i the position of the first entry
+   * \param j the position of the second entry
+   */
+  void SwapHeap (uint32_t i, uint32_t j);
+
+  uint32_t m_limit;          //!< Maximum number of packets in the queue disc
+  uint32_t m_quantum;        //!< Deficit assigned to flows at each round
+  uint32_t m_flows;          //!< Number of flow queues
+  uint32_t m_dropBatchSize;  //!< Max number of packets dropped from the fat flow
+  DataRate m_linkBandwidth;  //!< Link bandwidth, 0 to use the data rate of the device
+  uint32_t m_meanPktSize;    //!< LDC mean packet size attribute
+  std::string m_interval;    //!< LDC time interval attribute
+  std::string m_target;      //!< LDC target queueing delay attribute
+  double m_rTarget;          //!< LDC target load factor ratio attribute
+  double m_wQ;               //!< LDC delay weight attribute
+  uint32_t m_lExp;           //!< LDC exponent attribute
+
+  uint32_t m_overlimitDroppedPackets; //!< Number of overlimit dropped packets
+
+  Time m_oInterval;          //!< LDC time interval
+  Time m_dTarget;            //!< LDC target queueing delay
+  double m_ptc;              //!< Packet time constant of the link in packets/second
+
+  std::vector<uint32_t> m_flowsByHash;  //!< Flow of each hash bucket, NONE until used
+  std::vector<Flow> m_flowStates;       //!< The flows created so far
+  std::vector<uint32_t> m_heap;         //!< Max-heap of the backlogged flows, by byte count
+  std::vector<Slot> m_slots;            //!< The pool of packet slots
+  uint32_t m_freeSlot;                  //!< First free slot
+  FlowList m_newFlows;                  //!< The list of new flows
+  FlowList m_oldFlows;                  //!< The list of old flows
+
+  Ptr<UniformRandomVariable> m_uv;      //!< rng stream
+};
+
+} // namespace ns3
+
+#endif /* FQ_LDC_QUEUE_DISC */
@@ -0,0 +1,307 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * The algorithm follows the Linux HTB scheduler (net/sched/sch_htb.c)
+ * by Martin Devera.
+ */
+
+#ifndef HTB_QUEUE_DISC_H
+#define HTB_QUEUE_DISC_H
+
+#include "ns3/queue-disc.h"
+#include "ns3/data-rate.h"
+#include "ns3/event-id.h"
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace ns3 {
+
+class HtbQueueDisc;
+
+/**
+ * \ingroup traffic-control
+ *
+ * \brief A class of the HTB queue disc
+ *
+ * A class is guaranteed to send at its Rate and may borrow the unused
+ * bandwidth of its ancestors up to its Ceil. Leaf classes have a child
+ * queue disc and are added to the HTB queue disc with AddQueueDiscClass;
+ * inner classes have no queue disc and are only reachable as the parent
+ * of other classes.
+ */
+class HtbClass : public QueueDiscClass {
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  /**
+   * \brief HtbClass constructor
+   */
+  HtbClass ();
+
+  virtual ~HtbClass ();
+
+  /**
+   * \enum Mode
+   * \brief The state of the token buckets of the class
+   */
+  enum Mode
+    {
+      CAN_SEND,      //!< The class has rate and ceil tokens
+      MAY_BORROW,    //!< The class has ceil tokens only, it may borrow from its ancestors
+      CANT_SEND      //!< The class has no ceil tokens
+    };
+
+  /**
+   * \brief Set the parent of this class
+   * \param parent the parent class, an inner class, or 0 for a root class
+   */
+  void SetParentClass (Ptr<HtbClass> parent);
+  /**
+   * \brief Get the parent of this class
+   * \return the parent class, or 0 for a root class
+   */
+  Ptr<HtbClass> GetParentClass (void) const;
+  /**
+   * \brief Get the rate guaranteed to this class
+   * \return the rate
+   */
+  DataRate GetRate (void) const;
+  /**
+   * \brief Get the maximum rate of this class
+   * \return the ceil
+   */
+  DataRate GetCeil (void) const;
+  /**
+   * \brief Get the current mode of the class
+   * \return the mode
+   */
+  Mode GetMode (void) const;
+  /**
+   * \brief Get the number of packets sent through this class with the tokens of an ancestor
+   * \return the number of packets sent with borrowed tokens
+   */
+  uint32_t GetBorrowedPackets (void) const;
+
+protected:
+  /**
+   * \brief Dispose of the object
+   */
+  virtual void DoDispose (void);
+
+private:
+  friend class HtbQueueDisc;
+
+  static const uint32_t NUM_PRIO = 8;   //!< Number of priorities, as TC_HTB_NUMPRIO
+  static const uint32_t MAX_DEPTH = 8;  //!< Maximum number of levels, as TC_HTB_MAXDEPTH
+
+  DataRate m_rate;              //!< Guaranteed rate
+  DataRate m_ceil;              //!< Maximum rate
+  uint32_t m_burst;             //!< Size of the rate bucket in bytes
+  uint32_t m_cburst;            //!< Size of the ceil bucket in bytes
+  uint32_t m_quantum;           //!< Bytes served in a round when competing for the same level
+  uint32_t m_prio;              //!< Priority of the class, 0 is the highest
+  Ptr<HtbClass> m_parent;       //!< Parent class
+
+  // Variables maintained by the HTB queue disc
+  uint32_t m_id;                //!< Index of the class in the class tree
+  uint32_t m_level;             //!< 0 for leaves, one more than the highest child level otherwise
+  bool m_isLeaf;                //!< True if the class has a queue disc
+  Mode m_mode;                  //!< Current mode
+  int64_t m_buffer;             //!< Size of the rate bucket in nanoseconds
+  int64_t m_cbuffer;            //!< Size of the ceil bucket in nanoseconds
+  int64_t m_tokens;             //!< Rate tokens in nanoseconds
+  int64_t m_ctokens;            //!< Ceil tokens in nanoseconds
+  int64_t m_checkpoint;         //!< Time of the last token update in nanoseconds
+  int64_t m_waitKey;            //!< Time the class leaves the wait queue, -1 if not waiting
+  uint32_t m_activity;          //!< Bitmask of the priorities with a backlogged leaf below
+  int32_t m_deficit[MAX_DEPTH]; //!< DRR deficit of a leaf, for each level it is served from
+  std::set<uint32_t> m_feed[NUM_PRIO];  //!< Children borrowing from this inner class, per priority
+  uint32_t m_feedNext[NUM_PRIO];        //!< Lowest id of the next child to serve, per priority
+  uint32_t m_nBorrowed;         //!< Packets sent through this class with borrowed tokens
+};
+
+
+/**
+ * \ingroup traffic-control
+ *
+ * \brief A hierarchical token bucket (HTB) queue disc
+ *
+ * Packets are classified into leaf classes (a packet filter returns the
+ * index of the leaf class among the classes of the queue disc; packets not
+ * classified go to the DefaultClass) and the leaves are served by priority
+ * and then in round robin, as long as they or the ancestor they borrow
+ * from have tokens. As in Linux, the classes that can send are kept in
+ * ordered sets (one per level and priority, and one per inner class and
+ * priority for the borrowers) and the classes without tokens in a wait
+ * queue sorted by the time they get tokens back, so that enqueue and
+ * dequeue are logarithmic in the number of classes. When the queue disc is
+ * backlogged but no class can send, the queue disc is run again when the
+ * first class gets its tokens back.
+ */
+class HtbQueueDisc : public QueueDisc {
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  /**
+   * \brief HtbQueueDisc constructor
+   */
+  HtbQueueDisc ();
+
+  virtual ~HtbQueueDisc ();
+
+  /**
+   * \brief Set the parent drop callback
+   * \param cb the callback to set
+   *
+   * Called when the queue disc is added to a class of another queue disc,
+   * which is then in charge of dequeuing from it.
+   */
+  virtual void SetParentDropCallback (ParentDropCallback cb);
+
+protected:
+  /**
+   * \brief Dispose of the object
+   */
+  virtual void DoDispose (void);
+
+private:
+  virtual bool DoEnqueue (Ptr<QueueDiscItem> item);
+  virtual Ptr<QueueDiscItem> DoDequeue (void);
+  virtual Ptr<const QueueDiscItem> DoPeek (void) const;
+  virtual bool CheckConfig (void);
+  virtual void InitializeParams (void);
+
+  /**
+   * \brief Get a class of the class tree
+   * \param id the index of the class in the class tree
+   * \return the class
+   */
+  Ptr<HtbClass> GetClass (uint32_t id) const;
+  /**
+   * \brief Compute the mode a class would have with additional tokens
+   * \param cl the class
+   * \param diff the additional tokens in nanoseconds; set to the time the class needs to change mode
+   * \return the mode
+   */
+  HtbClass::Mode ClassMode (Ptr<HtbClass> cl, int64_t &diff) const;
+  /**
+   * \brief Update the mode of a class, moving it among rows and feeds
+   * \param cl the class
+   * \param diff the additional tokens in nanoseconds; set to the time the class needs to change mode
+   */
+  void ChangeClassMode (Ptr<HtbClass> cl, int64_t &diff);
+  /**
+   * \brief Attach a class to the row of its level or to the feed of its
+   * parent, and propagate the activity to the ancestors that it borrows from
+   * \param cl the class
+   */
+  void ActivatePrios (Ptr<HtbClass> cl);
+  /**
+   * \brief Undo ActivatePrios
+   * \param cl the class
+   */
+  void DeactivatePrios (Ptr<HtbClass> cl);
+  /**
+   * \brief Mark a leaf class as backlogged
+   * \param cl the leaf class
+   */
+  void Activate (Ptr<HtbClass> cl);
+  /**
+   * \brief Mark a leaf class as empty
+   * \param cl the leaf class
+   */
+  void Deactivate (Ptr<HtbClass> cl);
+  /**
+   * \brief Put a class in the wait queue
+   * \param cl the class
+   * \param delay the time in nanoseconds after which the class changes mode
+   */
+  void AddToWaitQueue (Ptr<HtbClass> cl, int64_t delay);
+  /**
+   * \brief Remove a class from the wait queue, if it is there
+   * \param cl the class
+   */
+  void RemoveFromWaitQueue (Ptr<HtbClass> cl);
+  /**
+   * \brief Update the mode of the classes whose wait time has expired
+   */
+  void DoEvents (void);
+  /**
+   * \brief Find the next class to serve in an ordered set of classes
+   * \param ids the set of class indices
+   * \param next the lowest index of the next class to serve
+   * \return the index of the class to serve
+   */
+  static uint32_t LookupNext (const std::set<uint32_t> &ids, uint32_t next);
+  /**
+   * \brief Find the leaf to serve starting from a row
+   * \param level the level of the row
+   * \param prio the priority
+   * \return the leaf class
+   */
+  Ptr<HtbClass> LookupLeaf (uint32_t level, uint32_t prio) const;
+  /**
+   * \brief Move the round robin pointer of the set a leaf was selected from
+   * \param cl the leaf class
+   * \param level the level the leaf was served from
+   * \param prio the priority
+   */
+  void NextLeaf (Ptr<HtbClass> cl, uint32_t level, uint32_t prio);
+  /**
+   * \brief Dequeue a packet from the leaves reached from a row
+   * \param level the level of the row
+   * \param prio the priority
+   * \return the dequeued item, or 0
+   */
+  Ptr<QueueDiscItem> DequeueTree (uint32_t level, uint32_t prio);
+  /**
+   * \brief Charge the tokens of a leaf and its ancestors for a packet
+   * \param cl the leaf class
+   * \param level the level the leaf was served from
+   * \param bytes the size of the packet
+   */
+  void ChargeClass (Ptr<HtbClass> cl, uint32_t level, uint32_t bytes);
+  /**
+   * \brief Run the queue disc when the first waiting class changes mode
+   */
+  void ScheduleWatchdog (void);
+  /**
+   * \brief Run the queue disc after the watchdog expires, or the root queue
+   * disc if this queue disc is a child
+   */
+  void Watchdog (void);
+
+  uint32_t m_defaultClass;       //!< Leaf class of the packets not classified by the filters
+
+  std::vector<Ptr<HtbClass> > m_tree;  //!< Leaf classes followed by inner classes
+  uint32_t m_nLevels;            //!< Number of levels of the class tree
+  std::set<uint32_t> m_rows[HtbClass::MAX_DEPTH][HtbClass::NUM_PRIO];  //!< Classes that can send, per level and priority
+  uint32_t m_rowNext[HtbClass::MAX_DEPTH][HtbClass::NUM_PRIO];         //!< Lowest id of the next class to serve in a row
+  std::set<std::pair<int64_t, uint32_t> > m_waitQueue;      //!< Classes waiting for tokens, by time
+  mutable Ptr<QueueDiscItem> m_peeked;  //!< Item dequeued by DoPeek
+  EventId m_watchdog;            //!< Event running the queue disc when tokens are available
+  bool m_isChild;                //!< True if the queue disc belongs to a class of another queue disc
+};
+
+} // namespace ns3
+
+#endif /* HTB_QUEUE_DISC_H */
@@ -0,0 +1,141 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LADDER_SCHEDULER_H
+#define LADDER_SCHEDULER_H
+
+#include "scheduler.h"
+#include <stdint.h>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * Declaration of ns3::LadderScheduler class.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup scheduler
+ * \brief a ladder queue event scheduler
+ *
+ * This event scheduler implements the ladder queue described in
+ * "Ladder Queue: An O(1) Priority Queue Structure for Large-Scale
+ * Discrete Event Simulation" by W. T. Tang, R. S. M. Goh and I. L.-J. Thng
+ * (ACM TOMACS, 2005). Events are kept in three tiers:
+ *  - the top: an unsorted vector receiving the events scheduled beyond
+ *    the time range covered by the rungs;
+ *  - the ladder: up to MAX_RUNGS rungs of buckets. When the ladder is empty,
+ *    the top is spread over a new rung whose bucket width is derived from
+ *    the range of its events, and a bucket holding more than THRESHOLD events
+ *    is spread over a finer child rung instead of being sorted;
+ *  - the bottom: a small sorted vector holding the events of the bucket
+ *    currently being consumed.
+ *
+ * Unlike the calendar queue, the bucket width adapts lazily to each epoch
+ * of events without ever resizing the whole structure, so that Insert and
+ * RemoveNext run in amortized O(1) time, also with the bimodal timestamp
+ * distributions (for instance, nanosecond scale packet events mixed with
+ * millisecond scale protocol timers) that defeat the calendar queue.
+ * The buckets are vectors whose storage is reused across epochs.
+ */
+class LadderScheduler : public Scheduler
+{
+public:
+  /**
+   *  Register this type.
+   *  \return The object TypeId.
+   */
+  static TypeId GetTypeId (void);
+
+  /** Constructor. */
+  LadderScheduler ();
+  /** Destructor. */
+  virtual ~LadderScheduler ();
+
+  // Inherited
+  virtual void Insert (const Scheduler::Event &ev);
+  virtual bool IsEmpty (void) const;
+  virtual Scheduler::Event PeekNext (void) const;
+  virtual Scheduler::Event RemoveNext (void);
+  virtual void Remove (const Scheduler::Event &ev);
+
+private:
+  /** Maximum number of rungs. */
+  static const uint32_t MAX_RUNGS = 8;
+  /** Bucket size above which a bucket is spread over a child rung. */
+  static const uint32_t THRESHOLD = 50;
+  /** Maximum number of buckets of a rung. */
+  static const uint32_t MAX_BUCKETS = 1 << 16;
+
+  /** Bucket type: an unsorted vector of events. */
+  typedef std::vector<Scheduler::Event> Bucket;
+
+  /** A rung of the ladder. */
+  struct Rung
+  {
+    uint64_t start;               //!< Timestamp of the start of the first bucket
+    uint64_t width;               //!< Width of the buckets
+    uint32_t nBuckets;            //!< Number of buckets in use
+    uint32_t current;             //!< Index of the next bucket to consume
+    std::vector<Bucket> buckets;  //!< The buckets
+  };
+
+  /**
+   * Get the rung and bucket an event belongs to.
+   * \param [in] ts The timestamp of the event.
+   * \param [out] bucket The bucket the event belongs to.
+   * \return \c true if the event belongs to a rung, \c false if it
+   *         belongs to the bottom.
+   */
+  bool FindBucket (uint64_t ts, Bucket **bucket);
+  /**
+   * Spread a set of events over a new rung.
+   * \param [in] events The events.
+   * \param [in] start The start of the time range covered by the rung.
+   * \param [in] range The length of the time range covered by the rung.
+   */
+  void SpawnRung (const Bucket &events, uint64_t start, uint64_t range);
+  /**
+   * Sort a set of events into the bottom.
+   * \param [in] events The events.
+   */
+  void FillBottom (const Bucket &events);
+  /** Refill the bottom, which must be empty, with the next events. */
+  void Refill (void);
+
+  /** The top events, beyond the range of the ladder. */
+  Bucket m_top;
+  /** The start of the time range of the top. */
+  uint64_t m_topStart;
+  /** The smallest timestamp inserted in the top. */
+  uint64_t m_topMin;
+  /** The largest timestamp inserted in the top. */
+  uint64_t m_topMax;
+  /** The rungs, of which the first m_nRungs are in use. */
+  std::vector<Rung> m_rungs;
+  /** The number of rungs in use. */
+  uint32_t m_nRungs;
+  /** The bottom events, sorted by decreasing timestamp. */
+  Bucket m_bottom;
+  /** The number of events. */
+  uint32_t m_size;
+};
+
+} // namespace ns3
+
+#endif /* LADDER_SCHEDULER_H */
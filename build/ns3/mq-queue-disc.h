@@ -0,0 +1,77 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * The queue disc follows the Linux mq scheduler (net/sched/sch_mq.c).
+ */
+
+#ifndef MQ_QUEUE_DISC_H
+#define MQ_QUEUE_DISC_H
+
+#include "ns3/queue-disc.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup traffic-control
+ *
+ * \brief The mq multi-queue aware queue disc
+ *
+ * mq has as many classes as the transmission queues of the device it is
+ * installed on, and the child queue disc of the i-th class is attached to the
+ * i-th transmission queue. The wake mode of mq is WAKE_CHILD, hence the
+ * traffic control layer enqueues the packets directly in the child queue disc
+ * of the transmission queue selected for them, and a device waking one of
+ * its transmission queues only restarts the corresponding child queue disc.
+ * The child queue discs are thus independent of each other: each of them
+ * runs its own control law (e.g., one LDC instance per Wi-Fi access
+ * category) and a stopped transmission queue does not block the packets
+ * destined to the other queues.
+ *
+ * mq can only be installed as root queue disc. It has no internal queue and
+ * no packet filter, and does not store packets itself: its packet counters
+ * and traces are always zero, those of the child queue discs must be used
+ * instead.
+ */
+class MqQueueDisc : public QueueDisc {
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  /**
+   * \brief MqQueueDisc constructor
+   */
+  MqQueueDisc ();
+
+  virtual ~MqQueueDisc();
+
+  /**
+   * \brief Return the wake mode adopted by this queue disc.
+   * \return WAKE_CHILD
+   */
+  virtual WakeMode GetWakeMode (void);
+
+private:
+  virtual bool DoEnqueue (Ptr<QueueDiscItem> item);
+  virtual Ptr<QueueDiscItem> DoDequeue (void);
+  virtual Ptr<const QueueDiscItem> DoPeek (void) const;
+  virtual bool CheckConfig (void);
+  virtual void InitializeParams (void);
+};
+
+} // namespace ns3
+
+#endif /* MQ_QUEUE_DISC_H */
@@ -27,13 +27,13 @@
 // n1 ------------------------------------ n2 ----------------------------------- n3
 //   point-to-point (access link)                point-to-point (bottleneck link)
 //   100 Mbps, 0.1 ms                            bandwidth [10 Mbps], delay [5 ms]
-//   qdiscs PfifoFast with capacity              qdiscs queueDiscType in {PfifoFast, ARED, CoDel, FqCoDel, PIE} [PfifoFast]
+//   qdiscs PfifoFast with capacity              qdiscs queueDiscType in {PfifoFast, ARED, CoDel, FqCoDel, PIE, LDC, FqLDC} [PfifoFast]
 //   of 1000 packets                             with capacity of queueDiscSize packets [1000]
 //   netdevices queues with size of 100 packets  netdevices queues with size of netdevicesQueueSize packets [100]
 //   without BQL                                 bql BQL [false]
 //   *** fixed configuration ***
 //
-// Two TCP flows are generated: one from n1 to n3 and the other from n3 to n1.
+// nFlows TCP flows [1] are generated from n1 to n3 and as many from n3 to n1.
 // Additionally, n1 pings n3, so that the RTT can be measured.
 //
 // The output will consist of a number of ping Rtt such as:
@@ -52,6 +52,16 @@
 //
 // If you use an AQM as queue disc on the bottleneck netdevices, you can observe that the ping Rtt
 // decrease. A further decrease can be observed when you enable BQL.
+//
+// In batch mode (--batch), the scenario is run once for every combination of the
+// number of flows in --flowsList and of the bottleneck bandwidth in --bandwidthList,
+// within the same process and without ping and per-run trace files. A single CSV
+// file (--csvFile) is written, with one line per run:
+//
+//    queueDiscType,bandwidth,flows,goodputMbps,meanSojournMs,p99SojournMs,drops,wallSecPerSimSec
+//
+// where the sojourn time is read from the sojourn time histogram of the bottleneck
+// queue disc of n2 and the last column is the wall clock time spent per simulated second.
 
 #include "ns3/core-module.h"
 #include "ns3/network-module.h"
@@ -61,6 +71,8 @@
 #include "ns3/internet-apps-module.h"
 #include "ns3/traffic-control-module.h"
 #include "ns3/flow-monitor-module.h"
+#include <fstream>
+#include <sstream>
 
 using namespace ns3;
 
@@ -93,37 +105,43 @@ static void PingRtt (std::string context, Time rtt)
   std::cout << context << "=" << rtt.GetMilliSeconds () << " ms" << std::endl;
 }
 
-int main (int argc, char *argv[])
+/**
+ * Parameters of a single run of the benchmark
+ */
+struct BenchmarkConfig
 {
-  std::string bandwidth = "10Mbps";
-  std::string delay = "5ms";
-  std::string queueDiscType = "PfifoFast";
-  uint32_t queueDiscSize = 1000;
-  uint32_t netdevicesQueueSize = 100;
-  bool bql = false;
-
-  std::string flowsDatarate = "20Mbps";
-  uint32_t flowsPacketsSize = 1000;
-
-  float startTime = 0.1; // in s
-  float simDuration = 60;
-  float samplingPeriod = 1;
-
-  CommandLine cmd;
-  cmd.AddValue ("bandwidth", "Bottleneck bandwidth", bandwidth);
-  cmd.AddValue ("delay", "Bottleneck delay", delay);
-  cmd.AddValue ("queueDiscType", "Bottleneck queue disc type in {PfifoFast, ARED, CoDel, FqCoDel, PIE}", queueDiscType);
-  cmd.AddValue ("queueDiscSize", "Bottleneck queue disc size in packets", queueDiscSize);
-  cmd.AddValue ("netdevicesQueueSize", "Bottleneck netdevices queue size in packets", netdevicesQueueSize);
-  cmd.AddValue ("bql", "Enable byte queue limits on bottleneck netdevices", bql);
-  cmd.AddValue ("flowsDatarate", "Upload and download flows datarate", flowsDatarate);
-  cmd.AddValue ("flowsPacketsSize", "Upload and download flows packets sizes", flowsPacketsSize);
-  cmd.AddValue ("startTime", "Simulation start time", startTime);
-  cmd.AddValue ("simDuration", "Simulation duration in seconds", simDuration);
-  cmd.AddValue ("samplingPeriod", "Goodput sampling period in seconds", samplingPeriod);
-  cmd.Parse (argc, argv);
-
-  float stopTime = startTime + simDuration;
+  std::string bandwidth;
+  std::string delay;
+  std::string queueDiscType;
+  uint32_t queueDiscSize;
+  uint32_t netdevicesQueueSize;
+  bool bql;
+  uint32_t nFlows;
+  std::string flowsDatarate;
+  uint32_t flowsPacketsSize;
+  float startTime;
+  float simDuration;
+  float samplingPeriod;
+  bool traces;           //!< ping, per-run trace files and flow monitor
+};
+
+/**
+ * Results of a single run of the benchmark
+ */
+struct BenchmarkResult
+{
+  double goodput;        //!< aggregate goodput of all the flows, in bit/s
+  double meanSojourn;    //!< mean sojourn time in the bottleneck queue disc, in s
+  double p99Sojourn;     //!< 99th percentile of the sojourn time, in s
+  uint32_t drops;        //!< packets dropped by the bottleneck queue disc
+  double wallPerSimSec;  //!< wall clock seconds per simulated second
+};
+
+static BenchmarkResult
+RunBenchmark (BenchmarkConfig c)
+{
+  std::string queueDiscType = c.queueDiscType;
+  float stopTime = c.startTime + c.simDuration;
 
   // Create nodes
   NodeContainer n1, n2, n3;
@@ -137,8 +155,8 @@ int main (int argc, char *argv[])
   accessLink.SetChannelAttribute ("Delay", StringValue ("0.1ms"));
 
   PointToPointHelper bottleneckLink;
-  bottleneckLink.SetDeviceAttribute ("DataRate", StringValue (bandwidth));
-  bottleneckLink.SetChannelAttribute ("Delay", StringValue (delay));
+  bottleneckLink.SetDeviceAttribute ("DataRate", StringValue (c.bandwidth));
+  bottleneckLink.SetChannelAttribute ("Delay", StringValue (c.delay));
 
   InternetStackHelper stack;
   stack.InstallAll ();
@@ -152,25 +170,25 @@ int main (int argc, char *argv[])
 
   if (queueDiscType.compare ("PfifoFast") == 0)
     {
-      tchBottleneck.SetRootQueueDisc ("ns3::PfifoFastQueueDisc", "Limit", UintegerValue (queueDiscSize));
+      tchBottleneck.SetRootQueueDisc ("ns3::PfifoFastQueueDisc", "Limit", UintegerValue (c.queueDiscSize));
     }
   else if (queueDiscType.compare ("ARED") == 0)
     {
       handle = tchBottleneck.SetRootQueueDisc ("ns3::RedQueueDisc");
       Config::SetDefault ("ns3::RedQueueDisc::ARED", BooleanValue (true));
       Config::SetDefault ("ns3::RedQueueDisc::Mode", EnumValue (Queue::QUEUE_MODE_PACKETS));
-      Config::SetDefault ("ns3::RedQueueDisc::QueueLimit", UintegerValue (queueDiscSize));
+      Config::SetDefault ("ns3::RedQueueDisc::QueueLimit", UintegerValue (c.queueDiscSize));
     }
   else if (queueDiscType.compare ("CoDel") == 0)
     {
       handle = tchBottleneck.SetRootQueueDisc ("ns3::CoDelQueueDisc");
       Config::SetDefault ("ns3::CoDelQueueDisc::Mode", EnumValue (Queue::QUEUE_MODE_PACKETS));
-      Config::SetDefault ("ns3::CoDelQueueDisc::MaxPackets", UintegerValue (queueDiscSize));
+      Config::SetDefault ("ns3::CoDelQueueDisc::MaxPackets", UintegerValue (c.queueDiscSize));
     }
   else if (queueDiscType.compare ("FqCoDel") == 0)
     {
       handle = tchBottleneck.SetRootQueueDisc ("ns3::FqCoDelQueueDisc");
-      Config::SetDefault ("ns3::FqCoDelQueueDisc::Packet limit", UintegerValue (queueDiscSize));
+      Config::SetDefault ("ns3::FqCoDelQueueDisc::PacketLimit", UintegerValue (c.queueDiscSize));
       tchBottleneck.AddPacketFilter (handle, "ns3::FqCoDelIpv4PacketFilter");
       tchBottleneck.AddPacketFilter (handle, "ns3::FqCoDelIpv6PacketFilter");
     }
@@ -178,14 +196,32 @@ int main (int argc, char *argv[])
     {
       handle = tchBottleneck.SetRootQueueDisc ("ns3::PieQueueDisc");
       Config::SetDefault ("ns3::PieQueueDisc::Mode", EnumValue (Queue::QUEUE_MODE_PACKETS));
-      Config::SetDefault ("ns3::PieQueueDisc::QueueLimit", UintegerValue (queueDiscSize));
+      Config::SetDefault ("ns3::PieQueueDisc::QueueLimit", UintegerValue (c.queueDiscSize));
+    }
+  else if (queueDiscType.compare ("LDC") == 0)
+    {
+      // the LDC specific attributes are set from the command line
+      handle = tchBottleneck.SetRootQueueDisc ("ns3::LdcQueueDisc");
+      Config::SetDefault ("ns3::LdcQueueDisc::Mode", EnumValue (Queue::QUEUE_MODE_PACKETS));
+      Config::SetDefault ("ns3::LdcQueueDisc::QueueLimit", UintegerValue (c.queueDiscSize));
+      Config::SetDefault ("ns3::LdcQueueDisc::MeanPktSize", UintegerValue (c.flowsPacketsSize));
+      Config::SetDefault ("ns3::LdcQueueDisc::LinkBandwidth", StringValue (c.bandwidth));
+      Config::SetDefault ("ns3::LdcQueueDisc::LinkDelay", StringValue (c.delay));
+    }
+  else if (queueDiscType.compare ("FqLDC") == 0)
+    {
+      handle = tchBottleneck.SetRootQueueDisc ("ns3::FqLdcQueueDisc");
+      Config::SetDefault ("ns3::FqLdcQueueDisc::PacketLimit", UintegerValue (c.queueDiscSize));
+      Config::SetDefault ("ns3::FqLdcQueueDisc::MeanPktSize", UintegerValue (c.flowsPacketsSize));
+      tchBottleneck.AddPacketFilter (handle, "ns3::FqCoDelIpv4PacketFilter");
+      tchBottleneck.AddPacketFilter (handle, "ns3::FqCoDelIpv6PacketFilter");
     }
   else
     {
       NS_ABORT_MSG ("--queueDiscType not valid");
     }
 
-  if (bql)
+  if (c.bql)
     {
       tchBottleneck.SetQueueLimits ("ns3::DynamicQueueLimits");
     }
@@ -200,7 +236,7 @@ int main (int argc, char *argv[])
   address.NewNetwork ();
   Ipv4InterfaceContainer interfacesAccess = address.Assign (devicesAccessLink);
 
-  Config::SetDefault ("ns3::Queue::MaxPackets", UintegerValue (netdevicesQueueSize));
+  Config::SetDefault ("ns3::Queue::MaxPackets", UintegerValue (c.netdevicesQueueSize));
 
   NetDeviceContainer devicesBottleneckLink = bottleneckLink.Install (n2.Get (0), n3.Get (0));
   QueueDiscContainer qdiscs;
@@ -209,20 +245,27 @@ int main (int argc, char *argv[])
   address.NewNetwork ();
   Ipv4InterfaceContainer interfacesBottleneck = address.Assign (devicesBottleneckLink);
 
-  Ptr<NetDeviceQueueInterface> interface = devicesBottleneckLink.Get (0)->GetObject<NetDeviceQueueInterface> ();
-  Ptr<NetDeviceQueue> queueInterface = interface->GetTxQueue (0);
-  Ptr<DynamicQueueLimits> queueLimits = StaticCast<DynamicQueueLimits> (queueInterface->GetQueueLimits ());
+  // the sojourn times are recorded in nanoseconds, within 1% of their value
+  Ptr<QueueDisc> bottleneckQueueDisc = qdiscs.Get (0);
+  bottleneckQueueDisc->SetSojournHistogramPrecision (8);
 
   AsciiTraceHelper ascii;
-  if (bql)
+  if (c.traces)
     {
-      queueDiscType = queueDiscType + "-bql";
-      Ptr<OutputStreamWrapper> streamLimits = ascii.CreateFileStream (queueDiscType + "-limits.txt");
-      queueLimits->TraceConnectWithoutContext ("Limit",MakeBoundCallback (&LimitsTrace, streamLimits));
+      Ptr<NetDeviceQueueInterface> interface = devicesBottleneckLink.Get (0)->GetObject<NetDeviceQueueInterface> ();
+      Ptr<NetDeviceQueue> queueInterface = interface->GetTxQueue (0);
+      Ptr<DynamicQueueLimits> queueLimits = StaticCast<DynamicQueueLimits> (queueInterface->GetQueueLimits ());
+
+      if (c.bql)
+        {
+          queueDiscType = queueDiscType + "-bql";
+          Ptr<OutputStreamWrapper> streamLimits = ascii.CreateFileStream (queueDiscType + "-limits.txt");
+          queueLimits->TraceConnectWithoutContext ("Limit",MakeBoundCallback (&LimitsTrace, streamLimits));
+        }
+      Ptr<Queue> queue = StaticCast<PointToPointNetDevice> (devicesBottleneckLink.Get (0))->GetQueue ();
+      Ptr<OutputStreamWrapper> streamBytesInQueue = ascii.CreateFileStream (queueDiscType + "-bytesInQueue.txt");
+      queue->TraceConnectWithoutContext ("BytesInQueue",MakeBoundCallback (&BytesInQueueTrace, streamBytesInQueue));
     }
-  Ptr<Queue> queue = StaticCast<PointToPointNetDevice> (devicesBottleneckLink.Get (0))->GetQueue ();
-  Ptr<OutputStreamWrapper> streamBytesInQueue = ascii.CreateFileStream (queueDiscType + "-bytesInQueue.txt");
-  queue->TraceConnectWithoutContext ("BytesInQueue",MakeBoundCallback (&BytesInQueueTrace, streamBytesInQueue));
 
   Ipv4InterfaceContainer n1Interface;
   n1Interface.Add (interfacesAccess.Get (0));
@@ -232,48 +275,54 @@ int main (int argc, char *argv[])
 
   Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
 
-  Config::SetDefault ("ns3::TcpSocket::SegmentSize", UintegerValue (flowsPacketsSize));
+  Config::SetDefault ("ns3::TcpSocket::SegmentSize", UintegerValue (c.flowsPacketsSize));
 
   // Flows configuration
   // Bidirectional TCP streams with ping like flent tcp_bidirectional test.
-  uint16_t port = 7;
   ApplicationContainer uploadApp, downloadApp, sourceApps;
-  // Configure and install upload flow
-  Address addUp (InetSocketAddress (Ipv4Address::GetAny (), port));
-  PacketSinkHelper sinkHelperUp ("ns3::TcpSocketFactory", addUp);
-  sinkHelperUp.SetAttribute ("Protocol", TypeIdValue (TcpSocketFactory::GetTypeId ()));
-  uploadApp.Add (sinkHelperUp.Install (n3));
-
-  InetSocketAddress socketAddressUp = InetSocketAddress (n3Interface.GetAddress (0), port);
-  OnOffHelper onOffHelperUp ("ns3::TcpSocketFactory", Address ());
-  onOffHelperUp.SetAttribute ("Remote", AddressValue (socketAddressUp));
-  onOffHelperUp.SetAttribute ("OnTime", StringValue ("ns3::ConstantRandomVariable[Constant=1]"));
-  onOffHelperUp.SetAttribute ("OffTime", StringValue ("ns3::ConstantRandomVariable[Constant=0]"));
-  onOffHelperUp.SetAttribute ("PacketSize", UintegerValue (flowsPacketsSize));
-  onOffHelperUp.SetAttribute ("DataRate", StringValue (flowsDatarate));
-  sourceApps.Add (onOffHelperUp.Install (n1));
-
-  port = 8;
-  // Configure and install download flow
-  Address addDown (InetSocketAddress (Ipv4Address::GetAny (), port));
-  PacketSinkHelper sinkHelperDown ("ns3::TcpSocketFactory", addDown);
-  sinkHelperDown.SetAttribute ("Protocol", TypeIdValue (TcpSocketFactory::GetTypeId ()));
-  downloadApp.Add (sinkHelperDown.Install (n1));
-
-  InetSocketAddress socketAddressDown = InetSocketAddress (n1Interface.GetAddress (0), port);
-  OnOffHelper onOffHelperDown ("ns3::TcpSocketFactory", Address ());
-  onOffHelperDown.SetAttribute ("Remote", AddressValue (socketAddressDown));
-  onOffHelperDown.SetAttribute ("OnTime", StringValue ("ns3::ConstantRandomVariable[Constant=1]"));
-  onOffHelperDown.SetAttribute ("OffTime", StringValue ("ns3::ConstantRandomVariable[Constant=0]"));
-  onOffHelperDown.SetAttribute ("PacketSize", UintegerValue (flowsPacketsSize));
-  onOffHelperDown.SetAttribute ("DataRate", StringValue (flowsDatarate));
-  sourceApps.Add (onOffHelperDown.Install (n3));
-
-  // Configure and install ping
-  V4PingHelper ping = V4PingHelper (n3Interface.GetAddress (0));
-  ping.Install (n1);
-
-  Config::Connect ("/NodeList/*/ApplicationList/*/$ns3::V4Ping/Rtt", MakeCallback (&PingRtt));
+  for (uint32_t i = 0; i < c.nFlows; i++)
+    {
+      uint16_t port = 7 + 2 * i;
+      // Configure and install upload flow
+      Address addUp (InetSocketAddress (Ipv4Address::GetAny (), port));
+      PacketSinkHelper sinkHelperUp ("ns3::TcpSocketFactory", addUp);
+      sinkHelperUp.SetAttribute ("Protocol", TypeIdValue (TcpSocketFactory::GetTypeId ()));
+      uploadApp.Add (sinkHelperUp.Install (n3));
+
+      InetSocketAddress socketAddressUp = InetSocketAddress (n3Interface.GetAddress (0), port);
+      OnOffHelper onOffHelperUp ("ns3::TcpSocketFactory", Address ());
+      onOffHelperUp.SetAttribute ("Remote", AddressValue (socketAddressUp));
+      onOffHelperUp.SetAttribute ("OnTime", StringValue ("ns3::ConstantRandomVariable[Constant=1]"));
+      onOffHelperUp.SetAttribute ("OffTime", StringValue ("ns3::ConstantRandomVariable[Constant=0]"));
+      onOffHelperUp.SetAttribute ("PacketSize", UintegerValue (c.flowsPacketsSize));
+      onOffHelperUp.SetAttribute ("DataRate", StringValue (c.flowsDatarate));
+      sourceApps.Add (onOffHelperUp.Install (n1));
+
+      port = 8 + 2 * i;
+      // Configure and install download flow
+      Address addDown (InetSocketAddress (Ipv4Address::GetAny (), port));
+      PacketSinkHelper sinkHelperDown ("ns3::TcpSocketFactory", addDown);
+      sinkHelperDown.SetAttribute ("Protocol", TypeIdValue (TcpSocketFactory::GetTypeId ()));
+      downloadApp.Add (sinkHelperDown.Install (n1));
+
+      InetSocketAddress socketAddressDown = InetSocketAddress (n1Interface.GetAddress (0), port);
+      OnOffHelper onOffHelperDown ("ns3::TcpSocketFactory", Address ());
+      onOffHelperDown.SetAttribute ("Remote", AddressValue (socketAddressDown));
+      onOffHelperDown.SetAttribute ("OnTime", StringValue ("ns3::ConstantRandomVariable[Constant=1]"));
+      onOffHelperDown.SetAttribute ("OffTime", StringValue ("ns3::ConstantRandomVariable[Constant=0]"));
+      onOffHelperDown.SetAttribute ("PacketSize", UintegerValue (c.flowsPacketsSize));
+      onOffHelperDown.SetAttribute ("DataRate", StringValue (c.flowsDatarate));
+      sourceApps.Add (onOffHelperDown.Install (n3));
+    }
+
+  if (c.traces)
+    {
+      // Configure and install ping
+      V4PingHelper ping = V4PingHelper (n3Interface.GetAddress (0));
+      ping.Install (n1);
+
+      Config::Connect ("/NodeList/*/ApplicationList/*/$ns3::V4Ping/Rtt", MakeCallback (&PingRtt));
+    }
 
   uploadApp.Start (Seconds (0));
   uploadApp.Stop (Seconds (stopTime));
@@ -283,23 +332,169 @@ int main (int argc, char *argv[])
   sourceApps.Start (Seconds (0 + 0.1));
   sourceApps.Stop (Seconds (stopTime - 0.1));
 
-  Ptr<OutputStreamWrapper> uploadGoodputStream = ascii.CreateFileStream (queueDiscType + "-upGoodput.txt");
-  Simulator::Schedule (Seconds (samplingPeriod), &GoodputSampling, queueDiscType + "-upGoodput.txt", uploadApp,
-                       uploadGoodputStream, samplingPeriod);
-  Ptr<OutputStreamWrapper> downloadGoodputStream = ascii.CreateFileStream (queueDiscType + "-downGoodput.txt");
-  Simulator::Schedule (Seconds (samplingPeriod), &GoodputSampling, queueDiscType + "-downGoodput.txt", downloadApp,
-                       downloadGoodputStream, samplingPeriod);
-
   // Flow monitor
   Ptr<FlowMonitor> flowMonitor;
   FlowMonitorHelper flowHelper;
-  flowMonitor = flowHelper.InstallAll();
+
+  if (c.traces)
+    {
+      Ptr<OutputStreamWrapper> uploadGoodputStream = ascii.CreateFileStream (queueDiscType + "-upGoodput.txt");
+      Simulator::Schedule (Seconds (c.samplingPeriod), &GoodputSampling, queueDiscType + "-upGoodput.txt", uploadApp,
+                           uploadGoodputStream, c.samplingPeriod);
+      Ptr<OutputStreamWrapper> downloadGoodputStream = ascii.CreateFileStream (queueDiscType + "-downGoodput.txt");
+      Simulator::Schedule (Seconds (c.samplingPeriod), &GoodputSampling, queueDiscType + "-downGoodput.txt", downloadApp,
+                           downloadGoodputStream, c.samplingPeriod);
+
+      flowMonitor = flowHelper.InstallAll();
+    }
+
+  SystemWallClockMs wallClock;
+  wallClock.Start ();
 
   Simulator::Stop (Seconds (stopTime));
   Simulator::Run ();
 
-  flowMonitor->SerializeToXmlFile(queueDiscType + "-flowMonitor.xml", true, true);
+  int64_t wallMs = wallClock.End ();
+
+  if (c.traces)
+    {
+      flowMonitor->SerializeToXmlFile(queueDiscType + "-flowMonitor.xml", true, true);
+    }
+
+  BenchmarkResult r;
+  uint64_t rxBytes = 0;
+  for (uint32_t i = 0; i < c.nFlows; i++)
+    {
+      rxBytes += DynamicCast<PacketSink> (uploadApp.Get (i))->GetTotalRx ();
+      rxBytes += DynamicCast<PacketSink> (downloadApp.Get (i))->GetTotalRx ();
+    }
+  r.goodput = rxBytes * 8.0 / c.simDuration;
+  const LogLinearHistogram &sojourn = bottleneckQueueDisc->GetSojournHistogram ();
+  r.meanSojourn = sojourn.GetMean () / 1e9;
+  r.p99Sojourn = sojourn.GetPercentile (99) / 1e9;
+  r.drops = bottleneckQueueDisc->GetTotalDroppedPackets ();
+  r.wallPerSimSec = wallMs / 1000.0 / stopTime;
 
   Simulator::Destroy ();
+  return r;
+}
+
+static std::vector<std::string>
+SplitList (std::string list)
+{
+  std::vector<std::string> items;
+  std::istringstream iss (list);
+  std::string item;
+  while (std::getline (iss, item, ','))
+    {
+      items.push_back (item);
+    }
+  return items;
+}
+
+int main (int argc, char *argv[])
+{
+  BenchmarkConfig c;
+  c.bandwidth = "10Mbps";
+  c.delay = "5ms";
+  c.queueDiscType = "PfifoFast";
+  c.queueDiscSize = 1000;
+  c.netdevicesQueueSize = 100;
+  c.bql = false;
+  c.nFlows = 1;
+
+  c.flowsDatarate = "20Mbps";
+  c.flowsPacketsSize = 1000;
+
+  c.startTime = 0.1; // in s
+  c.simDuration = 60;
+  c.samplingPeriod = 1;
+
+  std::string ldcTargetDelay = "20ms";
+  double ldcTargetRatio = 0.95;
+  double ldcWq = 0.75;
+  uint32_t ldcExponent = 3;
+  std::string ldcInterval = "2ms";
+  bool ldcAdaptive = false;
+  bool ldcFixedPoint = false;
+  uint32_t dequeueBatchSize = 1;
+
+  bool batch = false;
+  std::string flowsList = "1,2,4,8,16";
+  std::string bandwidthList = "10Mbps,100Mbps";
+  std::string csvFile = "queue-discs-benchmark.csv";
+
+  CommandLine cmd;
+  cmd.AddValue ("bandwidth", "Bottleneck bandwidth", c.bandwidth);
+  cmd.AddValue ("delay", "Bottleneck delay", c.delay);
+  cmd.AddValue ("queueDiscType", "Bottleneck queue disc type in {PfifoFast, ARED, CoDel, FqCoDel, PIE, LDC, FqLDC}", c.queueDiscType);
+  cmd.AddValue ("queueDiscSize", "Bottleneck queue disc size in packets", c.queueDiscSize);
+  cmd.AddValue ("netdevicesQueueSize", "Bottleneck netdevices queue size in packets", c.netdevicesQueueSize);
+  cmd.AddValue ("bql", "Enable byte queue limits on bottleneck netdevices", c.bql);
+  cmd.AddValue ("nFlows", "Number of upload flows (and of download flows)", c.nFlows);
+  cmd.AddValue ("flowsDatarate", "Upload and download flows datarate", c.flowsDatarate);
+  cmd.AddValue ("flowsPacketsSize", "Upload and download flows packets sizes", c.flowsPacketsSize);
+  cmd.AddValue ("startTime", "Simulation start time", c.startTime);
+  cmd.AddValue ("simDuration", "Simulation duration in seconds", c.simDuration);
+  cmd.AddValue ("samplingPeriod", "Goodput sampling period in seconds", c.samplingPeriod);
+  cmd.AddValue ("ldcTargetDelay", "LDC target queueing delay", ldcTargetDelay);
+  cmd.AddValue ("ldcTargetRatio", "LDC target load factor ratio", ldcTargetRatio);
+  cmd.AddValue ("ldcWq", "LDC weight for the delay component of the drop probability", ldcWq);
+  cmd.AddValue ("ldcExponent", "LDC exponent used in the drop probability", ldcExponent);
+  cmd.AddValue ("ldcInterval", "LDC time interval", ldcInterval);
+  cmd.AddValue ("ldcAdaptive", "Adapt the LDC weights and target to the measured delay", ldcAdaptive);
+  cmd.AddValue ("ldcFixedPoint", "Run the LDC control law in fixed point arithmetic", ldcFixedPoint);
+  cmd.AddValue ("dequeueBatchSize", "Maximum number of packets passed at once by the queue discs to the devices", dequeueBatchSize);
+  cmd.AddValue ("batch", "Run every combination of flowsList and bandwidthList and write a CSV file", batch);
+  cmd.AddValue ("flowsList", "Comma separated numbers of flows for the batch mode", flowsList);
+  cmd.AddValue ("bandwidthList", "Comma separated bottleneck bandwidths for the batch mode", bandwidthList);
+  cmd.AddValue ("csvFile", "Output file of the batch mode", csvFile);
+  cmd.Parse (argc, argv);
+
+  Config::SetDefault ("ns3::LdcQueueDisc::TargetQueueingDelay", StringValue (ldcTargetDelay));
+  Config::SetDefault ("ns3::LdcQueueDisc::TargetLoadFactorRatio", DoubleValue (ldcTargetRatio));
+  Config::SetDefault ("ns3::LdcQueueDisc::WQ", DoubleValue (ldcWq));
+  Config::SetDefault ("ns3::LdcQueueDisc::LdcExponent", UintegerValue (ldcExponent));
+  Config::SetDefault ("ns3::LdcQueueDisc::TimeInterval", StringValue (ldcInterval));
+  Config::SetDefault ("ns3::LdcQueueDisc::Adaptive", BooleanValue (ldcAdaptive));
+  Config::SetDefault ("ns3::LdcQueueDisc::FixedPoint", BooleanValue (ldcFixedPoint));
+  Config::SetDefault ("ns3::FqLdcQueueDisc::TargetQueueingDelay", StringValue (ldcTargetDelay));
+  Config::SetDefault ("ns3::FqLdcQueueDisc::TargetLoadFactorRatio", DoubleValue (ldcTargetRatio));
+  Config::SetDefault ("ns3::FqLdcQueueDisc::WQ", DoubleValue (ldcWq));
+  Config::SetDefault ("ns3::FqLdcQueueDisc::LdcExponent", UintegerValue (ldcExponent));
+  Config::SetDefault ("ns3::FqLdcQueueDisc::TimeInterval", StringValue (ldcInterval));
+  Config::SetDefault ("ns3::QueueDisc::BatchSize", UintegerValue (dequeueBatchSize));
+
+  if (!batch)
+    {
+      c.traces = true;
+      RunBenchmark (c);
+      return 0;
+    }
+
+  c.traces = false;
+  std::ofstream csv (csvFile.c_str ());
+  csv << "queueDiscType,bandwidth,flows,goodputMbps,meanSojournMs,p99SojournMs,drops,wallSecPerSimSec" << std::endl;
+
+  std::vector<std::string> bandwidths = SplitList (bandwidthList);
+  std::vector<std::string> flows = SplitList (flowsList);
+  for (std::vector<std::string>::const_iterator bw = bandwidths.begin (); bw != bandwidths.end (); bw++)
+    {
+      for (std::vector<std::string>::const_iterator nf = flows.begin (); nf != flows.end (); nf++)
+        {
+          c.bandwidth = *bw;
+          c.nFlows = std::atoi (nf->c_str ());
+          // the addresses assigned in the previous run are still marked as allocated
+          Ipv4AddressGenerator::Reset ();
+
+          BenchmarkResult r = RunBenchmark (c);
+          csv << c.queueDiscType << "," << c.bandwidth << "," << c.nFlows << ","
+              << r.goodput / 1e6 << "," << r.meanSojourn * 1e3 << "," << r.p99Sojourn * 1e3 << ","
+              << r.drops << "," << r.wallPerSimSec << std::endl;
+          NS_LOG_INFO ("bandwidth " << c.bandwidth << " flows " << c.nFlows << " done");
+        }
+    }
+  csv.close ();
+
   return 0;
 }
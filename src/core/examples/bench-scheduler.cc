@@ -0,0 +1,132 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "ns3/core-module.h"
+
+/**
+ * \file
+ * \ingroup scheduler
+ * Benchmark of the schedulers with the hold model.
+ *
+ * The schedulers are exercised directly, without the simulator and the
+ * events: the queue is filled with \c pop events, then each hold operation
+ * removes the next event and inserts a new one at its time plus an
+ * exponential increment, and the queue is finally drained. The increments
+ * are drawn before the measurements. The program prints the mean time of
+ * an Insert while filling the queue, of a hold operation, and of a
+ * RemoveNext while draining the queue.
+ *
+ *     ./waf --run "bench-scheduler --pop=5000000 --ops=10000000"
+ */
+
+using namespace ns3;
+
+/**
+ * Run the hold model on a scheduler.
+ * \param [in] type The TypeId name of the scheduler.
+ * \param [in] pop The number of pending events.
+ * \param [in] ops The number of hold operations.
+ * \param [in] increments The time increments.
+ */
+static void
+Hold (std::string type, uint32_t pop, uint32_t ops, const std::vector<uint64_t> &increments)
+{
+  ObjectFactory factory (type);
+  Ptr<Scheduler> scheduler = factory.Create<Scheduler> ();
+  SystemWallClockMs clock;
+  uint32_t uid = 0;
+  uint32_t n = increments.size ();
+
+  Scheduler::Event ev;
+  ev.impl = 0;
+  ev.key.m_context = 0;
+
+  clock.Start ();
+  for (uint32_t i = 0; i < pop; i++)
+    {
+      ev.key.m_ts = increments[uid % n];
+      ev.key.m_uid = uid++;
+      scheduler->Insert (ev);
+    }
+  double fill = clock.End ();
+
+  clock.Start ();
+  for (uint32_t i = 0; i < ops; i++)
+    {
+      Scheduler::Event next = scheduler->RemoveNext ();
+      ev.key.m_ts = next.key.m_ts + increments[uid % n];
+      ev.key.m_uid = uid++;
+      scheduler->Insert (ev);
+    }
+  double hold = clock.End ();
+
+  clock.Start ();
+  while (!scheduler->IsEmpty ())
+    {
+      scheduler->RemoveNext ();
+    }
+  double drain = clock.End ();
+
+  std::cout << std::left << std::setw (28) << type
+            << std::right << std::setw (16) << fill * 1e6 / pop
+            << std::setw (16) << hold * 1e6 / ops
+            << std::setw (16) << drain * 1e6 / pop << std::endl;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t pop = 1000000;
+  uint32_t ops = 10000000;
+  double mean = 100;
+  std::string types = "ns3::HeapScheduler,ns3::DaryHeapScheduler<2>,"
+    "ns3::DaryHeapScheduler<4>,ns3::MapScheduler";
+
+  CommandLine cmd;
+  cmd.AddValue ("pop",   "number of pending events", pop);
+  cmd.AddValue ("ops",   "number of hold operations", ops);
+  cmd.AddValue ("mean",  "mean time increment, in ns", mean);
+  cmd.AddValue ("types", "comma separated list of scheduler TypeIds", types);
+  cmd.Parse (argc, argv);
+
+  Ptr<ExponentialRandomVariable> erv = CreateObject<ExponentialRandomVariable> ();
+  erv->SetAttribute ("Mean", DoubleValue (mean));
+  std::vector<uint64_t> increments (1 << 20);
+  for (uint32_t i = 0; i < increments.size (); i++)
+    {
+      increments[i] = (uint64_t) erv->GetValue ();
+    }
+
+  std::cout << "population: " << pop << ", hold operations: " << ops << std::endl;
+  std::cout << std::left << std::setw (28) << "scheduler"
+            << std::right << std::setw (16) << "Insert (ns)"
+            << std::setw (16) << "Hold (ns)"
+            << std::setw (16) << "RemoveNext (ns)" << std::endl;
+
+  std::istringstream iss (types);
+  std::string type;
+  while (std::getline (iss, type, ','))
+    {
+      Hold (type, pop, ops, increments);
+    }
+
+  return 0;
+}
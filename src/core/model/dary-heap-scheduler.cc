@@ -0,0 +1,282 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "dary-heap-scheduler.h"
+#include "event-impl.h"
+#include "assert.h"
+#include "log.h"
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * Implementation of ns3::DaryHeapScheduler class template.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("DaryHeapScheduler");
+
+/** The binary variant. */
+typedef DaryHeapScheduler<2> DaryHeapScheduler2;
+/** The 4-ary variant. */
+typedef DaryHeapScheduler<4> DaryHeapScheduler4;
+
+NS_OBJECT_ENSURE_REGISTERED (DaryHeapScheduler2);
+NS_OBJECT_ENSURE_REGISTERED (DaryHeapScheduler4);
+
+template <uint32_t D>
+const uint32_t DaryHeapScheduler<D>::CACHE_LINE;
+
+
+template <uint32_t D>
+TypeId
+DaryHeapScheduler<D>::GetTypeId (void)
+{
+  std::ostringstream oss;
+  oss << "ns3::DaryHeapScheduler<" << D << ">";
+  static TypeId tid = TypeId (oss.str ().c_str ())
+    .SetParent<Scheduler> ()
+    .SetGroupName ("Core")
+    .AddConstructor<DaryHeapScheduler<D> > ()
+  ;
+  return tid;
+}
+
+template <uint32_t D>
+DaryHeapScheduler<D>::DaryHeapScheduler ()
+  : m_buffer (0),
+    m_keys (0),
+    m_size (0),
+    m_capacity (0)
+{
+  NS_LOG_FUNCTION (this);
+  Grow (64);
+}
+
+template <uint32_t D>
+DaryHeapScheduler<D>::~DaryHeapScheduler ()
+{
+  NS_LOG_FUNCTION (this);
+  delete [] m_buffer;
+  m_buffer = 0;
+  m_keys = 0;
+}
+
+template <uint32_t D>
+bool
+DaryHeapScheduler<D>::Less (const Key &a, const Key &b)
+{
+  return a.ts < b.ts || (a.ts == b.ts && a.uid < b.uid);
+}
+
+template <uint32_t D>
+void
+DaryHeapScheduler<D>::Grow (uint32_t capacity)
+{
+  NS_LOG_FUNCTION (this << capacity);
+  // The children of node i start at index D * i + 1, hence key 1 is
+  // aligned on a cache line.
+  char *buffer = new char [capacity * sizeof (Key) + 2 * CACHE_LINE];
+  uintptr_t aligned = ((uintptr_t) buffer + CACHE_LINE - 1) & ~((uintptr_t) CACHE_LINE - 1);
+  Key *keys = (Key *) (aligned + CACHE_LINE - sizeof (Key));
+  if (m_size > 0)
+    {
+      std::memcpy (keys, m_keys, m_size * sizeof (Key));
+    }
+  delete [] m_buffer;
+  m_buffer = buffer;
+  m_keys = keys;
+  m_capacity = capacity;
+}
+
+template <uint32_t D>
+void
+DaryHeapScheduler<D>::SiftUp (uint32_t hole, Key key)
+{
+  while (hole > 0)
+    {
+      uint32_t parent = (hole - 1) / D;
+      if (!Less (key, m_keys[parent]))
+        {
+          break;
+        }
+      m_keys[hole] = m_keys[parent];
+      hole = parent;
+    }
+  m_keys[hole] = key;
+}
+
+template <uint32_t D>
+void
+DaryHeapScheduler<D>::SiftDown (uint32_t hole, Key key)
+{
+  while (true)
+    {
+      uint32_t first = D * hole + 1;
+      if (first >= m_size)
+        {
+          break;
+        }
+      uint32_t last = std::min (first + D, m_size);
+#ifdef __GNUC__
+      // The grandchildren are adjacent: fetch them while the children
+      // are compared, since one of them is the next level.
+      uint32_t grandchildren = D * first + 1;
+      if (grandchildren < m_size)
+        {
+          for (uint32_t i = 0; i < D * D * sizeof (Key); i += CACHE_LINE)
+            {
+              __builtin_prefetch ((char *) &m_keys[grandchildren] + i);
+            }
+        }
+#endif /* __GNUC__ */
+      uint32_t smallest = first;
+      for (uint32_t child = first + 1; child < last; child++)
+        {
+          if (Less (m_keys[child], m_keys[smallest]))
+            {
+              smallest = child;
+            }
+        }
+      if (!Less (m_keys[smallest], key))
+        {
+          break;
+        }
+      m_keys[hole] = m_keys[smallest];
+      hole = smallest;
+    }
+  m_keys[hole] = key;
+}
+
+template <uint32_t D>
+Scheduler::Event
+DaryHeapScheduler<D>::Release (const Key &key)
+{
+  const Slot &slot = m_slots[key.slot];
+  Event ev;
+  ev.impl = slot.impl;
+  ev.key.m_ts = key.ts;
+  ev.key.m_uid = key.uid;
+  ev.key.m_context = slot.context;
+  m_freeSlots.push_back (key.slot);
+  return ev;
+}
+
+template <uint32_t D>
+void
+DaryHeapScheduler<D>::Insert (const Event &ev)
+{
+  NS_LOG_FUNCTION (this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+  if (m_size == m_capacity)
+    {
+      Grow (2 * m_capacity);
+    }
+  Key key;
+  key.ts = ev.key.m_ts;
+  key.uid = ev.key.m_uid;
+  if (m_freeSlots.empty ())
+    {
+      key.slot = m_slots.size ();
+      m_slots.push_back (Slot ());
+    }
+  else
+    {
+      key.slot = m_freeSlots.back ();
+      m_freeSlots.pop_back ();
+    }
+  m_slots[key.slot].impl = ev.impl;
+  m_slots[key.slot].context = ev.key.m_context;
+  m_size++;
+  SiftUp (m_size - 1, key);
+}
+
+template <uint32_t D>
+bool
+DaryHeapScheduler<D>::IsEmpty (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_size == 0;
+}
+
+template <uint32_t D>
+Scheduler::Event
+DaryHeapScheduler<D>::PeekNext (void) const
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (!IsEmpty ());
+  const Slot &slot = m_slots[m_keys[0].slot];
+  Event ev;
+  ev.impl = slot.impl;
+  ev.key.m_ts = m_keys[0].ts;
+  ev.key.m_uid = m_keys[0].uid;
+  ev.key.m_context = slot.context;
+  return ev;
+}
+
+template <uint32_t D>
+Scheduler::Event
+DaryHeapScheduler<D>::RemoveNext (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (!IsEmpty ());
+  Event next = Release (m_keys[0]);
+  m_size--;
+  if (m_size > 0)
+    {
+      SiftDown (0, m_keys[m_size]);
+    }
+  return next;
+}
+
+template <uint32_t D>
+void
+DaryHeapScheduler<D>::Remove (const Event &ev)
+{
+  NS_LOG_FUNCTION (this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+  uint32_t uid = ev.key.m_uid;
+  for (uint32_t i = 0; i < m_size; i++)
+    {
+      if (uid == m_keys[i].uid)
+        {
+          NS_ASSERT (m_slots[m_keys[i].slot].impl == ev.impl);
+          Release (m_keys[i]);
+          m_size--;
+          if (i == m_size)
+            {
+              return;
+            }
+          Key key = m_keys[m_size];
+          if (i > 0 && Less (key, m_keys[(i - 1) / D]))
+            {
+              SiftUp (i, key);
+            }
+          else
+            {
+              SiftDown (i, key);
+            }
+          return;
+        }
+    }
+  NS_ASSERT (false);
+}
+
+template class DaryHeapScheduler<2>;
+template class DaryHeapScheduler<4>;
+
+} // namespace ns3
@@ -19,7 +19,13 @@
  */
 
 #include "event-impl.h"
+#include "system-mutex.h"
 #include "log.h"
+#include "ns3/core-config.h"
+#include <new>
+#ifdef HAVE_PTHREAD_H
+#include <pthread.h>
+#endif /* HAVE_PTHREAD_H */
 
 /**
  * \file
@@ -31,6 +37,144 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("EventImpl");
 
+namespace {
+
+/** Granularity of the event size classes, in bytes. */
+const uint32_t GRANULE = 16;
+/** Number of event size classes. */
+const uint32_t N_CLASSES = 16;
+/** Number of events moved at once between a cache and the depot. */
+const uint32_t BATCH = 128;
+/** Maximum number of free events per size class in a cache. */
+const uint32_t CACHE_SIZE = 2 * BATCH;
+
+/** A free event. */
+struct FreeBlock
+{
+  FreeBlock *next;  //!< The next free event
+};
+
+/** A list of free events of the same size class. */
+struct FreeList
+{
+  FreeBlock *head;  //!< The first free event
+  uint32_t n;       //!< The number of free events
+};
+
+/** The free events owned by a thread. */
+struct ThreadCache
+{
+  FreeList lists[N_CLASSES];  //!< The freelists, by size class
+};
+
+/** The free events shared by the threads. */
+struct Depot
+{
+  FreeList lists[N_CLASSES];  //!< The freelists, by size class
+  uint64_t nAllocations;      //!< The number of calls to the global allocator
+  SystemMutex mutex;          //!< Protects the depot
+};
+
+/**
+ * Get the depot, which is never destroyed, so that events can still be
+ * deleted by the static destructors.
+ * \returns The depot.
+ */
+Depot *
+GetDepot (void)
+{
+  static Depot *depot = new Depot ();
+  return depot;
+}
+
+/**
+ * Move free events from the front of a list to another list.
+ * \param [in,out] from The list to take the events from.
+ * \param [in,out] to The list to add the events to.
+ * \param [in] n The maximum number of events to move.
+ */
+void
+Splice (FreeList &from, FreeList &to, uint32_t n)
+{
+  while (n > 0 && from.head != 0)
+    {
+      FreeBlock *block = from.head;
+      from.head = block->next;
+      from.n--;
+      block->next = to.head;
+      to.head = block;
+      to.n++;
+      n--;
+    }
+}
+
+#ifdef HAVE_PTHREAD_H
+
+/** The key of the cache of each thread. */
+pthread_key_t g_cacheKey;
+/** Creates g_cacheKey once. */
+pthread_once_t g_cacheKeyOnce = PTHREAD_ONCE_INIT;
+
+/**
+ * Give the free events of a terminating thread to the depot.
+ * \param [in] p The cache of the thread.
+ */
+void
+ReleaseCache (void *p)
+{
+  ThreadCache *cache = static_cast<ThreadCache *> (p);
+  Depot *depot = GetDepot ();
+  {
+    CriticalSection critical (depot->mutex);
+    for (uint32_t i = 0; i < N_CLASSES; i++)
+      {
+        Splice (cache->lists[i], depot->lists[i], cache->lists[i].n);
+      }
+  }
+  delete cache;
+}
+
+/** Create g_cacheKey. */
+void
+CreateCacheKey (void)
+{
+  pthread_key_create (&g_cacheKey, &ReleaseCache);
+}
+
+/**
+ * Get the cache of the calling thread.
+ * \returns The cache.
+ */
+ThreadCache *
+GetCache (void)
+{
+  pthread_once (&g_cacheKeyOnce, &CreateCacheKey);
+  ThreadCache *cache = static_cast<ThreadCache *> (pthread_getspecific (g_cacheKey));
+  if (cache == 0)
+    {
+      cache = new ThreadCache ();
+      pthread_setspecific (g_cacheKey, cache);
+    }
+  return cache;
+}
+
+#else /* HAVE_PTHREAD_H */
+
+/**
+ * Get the cache of the calling thread.
+ * \returns The cache.
+ */
+ThreadCache *
+GetCache (void)
+{
+  static ThreadCache *cache = new ThreadCache ();
+  return cache;
+}
+
+#endif /* HAVE_PTHREAD_H */
+
+} // unnamed namespace
+
 EventImpl::~EventImpl ()
 {
   NS_LOG_FUNCTION (this);
@@ -66,4 +210,71 @@ EventImpl::IsCancelled (void)
   return m_cancel;
 }
 
+void *
+EventImpl::operator new (std::size_t size)
+{
+  uint32_t sizeClass = (size - 1) / GRANULE;
+  if (sizeClass >= N_CLASSES)
+    {
+      Depot *depot = GetDepot ();
+      {
+        CriticalSection critical (depot->mutex);
+        depot->nAllocations++;
+      }
+      return ::operator new (size);
+    }
+
+  FreeList &list = GetCache ()->lists[sizeClass];
+  if (list.head == 0)
+    {
+      Depot *depot = GetDepot ();
+      CriticalSection critical (depot->mutex);
+      Splice (depot->lists[sizeClass], list, BATCH);
+      if (list.head == 0)
+        {
+          depot->nAllocations++;
+          return ::operator new ((sizeClass + 1) * GRANULE);
+        }
+    }
+  FreeBlock *block = list.head;
+  list.head = block->next;
+  list.n--;
+  return block;
+}
+
+void
+EventImpl::operator delete (void *p, std::size_t size)
+{
+  if (p == 0)
+    {
+      return;
+    }
+  uint32_t sizeClass = (size - 1) / GRANULE;
+  if (sizeClass >= N_CLASSES)
+    {
+      ::operator delete (p);
+      return;
+    }
+
+  FreeList &list = GetCache ()->lists[sizeClass];
+  FreeBlock *block = static_cast<FreeBlock *> (p);
+  block->next = list.head;
+  list.head = block;
+  list.n++;
+  if (list.n > CACHE_SIZE)
+    {
+      Depot *depot = GetDepot ();
+      CriticalSection critical (depot->mutex);
+      Splice (list, depot->lists[sizeClass], BATCH);
+    }
+}
+
+uint64_t
+EventImpl::GetNAllocations (void)
+{
+  Depot *depot = GetDepot ();
+  CriticalSection critical (depot->mutex);
+  return depot->nAllocations;
+}
+
 } // namespace ns3
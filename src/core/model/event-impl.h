@@ -21,6 +21,7 @@
 #define EVENT_IMPL_H
 
 #include <stdint.h>
+#include <cstddef>
 #include "simple-ref-count.h"
 
 /**
@@ -40,6 +41,16 @@ namespace ns3 {
  * when it reaches the time associated to this event. Most subclasses
  * are usually created by one of the many Simulator::Schedule
  * methods.
+ *
+ * The memory of the events is recycled through freelists, one per
+ * 16 byte size class up to 256 bytes, so that scheduling an event
+ * does not call the global allocator in steady state. Each thread owns
+ * a cache of free events, hence events are created and deleted without
+ * locking. Batches of free events go through a shared depot, protected
+ * by a mutex, when a cache runs empty or grows too large: this is the
+ * case of the events created by a thread calling
+ * Simulator::ScheduleWithContext and deleted by the simulator thread.
+ * The memory of the free events is never returned to the global allocator.
  */
 class EventImpl : public SimpleRefCount<EventImpl>
 {
@@ -66,6 +77,26 @@ public:
    */
   bool IsCancelled (void);
 
+  /**
+   * Allocate the memory of an event from the freelist of its size class.
+   * \param [in] size The size of the event.
+   * \returns The memory of the event.
+   */
+  static void * operator new (std::size_t size);
+  /**
+   * Return the memory of an event to the freelist of its size class.
+   * \param [in] p The memory of the event.
+   * \param [in] size The size of the event.
+   */
+  static void operator delete (void *p, std::size_t size);
+  /**
+   * Get the number of times the global allocator was called to create
+   * events, that is when the freelists were empty or the events were too
+   * large for the freelists.
+   * \returns The number of calls to the global allocator.
+   */
+  static uint64_t GetNAllocations (void);
+
 protected:
   /**
    * Implementation for Invoke().
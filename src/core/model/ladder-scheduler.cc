@@ -0,0 +1,293 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ladder-scheduler.h"
+#include "event-impl.h"
+#include "assert.h"
+#include "log.h"
+#include <algorithm>
+#include <limits>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * Implementation of ns3::LadderScheduler class.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LadderScheduler");
+
+NS_OBJECT_ENSURE_REGISTERED (LadderScheduler);
+
+const uint32_t LadderScheduler::MAX_RUNGS;
+const uint32_t LadderScheduler::THRESHOLD;
+const uint32_t LadderScheduler::MAX_BUCKETS;
+
+namespace {
+
+/**
+ * \ingroup scheduler
+ * Order the events by decreasing key, so that the bottom of the ladder
+ * can be consumed from its end.
+ * \param [in] a The first event.
+ * \param [in] b The second event.
+ * \returns \c true if \p a comes after \p b.
+ */
+bool
+LaterEvent (const Scheduler::Event &a, const Scheduler::Event &b)
+{
+  return b < a;
+}
+
+} // unnamed namespace
+
+TypeId
+LadderScheduler::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::LadderScheduler")
+    .SetParent<Scheduler> ()
+    .SetGroupName ("Core")
+    .AddConstructor<LadderScheduler> ()
+  ;
+  return tid;
+}
+
+LadderScheduler::LadderScheduler ()
+  : m_topStart (0),
+    m_topMin (std::numeric_limits<uint64_t>::max ()),
+    m_topMax (0),
+    m_rungs (MAX_RUNGS),
+    m_nRungs (0),
+    m_size (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+LadderScheduler::~LadderScheduler ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+bool
+LadderScheduler::FindBucket (uint64_t ts, Bucket **bucket)
+{
+  // The rungs cover decreasing time ranges: an event belongs to the
+  // first rung whose buckets left to consume start before it.
+  for (uint32_t i = 0; i < m_nRungs; i++)
+    {
+      Rung &rung = m_rungs[i];
+      if (ts >= rung.start + rung.current * rung.width)
+        {
+          uint64_t index = (ts - rung.start) / rung.width;
+          NS_ASSERT (index < rung.nBuckets);
+          *bucket = &rung.buckets[index];
+          return true;
+        }
+    }
+  return false;
+}
+
+void
+LadderScheduler::Insert (const Event &ev)
+{
+  NS_LOG_FUNCTION (this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+  uint64_t ts = ev.key.m_ts;
+  m_size++;
+  if (ts >= m_topStart)
+    {
+      m_top.push_back (ev);
+      m_topMin = std::min (m_topMin, ts);
+      m_topMax = std::max (m_topMax, ts);
+      return;
+    }
+  Bucket *bucket;
+  if (FindBucket (ts, &bucket))
+    {
+      bucket->push_back (ev);
+      return;
+    }
+  Bucket::iterator pos = std::upper_bound (m_bottom.begin (), m_bottom.end (), ev, &LaterEvent);
+  m_bottom.insert (pos, ev);
+}
+
+bool
+LadderScheduler::IsEmpty (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_size == 0;
+}
+
+void
+LadderScheduler::SpawnRung (const Bucket &events, uint64_t start, uint64_t range)
+{
+  NS_LOG_FUNCTION (this << events.size () << start << range);
+  NS_ASSERT (m_nRungs < MAX_RUNGS);
+  Rung &rung = m_rungs[m_nRungs++];
+  rung.nBuckets = std::min<uint32_t> (events.size (), MAX_BUCKETS);
+  rung.width = (range + rung.nBuckets - 1) / rung.nBuckets;
+  rung.start = start;
+  rung.current = 0;
+  if (rung.buckets.size () < rung.nBuckets)
+    {
+      rung.buckets.resize (rung.nBuckets);
+    }
+  for (Bucket::const_iterator i = events.begin (); i != events.end (); ++i)
+    {
+      uint64_t index = (i->key.m_ts - start) / rung.width;
+      NS_ASSERT (index < rung.nBuckets);
+      rung.buckets[index].push_back (*i);
+    }
+}
+
+void
+LadderScheduler::FillBottom (const Bucket &events)
+{
+  NS_LOG_FUNCTION (this << events.size ());
+  NS_ASSERT (m_bottom.empty ());
+  m_bottom.assign (events.begin (), events.end ());
+  std::sort (m_bottom.begin (), m_bottom.end (), &LaterEvent);
+}
+
+void
+LadderScheduler::Refill (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (m_bottom.empty () && m_size > 0);
+  while (true)
+    {
+      if (m_nRungs == 0)
+        {
+          // Start a new epoch with the events of the top. Later events
+          // beyond their range are inserted in the top again.
+          NS_ASSERT (!m_top.empty ());
+          uint64_t range = m_topMax - m_topMin + 1;
+          m_topStart = m_topMax + 1;
+          if (m_top.size () > THRESHOLD && range > 1)
+            {
+              SpawnRung (m_top, m_topMin, range);
+            }
+          else
+            {
+              FillBottom (m_top);
+            }
+          m_top.clear ();
+          m_topMin = std::numeric_limits<uint64_t>::max ();
+          m_topMax = 0;
+          if (!m_bottom.empty ())
+            {
+              return;
+            }
+        }
+
+      Rung &rung = m_rungs[m_nRungs - 1];
+      while (rung.current < rung.nBuckets && rung.buckets[rung.current].empty ())
+        {
+          rung.current++;
+        }
+      if (rung.current == rung.nBuckets)
+        {
+          m_nRungs--;
+          continue;
+        }
+
+      Bucket &bucket = rung.buckets[rung.current];
+      uint64_t start = rung.start + rung.current * rung.width;
+      rung.current++;
+      // m_rungs never reallocates, so that the bucket stays valid while
+      // it is spread over the next rung.
+      if (bucket.size () > THRESHOLD && rung.width > 1 && m_nRungs < MAX_RUNGS)
+        {
+          SpawnRung (bucket, start, rung.width);
+          bucket.clear ();
+          continue;
+        }
+      FillBottom (bucket);
+      bucket.clear ();
+      return;
+    }
+}
+
+Scheduler::Event
+LadderScheduler::PeekNext (void) const
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (!IsEmpty ());
+  if (m_bottom.empty ())
+    {
+      const_cast<LadderScheduler *> (this)->Refill ();
+    }
+  return m_bottom.back ();
+}
+
+Scheduler::Event
+LadderScheduler::RemoveNext (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (!IsEmpty ());
+  if (m_bottom.empty ())
+    {
+      Refill ();
+    }
+  Event ev = m_bottom.back ();
+  m_bottom.pop_back ();
+  m_size--;
+  if (m_size == 0)
+    {
+      // The rungs are empty: the next epoch starts from the top.
+      m_nRungs = 0;
+      m_topStart = 0;
+    }
+  NS_LOG_DEBUG ("remove " << ev.impl << " " << ev.key.m_ts << " " << ev.key.m_uid);
+  return ev;
+}
+
+void
+LadderScheduler::Remove (const Event &ev)
+{
+  NS_LOG_FUNCTION (this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+  NS_ASSERT (!IsEmpty ());
+  uint64_t ts = ev.key.m_ts;
+  Bucket *bucket;
+  if (ts >= m_topStart)
+    {
+      bucket = &m_top;
+    }
+  else if (!FindBucket (ts, &bucket))
+    {
+      Bucket::iterator pos = std::lower_bound (m_bottom.begin (), m_bottom.end (), ev, &LaterEvent);
+      NS_ASSERT (pos != m_bottom.end () && pos->key.m_uid == ev.key.m_uid);
+      NS_ASSERT (pos->impl == ev.impl);
+      m_bottom.erase (pos);
+      m_size--;
+      return;
+    }
+  // The top and the buckets are not sorted.
+  for (Bucket::iterator i = bucket->begin (); i != bucket->end (); ++i)
+    {
+      if (i->key.m_uid == ev.key.m_uid)
+        {
+          NS_ASSERT (ev.impl == i->impl);
+          *i = bucket->back ();
+          bucket->pop_back ();
+          m_size--;
+          return;
+        }
+    }
+  NS_ASSERT (false);
+}
+
+} // namespace ns3
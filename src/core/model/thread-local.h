@@ -0,0 +1,48 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef NS3_THREAD_LOCAL_H
+#define NS3_THREAD_LOCAL_H
+
+/**
+ * \file
+ * \ingroup core
+ * Definition of the NS_THREAD_LOCAL macro.
+ */
+
+/**
+ * \ingroup core
+ * \def NS_THREAD_LOCAL
+ * Declare a variable with one instance per thread, which is cheap to
+ * access from the library that defines it.
+ *
+ * The variables of a shared library are accessed through a call to
+ * __tls_get_addr by default, because the library could be loaded with
+ * dlopen. The ns-3 libraries are linked to the programs, hence the
+ * initial-exec model can be used: the variable is then at a constant
+ * offset from the thread pointer, as in a sequential program.
+ *
+ * The macro must be used on both the declaration and the definition.
+ */
+
+#if defined(__GNUC__) || defined(__clang__)
+#define NS_THREAD_LOCAL thread_local __attribute__ ((tls_model ("initial-exec")))
+#else
+#define NS_THREAD_LOCAL thread_local
+#endif
+
+#endif /* NS3_THREAD_LOCAL_H */
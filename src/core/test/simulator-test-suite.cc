@@ -19,10 +19,13 @@
  */
 #include "ns3/test.h"
 #include "ns3/simulator.h"
+#include "ns3/event-impl.h"
 #include "ns3/list-scheduler.h"
 #include "ns3/heap-scheduler.h"
 #include "ns3/map-scheduler.h"
 #include "ns3/calendar-scheduler.h"
+#include "ns3/ladder-scheduler.h"
+#include "ns3/dary-heap-scheduler.h"
 
 using namespace ns3;
 
@@ -459,6 +462,59 @@ SimulatorTemplateTestCase::DoRun (void)
   Simulator::Destroy ();
 }
 
+class SimulatorEventPoolTestCase : public TestCase
+{
+public:
+  SimulatorEventPoolTestCase ();
+  virtual void DoRun (void);
+  void Reschedule (uint32_t n);
+  void RescheduleLarge (uint32_t n, std::string a, std::string b, std::string c);
+};
+
+SimulatorEventPoolTestCase::SimulatorEventPoolTestCase ()
+  : TestCase ("Check that the events are recycled in steady state")
+{
+}
+void
+SimulatorEventPoolTestCase::Reschedule (uint32_t n)
+{
+  if (n > 0)
+    {
+      Simulator::Schedule (MicroSeconds (1), &SimulatorEventPoolTestCase::Reschedule, this, n - 1);
+    }
+}
+void
+SimulatorEventPoolTestCase::RescheduleLarge (uint32_t n, std::string a, std::string b, std::string c)
+{
+  if (n > 0)
+    {
+      Simulator::Schedule (MicroSeconds (1), &SimulatorEventPoolTestCase::RescheduleLarge, this, n - 1, a, b, c);
+    }
+}
+void
+SimulatorEventPoolTestCase::DoRun (void)
+{
+  // the first run fills the freelists
+  for (uint32_t i = 0; i < 100; i++)
+    {
+      Simulator::Schedule (MicroSeconds (i), &SimulatorEventPoolTestCase::Reschedule, this, 1000);
+      Simulator::Schedule (MicroSeconds (i), &SimulatorEventPoolTestCase::RescheduleLarge, this, 1000, "a", "b", "c");
+    }
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  uint64_t nAllocations = EventImpl::GetNAllocations ();
+  for (uint32_t i = 0; i < 100; i++)
+    {
+      Simulator::Schedule (MicroSeconds (i), &SimulatorEventPoolTestCase::Reschedule, this, 1000);
+      Simulator::Schedule (MicroSeconds (i), &SimulatorEventPoolTestCase::RescheduleLarge, this, 1000, "a", "b", "c");
+    }
+  Simulator::Run ();
+  Simulator::Destroy ();
+  NS_TEST_EXPECT_MSG_EQ (EventImpl::GetNAllocations (), nAllocations,
+                         "The events of the second run should come from the freelists");
+}
+
 class SimulatorTestSuite : public TestSuite
 {
 public:
@@ -475,5 +531,12 @@ public:
     AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
     factory.SetTypeId (CalendarScheduler::GetTypeId ());
     AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (LadderScheduler::GetTypeId ());
+    AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (DaryHeapScheduler<2>::GetTypeId ());
+    AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (DaryHeapScheduler<4>::GetTypeId ());
+    AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
+    AddTestCase (new SimulatorEventPoolTestCase (), TestCase::QUICK);
   }
 } g_simulatorTestSuite;
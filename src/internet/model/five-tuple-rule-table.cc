@@ -0,0 +1,310 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/log.h"
+#include "ns3/assert.h"
+#include "ns3/abort.h"
+#include "ns3/hash.h"
+#include "five-tuple-rule-table.h"
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <limits>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("FiveTupleRuleTable");
+
+/**
+ * \brief Copy the first bits of an address, clearing the others
+ * \param address the address
+ * \param length the length of the address in bytes
+ * \param prefixLength the number of bits to copy
+ * \param buf the buffer the masked address is written to
+ */
+static void
+MaskAddress (const uint8_t *address, uint32_t length, uint8_t prefixLength, uint8_t *buf)
+{
+  for (uint32_t i = 0; i < length; i++)
+    {
+      if (prefixLength >= 8 * (i + 1))
+        {
+          buf[i] = address[i];
+        }
+      else if (prefixLength > 8 * i)
+        {
+          buf[i] = address[i] & (0xff << (8 * (i + 1) - prefixLength));
+        }
+      else
+        {
+          buf[i] = 0;
+        }
+    }
+}
+
+/**
+ * \brief Parse a protocol, port or class field of a rules file
+ * \param field the field
+ * \param max the largest valid value
+ * \param value set to the value of the field, or to ANY for "*"
+ * \return true if the field is valid
+ */
+static bool
+ParseField (std::string field, int64_t max, int32_t &value)
+{
+  if (field == "*")
+    {
+      value = FiveTupleRuleTable::ANY;
+      return true;
+    }
+  std::istringstream iss (field);
+  int64_t v;
+  if (!(iss >> v) || !iss.eof () || v < 0 || v > max)
+    {
+      return false;
+    }
+  value = v;
+  return true;
+}
+
+FiveTupleRuleTable::FiveTupleRuleTable (uint32_t addressLength)
+  : m_addressLength (addressLength),
+    m_keyLength (2 * addressLength + 5),
+    m_nRules (0)
+{
+  NS_LOG_FUNCTION (this << addressLength);
+  NS_ABORT_MSG_IF (m_keyLength > MAX_KEY_LENGTH, "Addresses longer than 16 bytes are not supported");
+}
+
+void
+FiveTupleRuleTable::MakeKey (const Shape &shape, const uint8_t *src, const uint8_t *dst,
+                             uint8_t protocol, uint16_t srcPort, uint16_t dstPort, uint8_t *key) const
+{
+  MaskAddress (src, m_addressLength, shape.srcPrefixLength, key);
+  MaskAddress (dst, m_addressLength, shape.dstPrefixLength, key + m_addressLength);
+  key += 2 * m_addressLength;
+  key[0] = shape.anyProtocol ? 0 : protocol;
+  srcPort = shape.anySrcPort ? 0 : srcPort;
+  key[1] = (srcPort >> 8) & 0xff;
+  key[2] = srcPort & 0xff;
+  dstPort = shape.anyDstPort ? 0 : dstPort;
+  key[3] = (dstPort >> 8) & 0xff;
+  key[4] = dstPort & 0xff;
+}
+
+void
+FiveTupleRuleTable::Grow (Shape &shape)
+{
+  std::vector<std::vector<Entry> > buckets (2 * shape.buckets.size ());
+  for (uint32_t i = 0; i < shape.buckets.size (); i++)
+    {
+      for (uint32_t j = 0; j < shape.buckets[i].size (); j++)
+        {
+          const Entry &entry = shape.buckets[i][j];
+          buckets[entry.hash & (buckets.size () - 1)].push_back (entry);
+        }
+    }
+  shape.buckets.swap (buckets);
+}
+
+void
+FiveTupleRuleTable::AddRule (const uint8_t *src, uint8_t srcPrefixLength,
+                             const uint8_t *dst, uint8_t dstPrefixLength,
+                             int32_t protocol, int32_t srcPort, int32_t dstPort, int32_t classId)
+{
+  NS_LOG_FUNCTION (this << (uint16_t) srcPrefixLength << (uint16_t) dstPrefixLength
+                        << protocol << srcPort << dstPort << classId);
+  NS_ABORT_MSG_IF (srcPrefixLength > 8 * m_addressLength || dstPrefixLength > 8 * m_addressLength,
+                   "Prefix longer than the addresses");
+
+  bool anyProtocol = (protocol == ANY);
+  bool anySrcPort = (srcPort == ANY);
+  bool anyDstPort = (dstPort == ANY);
+
+  uint32_t s;
+  for (s = 0; s < m_shapes.size (); s++)
+    {
+      if (m_shapes[s].srcPrefixLength == srcPrefixLength && m_shapes[s].dstPrefixLength == dstPrefixLength
+          && m_shapes[s].anyProtocol == anyProtocol && m_shapes[s].anySrcPort == anySrcPort
+          && m_shapes[s].anyDstPort == anyDstPort)
+        {
+          break;
+        }
+    }
+  if (s == m_shapes.size ())
+    {
+      NS_LOG_DEBUG ("New shape " << s << " for rule " << m_nRules);
+      Shape shape;
+      shape.srcPrefixLength = srcPrefixLength;
+      shape.dstPrefixLength = dstPrefixLength;
+      shape.anyProtocol = anyProtocol;
+      shape.anySrcPort = anySrcPort;
+      shape.anyDstPort = anyDstPort;
+      shape.firstIndex = m_nRules;
+      shape.nEntries = 0;
+      shape.buckets.resize (16);
+      m_shapes.push_back (shape);
+    }
+  Shape &shape = m_shapes[s];
+
+  Entry entry;
+  entry.index = m_nRules++;
+  entry.classId = classId;
+  MakeKey (shape, src, dst, protocol, srcPort, dstPort, entry.key);
+  entry.hash = Hash32 ((const char *) entry.key, m_keyLength);
+
+  std::vector<Entry> &bucket = shape.buckets[entry.hash & (shape.buckets.size () - 1)];
+  for (uint32_t i = 0; i < bucket.size (); i++)
+    {
+      if (bucket[i].hash == entry.hash && memcmp (bucket[i].key, entry.key, m_keyLength) == 0)
+        {
+          NS_LOG_DEBUG ("Rule " << entry.index << " is shadowed by rule " << bucket[i].index);
+          return;
+        }
+    }
+  bucket.push_back (entry);
+
+  if (++shape.nEntries > shape.buckets.size ())
+    {
+      Grow (shape);
+    }
+}
+
+int32_t
+FiveTupleRuleTable::Lookup (const uint8_t *src, const uint8_t *dst,
+                            uint8_t protocol, uint16_t srcPort, uint16_t dstPort) const
+{
+  NS_LOG_FUNCTION (this << (uint16_t) protocol << srcPort << dstPort);
+
+  uint32_t bestIndex = std::numeric_limits<uint32_t>::max ();
+  int32_t classId = -1;
+  uint8_t key[MAX_KEY_LENGTH];
+
+  // shapes are sorted by the index of their first rule, hence once the first
+  // rule of a shape comes after the best match, so do all the following rules
+  for (std::vector<Shape>::const_iterator shape = m_shapes.begin ();
+       shape != m_shapes.end () && shape->firstIndex < bestIndex; shape++)
+    {
+      MakeKey (*shape, src, dst, protocol, srcPort, dstPort, key);
+      uint32_t hash = Hash32 ((const char *) key, m_keyLength);
+      const std::vector<Entry> &bucket = shape->buckets[hash & (shape->buckets.size () - 1)];
+      for (std::vector<Entry>::const_iterator e = bucket.begin (); e != bucket.end (); e++)
+        {
+          if (e->hash == hash && e->index < bestIndex && memcmp (e->key, key, m_keyLength) == 0)
+            {
+              bestIndex = e->index;
+              classId = e->classId;
+            }
+        }
+    }
+
+  NS_LOG_DEBUG ("Matched rule " << (classId == -1 ? -1 : (int64_t) bestIndex) << ", class " << classId);
+  return classId;
+}
+
+void
+FiveTupleRuleTable::Clear (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_shapes.clear ();
+  m_nRules = 0;
+}
+
+uint32_t
+FiveTupleRuleTable::GetNRules (void) const
+{
+  return m_nRules;
+}
+
+uint32_t
+FiveTupleRuleTable::GetNShapes (void) const
+{
+  return m_shapes.size ();
+}
+
+std::vector<FiveTupleRuleTable::RuleFields>
+FiveTupleRuleTable::ReadRules (std::string filename)
+{
+  NS_LOG_FUNCTION (filename);
+
+  std::ifstream file (filename.c_str ());
+  NS_ABORT_MSG_UNLESS (file.good (), "Cannot open the rules file " << filename);
+
+  std::vector<RuleFields> rules;
+  std::string line;
+  uint32_t lineNumber = 0;
+  while (std::getline (file, line))
+    {
+      lineNumber++;
+      std::string::size_type comment = line.find ('#');
+      if (comment != std::string::npos)
+        {
+          line.erase (comment);
+        }
+
+      std::istringstream iss (line);
+      std::vector<std::string> fields;
+      std::string field;
+      while (iss >> field)
+        {
+          fields.push_back (field);
+        }
+      if (fields.empty ())
+        {
+          continue;
+        }
+
+      RuleFields rule;
+      rule.line = lineNumber;
+      NS_ABORT_MSG_UNLESS (fields.size () == 6
+                           && ParseField (fields[2], 255, rule.protocol)
+                           && ParseField (fields[3], 65535, rule.srcPort)
+                           && ParseField (fields[4], 65535, rule.dstPort)
+                           && ParseField (fields[5], std::numeric_limits<int32_t>::max (), rule.classId)
+                           && rule.classId != ANY,
+                           "Malformed rule at line " << lineNumber << " of " << filename);
+      rule.src = fields[0];
+      rule.dst = fields[1];
+      rules.push_back (rule);
+    }
+  return rules;
+}
+
+int32_t
+FiveTupleRuleTable::SplitPrefix (std::string prefix, uint32_t maxLength, std::string &address)
+{
+  if (prefix == "*")
+    {
+      address = "";
+      return 0;
+    }
+
+  std::string::size_type slash = prefix.find ('/');
+  address = prefix.substr (0, slash);
+  if (slash == std::string::npos)
+    {
+      return maxLength;
+    }
+
+  int32_t length;
+  if (!ParseField (prefix.substr (slash + 1), maxLength, length) || length == ANY)
+    {
+      return -1;
+    }
+  return length;
+}
+
+} // namespace ns3
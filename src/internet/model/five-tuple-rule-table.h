@@ -0,0 +1,206 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef FIVE_TUPLE_RULE_TABLE_H
+#define FIVE_TUPLE_RULE_TABLE_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup internet
+ *
+ * \brief A table of classification rules on the 5-tuple of a packet
+ *
+ * A rule matches a source and a destination prefix and, optionally, the
+ * protocol number and the source and destination ports, and maps the
+ * matching packets to a class. When several rules match a packet, the
+ * first added one wins.
+ *
+ * The rules are grouped by shape, i.e., by the pair of prefix lengths and
+ * the set of fields they do not care about (the exact 5-tuple rules all
+ * have the same shape). The rules of a shape are stored in a hash table,
+ * keyed by the 5-tuple masked as the shape requires. A lookup masks the
+ * 5-tuple of the packet once per shape and probes the corresponding hash
+ * table, so its cost depends on the number of distinct shapes but not on
+ * the number of rules. Shapes are probed in the order of their first rule
+ * and the lookup stops as soon as no remaining shape can hold a better
+ * rule than the one already found.
+ *
+ * Addresses are given as arrays of bytes in network order, whose length
+ * (4 or 16 bytes) is set by the constructor.
+ */
+class FiveTupleRuleTable
+{
+public:
+  /**
+   * \brief Create an empty table
+   * \param addressLength the length of the addresses in bytes, at most 16
+   */
+  FiveTupleRuleTable (uint32_t addressLength);
+
+  /**
+   * Value of the protocol and port fields of a rule matching any value
+   */
+  static const int32_t ANY = -1;
+
+  /**
+   * \brief Add a rule, with a lower priority than the rules already added
+   * \param src the source address
+   * \param srcPrefixLength the number of bits of the source address to match
+   * \param dst the destination address
+   * \param dstPrefixLength the number of bits of the destination address to match
+   * \param protocol the protocol number, or ANY
+   * \param srcPort the source port, or ANY
+   * \param dstPort the destination port, or ANY
+   * \param classId the value returned for the packets matching the rule
+   */
+  void AddRule (const uint8_t *src, uint8_t srcPrefixLength,
+                const uint8_t *dst, uint8_t dstPrefixLength,
+                int32_t protocol, int32_t srcPort, int32_t dstPort, int32_t classId);
+
+  /**
+   * \brief Find the first rule matching a 5-tuple
+   * \param src the source address
+   * \param dst the destination address
+   * \param protocol the protocol number
+   * \param srcPort the source port
+   * \param dstPort the destination port
+   * \return the class of the first matching rule, or -1 if no rule matches
+   */
+  int32_t Lookup (const uint8_t *src, const uint8_t *dst,
+                  uint8_t protocol, uint16_t srcPort, uint16_t dstPort) const;
+
+  /**
+   * \brief Remove all the rules
+   */
+  void Clear (void);
+
+  /**
+   * \brief Get the number of rules
+   * \return the number of rules
+   */
+  uint32_t GetNRules (void) const;
+
+  /**
+   * \brief Get the number of distinct shapes of the rules
+   * \return the number of hash tables probed by a lookup, at most
+   */
+  uint32_t GetNShapes (void) const;
+
+  /**
+   * \brief The fields of a rule, as read from a rules file
+   */
+  struct RuleFields
+  {
+    std::string src;       //!< Source prefix
+    std::string dst;       //!< Destination prefix
+    int32_t protocol;      //!< Protocol number, or ANY
+    int32_t srcPort;       //!< Source port, or ANY
+    int32_t dstPort;       //!< Destination port, or ANY
+    int32_t classId;       //!< Class of the matching packets
+    uint32_t line;         //!< Line of the rule in the file
+  };
+
+  /**
+   * \brief Read the rules of a text file
+   *
+   * Each line holds a rule made of six fields separated by blanks: the
+   * source prefix, the destination prefix, the protocol number, the source
+   * port, the destination port and the class, e.g.:
+   *
+   * \verbatim
+     10.1.0.0/16  *  6  *  80  2
+     \endverbatim
+   *
+   * The prefixes are left to the caller to parse. A "*" stands for any
+   * protocol or port. Empty lines and the text following a "#" are ignored.
+   * The simulation is aborted if the file cannot be read or is malformed.
+   *
+   * \param filename the name of the file
+   * \return the rules, in the order of the file
+   */
+  static std::vector<RuleFields> ReadRules (std::string filename);
+
+  /**
+   * \brief Split a prefix such as "10.0.0.0/8" in address and prefix length
+   * \param prefix the prefix, or "*" for any address
+   * \param maxLength the number of bits of an address
+   * \param address set to the address, or to the empty string for any address
+   * \return the prefix length, maxLength if not given, 0 for any address, or -1 if not valid
+   */
+  static int32_t SplitPrefix (std::string prefix, uint32_t maxLength, std::string &address);
+
+private:
+  static const uint32_t MAX_KEY_LENGTH = 37;  //!< Key length of IPv6 5-tuples
+
+  /**
+   * \brief A rule in a hash table
+   */
+  struct Entry
+  {
+    uint32_t hash;                 //!< Hash of the key
+    uint32_t index;                //!< Index of the rule, the lower the higher the priority
+    int32_t classId;               //!< Class of the matching packets
+    uint8_t key[MAX_KEY_LENGTH];   //!< Masked 5-tuple
+  };
+
+  /**
+   * \brief The rules sharing the same prefix lengths and wildcards
+   */
+  struct Shape
+  {
+    uint8_t srcPrefixLength;       //!< Bits of the source address matched
+    uint8_t dstPrefixLength;       //!< Bits of the destination address matched
+    bool anyProtocol;              //!< The protocol is not matched
+    bool anySrcPort;               //!< The source port is not matched
+    bool anyDstPort;               //!< The destination port is not matched
+    uint32_t firstIndex;           //!< Index of the first rule of this shape
+    uint32_t nEntries;             //!< Number of rules in the hash table
+    std::vector<std::vector<Entry> > buckets;  //!< Hash table, the number of buckets is a power of 2
+  };
+
+  /**
+   * \brief Write the 5-tuple masked as a shape requires
+   * \param shape the shape
+   * \param src the source address
+   * \param dst the destination address
+   * \param protocol the protocol number
+   * \param srcPort the source port
+   * \param dstPort the destination port
+   * \param key the buffer the key is written to
+   */
+  void MakeKey (const Shape &shape, const uint8_t *src, const uint8_t *dst,
+                uint8_t protocol, uint16_t srcPort, uint16_t dstPort, uint8_t *key) const;
+
+  /**
+   * \brief Double the number of buckets of the hash table of a shape
+   * \param shape the shape
+   */
+  static void Grow (Shape &shape);
+
+  uint32_t m_addressLength;        //!< Length of the addresses in bytes
+  uint32_t m_keyLength;            //!< Length of the keys in bytes
+  uint32_t m_nRules;               //!< Number of rules added
+  std::vector<Shape> m_shapes;     //!< Shapes, in the order of their first rule
+};
+
+} // namespace ns3
+
+#endif /* FIVE_TUPLE_RULE_TABLE_H */
@@ -23,6 +23,7 @@
 
 #include "ns3/log.h"
 #include "ns3/enum.h"
+#include "ns3/string.h"
 #include "ns3/tcp-header.h"
 #include "ns3/udp-header.h"
 #include "ipv4-queue-disc-item.h"
@@ -147,4 +148,141 @@ FqCoDelIpv4PacketFilter::DoClassify (Ptr<QueueDiscItem> item) const
   return hash;
 }
 
+// ------------------------------------------------------------------------- //
+
+NS_OBJECT_ENSURE_REGISTERED (FiveTupleIpv4PacketFilter);
+
+TypeId
+FiveTupleIpv4PacketFilter::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::FiveTupleIpv4PacketFilter")
+    .SetParent<Ipv4PacketFilter> ()
+    .SetGroupName ("Internet")
+    .AddConstructor<FiveTupleIpv4PacketFilter> ()
+    .AddAttribute ("RulesFile",
+                   "The file the rules are loaded from, replacing the current rules",
+                   StringValue (""),
+                   MakeStringAccessor (&FiveTupleIpv4PacketFilter::SetRulesFile,
+                                       &FiveTupleIpv4PacketFilter::GetRulesFile),
+                   MakeStringChecker ())
+  ;
+  return tid;
+}
+
+FiveTupleIpv4PacketFilter::FiveTupleIpv4PacketFilter ()
+  : m_rules (4)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+FiveTupleIpv4PacketFilter::~FiveTupleIpv4PacketFilter ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+FiveTupleIpv4PacketFilter::AddRule (Ipv4Address src, Ipv4Mask srcMask, Ipv4Address dst, Ipv4Mask dstMask,
+                                    int32_t protocol, int32_t srcPort, int32_t dstPort, int32_t classId)
+{
+  NS_LOG_FUNCTION (this << src << srcMask << dst << dstMask << protocol << srcPort << dstPort << classId);
+  uint8_t srcBuf[4];
+  uint8_t dstBuf[4];
+  src.Serialize (srcBuf);
+  dst.Serialize (dstBuf);
+  m_rules.AddRule (srcBuf, srcMask.GetPrefixLength (), dstBuf, dstMask.GetPrefixLength (),
+                   protocol, srcPort, dstPort, classId);
+}
+
+void
+FiveTupleIpv4PacketFilter::LoadRules (std::string filename)
+{
+  NS_LOG_FUNCTION (this << filename);
+  std::vector<FiveTupleRuleTable::RuleFields> rules = FiveTupleRuleTable::ReadRules (filename);
+
+  for (std::vector<FiveTupleRuleTable::RuleFields>::const_iterator r = rules.begin (); r != rules.end (); r++)
+    {
+      std::string src;
+      std::string dst;
+      int32_t srcLength = FiveTupleRuleTable::SplitPrefix (r->src, 32, src);
+      int32_t dstLength = FiveTupleRuleTable::SplitPrefix (r->dst, 32, dst);
+      NS_ABORT_MSG_IF (srcLength < 0 || dstLength < 0,
+                       "Malformed prefix at line " << r->line << " of " << filename);
+
+      uint8_t srcBuf[4] = {0, 0, 0, 0};
+      uint8_t dstBuf[4] = {0, 0, 0, 0};
+      if (!src.empty ())
+        {
+          Ipv4Address (src.c_str ()).Serialize (srcBuf);
+        }
+      if (!dst.empty ())
+        {
+          Ipv4Address (dst.c_str ()).Serialize (dstBuf);
+        }
+      m_rules.AddRule (srcBuf, srcLength, dstBuf, dstLength, r->protocol, r->srcPort, r->dstPort, r->classId);
+    }
+  NS_LOG_INFO ("Loaded " << rules.size () << " rules from " << filename << ", "
+               << m_rules.GetNShapes () << " distinct shapes");
+}
+
+void
+FiveTupleIpv4PacketFilter::ClearRules (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_rules.Clear ();
+}
+
+uint32_t
+FiveTupleIpv4PacketFilter::GetNRules (void) const
+{
+  return m_rules.GetNRules ();
+}
+
+void
+FiveTupleIpv4PacketFilter::SetRulesFile (std::string filename)
+{
+  NS_LOG_FUNCTION (this << filename);
+  m_rulesFile = filename;
+  m_rules.Clear ();
+  if (!filename.empty ())
+    {
+      LoadRules (filename);
+    }
+}
+
+std::string
+FiveTupleIpv4PacketFilter::GetRulesFile (void) const
+{
+  return m_rulesFile;
+}
+
+int32_t
+FiveTupleIpv4PacketFilter::DoClassify (Ptr<QueueDiscItem> item) const
+{
+  NS_LOG_FUNCTION (this << item);
+  Ptr<Ipv4QueueDiscItem> ipv4Item = DynamicCast<Ipv4QueueDiscItem> (item);
+
+  NS_ASSERT (ipv4Item != 0);
+
+  const Ipv4Header &hdr = ipv4Item->GetHeader ();
+  uint8_t src[4];
+  uint8_t dst[4];
+  hdr.GetSource ().Serialize (src);
+  hdr.GetDestination ().Serialize (dst);
+  uint8_t prot = hdr.GetProtocol ();
+  uint16_t srcPort = 0;
+  uint16_t dstPort = 0;
+
+  // TCP and UDP headers both start with the source and destination ports,
+  // which are read without deserializing the whole transport header
+  uint8_t ports[4];
+  if ((prot == 6 || prot == 17) && hdr.GetFragmentOffset () == 0
+      && ipv4Item->GetPacket ()->CopyData (ports, 4) == 4)
+    {
+      srcPort = (ports[0] << 8) | ports[1];
+      dstPort = (ports[2] << 8) | ports[3];
+    }
+
+  return m_rules.Lookup (src, dst, prot, srcPort, dstPort);
+}
+
 } // namespace ns3
@@ -23,6 +23,7 @@
 
 #include "ns3/log.h"
 #include "ns3/enum.h"
+#include "ns3/string.h"
 #include "ns3/tcp-header.h"
 #include "ns3/udp-header.h"
 #include "ipv6-queue-disc-item.h"
@@ -146,4 +147,140 @@ FqCoDelIpv6PacketFilter::DoClassify (Ptr< QueueDiscItem > item) const
   return hash;
 }
 
+// ------------------------------------------------------------------------- //
+
+NS_OBJECT_ENSURE_REGISTERED (FiveTupleIpv6PacketFilter);
+
+TypeId
+FiveTupleIpv6PacketFilter::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::FiveTupleIpv6PacketFilter")
+    .SetParent<Ipv6PacketFilter> ()
+    .SetGroupName ("Internet")
+    .AddConstructor<FiveTupleIpv6PacketFilter> ()
+    .AddAttribute ("RulesFile",
+                   "The file the rules are loaded from, replacing the current rules",
+                   StringValue (""),
+                   MakeStringAccessor (&FiveTupleIpv6PacketFilter::SetRulesFile,
+                                       &FiveTupleIpv6PacketFilter::GetRulesFile),
+                   MakeStringChecker ())
+  ;
+  return tid;
+}
+
+FiveTupleIpv6PacketFilter::FiveTupleIpv6PacketFilter ()
+  : m_rules (16)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+FiveTupleIpv6PacketFilter::~FiveTupleIpv6PacketFilter ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+FiveTupleIpv6PacketFilter::AddRule (Ipv6Address src, Ipv6Prefix srcPrefix, Ipv6Address dst, Ipv6Prefix dstPrefix,
+                                    int32_t protocol, int32_t srcPort, int32_t dstPort, int32_t classId)
+{
+  NS_LOG_FUNCTION (this << src << srcPrefix << dst << dstPrefix << protocol << srcPort << dstPort << classId);
+  uint8_t srcBuf[16];
+  uint8_t dstBuf[16];
+  src.Serialize (srcBuf);
+  dst.Serialize (dstBuf);
+  m_rules.AddRule (srcBuf, srcPrefix.GetPrefixLength (), dstBuf, dstPrefix.GetPrefixLength (),
+                   protocol, srcPort, dstPort, classId);
+}
+
+void
+FiveTupleIpv6PacketFilter::LoadRules (std::string filename)
+{
+  NS_LOG_FUNCTION (this << filename);
+  std::vector<FiveTupleRuleTable::RuleFields> rules = FiveTupleRuleTable::ReadRules (filename);
+
+  for (std::vector<FiveTupleRuleTable::RuleFields>::const_iterator r = rules.begin (); r != rules.end (); r++)
+    {
+      std::string src;
+      std::string dst;
+      int32_t srcLength = FiveTupleRuleTable::SplitPrefix (r->src, 128, src);
+      int32_t dstLength = FiveTupleRuleTable::SplitPrefix (r->dst, 128, dst);
+      NS_ABORT_MSG_IF (srcLength < 0 || dstLength < 0,
+                       "Malformed prefix at line " << r->line << " of " << filename);
+
+      uint8_t srcBuf[16] = {0};
+      uint8_t dstBuf[16] = {0};
+      if (!src.empty ())
+        {
+          Ipv6Address (src.c_str ()).Serialize (srcBuf);
+        }
+      if (!dst.empty ())
+        {
+          Ipv6Address (dst.c_str ()).Serialize (dstBuf);
+        }
+      m_rules.AddRule (srcBuf, srcLength, dstBuf, dstLength, r->protocol, r->srcPort, r->dstPort, r->classId);
+    }
+  NS_LOG_INFO ("Loaded " << rules.size () << " rules from " << filename << ", "
+               << m_rules.GetNShapes () << " distinct shapes");
+}
+
+void
+FiveTupleIpv6PacketFilter::ClearRules (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_rules.Clear ();
+}
+
+uint32_t
+FiveTupleIpv6PacketFilter::GetNRules (void) const
+{
+  return m_rules.GetNRules ();
+}
+
+void
+FiveTupleIpv6PacketFilter::SetRulesFile (std::string filename)
+{
+  NS_LOG_FUNCTION (this << filename);
+  m_rulesFile = filename;
+  m_rules.Clear ();
+  if (!filename.empty ())
+    {
+      LoadRules (filename);
+    }
+}
+
+std::string
+FiveTupleIpv6PacketFilter::GetRulesFile (void) const
+{
+  return m_rulesFile;
+}
+
+int32_t
+FiveTupleIpv6PacketFilter::DoClassify (Ptr<QueueDiscItem> item) const
+{
+  NS_LOG_FUNCTION (this << item);
+  Ptr<Ipv6QueueDiscItem> ipv6Item = DynamicCast<Ipv6QueueDiscItem> (item);
+
+  NS_ASSERT (ipv6Item != 0);
+
+  const Ipv6Header &hdr = ipv6Item->GetHeader ();
+  uint8_t src[16];
+  uint8_t dst[16];
+  hdr.GetSourceAddress ().Serialize (src);
+  hdr.GetDestinationAddress ().Serialize (dst);
+  uint8_t prot = hdr.GetNextHeader ();
+  uint16_t srcPort = 0;
+  uint16_t dstPort = 0;
+
+  // TCP and UDP headers both start with the source and destination ports,
+  // which are read without deserializing the whole transport header
+  uint8_t ports[4];
+  if ((prot == 6 || prot == 17) && ipv6Item->GetPacket ()->CopyData (ports, 4) == 4)
+    {
+      srcPort = (ports[0] << 8) | ports[1];
+      dstPort = (ports[2] << 8) | ports[3];
+    }
+
+  return m_rules.Lookup (src, dst, prot, srcPort, dstPort);
+}
+
 } // namespace ns3
@@ -26,6 +26,8 @@
 
 #include "ns3/object.h"
 #include "ns3/packet-filter.h"
+#include "ns3/ipv6-address.h"
+#include "five-tuple-rule-table.h"
 
 namespace ns3 {
 
@@ -76,6 +78,79 @@ private:
   uint32_t m_perturbation; //!< hash perturbation value
 };
 
+
+/**
+ * \ingroup internet
+ *
+ * FiveTupleIpv6PacketFilter classifies IPv6 packets according to a list of
+ * rules on their 5-tuple, which can be added one by one or loaded from a
+ * file (see FiveTupleRuleTable::ReadRules for the format). Packets get the
+ * class of the first matching rule, or are not classified if no rule
+ * matches. The headers of a packet are parsed once and the cost of a lookup
+ * does not depend on the number of rules (see FiveTupleRuleTable), hence a
+ * single filter of this kind should be preferred to a long list of filters.
+ */
+class FiveTupleIpv6PacketFilter : public Ipv6PacketFilter {
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  FiveTupleIpv6PacketFilter ();
+  virtual ~FiveTupleIpv6PacketFilter ();
+
+  /**
+   * \brief Add a rule, with a lower priority than the rules already added
+   * \param src the source address
+   * \param srcPrefix the prefix of the source address
+   * \param dst the destination address
+   * \param dstPrefix the prefix of the destination address
+   * \param protocol the protocol number, or FiveTupleRuleTable::ANY
+   * \param srcPort the source port, or FiveTupleRuleTable::ANY
+   * \param dstPort the destination port, or FiveTupleRuleTable::ANY
+   * \param classId the value returned for the packets matching the rule
+   */
+  void AddRule (Ipv6Address src, Ipv6Prefix srcPrefix, Ipv6Address dst, Ipv6Prefix dstPrefix,
+                int32_t protocol, int32_t srcPort, int32_t dstPort, int32_t classId);
+
+  /**
+   * \brief Add the rules of a file, with a lower priority than the rules already added
+   * \param filename the name of the file
+   */
+  void LoadRules (std::string filename);
+
+  /**
+   * \brief Remove all the rules
+   */
+  void ClearRules (void);
+
+  /**
+   * \brief Get the number of rules
+   * \return the number of rules
+   */
+  uint32_t GetNRules (void) const;
+
+private:
+  virtual int32_t DoClassify (Ptr<QueueDiscItem> item) const;
+
+  /**
+   * \brief Replace the rules with those of a file
+   * \param filename the name of the file, or the empty string for no rules
+   */
+  void SetRulesFile (std::string filename);
+
+  /**
+   * \brief Get the name of the file the rules were loaded from
+   * \return the name of the file
+   */
+  std::string GetRulesFile (void) const;
+
+  std::string m_rulesFile;    //!< Name of the rules file
+  FiveTupleRuleTable m_rules; //!< Compiled rules
+};
+
 } // namespace ns3
 
 #endif /* IPV6_PACKET_FILTER */
@@ -95,4 +95,18 @@ Ipv6QueueDiscItem::GetUint8Value (QueueItem::Uint8Values field, uint8_t& value)
   return ret;
 }
 
+bool
+Ipv6QueueDiscItem::Mark (void)
+{
+  NS_LOG_FUNCTION (this);
+  // the ECN field is made of the two least significant bits of the traffic class
+  uint8_t tc = m_header.GetTrafficClass ();
+  if (!m_headerAdded && (tc & 0x03) != 0)
+    {
+      m_header.SetTrafficClass (tc | 0x03);
+      return true;
+    }
+  return false;
+}
+
 } // namespace ns3
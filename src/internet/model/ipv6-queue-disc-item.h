@@ -79,6 +79,13 @@ public:
    */
   virtual bool GetUint8Value (Uint8Values field, uint8_t &value) const;
 
+  /**
+   * \brief Mark the packet by setting the ECN bits of the traffic class to CE,
+   * if the packet is ECN capable (ECT0 or ECT1)
+   * \return true if the packet has been marked
+   */
+  virtual bool Mark (void);
+
 private:
   /**
    * \brief Default constructor
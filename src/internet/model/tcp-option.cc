@@ -68,7 +68,9 @@ TcpOption::CreateOption (uint8_t kind)
     TypeId tid;
   };
 
-  static ObjectFactory objectFactory;
+  // One factory per thread: the threads of MultithreadedSimulatorImpl
+  // parse TCP options concurrently.
+  static thread_local ObjectFactory objectFactory;
   static kindToTid toTid[] =
   {
     { TcpOption::END,       TcpOptionEnd::GetTypeId () },
@@ -0,0 +1,267 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/packet.h"
+#include "ns3/udp-header.h"
+#include "ns3/tcp-header.h"
+#include "ns3/ipv4-header.h"
+#include "ns3/ipv6-header.h"
+#include "ns3/ipv4-queue-disc-item.h"
+#include "ns3/ipv6-queue-disc-item.h"
+#include "ns3/ipv4-packet-filter.h"
+#include "ns3/ipv6-packet-filter.h"
+#include "ns3/string.h"
+#include <fstream>
+#include <sstream>
+
+using namespace ns3;
+
+/**
+ * \brief Create an IPv4 item carrying a transport header
+ * \param src the source address
+ * \param dst the destination address
+ * \param protocol the protocol number, 6 or 17
+ * \param srcPort the source port
+ * \param dstPort the destination port
+ * \return the item
+ */
+static Ptr<QueueDiscItem>
+CreateIpv4Item (const char *src, const char *dst, uint8_t protocol, uint16_t srcPort, uint16_t dstPort)
+{
+  Ptr<Packet> p = Create<Packet> (100);
+  if (protocol == 6)
+    {
+      TcpHeader tcp;
+      tcp.SetSourcePort (srcPort);
+      tcp.SetDestinationPort (dstPort);
+      p->AddHeader (tcp);
+    }
+  else
+    {
+      UdpHeader udp;
+      udp.SetSourcePort (srcPort);
+      udp.SetDestinationPort (dstPort);
+      p->AddHeader (udp);
+    }
+  Ipv4Header hdr;
+  hdr.SetSource (Ipv4Address (src));
+  hdr.SetDestination (Ipv4Address (dst));
+  hdr.SetProtocol (protocol);
+  return Create<Ipv4QueueDiscItem> (p, Address (), 0x0800, hdr);
+}
+
+/**
+ * \brief Create an IPv6 item carrying a UDP header
+ * \param src the source address
+ * \param dst the destination address
+ * \param srcPort the source port
+ * \param dstPort the destination port
+ * \return the item
+ */
+static Ptr<QueueDiscItem>
+CreateIpv6Item (const char *src, const char *dst, uint16_t srcPort, uint16_t dstPort)
+{
+  Ptr<Packet> p = Create<Packet> (100);
+  UdpHeader udp;
+  udp.SetSourcePort (srcPort);
+  udp.SetDestinationPort (dstPort);
+  p->AddHeader (udp);
+  Ipv6Header hdr;
+  hdr.SetSourceAddress (Ipv6Address (src));
+  hdr.SetDestinationAddress (Ipv6Address (dst));
+  hdr.SetNextHeader (17);
+  return Create<Ipv6QueueDiscItem> (p, Address (), 0x86DD, hdr);
+}
+
+/**
+ * Check that the five tuple IPv4 filter returns the class of the first
+ * matching rule, whether the rules are added one by one or loaded from a file
+ */
+class FiveTupleIpv4PacketFilterTest : public TestCase
+{
+public:
+  FiveTupleIpv4PacketFilterTest ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * \brief Check the classification of a set of packets
+   * \param filter the filter
+   */
+  void CheckClasses (Ptr<PacketFilter> filter);
+};
+
+FiveTupleIpv4PacketFilterTest::FiveTupleIpv4PacketFilterTest ()
+  : TestCase ("Five tuple IPv4 packet filter")
+{
+}
+
+void
+FiveTupleIpv4PacketFilterTest::CheckClasses (Ptr<PacketFilter> filter)
+{
+  NS_TEST_EXPECT_MSG_EQ (filter->Classify (CreateIpv4Item ("10.1.1.1", "10.2.2.2", 17, 1000, 2000)), 1,
+                         "The exact rule should match");
+  NS_TEST_EXPECT_MSG_EQ (filter->Classify (CreateIpv4Item ("10.1.1.1", "10.2.2.2", 17, 1001, 2000)), 4,
+                         "Only the 10.0.0.0/8 rule should match");
+  NS_TEST_EXPECT_MSG_EQ (filter->Classify (CreateIpv4Item ("10.1.5.5", "10.9.9.9", 6, 5555, 80)), 2,
+                         "The source prefix and destination port rule should match");
+  NS_TEST_EXPECT_MSG_EQ (filter->Classify (CreateIpv4Item ("10.9.9.9", "10.2.3.4", 6, 1, 1)), 3,
+                         "The destination prefix and protocol rule should match");
+  NS_TEST_EXPECT_MSG_EQ (filter->Classify (CreateIpv4Item ("10.1.5.5", "10.2.3.4", 6, 1, 80)), 2,
+                         "The first of the matching rules should win");
+  NS_TEST_EXPECT_MSG_EQ (filter->Classify (CreateIpv4Item ("192.168.1.1", "10.2.2.2", 17, 1000, 2000)),
+                         PacketFilter::PF_NO_MATCH, "No rule should match");
+  NS_TEST_EXPECT_MSG_EQ (filter->Classify (CreateIpv6Item ("2001:db8::1", "2001:db8::2", 1000, 2000)),
+                         PacketFilter::PF_NO_MATCH, "IPv6 packets should not be classified");
+}
+
+void
+FiveTupleIpv4PacketFilterTest::DoRun (void)
+{
+  int32_t any = FiveTupleRuleTable::ANY;
+
+  Ptr<FiveTupleIpv4PacketFilter> filter = CreateObject<FiveTupleIpv4PacketFilter> ();
+  filter->AddRule ("10.1.1.1", "/32", "10.2.2.2", "/32", 17, 1000, 2000, 1);
+  filter->AddRule ("10.1.0.0", "/16", "0.0.0.0", "/0", any, any, 80, 2);
+  filter->AddRule ("0.0.0.0", "/0", "10.2.0.0", "/16", 6, any, any, 3);
+  filter->AddRule ("10.0.0.0", "/8", "0.0.0.0", "/0", any, any, any, 4);
+  NS_TEST_EXPECT_MSG_EQ (filter->GetNRules (), 4, "Unexpected number of rules");
+  CheckClasses (filter);
+
+  std::string filename = CreateTempDirFilename ("five-tuple-ipv4-rules.txt");
+  std::ofstream rules (filename.c_str ());
+  rules << "# src dst protocol srcPort dstPort class" << std::endl
+        << "10.1.1.1 10.2.2.2/32 17 1000 2000 1" << std::endl
+        << std::endl
+        << "10.1.0.0/16   *   *   *   80   2   # web" << std::endl
+        << "* 10.2.0.0/16 6 * * 3" << std::endl
+        << "10.0.0.0/8 * * * * 4" << std::endl;
+  rules.close ();
+
+  Ptr<FiveTupleIpv4PacketFilter> loaded = CreateObject<FiveTupleIpv4PacketFilter> ();
+  loaded->SetAttribute ("RulesFile", StringValue (filename));
+  NS_TEST_EXPECT_MSG_EQ (loaded->GetNRules (), 4, "Unexpected number of rules loaded");
+  CheckClasses (loaded);
+
+  loaded->ClearRules ();
+  NS_TEST_EXPECT_MSG_EQ (loaded->Classify (CreateIpv4Item ("10.1.1.1", "10.2.2.2", 17, 1000, 2000)),
+                         PacketFilter::PF_NO_MATCH, "No rule should be left");
+}
+
+/**
+ * Check that many exact and prefix rules share a few hash tables
+ */
+class FiveTupleManyRulesTest : public TestCase
+{
+public:
+  FiveTupleManyRulesTest ();
+
+private:
+  virtual void DoRun (void);
+};
+
+FiveTupleManyRulesTest::FiveTupleManyRulesTest ()
+  : TestCase ("Five tuple packet filter with many rules")
+{
+}
+
+void
+FiveTupleManyRulesTest::DoRun (void)
+{
+  int32_t any = FiveTupleRuleTable::ANY;
+
+  Ptr<FiveTupleIpv4PacketFilter> filter = CreateObject<FiveTupleIpv4PacketFilter> ();
+  for (uint32_t i = 0; i < 2000; i++)
+    {
+      std::ostringstream src;
+      src << "10.0." << i / 256 << "." << i % 256;
+      filter->AddRule (src.str ().c_str (), "/32", "10.100.0.1", "/32", 17, 5000 + i, 80, i);
+    }
+  for (uint32_t i = 0; i < 200; i++)
+    {
+      std::ostringstream dst;
+      dst << "172." << 16 + i / 256 << "." << i % 256 << ".0";
+      filter->AddRule ("0.0.0.0", "/0", dst.str ().c_str (), "/24", any, any, any, 10000 + i);
+    }
+  NS_TEST_EXPECT_MSG_EQ (filter->GetNRules (), 2200, "Unexpected number of rules");
+
+  NS_TEST_EXPECT_MSG_EQ (filter->Classify (CreateIpv4Item ("10.0.7.42", "10.100.0.1", 17, 5000 + 7 * 256 + 42, 80)),
+                         7 * 256 + 42, "The exact rule should match");
+  NS_TEST_EXPECT_MSG_EQ (filter->Classify (CreateIpv4Item ("10.0.7.42", "10.100.0.1", 17, 4999, 80)),
+                         PacketFilter::PF_NO_MATCH, "No rule should match");
+  NS_TEST_EXPECT_MSG_EQ (filter->Classify (CreateIpv4Item ("1.2.3.4", "172.16.199.77", 6, 1, 2)),
+                         10199, "The prefix rule should match");
+}
+
+/**
+ * Check that the five tuple IPv6 filter returns the class of the first matching rule
+ */
+class FiveTupleIpv6PacketFilterTest : public TestCase
+{
+public:
+  FiveTupleIpv6PacketFilterTest ();
+
+private:
+  virtual void DoRun (void);
+};
+
+FiveTupleIpv6PacketFilterTest::FiveTupleIpv6PacketFilterTest ()
+  : TestCase ("Five tuple IPv6 packet filter")
+{
+}
+
+void
+FiveTupleIpv6PacketFilterTest::DoRun (void)
+{
+  std::string filename = CreateTempDirFilename ("five-tuple-ipv6-rules.txt");
+  std::ofstream rules (filename.c_str ());
+  rules << "2001:db8::1 2001:db8::2 17 1000 2000 1" << std::endl
+        << "2001:db8:1::/48 * * * 443 2" << std::endl
+        << "* 2001:db8::/32 17 * * 3" << std::endl;
+  rules.close ();
+
+  Ptr<FiveTupleIpv6PacketFilter> filter = CreateObject<FiveTupleIpv6PacketFilter> ();
+  filter->LoadRules (filename);
+  filter->AddRule ("2001:db8:2::", Ipv6Prefix (48), "::", Ipv6Prefix ((uint8_t) 0),
+                   FiveTupleRuleTable::ANY, FiveTupleRuleTable::ANY, FiveTupleRuleTable::ANY, 4);
+  NS_TEST_EXPECT_MSG_EQ (filter->GetNRules (), 4, "Unexpected number of rules");
+
+  NS_TEST_EXPECT_MSG_EQ (filter->Classify (CreateIpv6Item ("2001:db8::1", "2001:db8::2", 1000, 2000)), 1,
+                         "The exact rule should match");
+  NS_TEST_EXPECT_MSG_EQ (filter->Classify (CreateIpv6Item ("2001:db8:1:5::7", "2001:db8::2", 1000, 443)), 2,
+                         "The source prefix and destination port rule should match");
+  NS_TEST_EXPECT_MSG_EQ (filter->Classify (CreateIpv6Item ("2001:db8::1", "2001:db8::2", 1001, 2000)), 3,
+                         "The destination prefix rule should match");
+  NS_TEST_EXPECT_MSG_EQ (filter->Classify (CreateIpv6Item ("2001:db8:2::1", "fe80::1", 1, 2)), 4,
+                         "The rule added after loading should match");
+  NS_TEST_EXPECT_MSG_EQ (filter->Classify (CreateIpv6Item ("2001:db9::1", "fe80::1", 1, 2)),
+                         PacketFilter::PF_NO_MATCH, "No rule should match");
+  NS_TEST_EXPECT_MSG_EQ (filter->Classify (CreateIpv4Item ("10.1.1.1", "10.2.2.2", 17, 1000, 2000)),
+                         PacketFilter::PF_NO_MATCH, "IPv4 packets should not be classified");
+}
+
+//-----------------------------------------------------------------------------
+class FiveTuplePacketFilterTestSuite : public TestSuite
+{
+public:
+  FiveTuplePacketFilterTestSuite () : TestSuite ("five-tuple-packet-filter", UNIT)
+  {
+    AddTestCase (new FiveTupleIpv4PacketFilterTest, TestCase::QUICK);
+    AddTestCase (new FiveTupleManyRulesTest, TestCase::QUICK);
+    AddTestCase (new FiveTupleIpv6PacketFilterTest, TestCase::QUICK);
+  }
+} g_fiveTuplePacketFilterTestSuite;
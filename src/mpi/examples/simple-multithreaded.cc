@@ -0,0 +1,191 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ *
+ * SimpleMultithreaded creates a ring of routers, each with leaf nodes,
+ * and places each router and its leaves on its own system.
+ *
+ *      leaves         leaves
+ *         \             /
+ *          r0 ------- r1
+ *          |           |
+ *          r3 ------- r2
+ *         /             \
+ *      leaves         leaves
+ *
+ * Each leaf runs a TCP bulk send application to the leaf with the same
+ * rank on the next router of the ring. The links between the routers
+ * cross two systems: with --threaded, the systems run in the threads
+ * of MultithreadedSimulatorImpl, otherwise the whole ring runs in the
+ * default sequential simulator. The program prints, for each packet
+ * sink, the number of bytes received and a digest of the reception
+ * times: the two runs print the same lines.
+ *
+ *     ./waf --run "simple-multithreaded --threaded=0"
+ *     ./waf --run "simple-multithreaded --threaded=1"
+ */
+
+#include <iostream>
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/mpi-interface.h"
+#include "ns3/ipv4-global-routing-helper.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/bulk-send-helper.h"
+#include "ns3/packet-sink-helper.h"
+#include "ns3/packet-sink.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("SimpleMultithreaded");
+
+/**
+ * The packets received by a sink. Each sink has its own instance,
+ * updated by the thread of its node.
+ */
+struct SinkStats
+{
+  uint64_t bytes;   //!< The number of bytes received
+  uint64_t digest;  //!< The digest of the reception times
+};
+
+/**
+ * Record a packet received by a sink.
+ * \param [in] stats The statistics of the sink.
+ * \param [in] packet The packet.
+ * \param [in] from The address of the sender.
+ */
+static void
+SinkRx (SinkStats *stats, Ptr<const Packet> packet, const Address &from)
+{
+  stats->bytes += packet->GetSize ();
+  stats->digest = stats->digest * 1000003 + Simulator::Now ().GetNanoSeconds ();
+}
+
+int
+main (int argc, char *argv[])
+{
+  bool threaded = true;
+  uint32_t nRouters = 4;
+  uint32_t nLeaves = 4;
+  double stopTime = 10;
+
+  CommandLine cmd;
+  cmd.AddValue ("threaded", "Run the systems in threads", threaded);
+  cmd.AddValue ("routers", "Number of routers, and of systems", nRouters);
+  cmd.AddValue ("leaves", "Number of leaves of each router", nLeaves);
+  cmd.AddValue ("time", "Simulation time, in seconds", stopTime);
+  cmd.Parse (argc, argv);
+
+  if (threaded)
+    {
+      GlobalValue::Bind ("SimulatorImplementationType",
+                         StringValue ("ns3::MultithreadedSimulatorImpl"));
+      MpiInterface::Enable (&argc, &argv);
+    }
+
+  NodeContainer routers;
+  std::vector<NodeContainer> leaves (nRouters);
+  for (uint32_t i = 0; i < nRouters; ++i)
+    {
+      routers.Add (CreateObject<Node> (i));
+      leaves[i].Create (nLeaves, i);
+    }
+
+  InternetStackHelper stack;
+  stack.InstallAll ();
+
+  PointToPointHelper routerLink;
+  routerLink.SetDeviceAttribute ("DataRate", StringValue ("10Mbps"));
+  routerLink.SetChannelAttribute ("Delay", StringValue ("5ms"));
+
+  PointToPointHelper leafLink;
+  leafLink.SetDeviceAttribute ("DataRate", StringValue ("5Mbps"));
+  leafLink.SetChannelAttribute ("Delay", StringValue ("1ms"));
+
+  Ipv4AddressHelper address;
+  address.SetBase ("10.1.0.0", "255.255.255.0");
+  for (uint32_t i = 0; i < nRouters; ++i)
+    {
+      address.Assign (routerLink.Install (routers.Get (i), routers.Get ((i + 1) % nRouters)));
+      address.NewNetwork ();
+    }
+
+  std::vector<Ipv4InterfaceContainer> leafInterfaces (nRouters);
+  address.SetBase ("10.2.0.0", "255.255.255.0");
+  for (uint32_t i = 0; i < nRouters; ++i)
+    {
+      for (uint32_t j = 0; j < nLeaves; ++j)
+        {
+          Ipv4InterfaceContainer ifc = address.Assign (leafLink.Install (leaves[i].Get (j), routers.Get (i)));
+          leafInterfaces[i].Add (ifc.Get (0));
+          address.NewNetwork ();
+        }
+    }
+
+  Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+
+  uint16_t port = 50000;
+  std::vector<SinkStats> stats (nRouters * nLeaves);
+  PacketSinkHelper sinkHelper ("ns3::TcpSocketFactory",
+                               InetSocketAddress (Ipv4Address::GetAny (), port));
+  BulkSendHelper sourceHelper ("ns3::TcpSocketFactory", Address ());
+  for (uint32_t i = 0; i < nRouters; ++i)
+    {
+      for (uint32_t j = 0; j < nLeaves; ++j)
+        {
+          SinkStats &sinkStats = stats[i * nLeaves + j];
+          sinkStats.bytes = 0;
+          sinkStats.digest = 0;
+          ApplicationContainer sinkApp = sinkHelper.Install (leaves[i].Get (j));
+          sinkApp.Get (0)->TraceConnectWithoutContext ("Rx", MakeBoundCallback (&SinkRx, &sinkStats));
+          sinkApp.Start (Seconds (0.5));
+
+          uint32_t next = (i + 1) % nRouters;
+          sourceHelper.SetAttribute ("Remote", AddressValue (InetSocketAddress (leafInterfaces[next].GetAddress (j), port)));
+          ApplicationContainer sourceApp = sourceHelper.Install (leaves[i].Get (j));
+          sourceApp.Start (Seconds (1.0 + 0.01 * (i * nLeaves + j)));
+        }
+    }
+
+  SystemWallClockMs clock;
+  clock.Start ();
+  Simulator::Stop (Seconds (stopTime));
+  Simulator::Run ();
+  int64_t elapsed = clock.End ();
+
+  for (uint32_t i = 0; i < nRouters; ++i)
+    {
+      for (uint32_t j = 0; j < nLeaves; ++j)
+        {
+          const SinkStats &sinkStats = stats[i * nLeaves + j];
+          std::cout << "sink " << leaves[i].Get (j)->GetId ()
+                    << " bytes " << sinkStats.bytes
+                    << " digest " << sinkStats.digest << std::endl;
+        }
+    }
+  std::cout << "time " << Simulator::Now ().GetSeconds () << std::endl;
+  std::clog << "wall clock " << elapsed << " ms" << std::endl;
+
+  Simulator::Destroy ();
+  if (threaded)
+    {
+      MpiInterface::Disable ();
+    }
+  return 0;
+}
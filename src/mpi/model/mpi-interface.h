@@ -66,6 +66,13 @@ public:
    * When running a sequential simulation this will return a size of 1.
    */
   static uint32_t GetSize ();
+  /**
+   * \param systemId a system identification
+   * \return true if the nodes of the system run in this process
+   *
+   * When running a sequential simulation this will return true.
+   */
+  static bool IsLocal (uint32_t systemId);
   /**
    * \return true if parallel communication is enabled
    */
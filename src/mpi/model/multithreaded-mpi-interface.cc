@@ -0,0 +1,123 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+
+#include "multithreaded-mpi-interface.h"
+#include "mpi-receiver.h"
+
+#include "ns3/node.h"
+#include "ns3/node-list.h"
+#include "ns3/net-device.h"
+#include "ns3/simulator.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("MultithreadedMpiInterface");
+
+bool MultithreadedMpiInterface::m_enabled = false;
+std::vector<std::vector<MpiReceiver *> > MultithreadedMpiInterface::m_receivers;
+
+void
+MultithreadedMpiInterface::Destroy ()
+{
+  NS_LOG_FUNCTION (this);
+  m_receivers.clear ();
+}
+
+uint32_t
+MultithreadedMpiInterface::GetSystemId ()
+{
+  return Simulator::GetSystemId ();
+}
+
+uint32_t
+MultithreadedMpiInterface::GetSize ()
+{
+  uint32_t size = 1;
+  for (NodeList::Iterator i = NodeList::Begin (); i != NodeList::End (); ++i)
+    {
+      size = std::max (size, (*i)->GetSystemId () + 1);
+    }
+  return size;
+}
+
+bool
+MultithreadedMpiInterface::IsLocal (uint32_t systemId)
+{
+  return true;
+}
+
+bool
+MultithreadedMpiInterface::IsEnabled ()
+{
+  return m_enabled;
+}
+
+void
+MultithreadedMpiInterface::Enable (int* pargc, char*** pargv)
+{
+  NS_LOG_FUNCTION (this << pargc << pargv);
+  m_enabled = true;
+}
+
+void
+MultithreadedMpiInterface::Disable ()
+{
+  NS_LOG_FUNCTION (this);
+  m_enabled = false;
+  m_receivers.clear ();
+}
+
+void
+MultithreadedMpiInterface::SendPacket (Ptr<Packet> p, const Time& rxTime, uint32_t node, uint32_t dev)
+{
+  NS_LOG_FUNCTION (this << p << rxTime.GetTimeStep () << node << dev);
+  NS_ASSERT_MSG (node < m_receivers.size () && dev < m_receivers[node].size ()
+                 && m_receivers[node][dev] != 0,
+                 "No receiver for device " << dev << " of node " << node);
+
+  // The packet shares its buffers with the packets of this thread,
+  // whose reference counts are not atomic: deliver a deep copy.
+  uint32_t serializedSize = p->GetSerializedSize ();
+  std::vector<uint8_t> buffer (serializedSize);
+  p->Serialize (&buffer[0], serializedSize);
+  Ptr<Packet> copy = Create<Packet> (&buffer[0], serializedSize, true);
+
+  Simulator::ScheduleWithContext (node, rxTime - Simulator::Now (),
+                                  &MpiReceiver::Receive, m_receivers[node][dev], copy);
+}
+
+void
+MultithreadedMpiInterface::CollectReceivers ()
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  m_receivers.clear ();
+  m_receivers.resize (NodeList::GetNNodes ());
+  for (NodeList::Iterator i = NodeList::Begin (); i != NodeList::End (); ++i)
+    {
+      Ptr<Node> node = *i;
+      std::vector<MpiReceiver *> &receivers = m_receivers[node->GetId ()];
+      receivers.resize (node->GetNDevices (), 0);
+      for (uint32_t j = 0; j < node->GetNDevices (); ++j)
+        {
+          receivers[j] = PeekPointer (node->GetDevice (j)->GetObject<MpiReceiver> ());
+        }
+    }
+}
+
+} // namespace ns3
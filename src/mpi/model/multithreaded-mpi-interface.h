@@ -0,0 +1,106 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef NS3_MULTITHREADED_MPI_INTERFACE_H
+#define NS3_MULTITHREADED_MPI_INTERFACE_H
+
+#include <stdint.h>
+#include <vector>
+
+#include "ns3/nstime.h"
+#include "ns3/packet.h"
+
+#include "parallel-communication-interface.h"
+
+namespace ns3 {
+
+class MpiReceiver;
+
+/**
+ * \ingroup mpi
+ *
+ * \brief Interface between ns-3 and the threads of
+ * MultithreadedSimulatorImpl
+ *
+ * The systems are the threads of this process, hence no MPI library is
+ * used: a packet sent to a node of another system is copied and
+ * delivered to its MpiReceiver by an event scheduled in the thread of
+ * the node.
+ */
+class MultithreadedMpiInterface : public ParallelCommunicationInterface
+{
+public:
+  /**
+   * Does nothing: the systems do not hold any storage.
+   */
+  virtual void Destroy ();
+  /**
+   * \return the system of the calling thread, 0 outside
+   * Simulator::Run
+   */
+  virtual uint32_t GetSystemId ();
+  /**
+   * \return the number of systems, that is the largest system
+   * identification of the nodes plus one
+   */
+  virtual uint32_t GetSize ();
+  /**
+   * \param systemId a system identification
+   * \return true: all the systems run in this process
+   */
+  virtual bool IsLocal (uint32_t systemId);
+  /**
+   * \return true if Enable was called
+   */
+  virtual bool IsEnabled ();
+  /**
+   * \param pargc number of command line arguments
+   * \param pargv command line arguments
+   *
+   * Enables the interface. The command line is not used.
+   */
+  virtual void Enable (int* pargc, char*** pargv);
+  /**
+   * Disables the interface.
+   */
+  virtual void Disable ();
+  /**
+   * \param p packet to send
+   * \param rxTime received time at destination node
+   * \param node destination node
+   * \param dev destination device
+   *
+   * Copy the packet, so that the two threads do not share its buffers,
+   * and schedule its reception in the thread of the destination node.
+   */
+  virtual void SendPacket (Ptr<Packet> p, const Time &rxTime, uint32_t node, uint32_t dev);
+  /**
+   * Record the receivers of the net devices of all the nodes. Called
+   * by MultithreadedSimulatorImpl before the threads start, so that
+   * SendPacket does not access the node list.
+   */
+  static void CollectReceivers ();
+
+private:
+  static bool m_enabled;
+
+  /** The receiver of each net device, indexed by node and by device. */
+  static std::vector<std::vector<MpiReceiver *> > m_receivers;
+};
+
+} // namespace ns3
+
+#endif /* NS3_MULTITHREADED_MPI_INTERFACE_H */
@@ -0,0 +1,788 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "multithreaded-simulator-impl.h"
+#include "multithreaded-mpi-interface.h"
+#include "mpi-receiver.h"
+
+#include "ns3/simulator.h"
+#include "ns3/scheduler.h"
+#include "ns3/event-impl.h"
+#include "ns3/channel.h"
+#include "ns3/node.h"
+#include "ns3/node-list.h"
+#include "ns3/node-container.h"
+#include "ns3/net-device.h"
+#include "ns3/ptr.h"
+#include "ns3/assert.h"
+#include "ns3/abort.h"
+#include "ns3/log.h"
+
+#include <algorithm>
+#include <limits>
+#include <sched.h>
+
+namespace ns3 {
+
+// Note:  Logging in this file is largely avoided due to the
+// number of calls that are made to these functions and the possibility
+// of causing recursions leading to stack overflow
+NS_LOG_COMPONENT_DEFINE ("MultithreadedSimulatorImpl");
+
+NS_OBJECT_ENSURE_REGISTERED (MultithreadedSimulatorImpl);
+
+namespace {
+
+/** The largest timestamp. */
+const uint64_t MAX_TS = std::numeric_limits<uint64_t>::max ();
+
+/** The number of times a thread polls the barrier before it yields. */
+const uint32_t SPIN_COUNT = 1000;
+
+} // unnamed namespace
+
+thread_local struct MultithreadedSimulatorImpl::Partition *MultithreadedSimulatorImpl::g_partition = 0;
+
+TypeId
+MultithreadedSimulatorImpl::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::MultithreadedSimulatorImpl")
+    .SetParent<SimulatorImpl> ()
+    .SetGroupName ("Mpi")
+    .AddConstructor<MultithreadedSimulatorImpl> ()
+  ;
+  return tid;
+}
+
+MultithreadedSimulatorImpl::MultithreadedSimulatorImpl ()
+  : m_stopRequested (false),
+    m_barrierCount (0),
+    m_barrierGeneration (0)
+{
+  NS_LOG_FUNCTION (this);
+  // uids are allocated from 4.
+  // uid 0 is "invalid" events
+  // uid 1 is "now" events
+  // uid 2 is "destroy" events
+  m_uid = 4;
+  m_firstUid = 4;
+  m_currentTs = 0;
+  m_stopTs = MAX_TS;
+  m_stopUid = 0;
+  m_running = false;
+  m_lookAhead = MAX_TS;
+}
+
+MultithreadedSimulatorImpl::~MultithreadedSimulatorImpl ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+MultithreadedSimulatorImpl::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  while (!m_events->IsEmpty ())
+    {
+      Scheduler::Event next = m_events->RemoveNext ();
+      next.impl->Unref ();
+    }
+  m_events = 0;
+  for (std::vector<struct Partition *>::iterator i = m_partitions.begin (); i != m_partitions.end (); ++i)
+    {
+      struct Partition *partition = *i;
+      while (!partition->events->IsEmpty ())
+        {
+          Scheduler::Event next = partition->events->RemoveNext ();
+          next.impl->Unref ();
+        }
+      for (std::vector<RemoteEvent>::iterator j = partition->remote.begin (); j != partition->remote.end (); ++j)
+        {
+          j->impl->Unref ();
+        }
+      delete partition;
+    }
+  m_partitions.clear ();
+  SimulatorImpl::DoDispose ();
+}
+
+void
+MultithreadedSimulatorImpl::Destroy ()
+{
+  NS_LOG_FUNCTION (this);
+  while (!m_destroyEvents.empty ())
+    {
+      Ptr<EventImpl> ev = m_destroyEvents.front ().PeekEventImpl ();
+      m_destroyEvents.pop_front ();
+      NS_LOG_LOGIC ("handle destroy " << ev);
+      if (!ev->IsCancelled ())
+        {
+          ev->Invoke ();
+        }
+    }
+}
+
+void
+MultithreadedSimulatorImpl::SetScheduler (ObjectFactory schedulerFactory)
+{
+  NS_LOG_FUNCTION (this << schedulerFactory);
+  NS_ASSERT_MSG (!m_running, "Cannot change the scheduler during Run");
+  m_schedulerFactory = schedulerFactory;
+  Ptr<Scheduler> scheduler = schedulerFactory.Create<Scheduler> ();
+  if (m_events != 0)
+    {
+      while (!m_events->IsEmpty ())
+        {
+          scheduler->Insert (m_events->RemoveNext ());
+        }
+    }
+  m_events = scheduler;
+  for (std::vector<struct Partition *>::iterator i = m_partitions.begin (); i != m_partitions.end (); ++i)
+    {
+      scheduler = schedulerFactory.Create<Scheduler> ();
+      while (!(*i)->events->IsEmpty ())
+        {
+          scheduler->Insert ((*i)->events->RemoveNext ());
+        }
+      (*i)->events = scheduler;
+    }
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetSystemId (void) const
+{
+  return g_partition != 0 ? g_partition->id : 0;
+}
+
+bool
+MultithreadedSimulatorImpl::IsFinished (void) const
+{
+  struct Partition *partition = g_partition;
+  if (partition != 0)
+    {
+      return partition->stop || (partition->events->IsEmpty () && partition->remote.empty ());
+    }
+  if (!m_events->IsEmpty ())
+    {
+      return false;
+    }
+  for (std::vector<struct Partition *>::const_iterator i = m_partitions.begin (); i != m_partitions.end (); ++i)
+    {
+      if (!(*i)->events->IsEmpty () || !(*i)->remote.empty ())
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
+bool
+MultithreadedSimulatorImpl::IsLater (const RemoteEvent &a, const RemoteEvent &b)
+{
+  if (a.ts != b.ts)
+    {
+      return a.ts > b.ts;
+    }
+  if (a.sendTs != b.sendTs)
+    {
+      return a.sendTs > b.sendTs;
+    }
+  if (a.source != b.source)
+    {
+      return a.source > b.source;
+    }
+  return a.seq > b.seq;
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetPartition (uint32_t context, uint32_t other) const
+{
+  return context < m_nodePartitions.size () ? m_nodePartitions[context] : other;
+}
+
+bool
+MultithreadedSimulatorImpl::IsBeforeStop (uint64_t ts, uint32_t uid) const
+{
+  // The events scheduled before Stop (delay) run at the stop time:
+  // they are all local, with a smaller uid.
+  return ts < m_stopTs || (ts == m_stopTs && uid < m_stopUid);
+}
+
+void
+MultithreadedSimulatorImpl::CalculateLookAhead (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_lookAhead = MAX_TS;
+  NodeContainer c = NodeContainer::GetGlobal ();
+  for (NodeContainer::Iterator iter = c.Begin (); iter != c.End (); ++iter)
+    {
+      for (uint32_t i = 0; i < (*iter)->GetNDevices (); ++i)
+        {
+          Ptr<NetDevice> localNetDevice = (*iter)->GetDevice (i);
+          // only works for p2p links currently
+          if (!localNetDevice->IsPointToPoint ())
+            {
+              continue;
+            }
+          Ptr<Channel> channel = localNetDevice->GetChannel ();
+          if (channel == 0)
+            {
+              continue;
+            }
+
+          // grab the adjacent node
+          Ptr<Node> remoteNode;
+          if (channel->GetDevice (0) == localNetDevice)
+            {
+              remoteNode = (channel->GetDevice (1))->GetNode ();
+            }
+          else
+            {
+              remoteNode = (channel->GetDevice (0))->GetNode ();
+            }
+
+          // if it's not remote, don't consider it
+          if (remoteNode->GetSystemId () == (*iter)->GetSystemId ())
+            {
+              continue;
+            }
+          NS_ABORT_MSG_IF (localNetDevice->GetObject<MpiReceiver> () == 0,
+                           "Node " << (*iter)->GetId () << " and node " << remoteNode->GetId ()
+                           << " belong to different systems: enable MpiInterface before the"
+                           " channel is created");
+
+          TimeValue delay;
+          channel->GetAttribute ("Delay", delay);
+          NS_ABORT_MSG_IF (!delay.Get ().IsStrictlyPositive (),
+                           "The channels between two systems need a positive delay");
+          m_lookAhead = std::min<uint64_t> (m_lookAhead, delay.Get ().GetTimeStep ());
+        }
+    }
+  NS_LOG_LOGIC ("lookahead " << m_lookAhead);
+}
+
+void
+MultithreadedSimulatorImpl::Distribute (void)
+{
+  NS_LOG_FUNCTION (this);
+  uint32_t nPartitions = m_partitions.size ();
+  m_nodePartitions.resize (NodeList::GetNNodes ());
+  for (NodeList::Iterator i = NodeList::Begin (); i != NodeList::End (); ++i)
+    {
+      uint32_t systemId = (*i)->GetSystemId ();
+      m_nodePartitions[(*i)->GetId ()] = systemId;
+      nPartitions = std::max (nPartitions, systemId + 1);
+    }
+  nPartitions = std::max (nPartitions, 1U);
+
+  while (m_partitions.size () < nPartitions)
+    {
+      struct Partition *partition = new struct Partition;
+      partition->id = m_partitions.size ();
+      partition->events = m_schedulerFactory.Create<Scheduler> ();
+      partition->uid = m_uid;
+      partition->currentTs = m_currentTs;
+      partition->currentUid = 0;
+      partition->currentContext = Simulator::NO_CONTEXT;
+      m_partitions.push_back (partition);
+    }
+  for (uint32_t i = 0; i < nPartitions; ++i)
+    {
+      struct Partition *partition = m_partitions[i];
+      partition->outbox.resize (nPartitions);
+      // The uids assigned during Run follow the uids assigned before.
+      partition->uid = std::max (partition->uid, m_uid);
+      partition->stop = false;
+      partition->stopped = false;
+    }
+
+  while (!m_events->IsEmpty ())
+    {
+      Scheduler::Event next = m_events->RemoveNext ();
+      m_partitions[GetPartition (next.key.m_context, 0)]->events->Insert (next);
+    }
+  m_firstUid = m_uid;
+
+  CalculateLookAhead ();
+  MultithreadedMpiInterface::CollectReceivers ();
+}
+
+void
+MultithreadedSimulatorImpl::Run (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT_MSG (g_partition == 0, "Simulator::Run called during Run");
+  Distribute ();
+  m_stopRequested = false;
+  m_running = true;
+
+  for (uint32_t i = 1; i < m_partitions.size (); ++i)
+    {
+      struct Partition *partition = m_partitions[i];
+      partition->thread = Create<SystemThread> (MakeBoundCallback (&MultithreadedSimulatorImpl::RunThread,
+                                                                   this, partition));
+      partition->thread->Start ();
+    }
+  RunPartition (m_partitions[0]);
+  for (uint32_t i = 1; i < m_partitions.size (); ++i)
+    {
+      m_partitions[i]->thread->Join ();
+      m_partitions[i]->thread = 0;
+    }
+  m_running = false;
+
+  bool stopped = false;
+  m_currentTs = 0;
+  for (std::vector<struct Partition *>::iterator i = m_partitions.begin (); i != m_partitions.end (); ++i)
+    {
+      stopped = stopped || (*i)->stop;
+      m_currentTs = std::max (m_currentTs, (*i)->currentTs);
+      m_uid = std::max (m_uid, (*i)->uid);
+    }
+  m_firstUid = m_uid;
+  if (!stopped && !m_stopRequested && m_stopTs != MAX_TS)
+    {
+      // As the sequential simulator, run the stop event.
+      m_currentTs = m_stopTs;
+      for (std::vector<struct Partition *>::iterator i = m_partitions.begin (); i != m_partitions.end (); ++i)
+        {
+          (*i)->currentTs = m_stopTs;
+          (*i)->currentUid = m_stopUid;
+        }
+      m_stopTs = MAX_TS;
+    }
+}
+
+void
+MultithreadedSimulatorImpl::RunThread (MultithreadedSimulatorImpl *impl, struct Partition *partition)
+{
+  impl->RunPartition (partition);
+}
+
+void
+MultithreadedSimulatorImpl::RunPartition (struct Partition *partition)
+{
+  NS_LOG_FUNCTION (this << partition->id);
+  g_partition = partition;
+  while (true)
+    {
+      ReceiveEvents (partition);
+      // The other threads read the published values until the next
+      // barrier, while this partition may already run the window: only
+      // the partition 0 reads the requests of the other threads.
+      partition->next = GetNextTs (partition);
+      partition->stopped = partition->stop || (partition->id == 0 && m_stopRequested);
+      Synchronize ();
+
+      uint64_t lbts = MAX_TS;
+      bool stop = false;
+      for (std::vector<struct Partition *>::const_iterator i = m_partitions.begin (); i != m_partitions.end (); ++i)
+        {
+          lbts = std::min (lbts, (*i)->next);
+          stop = stop || (*i)->stopped;
+        }
+      if (stop || lbts == MAX_TS)
+        {
+          break;
+        }
+      ProcessWindow (partition, lbts > MAX_TS - m_lookAhead ? MAX_TS : lbts + m_lookAhead);
+      Synchronize ();
+    }
+  g_partition = 0;
+}
+
+void
+MultithreadedSimulatorImpl::ReceiveEvents (struct Partition *partition)
+{
+  for (std::vector<struct Partition *>::iterator i = m_partitions.begin (); i != m_partitions.end (); ++i)
+    {
+      std::vector<RemoteEvent> &inbox = (*i)->outbox[partition->id];
+      for (std::vector<RemoteEvent>::iterator j = inbox.begin (); j != inbox.end (); ++j)
+        {
+          // All the uids assigned in the previous windows were assigned
+          // before the event was sent.
+          std::vector<std::pair<uint64_t, uint32_t> >::const_iterator mark =
+            std::upper_bound (partition->marks.begin (), partition->marks.end (),
+                              std::make_pair (j->sendTs, std::numeric_limits<uint32_t>::max ()));
+          j->uidBound = mark != partition->marks.end () ? mark->second : partition->uid;
+          partition->remote.push_back (*j);
+          std::push_heap (partition->remote.begin (), partition->remote.end (), &IsLater);
+        }
+      inbox.clear ();
+    }
+  partition->marks.clear ();
+}
+
+uint64_t
+MultithreadedSimulatorImpl::GetNextTs (const struct Partition *partition) const
+{
+  uint64_t ts = MAX_TS;
+  if (!partition->events->IsEmpty ())
+    {
+      Scheduler::Event next = partition->events->PeekNext ();
+      if (IsBeforeStop (next.key.m_ts, next.key.m_uid))
+        {
+          ts = next.key.m_ts;
+        }
+    }
+  if (!partition->remote.empty ())
+    {
+      const RemoteEvent &next = partition->remote.front ();
+      if (IsBeforeStop (next.ts, std::numeric_limits<uint32_t>::max ()))
+        {
+          ts = std::min (ts, next.ts);
+        }
+    }
+  return ts;
+}
+
+void
+MultithreadedSimulatorImpl::ProcessWindow (struct Partition *partition, uint64_t end)
+{
+  std::vector<RemoteEvent> &remote = partition->remote;
+  while (!partition->stop)
+    {
+      bool local;
+      Scheduler::Event next = Scheduler::Event ();
+      if (partition->events->IsEmpty ())
+        {
+          if (remote.empty ())
+            {
+              break;
+            }
+          local = false;
+        }
+      else
+        {
+          next = partition->events->PeekNext ();
+          local = remote.empty () || next.key.m_ts < remote.front ().ts
+            || (next.key.m_ts == remote.front ().ts && next.key.m_uid < remote.front ().uidBound);
+        }
+
+      uint64_t ts = local ? next.key.m_ts : remote.front ().ts;
+      if (ts >= end || !IsBeforeStop (ts, local ? next.key.m_uid : std::numeric_limits<uint32_t>::max ()))
+        {
+          break;
+        }
+      NS_ASSERT (ts >= partition->currentTs);
+      if (ts > partition->currentTs)
+        {
+          partition->marks.push_back (std::make_pair (ts, partition->uid));
+          partition->currentTs = ts;
+          partition->currentUid = 0;
+        }
+
+      EventImpl *impl;
+      if (local)
+        {
+          partition->events->RemoveNext ();
+          partition->currentUid = next.key.m_uid;
+          partition->currentContext = next.key.m_context;
+          impl = next.impl;
+        }
+      else
+        {
+          std::pop_heap (remote.begin (), remote.end (), &IsLater);
+          partition->currentContext = remote.back ().context;
+          impl = remote.back ().impl;
+          remote.pop_back ();
+        }
+      impl->Invoke ();
+      impl->Unref ();
+    }
+}
+
+void
+MultithreadedSimulatorImpl::Synchronize (void)
+{
+  uint32_t generation = m_barrierGeneration.load (std::memory_order_acquire);
+  if (m_barrierCount.fetch_add (1, std::memory_order_acq_rel) + 1 == m_partitions.size ())
+    {
+      m_barrierCount.store (0, std::memory_order_relaxed);
+      m_barrierGeneration.store (generation + 1, std::memory_order_release);
+      return;
+    }
+  uint32_t spins = 0;
+  while (m_barrierGeneration.load (std::memory_order_acquire) == generation)
+    {
+      if (++spins >= SPIN_COUNT)
+        {
+          sched_yield ();
+        }
+    }
+}
+
+void
+MultithreadedSimulatorImpl::Stop (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (g_partition != 0)
+    {
+      g_partition->stop = true;
+    }
+  else if (m_running)
+    {
+      m_stopRequested = true;
+    }
+}
+
+void
+MultithreadedSimulatorImpl::Stop (Time const &delay)
+{
+  NS_LOG_FUNCTION (this << delay.GetTimeStep ());
+  if (g_partition != 0)
+    {
+      Simulator::Schedule (delay, &Simulator::Stop);
+      return;
+    }
+  NS_ASSERT_MSG (!m_running, "Simulator::Stop called by a thread which runs no partition");
+  uint64_t ts = (delay + TimeStep (m_currentTs)).GetTimeStep ();
+  if (ts < m_stopTs)
+    {
+      m_stopTs = ts;
+      m_stopUid = m_uid;
+    }
+  m_uid++;
+}
+
+//
+// Schedule an event for a _relative_ time in the future.
+//
+EventId
+MultithreadedSimulatorImpl::Schedule (Time const &delay, EventImpl *event)
+{
+  NS_LOG_FUNCTION (this << delay.GetTimeStep () << event);
+  struct Partition *partition = g_partition;
+  NS_ASSERT_MSG (partition != 0 || !m_running, "Simulator::Schedule Thread-unsafe invocation!");
+
+  Scheduler::Event ev;
+  ev.impl = event;
+  if (partition != 0)
+    {
+      Time tAbsolute = delay + TimeStep (partition->currentTs);
+      NS_ASSERT (tAbsolute.IsPositive ());
+      NS_ASSERT (tAbsolute >= TimeStep (partition->currentTs));
+      ev.key.m_ts = (uint64_t) tAbsolute.GetTimeStep ();
+      ev.key.m_context = partition->currentContext;
+      ev.key.m_uid = partition->uid++;
+      partition->events->Insert (ev);
+    }
+  else
+    {
+      Time tAbsolute = delay + TimeStep (m_currentTs);
+      NS_ASSERT (tAbsolute.IsPositive ());
+      NS_ASSERT (tAbsolute >= TimeStep (m_currentTs));
+      ev.key.m_ts = (uint64_t) tAbsolute.GetTimeStep ();
+      ev.key.m_context = Simulator::NO_CONTEXT;
+      ev.key.m_uid = m_uid++;
+      m_events->Insert (ev);
+    }
+  return EventId (event, ev.key.m_ts, ev.key.m_context, ev.key.m_uid);
+}
+
+void
+MultithreadedSimulatorImpl::ScheduleWithContext (uint32_t context, Time const &delay, EventImpl *event)
+{
+  NS_LOG_FUNCTION (this << context << delay.GetTimeStep () << event);
+  struct Partition *partition = g_partition;
+  NS_ASSERT_MSG (partition != 0 || !m_running, "Simulator::ScheduleWithContext Thread-unsafe invocation!");
+
+  if (partition == 0)
+    {
+      Scheduler::Event ev;
+      ev.impl = event;
+      ev.key.m_ts = (uint64_t) (delay + TimeStep (m_currentTs)).GetTimeStep ();
+      ev.key.m_context = context;
+      ev.key.m_uid = m_uid++;
+      m_events->Insert (ev);
+      return;
+    }
+
+  uint64_t ts = (uint64_t) (delay + TimeStep (partition->currentTs)).GetTimeStep ();
+  uint32_t destination = GetPartition (context, partition->id);
+  if (destination == partition->id)
+    {
+      Scheduler::Event ev;
+      ev.impl = event;
+      ev.key.m_ts = ts;
+      ev.key.m_context = context;
+      ev.key.m_uid = partition->uid++;
+      partition->events->Insert (ev);
+      return;
+    }
+
+  NS_ABORT_MSG_IF ((uint64_t) delay.GetTimeStep () < m_lookAhead,
+                   "The delay of an event for another system (" << delay
+                   << ") is smaller than the lookahead (" << TimeStep (m_lookAhead) << ")");
+  std::vector<RemoteEvent> &outbox = partition->outbox[destination];
+  RemoteEvent ev;
+  ev.ts = ts;
+  ev.sendTs = partition->currentTs;
+  ev.source = partition->id;
+  ev.seq = outbox.size ();
+  ev.uidBound = 0;
+  ev.context = context;
+  ev.impl = event;
+  outbox.push_back (ev);
+}
+
+EventId
+MultithreadedSimulatorImpl::ScheduleNow (EventImpl *event)
+{
+  return Schedule (TimeStep (0), event);
+}
+
+EventId
+MultithreadedSimulatorImpl::ScheduleDestroy (EventImpl *event)
+{
+  EventId id (Ptr<EventImpl> (event, false), Now ().GetTimeStep (), 0xffffffff, 2);
+  CriticalSection cs (m_destroyEventsMutex);
+  m_destroyEvents.push_back (id);
+  return id;
+}
+
+Time
+MultithreadedSimulatorImpl::Now (void) const
+{
+  // Do not add function logging here, to avoid stack overflow
+  struct Partition *partition = g_partition;
+  return TimeStep (partition != 0 ? partition->currentTs : m_currentTs);
+}
+
+Time
+MultithreadedSimulatorImpl::GetDelayLeft (const EventId &id) const
+{
+  if (IsExpired (id))
+    {
+      return TimeStep (0);
+    }
+  else
+    {
+      return TimeStep (id.GetTs ()) - Now ();
+    }
+}
+
+void
+MultithreadedSimulatorImpl::Remove (const EventId &id)
+{
+  if (id.GetUid () == 2)
+    {
+      // destroy events.
+      CriticalSection cs (m_destroyEventsMutex);
+      for (DestroyEvents::iterator i = m_destroyEvents.begin (); i != m_destroyEvents.end (); i++)
+        {
+          if (*i == id)
+            {
+              m_destroyEvents.erase (i);
+              break;
+            }
+        }
+      return;
+    }
+  if (IsExpired (id))
+    {
+      return;
+    }
+  struct Partition *partition = g_partition;
+  NS_ASSERT_MSG (partition != 0 || !m_running, "Simulator::Remove Thread-unsafe invocation!");
+  Ptr<Scheduler> events;
+  if (partition != 0)
+    {
+      NS_ABORT_MSG_IF (GetPartition (id.GetContext (), partition->id) != partition->id,
+                       "Cannot remove an event of another system");
+      events = partition->events;
+    }
+  else if (id.GetUid () >= m_firstUid || m_partitions.empty ())
+    {
+      events = m_events;
+    }
+  else
+    {
+      events = m_partitions[GetPartition (id.GetContext (), 0)]->events;
+    }
+
+  Scheduler::Event event;
+  event.impl = id.PeekEventImpl ();
+  event.key.m_ts = id.GetTs ();
+  event.key.m_context = id.GetContext ();
+  event.key.m_uid = id.GetUid ();
+  events->Remove (event);
+  event.impl->Cancel ();
+  // whenever we remove an event from the event list, we have to unref it.
+  event.impl->Unref ();
+}
+
+void
+MultithreadedSimulatorImpl::Cancel (const EventId &id)
+{
+  if (!IsExpired (id))
+    {
+      id.PeekEventImpl ()->Cancel ();
+    }
+}
+
+bool
+MultithreadedSimulatorImpl::IsExpired (const EventId &id) const
+{
+  if (id.GetUid () == 2)
+    {
+      if (id.PeekEventImpl () == 0 ||
+          id.PeekEventImpl ()->IsCancelled ())
+        {
+          return true;
+        }
+      // destroy events.
+      CriticalSection cs (m_destroyEventsMutex);
+      for (DestroyEvents::const_iterator i = m_destroyEvents.begin (); i != m_destroyEvents.end (); i++)
+        {
+          if (*i == id)
+            {
+              return false;
+            }
+        }
+      return true;
+    }
+  struct Partition *partition = g_partition;
+  uint64_t currentTs = partition != 0 ? partition->currentTs : m_currentTs;
+  uint32_t currentUid = partition != 0 ? partition->currentUid : 0;
+  if (id.PeekEventImpl () == 0 ||
+      id.GetTs () < currentTs ||
+      (id.GetTs () == currentTs &&
+       id.GetUid () <= currentUid) ||
+      id.PeekEventImpl ()->IsCancelled ())
+    {
+      return true;
+    }
+  else
+    {
+      return false;
+    }
+}
+
+Time
+MultithreadedSimulatorImpl::GetMaximumSimulationTime (void) const
+{
+  return TimeStep (0x7fffffffffffffffLL);
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetContext (void) const
+{
+  struct Partition *partition = g_partition;
+  return partition != 0 ? partition->currentContext : Simulator::NO_CONTEXT;
+}
+
+} // namespace ns3
@@ -0,0 +1,249 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef NS3_MULTITHREADED_SIMULATOR_IMPL_H
+#define NS3_MULTITHREADED_SIMULATOR_IMPL_H
+
+#include "ns3/simulator-impl.h"
+#include "ns3/scheduler.h"
+#include "ns3/event-impl.h"
+#include "ns3/system-thread.h"
+#include "ns3/system-mutex.h"
+#include "ns3/ptr.h"
+
+#include <atomic>
+#include <list>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup mpi
+ *
+ * \brief Conservative parallel simulator running the systems in the
+ * threads of a single process
+ *
+ * The nodes are partitioned by their system id, as with
+ * DistributedSimulatorImpl, but each partition is run by a thread of
+ * this process instead of an MPI task: the thread calling Run runs the
+ * partition 0 and one thread is started for each other partition.
+ *
+ * The partitions synchronize with the granted time window algorithm.
+ * The lookahead is the smallest delay of the point-to-point channels
+ * between two partitions. The threads agree on the smallest timestamp
+ * of their next events, then each runs its events up to this timestamp
+ * plus the lookahead, hence a window never contains an event scheduled
+ * by another partition in the same window. An event scheduled with
+ * Simulator::ScheduleWithContext for a node of another partition is
+ * stored in a queue owned by the sending thread for the destination
+ * partition, which drains it after the next barrier: the queues need
+ * neither locks nor atomic operations.
+ *
+ * The events of a partition at the same timestamp run in the order of
+ * the sequential simulator: the local events and the events of the
+ * other partitions are merged by the time at which they were
+ * scheduled, and each partition records the first uid it assigned at
+ * each timestamp to compare its events to those of the other
+ * partitions. Events with the same timestamp that were scheduled at
+ * the same time by two partitions are the known exception: they run
+ * after the local ones, in the order of the partition that scheduled
+ * them, while the sequential simulator orders them by their uid. See
+ * the "Multithreaded Simulations" section of the documentation.
+ *
+ * A Stop (delay) before Run stops all the partitions exactly at the
+ * same point as the sequential simulator. A Stop during Run stops the
+ * calling partition immediately, the other partitions at the end of
+ * the window.
+ *
+ * The objects of a partition must only be used by its thread: the
+ * reference counts are not atomic. MpiInterface::Enable with this
+ * implementation selects MultithreadedMpiInterface, which copies the
+ * packets sent through PointToPointRemoteChannel.
+ */
+class MultithreadedSimulatorImpl : public SimulatorImpl
+{
+public:
+  /**
+   *  Register this type.
+   *  \return The object TypeId.
+   */
+  static TypeId GetTypeId (void);
+
+  /** Constructor. */
+  MultithreadedSimulatorImpl ();
+  /** Destructor. */
+  ~MultithreadedSimulatorImpl ();
+
+  // Inherited
+  virtual void Destroy ();
+  virtual bool IsFinished (void) const;
+  virtual void Stop (void);
+  virtual void Stop (const Time &delay);
+  virtual EventId Schedule (const Time &delay, EventImpl *event);
+  virtual void ScheduleWithContext (uint32_t context, const Time &delay, EventImpl *event);
+  virtual EventId ScheduleNow (EventImpl *event);
+  virtual EventId ScheduleDestroy (EventImpl *event);
+  virtual void Remove (const EventId &id);
+  virtual void Cancel (const EventId &id);
+  virtual bool IsExpired (const EventId &id) const;
+  virtual void Run (void);
+  virtual Time Now (void) const;
+  virtual Time GetDelayLeft (const EventId &id) const;
+  virtual Time GetMaximumSimulationTime (void) const;
+  virtual void SetScheduler (ObjectFactory schedulerFactory);
+  virtual uint32_t GetSystemId (void) const;
+  virtual uint32_t GetContext (void) const;
+
+private:
+  virtual void DoDispose (void);
+
+  /** An event scheduled by another partition. */
+  struct RemoteEvent
+  {
+    uint64_t ts;        //!< The timestamp of the event
+    uint64_t sendTs;    //!< The time at which the event was scheduled
+    uint32_t source;    //!< The partition which scheduled the event
+    uint32_t seq;       //!< The rank of the event in the queue of the source
+    /**
+     * The first uid the destination assigned at a time later than
+     * \c sendTs: the local events with a smaller uid and the same
+     * timestamp run first.
+     */
+    uint32_t uidBound;
+    uint32_t context;   //!< The context of the event
+    EventImpl *impl;    //!< The event
+  };
+
+  /** The state of a partition, only used by its thread during Run. */
+  struct Partition
+  {
+    uint32_t id;                            //!< The system id
+    Ptr<Scheduler> events;                  //!< The local events
+    std::vector<RemoteEvent> remote;        //!< The heap of the remote events
+    /** The events scheduled for each other partition in this window. */
+    std::vector<std::vector<RemoteEvent> > outbox;
+    /** The first uid assigned at each timestamp of this window. */
+    std::vector<std::pair<uint64_t, uint32_t> > marks;
+    uint32_t uid;                           //!< The next uid
+    uint64_t currentTs;                     //!< The current timestamp
+    uint32_t currentUid;                    //!< The uid of the current local event
+    uint32_t currentContext;                //!< The current context
+    uint64_t next;                          //!< The published timestamp of the next event
+    bool stop;                              //!< Whether Stop was called
+    bool stopped;                           //!< The published value of stop
+    Ptr<SystemThread> thread;               //!< The thread, 0 for the partition 0
+  };
+
+  /**
+   * Compare two remote events.
+   * \param [in] a The first event.
+   * \param [in] b The second event.
+   * \returns \c true if \p a runs after \p b.
+   */
+  static bool IsLater (const RemoteEvent &a, const RemoteEvent &b);
+  /**
+   * Get the partition of a context.
+   * \param [in] context The context.
+   * \param [in] other The partition of the contexts which are not nodes.
+   * \returns The partition running the context.
+   */
+  uint32_t GetPartition (uint32_t context, uint32_t other) const;
+  /**
+   * Check whether an event may run before the stop time.
+   * \param [in] ts The timestamp of the event.
+   * \param [in] uid The uid of a local event, 0xffffffff for a remote one.
+   * \returns \c true if the event may run.
+   */
+  bool IsBeforeStop (uint64_t ts, uint32_t uid) const;
+  /**
+   * Assign the nodes to the partitions, distribute the events scheduled
+   * since the last run and compute the lookahead.
+   */
+  void Distribute (void);
+  /** Compute the lookahead from the point-to-point channels. */
+  void CalculateLookAhead (void);
+  /**
+   * Run a partition in a thread started by Run.
+   * \param [in] impl The simulator.
+   * \param [in] partition The partition.
+   */
+  static void RunThread (MultithreadedSimulatorImpl *impl, struct Partition *partition);
+  /** Run a partition until all the partitions stop. \param [in] partition The partition. */
+  void RunPartition (struct Partition *partition);
+  /**
+   * Insert the events sent by the other partitions in the last window.
+   * \param [in] partition The partition.
+   */
+  void ReceiveEvents (struct Partition *partition);
+  /**
+   * Get the timestamp of the next event which may run.
+   * \param [in] partition The partition.
+   * \returns The timestamp, or the largest timestamp if there is none.
+   */
+  uint64_t GetNextTs (const struct Partition *partition) const;
+  /**
+   * Run the events of a window.
+   * \param [in] partition The partition.
+   * \param [in] end The end of the window, excluded.
+   */
+  void ProcessWindow (struct Partition *partition, uint64_t end);
+  /** Wait until all the partitions call this method. */
+  void Synchronize (void);
+
+  /** The partition run by the calling thread, 0 outside Run. */
+  static thread_local struct Partition *g_partition;
+
+  /** Container type for the events to run at Simulator::Destroy(). */
+  typedef std::list<EventId> DestroyEvents;
+  /** The events to run at Simulator::Destroy(). */
+  DestroyEvents m_destroyEvents;
+  /** Protect the events to run at Simulator::Destroy(). */
+  mutable SystemMutex m_destroyEventsMutex;
+
+  /** The factory of the schedulers. */
+  ObjectFactory m_schedulerFactory;
+  /** The events scheduled outside Run. */
+  Ptr<Scheduler> m_events;
+  /** The next uid outside Run. */
+  uint32_t m_uid;
+  /** The first uid of the events in m_events. */
+  uint32_t m_firstUid;
+  /** The timestamp outside Run. */
+  uint64_t m_currentTs;
+  /** The timestamp set by Stop (delay) outside Run. */
+  uint64_t m_stopTs;
+  /** The uid of the Stop (delay) outside Run. */
+  uint32_t m_stopUid;
+  /** Set by Stop from a thread which runs no partition. */
+  std::atomic<bool> m_stopRequested;
+  /** Whether Run is running. */
+  bool m_running;
+
+  /** The partitions. */
+  std::vector<struct Partition *> m_partitions;
+  /** The partition of each node. */
+  std::vector<uint32_t> m_nodePartitions;
+  /** The lookahead. */
+  uint64_t m_lookAhead;
+  /** The number of threads waiting at the barrier. */
+  std::atomic<uint32_t> m_barrierCount;
+  /** The number of times all the threads reached the barrier. */
+  std::atomic<uint32_t> m_barrierGeneration;
+};
+
+} // namespace ns3
+
+#endif /* NS3_MULTITHREADED_SIMULATOR_IMPL_H */
@@ -65,6 +65,14 @@ public:
    * \return number of parallel tasks
    */
   virtual uint32_t GetSize () = 0;
+  /**
+   * \param systemId a system identification
+   * \return true if the nodes of the system run in this process
+   */
+  virtual bool IsLocal (uint32_t systemId)
+  {
+    return systemId == GetSystemId ();
+  }
   /**
    * \return true if parallel communication is enabled
    */
@@ -50,16 +50,18 @@ namespace ns3 {
 NS_LOG_COMPONENT_DEFINE ("Buffer");
 
 
-uint32_t Buffer::g_recommendedStart = 0;
+NS_THREAD_LOCAL uint32_t Buffer::g_recommendedStart = 0;
 #ifdef BUFFER_FREE_LIST
-/* The following macros are pretty evil but they are needed to allow us to
+/* The free list and the heuristics are per thread, so that the threads
+ * of MultithreadedSimulatorImpl create and release buffers without locking.
+ * The following macros are pretty evil but they are needed to allow us to
  * keep track of 3 possible states for the g_freeList variable:
  *  - uninitialized means that no one has created a buffer yet
  *    so no one has created the associated free list (it is created
  *    on-demand when the first buffer is created)
  *  - initialized means that the free list exists and is valid
- *  - destroyed means that the static destructors of this compilation unit
- *    have run so, the free list has been cleared from its content
+ *  - destroyed means that the thread local destructors of this compilation
+ *    unit have run so, the free list has been cleared from its content
  * The key is that in destroyed state, we are careful not re-create it
  * which is a typical weakness of lazy evaluation schemes which use 
  * '0' as a special value to indicate both un-initialized and destroyed.
@@ -75,9 +77,9 @@ uint32_t Buffer::g_recommendedStart = 0;
 #define IS_INITIALIZED(x) (!IS_UNINITIALIZED (x) && !IS_DESTROYED (x))
 #define DESTROYED ((Buffer::FreeList*)MAGIC_DESTROYED)
 #define UNINITIALIZED ((Buffer::FreeList*)0)
-uint32_t Buffer::g_maxSize = 0;
-Buffer::FreeList *Buffer::g_freeList = 0;
-struct Buffer::LocalStaticDestructor Buffer::g_localStaticDestructor;
+NS_THREAD_LOCAL uint32_t Buffer::g_maxSize = 0;
+NS_THREAD_LOCAL Buffer::FreeList *Buffer::g_freeList = 0;
+NS_THREAD_LOCAL struct Buffer::LocalStaticDestructor Buffer::g_localStaticDestructor;
 
 Buffer::LocalStaticDestructor::~LocalStaticDestructor(void)
 {
@@ -94,12 +96,26 @@ Buffer::LocalStaticDestructor::~LocalStaticDestructor(void)
     }
 }
 
+void
+Buffer::InitializeFreeList (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  NS_ASSERT (IS_UNINITIALIZED (g_freeList));
+  g_freeList = new Buffer::FreeList ();
+  // Using the destructor of this thread registers it.
+  g_localStaticDestructor.Use ();
+}
+
 void
 Buffer::Recycle (struct Buffer::Data *data)
 {
   NS_LOG_FUNCTION (data);
   NS_ASSERT (data->m_count == 0);
-  NS_ASSERT (!IS_UNINITIALIZED (g_freeList));
+  if (IS_UNINITIALIZED (g_freeList))
+    {
+      // The buffer was created by another thread.
+      InitializeFreeList ();
+    }
   g_maxSize = std::max (g_maxSize, data->m_size);
   /* feed into free list */
   if (data->m_size < g_maxSize ||
@@ -122,7 +138,7 @@ Buffer::Create (uint32_t dataSize)
   /* try to find a buffer correctly sized. */
   if (IS_UNINITIALIZED (g_freeList))
     {
-      g_freeList = new Buffer::FreeList ();
+      InitializeFreeList ();
     }
   else if (IS_INITIALIZED (g_freeList))
     {
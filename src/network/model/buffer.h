@@ -24,6 +24,7 @@
 #include <vector>
 #include <ostream>
 #include "ns3/assert.h"
+#include "ns3/thread-local.h"
 
 #define BUFFER_FREE_LIST 1
 
@@ -766,7 +767,7 @@ private:
    * writing data. i.e., m_start should be initialized to this 
    * value.
    */
-  static uint32_t g_recommendedStart;
+  static NS_THREAD_LOCAL uint32_t g_recommendedStart;
 
   /**
    * offset to the start of the virtual zero area from the start
@@ -795,11 +796,15 @@ private:
   /// Local static destructor structure
   struct LocalStaticDestructor 
   {
+    /** Do nothing: used to construct the structure in the calling thread. */
+    void Use (void) {}
     ~LocalStaticDestructor ();
   };
-  static uint32_t g_maxSize; //!< Max observed data size
-  static FreeList *g_freeList; //!< Buffer data container
-  static struct LocalStaticDestructor g_localStaticDestructor; //!< Local static destructor
+  /** Create the free list of the calling thread. */
+  static void InitializeFreeList (void);
+  static NS_THREAD_LOCAL uint32_t g_maxSize; //!< Max observed data size
+  static NS_THREAD_LOCAL FreeList *g_freeList; //!< Buffer data container
+  static NS_THREAD_LOCAL struct LocalStaticDestructor g_localStaticDestructor; //!< Local static destructor
 #endif
 };
 
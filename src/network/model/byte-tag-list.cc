@@ -19,6 +19,7 @@
  */
 #include "byte-tag-list.h"
 #include "ns3/log.h"
+#include "ns3/thread-local.h"
 #include <vector>
 #include <cstring>
 
@@ -52,12 +53,21 @@ struct ByteTagListData {
  *
  * Internal use only.
  */
-static class ByteTagListDataFreeList : public std::vector<struct ByteTagListData *>
+class ByteTagListDataFreeList : public std::vector<struct ByteTagListData *>
 {
 public:
   ~ByteTagListDataFreeList ();
-} g_freeList; //!< Container for struct ByteTagListData
-static uint32_t g_maxSize = 0; //!< maximum data size (used for allocation)
+};
+
+/**
+ * Container for struct ByteTagListData, per thread. Every access to a
+ * thread local object with a destructor checks that it is constructed,
+ * hence it is only accessed through g_freeList.
+ */
+static NS_THREAD_LOCAL ByteTagListDataFreeList g_freeListStorage;
+static NS_THREAD_LOCAL ByteTagListDataFreeList *g_freeList = 0; //!< g_freeListStorage, once the thread uses it
+static NS_THREAD_LOCAL uint32_t g_maxSize = 0; //!< maximum data size (used for allocation)
+static NS_THREAD_LOCAL bool g_freeListDestroyed = false; //!< Set when g_freeList has been destroyed
 
 ByteTagListDataFreeList::~ByteTagListDataFreeList ()
 {
@@ -68,6 +78,23 @@ ByteTagListDataFreeList::~ByteTagListDataFreeList ()
       uint8_t *buffer = (uint8_t *)(*i);
       delete [] buffer;
     }
+  g_freeList = 0;
+  g_freeListDestroyed = true;
+}
+
+/**
+ * \brief Get the free list of the calling thread
+ * \returns the free list, or 0 if it has been destroyed
+ */
+static ByteTagListDataFreeList *
+GetFreeList (void)
+{
+  if (g_freeList == 0 && !g_freeListDestroyed)
+    {
+      // Constructs the free list of the thread and registers its destructor.
+      g_freeList = &g_freeListStorage;
+    }
+  return g_freeList;
 }
 #endif /* USE_FREE_LIST */
 
@@ -344,10 +371,11 @@ struct ByteTagListData *
 ByteTagList::Allocate (uint32_t size)
 {
   NS_LOG_FUNCTION (this << size);
-  while (!g_freeList.empty ())
+  ByteTagListDataFreeList *freeList = GetFreeList ();
+  while (freeList != 0 && !freeList->empty ())
     {
-      struct ByteTagListData *data = g_freeList.back ();
-      g_freeList.pop_back ();
+      struct ByteTagListData *data = freeList->back ();
+      freeList->pop_back ();
       NS_ASSERT (data != 0);
       if (data->size >= size)
         {
@@ -378,7 +406,9 @@ ByteTagList::Deallocate (struct ByteTagListData *data)
   data->count--;
   if (data->count == 0)
     {
-      if (g_freeList.size () > FREE_LIST_SIZE ||
+      ByteTagListDataFreeList *freeList = GetFreeList ();
+      if (freeList == 0 ||
+          freeList->size () > FREE_LIST_SIZE ||
           data->size < g_maxSize)
         {
           uint8_t *buffer = (uint8_t *)data;
@@ -386,7 +416,7 @@ ByteTagList::Deallocate (struct ByteTagListData *data)
         }
       else
         {
-          g_freeList.push_back (data);
+          freeList->push_back (data);
         }
     }
 }
@@ -281,4 +281,29 @@ NetDevice::~NetDevice ()
   NS_LOG_FUNCTION (this);
 }
 
+uint32_t
+NetDevice::SendBatch (const std::vector<TxItem> &items)
+{
+  NS_LOG_FUNCTION (this << items.size ());
+
+  Ptr<NetDeviceQueue> txq;
+  Ptr<NetDeviceQueueInterface> ndqi = GetObject<NetDeviceQueueInterface> ();
+  if (ndqi && ndqi->GetNTxQueues () > 0)
+    {
+      txq = ndqi->GetTxQueue (0);
+    }
+
+  uint32_t sent = 0;
+  for (std::vector<TxItem>::const_iterator it = items.begin (); it != items.end (); it++)
+    {
+      if (txq && txq->IsStopped ())
+        {
+          break;
+        }
+      Send (it->packet, it->dest, it->protocolNumber);
+      sent++;
+    }
+  return sent;
+}
+
 } // namespace ns3
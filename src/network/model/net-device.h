@@ -570,6 +570,31 @@ public:
    * \return whether the Send operation succeeded 
    */
   virtual bool SendFrom (Ptr<Packet> packet, const Address& source, const Address& dest, uint16_t protocolNumber) = 0;
+
+  /**
+   * \brief A packet to be sent by SendBatch, with the arguments of Send
+   */
+  struct TxItem
+  {
+    Ptr<Packet> packet;       //!< the packet
+    Address dest;             //!< mac address of the destination
+    uint16_t protocolNumber;  //!< type of payload contained in the packet
+  };
+
+  /**
+   * \param items the packets to send, in order
+   *
+   * Called by the traffic control layer to pass a batch of packets to a
+   * single-queue Network Device at once, like Linux does with xmit_more.
+   * The packets are taken in order as long as the transmission queue of the
+   * device is not stopped, and a packet that is taken is consumed by the
+   * device (possibly by dropping it), as with Send. The default
+   * implementation calls Send for each packet; devices can override it to
+   * take the whole batch in a single call.
+   *
+   * \return the number of packets taken by the device
+   */
+  virtual uint32_t SendBatch (const std::vector<TxItem> &items);
   /**
    * \returns the node base class which contains this network
    *          interface.
@@ -33,10 +33,12 @@ NS_LOG_COMPONENT_DEFINE ("PacketMetadata");
 
 bool PacketMetadata::m_enable = false;
 bool PacketMetadata::m_enableChecking = false;
-bool PacketMetadata::m_metadataSkipped = false;
-uint32_t PacketMetadata::m_maxSize = 0;
-uint16_t PacketMetadata::m_chunkUid = 0;
-PacketMetadata::DataFreeList PacketMetadata::m_freeList;
+NS_THREAD_LOCAL bool PacketMetadata::m_metadataSkipped = false;
+NS_THREAD_LOCAL uint32_t PacketMetadata::m_maxSize = 0;
+NS_THREAD_LOCAL uint16_t PacketMetadata::m_chunkUid = 0;
+NS_THREAD_LOCAL PacketMetadata::DataFreeList *PacketMetadata::m_freeList = 0;
+NS_THREAD_LOCAL PacketMetadata::DataFreeList PacketMetadata::m_freeListStorage;
+NS_THREAD_LOCAL bool PacketMetadata::m_freeListDestroyed = false;
 
 PacketMetadata::DataFreeList::~DataFreeList ()
 {
@@ -45,7 +47,8 @@ PacketMetadata::DataFreeList::~DataFreeList ()
     {
       PacketMetadata::Deallocate (*i);
     }
-  PacketMetadata::m_enable = false;
+  PacketMetadata::m_freeList = 0;
+  PacketMetadata::m_freeListDestroyed = true;
 }
 
 void 
@@ -576,10 +579,11 @@ PacketMetadata::Create (uint32_t size)
     {
       m_maxSize = size;
     }
-  while (!m_freeList.empty ()) 
+  DataFreeList *freeList = GetFreeList ();
+  while (freeList != 0 && !freeList->empty ())
     {
-      struct PacketMetadata::Data *data = m_freeList.back ();
-      m_freeList.pop_back ();
+      struct PacketMetadata::Data *data = freeList->back ();
+      freeList->pop_back ();
       if (data->m_size >= size) 
         {
           NS_LOG_LOGIC ("create found size="<<data->m_size);
@@ -597,22 +601,34 @@ void
 PacketMetadata::Recycle (struct PacketMetadata::Data *data)
 {
   NS_LOG_FUNCTION (data);
-  if (!m_enable)
+  if (!m_enable || m_freeListDestroyed)
     {
       PacketMetadata::Deallocate (data);
       return;
     } 
-  NS_LOG_LOGIC ("recycle size="<<data->m_size<<", list="<<m_freeList.size ());
+  DataFreeList *freeList = GetFreeList ();
+  NS_LOG_LOGIC ("recycle size="<<data->m_size<<", list="<<freeList->size ());
   NS_ASSERT (data->m_count == 0);
-  if (m_freeList.size () > 1000 ||
+  if (freeList->size () > 1000 ||
       data->m_size < m_maxSize) 
     {
       PacketMetadata::Deallocate (data);
     } 
   else 
     {
-      m_freeList.push_back (data);
+      freeList->push_back (data);
+    }
+}
+
+PacketMetadata::DataFreeList *
+PacketMetadata::GetFreeList (void)
+{
+  if (m_freeList == 0 && !m_freeListDestroyed)
+    {
+      // Constructs the free list of the thread and registers its destructor.
+      m_freeList = &m_freeListStorage;
     }
+  return m_freeList;
 }
 
 struct PacketMetadata::Data *
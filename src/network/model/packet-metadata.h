@@ -26,6 +26,7 @@
 #include "ns3/callback.h"
 #include "ns3/assert.h"
 #include "ns3/type-id.h"
+#include "ns3/thread-local.h"
 #include "buffer.h"
 
 namespace ns3 {
@@ -655,8 +656,27 @@ public:
    * \param data the buffer data storage
    */
   static void Deallocate (struct PacketMetadata::Data *data);
+  /**
+   * \brief Get the free list of the calling thread
+   * \returns the free list, or 0 if it has been destroyed
+   */
+  static DataFreeList *GetFreeList (void);
 
-  static DataFreeList m_freeList; //!< the metadata data storage
+  /**
+   * The metadata data storage of the thread, 0 until the thread uses it.
+   * The free list and the size and uid counters below are per thread,
+   * so that the threads of MultithreadedSimulatorImpl handle packets
+   * without locking.
+   */
+  static NS_THREAD_LOCAL DataFreeList *m_freeList;
+  /**
+   * The free list pointed to by m_freeList. Every access to a thread
+   * local object with a destructor checks that it is constructed, hence
+   * it is only accessed once per thread, by GetFreeList.
+   */
+  static NS_THREAD_LOCAL DataFreeList m_freeListStorage;
+  /** Set when the free list of the thread has been destroyed. */
+  static NS_THREAD_LOCAL bool m_freeListDestroyed;
   static bool m_enable; //!< Enable the packet metadata
   static bool m_enableChecking; //!< Enable the packet metadata checking
 
@@ -665,10 +685,10 @@ public:
    * m_enable is false; used to detect enabling of metadata in the
    * middle of a simulation, which isn't allowed.
    */
-  static bool m_metadataSkipped;
+  static NS_THREAD_LOCAL bool m_metadataSkipped;
 
-  static uint32_t m_maxSize; //!< maximum metadata size
-  static uint16_t m_chunkUid; //!< Chunk Uid
+  static NS_THREAD_LOCAL uint32_t m_maxSize; //!< maximum metadata size
+  static NS_THREAD_LOCAL uint16_t m_chunkUid; //!< Chunk Uid
 
   struct Data *m_data; //!< Metadata storage
   /*
@@ -34,6 +34,7 @@
 #include "ns3/assert.h"
 #include "ns3/ptr.h"
 #include "ns3/deprecated.h"
+#include "ns3/thread-local.h"
 
 namespace ns3 {
 
@@ -727,7 +728,7 @@ private:
   /* Please see comments above about nix-vector */
   Ptr<NixVector> m_nixVector; //!< the packet's Nix vector
 
-  static uint32_t m_globalUid; //!< Global counter of packets Uid
+  static NS_THREAD_LOCAL uint32_t m_globalUid; //!< Counter of packets Uid, per thread
 };
 
 /**
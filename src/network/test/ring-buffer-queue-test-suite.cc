@@ -0,0 +1,126 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/ring-buffer-queue.h"
+#include "ns3/uinteger.h"
+#include "ns3/enum.h"
+
+using namespace ns3;
+
+class RingBufferQueueTestCase : public TestCase
+{
+public:
+  RingBufferQueueTestCase ();
+  virtual void DoRun (void);
+private:
+  /**
+   * Count the packets reported by a trace source
+   * \param count the counter to increment
+   * \param p the packet
+   */
+  static void Count (uint32_t *count, Ptr<const Packet> p);
+};
+
+RingBufferQueueTestCase::RingBufferQueueTestCase ()
+  : TestCase ("Sanity check on the ring buffer queue implementation")
+{
+}
+
+void
+RingBufferQueueTestCase::Count (uint32_t *count, Ptr<const Packet> p)
+{
+  (*count)++;
+}
+
+void
+RingBufferQueueTestCase::DoRun (void)
+{
+  Ptr<RingBufferQueue> queue = CreateObject<RingBufferQueue> ();
+  NS_TEST_EXPECT_MSG_EQ (queue->SetAttributeFailSafe ("MaxPackets", UintegerValue (3)), true,
+                         "Verify that we can actually set the attribute");
+  queue->SetCapacity (3);
+  NS_TEST_EXPECT_MSG_EQ (queue->GetCapacity (), 4, "The capacity should be rounded up to a power of two");
+
+  uint32_t enqueued = 0;
+  uint32_t dequeued = 0;
+  uint32_t dropped = 0;
+  queue->TraceConnectWithoutContext ("Enqueue", MakeBoundCallback (&RingBufferQueueTestCase::Count, &enqueued));
+  queue->TraceConnectWithoutContext ("Dequeue", MakeBoundCallback (&RingBufferQueueTestCase::Count, &dequeued));
+  queue->TraceConnectWithoutContext ("Drop", MakeBoundCallback (&RingBufferQueueTestCase::Count, &dropped));
+
+  // go around the ring several times, checking the FIFO order and the drops
+  std::vector<Ptr<Packet> > packets;
+  uint32_t next = 0;
+  for (uint32_t round = 0; round < 5; round++)
+    {
+      for (uint32_t i = 0; i < 4; i++)
+        {
+          packets.push_back (Create<Packet> (100));
+          queue->Enqueue (Create<QueueItem> (packets.back ()));
+        }
+      NS_TEST_EXPECT_MSG_EQ (queue->GetNPackets (), 3, "The fourth packet should be dropped");
+      NS_TEST_EXPECT_MSG_EQ (queue->Peek ()->GetPacket ()->GetUid (), packets[next]->GetUid (),
+                             "The head of the queue should be the oldest packet");
+      for (uint32_t i = 0; i < 3; i++, next++)
+        {
+          Ptr<QueueItem> item = queue->Dequeue ();
+          NS_TEST_EXPECT_MSG_EQ ((item != 0), true, "There should be a packet to dequeue");
+          NS_TEST_EXPECT_MSG_EQ (item->GetPacket ()->GetUid (), packets[next]->GetUid (),
+                                 "The packets should be dequeued in FIFO order");
+        }
+      next++;  // the dropped one
+      NS_TEST_EXPECT_MSG_EQ ((queue->Dequeue () == 0), true, "There should be no packets in there");
+    }
+  NS_TEST_EXPECT_MSG_EQ (enqueued, 15, "Wrong number of enqueue traces");
+  NS_TEST_EXPECT_MSG_EQ (dequeued, 15, "Wrong number of dequeue traces");
+  NS_TEST_EXPECT_MSG_EQ (dropped, 5, "Wrong number of drop traces");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetCapacity (), 4, "The ring buffer should not grow in packet mode");
+
+  // in byte mode, small packets make the ring buffer grow without
+  // changing the order of the packets
+  queue = CreateObject<RingBufferQueue> ();
+  queue->SetAttribute ("Mode", EnumValue (Queue::QUEUE_MODE_BYTES));
+  queue->SetAttribute ("MaxBytes", UintegerValue (1000));
+  queue->SetCapacity (2);
+  packets.clear ();
+  queue->Enqueue (Create<QueueItem> (Create<Packet> (100)));
+  queue->Dequeue ();
+  for (uint32_t i = 0; i < 10; i++)
+    {
+      packets.push_back (Create<Packet> (100));
+      queue->Enqueue (Create<QueueItem> (packets.back ()));
+    }
+  NS_TEST_EXPECT_MSG_EQ (queue->GetNPackets (), 10, "All the packets should fit in the byte limit");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetCapacity (), 16, "The ring buffer should have grown");
+  queue->Remove ();
+  for (uint32_t i = 1; i < 10; i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (queue->Dequeue ()->GetPacket ()->GetUid (), packets[i]->GetUid (),
+                             "The packets should be dequeued in FIFO order");
+    }
+  NS_TEST_EXPECT_MSG_EQ (queue->GetNBytes (), 0, "There should be no bytes in there");
+}
+
+static class RingBufferQueueTestSuite : public TestSuite
+{
+public:
+  RingBufferQueueTestSuite ()
+    : TestSuite ("ring-buffer-queue", UNIT)
+  {
+    AddTestCase (new RingBufferQueueTestCase (), TestCase::QUICK);
+  }
+} g_ringBufferQueueTestSuite;
@@ -0,0 +1,167 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/log.h"
+#include "ns3/uinteger.h"
+#include "ring-buffer-queue.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("RingBufferQueue");
+
+NS_OBJECT_ENSURE_REGISTERED (RingBufferQueue);
+
+TypeId RingBufferQueue::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::RingBufferQueue")
+    .SetParent<Queue> ()
+    .SetGroupName ("Network")
+    .AddConstructor<RingBufferQueue> ()
+    .AddAttribute ("Capacity",
+                   "The number of items the ring buffer can hold without growing (rounded up to a power of two)",
+                   UintegerValue (16),
+                   MakeUintegerAccessor (&RingBufferQueue::SetCapacity,
+                                         &RingBufferQueue::GetCapacity),
+                   MakeUintegerChecker<uint32_t> (1))
+  ;
+  return tid;
+}
+
+RingBufferQueue::RingBufferQueue () :
+  Queue (),
+  m_ring (),
+  m_head (0),
+  m_count (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+RingBufferQueue::~RingBufferQueue ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+RingBufferQueue::SetCapacity (uint32_t capacity)
+{
+  NS_LOG_FUNCTION (this << capacity);
+
+  if (capacity < m_count)
+    {
+      capacity = m_count;
+    }
+
+  uint32_t size = 1;
+  while (size < capacity && size < (1u << 31))
+    {
+      size <<= 1;
+    }
+
+  if (size != m_ring.size ())
+    {
+      Resize (size);
+    }
+}
+
+uint32_t
+RingBufferQueue::GetCapacity (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_ring.size ();
+}
+
+void
+RingBufferQueue::Resize (uint32_t capacity)
+{
+  NS_LOG_FUNCTION (this << capacity);
+  NS_ASSERT (capacity >= m_count && (capacity & (capacity - 1)) == 0);
+
+  std::vector<Ptr<QueueItem> > ring (capacity);
+  uint32_t mask = m_ring.size () - 1;
+  for (uint32_t i = 0; i < m_count; i++)
+    {
+      ring[i] = m_ring[(m_head + i) & mask];
+    }
+  m_ring.swap (ring);
+  m_head = 0;
+}
+
+bool
+RingBufferQueue::DoEnqueue (Ptr<QueueItem> item)
+{
+  NS_LOG_FUNCTION (this << item);
+  NS_ASSERT (m_count == GetNPackets ());
+
+  if (m_count == m_ring.size ())
+    {
+      NS_LOG_LOGIC ("Ring buffer full, growing to " << 2 * m_ring.size () << " items");
+      Resize (2 * m_ring.size ());
+    }
+
+  m_ring[(m_head + m_count) & (m_ring.size () - 1)] = item;
+  m_count++;
+
+  return true;
+}
+
+Ptr<QueueItem>
+RingBufferQueue::PopHead (void)
+{
+  // release the reference held by the slot, so that the ring buffer does
+  // not keep the item alive
+  Ptr<QueueItem> item = m_ring[m_head];
+  m_ring[m_head] = 0;
+  m_head = (m_head + 1) & (m_ring.size () - 1);
+  m_count--;
+  return item;
+}
+
+Ptr<QueueItem>
+RingBufferQueue::DoDequeue (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (m_count == GetNPackets () && m_count > 0);
+
+  Ptr<QueueItem> item = PopHead ();
+
+  NS_LOG_LOGIC ("Popped " << item);
+
+  return item;
+}
+
+Ptr<QueueItem>
+RingBufferQueue::DoRemove (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (m_count == GetNPackets () && m_count > 0);
+
+  Ptr<QueueItem> item = PopHead ();
+
+  NS_LOG_LOGIC ("Removed " << item);
+
+  return item;
+}
+
+Ptr<const QueueItem>
+RingBufferQueue::DoPeek (void) const
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (m_count == GetNPackets () && m_count > 0);
+
+  return m_ring[m_head];
+}
+
+} // namespace ns3
@@ -0,0 +1,95 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef RING_BUFFER_QUEUE_H
+#define RING_BUFFER_QUEUE_H
+
+#include <vector>
+#include "ns3/queue.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup queue
+ *
+ * \brief A FIFO packet queue that drops tail-end packets on overflow,
+ * stored in a ring buffer
+ *
+ * The behavior is the same as that of DropTailQueue, but the items are
+ * kept in a circular array whose capacity (a power of two) is set with
+ * SetCapacity, usually from the limit of the queue. Once the capacity is
+ * large enough, enqueue and dequeue do not allocate memory. If an item
+ * does not fit, e.g., in byte mode with packets smaller than expected,
+ * the capacity is doubled.
+ */
+class RingBufferQueue : public Queue
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  /**
+   * \brief RingBufferQueue Constructor
+   */
+  RingBufferQueue ();
+
+  virtual ~RingBufferQueue ();
+
+  /**
+   * \brief Set the number of items the ring buffer can hold without growing
+   *
+   * The capacity is rounded up to a power of two and is never less than
+   * the number of items in the queue.
+   *
+   * \param capacity the requested capacity in items
+   */
+  void SetCapacity (uint32_t capacity);
+
+  /**
+   * \brief Get the number of items the ring buffer can hold without growing
+   *
+   * \return the capacity in items
+   */
+  uint32_t GetCapacity (void) const;
+
+private:
+  virtual bool DoEnqueue (Ptr<QueueItem> item);
+  virtual Ptr<QueueItem> DoDequeue (void);
+  virtual Ptr<QueueItem> DoRemove (void);
+  virtual Ptr<const QueueItem> DoPeek (void) const;
+
+  /**
+   * \brief Move the items to a ring buffer of the given capacity
+   * \param capacity the new capacity, a power of two not less than the number of items
+   */
+  void Resize (uint32_t capacity);
+
+  /**
+   * \brief Remove the item at the head of the ring buffer
+   * \return the removed item
+   */
+  Ptr<QueueItem> PopHead (void);
+
+  std::vector<Ptr<QueueItem> > m_ring; //!< the circular array of items
+  uint32_t m_head;                     //!< index of the first item
+  uint32_t m_count;                    //!< number of items in the ring buffer
+};
+
+} // namespace ns3
+
+#endif /* RING_BUFFER_QUEUE_H */
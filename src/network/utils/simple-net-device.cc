@@ -208,13 +208,19 @@ SimpleNetDevice::GetTypeId (void)
     .AddAttribute ("DataRate",
                    "The default data rate for point to point links. Zero means infinite",
                    DataRateValue (DataRate ("0b/s")),
-                   MakeDataRateAccessor (&SimpleNetDevice::m_bps),
+                   MakeDataRateAccessor (&SimpleNetDevice::SetDataRate,
+                                         &SimpleNetDevice::GetDataRate),
                    MakeDataRateChecker ())
     .AddTraceSource ("PhyRxDrop",
                      "Trace source indicating a packet has been dropped "
                      "by the device during reception",
                      MakeTraceSourceAccessor (&SimpleNetDevice::m_phyRxDropTrace),
                      "ns3::Packet::TracedCallback")
+    .AddTraceSource ("DataRateChange",
+                     "Trace source indicating that the data rate of the "
+                     "device has changed",
+                     MakeTraceSourceAccessor (&SimpleNetDevice::m_dataRateTrace),
+                     "ns3::SimpleNetDevice::DataRateTracedCallback")
   ;
   return tid;
 }
@@ -301,6 +307,21 @@ SimpleNetDevice::SetReceiveErrorModel (Ptr<ErrorModel> em)
   m_receiveErrorModel = em;
 }
 
+void
+SimpleNetDevice::SetDataRate (DataRate bps)
+{
+  NS_LOG_FUNCTION (this << bps);
+  m_bps = bps;
+  m_dataRateTrace (bps);
+}
+
+DataRate
+SimpleNetDevice::GetDataRate (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_bps;
+}
+
 void 
 SimpleNetDevice::SetIfIndex (const uint32_t index)
 {
@@ -108,6 +108,27 @@ public:
    */
   void SetReceiveErrorModel (Ptr<ErrorModel> em);
 
+  /**
+   * Set the Data Rate used for transmission of packets.
+   *
+   * \param bps the data rate at which this object operates (zero means infinite)
+   */
+  void SetDataRate (DataRate bps);
+
+  /**
+   * Get the Data Rate used for transmission of packets.
+   *
+   * \returns the data rate at which this object operates
+   */
+  DataRate GetDataRate (void) const;
+
+  /**
+   * TracedCallback signature for data rate changes.
+   *
+   * \param [in] bps The new data rate.
+   */
+  typedef void (* DataRateTracedCallback) (DataRate bps);
+
   // inherited from NetDevice base class.
   virtual void SetIfIndex (const uint32_t index);
   virtual uint32_t GetIfIndex (void) const;
@@ -158,6 +179,13 @@ private:
    */
   TracedCallback<Ptr<const Packet> > m_phyRxDropTrace;
 
+  /**
+   * The trace source fired when the data rate of the device is changed.
+   *
+   * \see class CallBackTraceSource
+   */
+  TracedCallback<DataRate> m_dataRateTrace;
+
   /**
    * The TransmitComplete method is used internally to finish the process
    * of sending a packet out on the channel.
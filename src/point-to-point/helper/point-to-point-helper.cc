@@ -237,8 +237,9 @@ PointToPointHelper::Install (Ptr<Node> a, Ptr<Node> b)
   Ptr<Queue> queueB = m_queueFactory.Create<Queue> ();
   devB->SetQueue (queueB);
   // If MPI is enabled, we need to see if both nodes have the same system id 
-  // (rank), and the rank is the same as this instance.  If both are true, 
-  //use a normal p2p channel, otherwise use a remote channel
+  // (rank or thread).  If true, use a normal p2p channel, otherwise use a
+  // remote channel.  The nodes of another rank do not run in this instance,
+  // hence a channel between two of them is never used.
   bool useNormalChannel = true;
   Ptr<PointToPointChannel> channel = 0;
 
@@ -246,8 +247,7 @@ PointToPointHelper::Install (Ptr<Node> a, Ptr<Node> b)
     {
       uint32_t n1SystemId = a->GetSystemId ();
       uint32_t n2SystemId = b->GetSystemId ();
-      uint32_t currSystemId = MpiInterface::GetSystemId ();
-      if (n1SystemId != currSystemId || n2SystemId != currSystemId) 
+      if (n1SystemId != n2SystemId) 
         {
           useNormalChannel = false;
         }
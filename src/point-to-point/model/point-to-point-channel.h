@@ -69,7 +69,7 @@ public:
    * \brief Attach a given netdevice to this channel
    * \param device pointer to the netdevice to attach to the channel
    */
-  void Attach (Ptr<PointToPointNetDevice> device);
+  virtual void Attach (Ptr<PointToPointNetDevice> device);
 
   /**
    * \brief Transmit a packet over this channel
@@ -93,6 +93,18 @@ public:
    */
   Ptr<PointToPointNetDevice> GetPointToPointDevice (uint32_t i) const;
 
+  /**
+   * \brief Get PointToPointNetDevice corresponding to index i on this
+   * channel, without taking a reference on it
+   *
+   * With MultithreadedSimulatorImpl, the device may belong to another
+   * thread, which updates its reference count concurrently.
+   *
+   * \param i Index number of the device requested
+   * \returns PointToPointNetDevice requested
+   */
+  const PointToPointNetDevice *PeekPointToPointDevice (uint32_t i) const;
+
   /**
    * \brief Get NetDevice corresponding to index i on this channel
    * \param i Index number of the device requested
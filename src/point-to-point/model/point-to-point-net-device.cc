@@ -55,7 +55,8 @@ PointToPointNetDevice::GetTypeId (void)
     .AddAttribute ("DataRate", 
                    "The default data rate for point to point links",
                    DataRateValue (DataRate ("32768b/s")),
-                   MakeDataRateAccessor (&PointToPointNetDevice::m_bps),
+                   MakeDataRateAccessor (&PointToPointNetDevice::SetDataRate,
+                                         &PointToPointNetDevice::GetDataRate),
                    MakeDataRateChecker ())
     .AddAttribute ("ReceiveErrorModel", 
                    "The receiver error model used to simulate packet loss",
@@ -167,6 +168,16 @@ PointToPointNetDevice::GetTypeId (void)
                      "attached to the device",
                      MakeTraceSourceAccessor (&PointToPointNetDevice::m_promiscSnifferTrace),
                      "ns3::Packet::TracedCallback")
+
+    //
+    // Trace source fired when the data rate changes, so that the users of
+    // the device (e.g., queue discs) can follow the link capacity.
+    //
+    .AddTraceSource ("DataRateChange",
+                     "Trace source indicating that the data rate of the "
+                     "device has changed",
+                     MakeTraceSourceAccessor (&PointToPointNetDevice::m_dataRateTrace),
+                     "ns3::PointToPointNetDevice::DataRateTracedCallback")
   ;
   return tid;
 }
@@ -241,6 +252,14 @@ PointToPointNetDevice::SetDataRate (DataRate bps)
 {
   NS_LOG_FUNCTION (this);
   m_bps = bps;
+  m_dataRateTrace (bps);
+}
+
+DataRate
+PointToPointNetDevice::GetDataRate (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_bps;
 }
 
 void
@@ -583,6 +602,47 @@ PointToPointNetDevice::Send (
       return false;
     }
 
+  return DoSend (packet, protocolNumber, txq);
+}
+
+uint32_t
+PointToPointNetDevice::SendBatch (const std::vector<TxItem> &items)
+{
+  NS_LOG_FUNCTION (this << items.size ());
+
+  Ptr<NetDeviceQueue> txq;
+  if (m_queueInterface)
+    {
+      txq = m_queueInterface->GetTxQueue (0);
+    }
+
+  uint32_t sent = 0;
+  for (std::vector<TxItem>::const_iterator it = items.begin (); it != items.end (); it++)
+    {
+      // the remaining packets are left to the caller once the queue is stopped
+      if (txq && txq->IsStopped ())
+        {
+          break;
+        }
+
+      if (IsLinkUp () == false)
+        {
+          m_macTxDropTrace (it->packet);
+        }
+      else
+        {
+          DoSend (it->packet, it->protocolNumber, txq);
+        }
+      sent++;
+    }
+  return sent;
+}
+
+bool
+PointToPointNetDevice::DoSend (Ptr<Packet> packet, uint16_t protocolNumber, Ptr<NetDeviceQueue> txq)
+{
+  NS_LOG_FUNCTION (this << packet << protocolNumber << txq);
+
   //
   // Stick a point to point protocol header on the packet in preparation for
   // shoving it out the door.
@@ -725,7 +785,8 @@ PointToPointNetDevice::GetRemote (void) const
   NS_ASSERT (m_channel->GetNDevices () == 2);
   for (uint32_t i = 0; i < m_channel->GetNDevices (); ++i)
     {
-      Ptr<NetDevice> tmp = m_channel->GetDevice (i);
+      // The remote device may belong to another thread.
+      const PointToPointNetDevice *tmp = m_channel->PeekPointToPointDevice (i);
       if (tmp != this)
         {
           return tmp->GetAddress ();
@@ -94,6 +94,20 @@ public:
    */
   void SetDataRate (DataRate bps);
 
+  /**
+   * Get the Data Rate used for transmission of packets.
+   *
+   * \returns the data rate at which this object operates
+   */
+  DataRate GetDataRate (void) const;
+
+  /**
+   * TracedCallback signature for data rate changes.
+   *
+   * \param [in] bps The new data rate.
+   */
+  typedef void (* DataRateTracedCallback) (DataRate bps);
+
   /**
    * Set the interframe gap used to separate packets.  The interframe gap
    * defines the minimum space required between packets sent by this device.
@@ -177,6 +191,7 @@ public:
 
   virtual bool Send (Ptr<Packet> packet, const Address &dest, uint16_t protocolNumber);
   virtual bool SendFrom (Ptr<Packet> packet, const Address& source, const Address& dest, uint16_t protocolNumber);
+  virtual uint32_t SendBatch (const std::vector<TxItem> &items);
 
   virtual Ptr<Node> GetNode (void) const;
   virtual void SetNode (Ptr<Node> node);
@@ -269,6 +284,18 @@ private:
    */
   bool TransmitStart (Ptr<Packet> p);
 
+  /**
+   * Enqueue a packet in the device queue and start transmitting it if the
+   * channel is ready. Used by Send and SendBatch once the link state has
+   * been checked.
+   *
+   * \param packet the packet to send
+   * \param protocolNumber the protocol number of the payload
+   * \param txq the transmission queue of the device, if any
+   * \returns true if the packet was enqueued or transmitted
+   */
+  bool DoSend (Ptr<Packet> packet, uint16_t protocolNumber, Ptr<NetDeviceQueue> txq);
+
   /**
    * Stop Sending a Packet Down the Wire and Begin the Interframe Gap.
    *
@@ -436,6 +463,13 @@ private:
    */
   TracedCallback<Ptr<const Packet> > m_promiscSnifferTrace;
 
+  /**
+   * The trace source fired when the data rate of the device is changed.
+   *
+   * \see class CallBackTraceSource
+   */
+  TracedCallback<DataRate> m_dataRateTrace;
+
   Ptr<Node> m_node;         //!< Node owning this NetDevice
   Ptr<NetDeviceQueueInterface> m_queueInterface;   //!< NetDevice queue interface
   Mac48Address m_address;   //!< Mac48Address of this NetDevice
@@ -24,6 +24,7 @@
 #include "point-to-point-net-device.h"
 #include "ns3/packet.h"
 #include "ns3/simulator.h"
+#include "ns3/node.h"
 #include "ns3/log.h"
 #include "ns3/mpi-interface.h"
 
@@ -53,6 +54,18 @@ PointToPointRemoteChannel::~PointToPointRemoteChannel ()
 {
 }
 
+void
+PointToPointRemoteChannel::Attach (Ptr<PointToPointNetDevice> device)
+{
+  NS_LOG_FUNCTION (this << device);
+  NS_ASSERT_MSG (device->GetNode () != 0, "The device must be added to a node before it is attached");
+  uint32_t i = GetNDevices ();
+  PointToPointChannel::Attach (device);
+  m_ends[i].device = PeekPointer (device);
+  m_ends[i].node = device->GetNode ()->GetId ();
+  m_ends[i].ifIndex = device->GetIfIndex ();
+}
+
 bool
 PointToPointRemoteChannel::TransmitStart (
   Ptr<Packet> p,
@@ -64,16 +77,13 @@ PointToPointRemoteChannel::TransmitStart (
 
   IsInitialized ();
 
-  uint32_t wire = src == GetSource (0) ? 0 : 1;
-  Ptr<PointToPointNetDevice> dst = GetDestination (wire);
+  // The destination device may belong to another thread: do not
+  // take a reference on it.
+  const End &dst = m_ends[PeekPointer (src) == m_ends[0].device ? 1 : 0];
 
-#ifdef NS3_MPI
   // Calculate the rxTime (absolute)
   Time rxTime = Simulator::Now () + txTime + GetDelay ();
-  MpiInterface::SendPacket (p, rxTime, dst->GetNode ()->GetId (), dst->GetIfIndex ());
-#else
-  NS_FATAL_ERROR ("Can't use distributed simulator without MPI compiled in");
-#endif
+  MpiInterface::SendPacket (p, rxTime, dst.node, dst.ifIndex);
   return true;
 }
 
@@ -20,7 +20,8 @@
 
 // This object connects two point-to-point net devices where at least one
 // is not local to this simulator object.  It simply over-rides the transmit
-// method and uses an MPI Send operation instead.
+// method and uses an MPI Send operation instead.  With the multithreaded
+// simulator, the two devices belong to two threads of the same process.
 
 #ifndef POINT_TO_POINT_REMOTE_CHANNEL_H
 #define POINT_TO_POINT_REMOTE_CHANNEL_H
@@ -37,6 +38,12 @@ namespace ns3 {
  * This object connects two point-to-point net devices where at least one
  * is not local to this simulator object. It simply override the transmit
  * method and uses an MPI Send operation instead.
+ *
+ * With MultithreadedSimulatorImpl, the two devices are local to two
+ * threads of the same process: the channel identifies the destination
+ * device by the node id and the interface index recorded when it was
+ * attached, so that transmitting a packet does not take a reference
+ * on the objects of the other thread.
  */
 class PointToPointRemoteChannel : public PointToPointChannel
 {
@@ -58,6 +65,15 @@ public:
    */
   ~PointToPointRemoteChannel ();
 
+  /**
+   * \brief Attach a given netdevice to this channel
+   *
+   * The device must have been added to its node.
+   *
+   * \param device pointer to the netdevice to attach to the channel
+   */
+  virtual void Attach (Ptr<PointToPointNetDevice> device);
+
   /**
    * \brief Transmit the packet
    *
@@ -68,6 +84,17 @@ public:
    */
   virtual bool TransmitStart (Ptr<Packet> p, Ptr<PointToPointNetDevice> src,
                               Time txTime);
+
+private:
+  /** An end of the channel. */
+  struct End
+  {
+    const PointToPointNetDevice *device; //!< The device
+    uint32_t node;                       //!< The id of the node of the device
+    uint32_t ifIndex;                    //!< The interface index of the device
+  };
+
+  End m_ends[2]; //!< The ends of the channel, in the order of attachment
 };
 
 } // namespace ns3
@@ -21,8 +21,16 @@
 #include "ns3/test.h"
 #include "ns3/drop-tail-queue.h"
 #include "ns3/simulator.h"
+#include "ns3/global-value.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/mpi-interface.h"
 #include "ns3/point-to-point-net-device.h"
 #include "ns3/point-to-point-channel.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/node.h"
+
+#include <vector>
 
 using namespace ns3;
 
@@ -100,6 +108,292 @@ PointToPointTest::DoRun (void)
   Simulator::Destroy ();
 }
 
+/**
+ * \brief Test class for PointToPointNetDevice::SendBatch
+ *
+ * A batch larger than the device queue is passed to the device, which
+ * takes packets until its transmission queue is stopped. The remaining
+ * packets are passed again when the transmission queue is woken up. All
+ * the packets must be received, in order.
+ */
+class PointToPointSendBatchTest : public TestCase
+{
+public:
+  /**
+   * \brief Create the test
+   */
+  PointToPointSendBatchTest ();
+
+  /**
+   * \brief Run the test
+   */
+  virtual void DoRun (void);
+
+private:
+  /**
+   * \brief Pass the packets not taken yet to the device
+   */
+  void SendPending (void);
+
+  /**
+   * \brief Record a received packet
+   *
+   * \param device The receiving device
+   * \param packet The packet
+   * \param protocol The protocol number
+   * \param from The address of the sender
+   * \returns true
+   */
+  bool Receive (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol, const Address &from);
+
+  Ptr<PointToPointNetDevice> m_device;          //!< The sending device
+  std::vector<NetDevice::TxItem> m_pending;      //!< The packets not taken yet
+  std::vector<uint32_t> m_taken;                 //!< The number of packets taken by each call to SendBatch
+  std::vector<uint32_t> m_received;              //!< The sizes of the received packets
+};
+
+PointToPointSendBatchTest::PointToPointSendBatchTest ()
+  : TestCase ("PointToPoint SendBatch")
+{
+}
+
+void
+PointToPointSendBatchTest::SendPending (void)
+{
+  uint32_t taken = m_device->SendBatch (m_pending);
+  m_taken.push_back (taken);
+  m_pending.erase (m_pending.begin (), m_pending.begin () + taken);
+}
+
+bool
+PointToPointSendBatchTest::Receive (Ptr<NetDevice> device, Ptr<const Packet> packet,
+                                    uint16_t protocol, const Address &from)
+{
+  m_received.push_back (packet->GetSize ());
+  return true;
+}
+
+void
+PointToPointSendBatchTest::DoRun (void)
+{
+  Ptr<Node> a = CreateObject<Node> ();
+  Ptr<Node> b = CreateObject<Node> ();
+  m_device = CreateObject<PointToPointNetDevice> ();
+  Ptr<PointToPointNetDevice> devB = CreateObject<PointToPointNetDevice> ();
+  Ptr<PointToPointChannel> channel = CreateObject<PointToPointChannel> ();
+
+  m_device->Attach (channel);
+  m_device->SetAddress (Mac48Address::Allocate ());
+  m_device->SetQueue (CreateObjectWithAttributes<DropTailQueue> ("MaxPackets", UintegerValue (4)));
+  devB->Attach (channel);
+  devB->SetAddress (Mac48Address::Allocate ());
+  devB->SetQueue (CreateObject<DropTailQueue> ());
+
+  a->AddDevice (m_device);
+  b->AddDevice (devB);
+  devB->SetReceiveCallback (MakeCallback (&PointToPointSendBatchTest::Receive, this));
+
+  Ptr<NetDeviceQueueInterface> ifaceA = CreateObject<NetDeviceQueueInterface> ();
+  m_device->AggregateObject (ifaceA);
+  ifaceA->CreateTxQueues ();
+  ifaceA->GetTxQueue (0)->SetWakeCallback (MakeCallback (&PointToPointSendBatchTest::SendPending, this));
+  Ptr<NetDeviceQueueInterface> ifaceB = CreateObject<NetDeviceQueueInterface> ();
+  devB->AggregateObject (ifaceB);
+  ifaceB->CreateTxQueues ();
+
+  for (uint32_t i = 0; i < 12; i++)
+    {
+      NetDevice::TxItem item;
+      item.packet = Create<Packet> (100 + i);
+      item.dest = devB->GetAddress ();
+      item.protocolNumber = 0x800;
+      m_pending.push_back (item);
+    }
+  Simulator::Schedule (Seconds (1.0), &PointToPointSendBatchTest::SendPending, this);
+
+  Simulator::Run ();
+
+  // the first packet is transmitted at once and the next four fill the
+  // device queue, which stops the transmission queue
+  NS_TEST_ASSERT_MSG_GT (m_taken.size (), 1, "The batch should be passed more than once");
+  NS_TEST_EXPECT_MSG_EQ (m_taken[0], 5, "The device should take the packets that fit its queue");
+  NS_TEST_EXPECT_MSG_EQ (m_pending.size (), 0, "All the packets should be taken");
+  NS_TEST_ASSERT_MSG_EQ (m_received.size (), 12, "All the packets should be received");
+  for (uint32_t i = 0; i < m_received.size (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (m_received[i], 100 + i, "The packets should be received in order");
+    }
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \brief Test class for the remote channels of a multithreaded simulation
+ *
+ * A chain of four nodes, each on its own system, exchanges packets: each
+ * node replies to the packets it receives with a packet one byte larger,
+ * and the second node also forwards the packets of the first node to the
+ * third. The packets received by each node must be the same, at the same
+ * times, with MultithreadedSimulatorImpl and with the default simulator.
+ */
+class PointToPointMultithreadedTest : public TestCase
+{
+public:
+  /**
+   * \brief Create the test
+   */
+  PointToPointMultithreadedTest ();
+
+  /**
+   * \brief Run the test
+   */
+  virtual void DoRun (void);
+
+private:
+  /** The time and the size of the packets received by a node. */
+  typedef std::vector<std::pair<int64_t, uint32_t> > Receptions;
+
+  /**
+   * \brief Run the chain
+   *
+   * \param simulator The TypeId name of the simulator
+   * \returns The packets received by each node
+   */
+  std::vector<Receptions> RunChain (std::string simulator);
+
+  /**
+   * \brief Record a packet, reply to it and forward it
+   *
+   * \param receptions The packets received by the node
+   * \param device The receiving device
+   * \param packet The packet
+   * \param protocol The protocol number
+   * \param from The address of the sender
+   * \returns true
+   */
+  static bool Receive (Receptions *receptions, Ptr<NetDevice> device, Ptr<const Packet> packet,
+                       uint16_t protocol, const Address &from);
+
+  /**
+   * \brief Send a packet
+   *
+   * \param device The sending device
+   * \param size The size of the packet
+   */
+  static void Send (Ptr<NetDevice> device, uint32_t size);
+};
+
+PointToPointMultithreadedTest::PointToPointMultithreadedTest ()
+  : TestCase ("PointToPoint multithreaded")
+{
+}
+
+void
+PointToPointMultithreadedTest::Send (Ptr<NetDevice> device, uint32_t size)
+{
+  device->Send (Create<Packet> (size), device->GetBroadcast (), 0x800);
+}
+
+bool
+PointToPointMultithreadedTest::Receive (Receptions *receptions, Ptr<NetDevice> device,
+                                        Ptr<const Packet> packet, uint16_t protocol,
+                                        const Address &from)
+{
+  uint32_t size = packet->GetSize ();
+  receptions->push_back (std::make_pair (Simulator::Now ().GetNanoSeconds (), size));
+  if (size < 200)
+    {
+      Send (device, size + 1);
+      Ptr<Node> node = device->GetNode ();
+      if (node->GetId () == 1 && device->GetIfIndex () == 0)
+        {
+          Simulator::Schedule (MicroSeconds (size), &PointToPointMultithreadedTest::Send,
+                               node->GetDevice (1), size + 2);
+        }
+    }
+  return true;
+}
+
+std::vector<PointToPointMultithreadedTest::Receptions>
+PointToPointMultithreadedTest::RunChain (std::string simulator)
+{
+  StringValue defaultSimulator;
+  GlobalValue::GetValueByName ("SimulatorImplementationType", defaultSimulator);
+  GlobalValue::Bind ("SimulatorImplementationType", StringValue (simulator));
+  bool threaded = simulator == "ns3::MultithreadedSimulatorImpl";
+  if (threaded)
+    {
+      MpiInterface::Enable (0, 0);
+    }
+
+  const uint32_t nNodes = 4;
+  std::vector<Receptions> receptions (nNodes);
+  NodeContainer nodes;
+  for (uint32_t i = 0; i < nNodes; ++i)
+    {
+      nodes.Add (CreateObject<Node> (i));
+    }
+  PointToPointHelper p2p;
+  for (uint32_t i = 0; i + 1 < nNodes; ++i)
+    {
+      std::ostringstream delay;
+      delay << 2 + i << "ms";
+      p2p.SetChannelAttribute ("Delay", StringValue (delay.str ()));
+      p2p.Install (nodes.Get (i), nodes.Get (i + 1));
+    }
+  for (uint32_t i = 0; i < nNodes; ++i)
+    {
+      Ptr<Node> node = nodes.Get (i);
+      for (uint32_t j = 0; j < node->GetNDevices (); ++j)
+        {
+          node->GetDevice (j)->SetReceiveCallback (MakeBoundCallback (&PointToPointMultithreadedTest::Receive,
+                                                                      &receptions[i]));
+        }
+      for (uint32_t k = 0; k < 10; ++k)
+        {
+          Simulator::ScheduleWithContext (i, MicroSeconds (100 * k + 7 * i), &PointToPointMultithreadedTest::Send,
+                                          node->GetDevice (0), 10 * k + i);
+        }
+    }
+
+  Simulator::Stop (Seconds (1));
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  if (threaded)
+    {
+      MpiInterface::Disable ();
+    }
+  GlobalValue::Bind ("SimulatorImplementationType", defaultSimulator);
+  return receptions;
+}
+
+void
+PointToPointMultithreadedTest::DoRun (void)
+{
+  TypeId tid;
+  if (!TypeId::LookupByNameFailSafe ("ns3::MultithreadedSimulatorImpl", &tid))
+    {
+      // Built without threads.
+      return;
+    }
+  std::vector<Receptions> expected = RunChain ("ns3::DefaultSimulatorImpl");
+  std::vector<Receptions> receptions = RunChain ("ns3::MultithreadedSimulatorImpl");
+  for (uint32_t i = 0; i < expected.size (); ++i)
+    {
+      NS_TEST_ASSERT_MSG_GT (expected[i].size (), 10, "Node " << i << " received few packets");
+      NS_TEST_ASSERT_MSG_EQ (receptions[i].size (), expected[i].size (),
+                             "Node " << i << " received a different number of packets");
+      for (uint32_t j = 0; j < expected[i].size () && j < receptions[i].size (); ++j)
+        {
+          NS_TEST_ASSERT_MSG_EQ (receptions[i][j].first, expected[i][j].first,
+                                 "Node " << i << " received packet " << j << " at a different time");
+          NS_TEST_ASSERT_MSG_EQ (receptions[i][j].second, expected[i][j].second,
+                                 "Node " << i << " received a different packet " << j);
+        }
+    }
+}
+
 /**
  * \brief TestSuite for PointToPoint module
  */
@@ -116,6 +410,8 @@ PointToPointTestSuite::PointToPointTestSuite ()
   : TestSuite ("devices-point-to-point", UNIT)
 {
   AddTestCase (new PointToPointTest, TestCase::QUICK);
+  AddTestCase (new PointToPointSendBatchTest, TestCase::QUICK);
+  AddTestCase (new PointToPointMultithreadedTest, TestCase::QUICK);
 }
 
 static PointToPointTestSuite g_pointToPointTestSuite; //!< The testsuite
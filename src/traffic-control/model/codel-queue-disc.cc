@@ -28,6 +28,7 @@
 #include "ns3/log.h"
 #include "ns3/enum.h"
 #include "ns3/uinteger.h"
+#include "ns3/boolean.h"
 #include "ns3/abort.h"
 #include "codel-queue-disc.h"
 #include "ns3/object-factory.h"
@@ -158,6 +159,11 @@ TypeId CoDelQueueDisc::GetTypeId (void)
                    MakeEnumAccessor (&CoDelQueueDisc::SetMode),
                    MakeEnumChecker (Queue::QUEUE_MODE_BYTES, "QUEUE_MODE_BYTES",
                                     Queue::QUEUE_MODE_PACKETS, "QUEUE_MODE_PACKETS"))
+    .AddAttribute ("UseRingBuffer",
+                   "True to use a RingBufferQueue sized from the queue limit as internal queue",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&CoDelQueueDisc::m_useRingBuffer),
+                   MakeBooleanChecker ())
     .AddAttribute ("MaxPackets",
                    "The maximum number of packets accepted by this CoDelQueueDisc.",
                    UintegerValue (DEFAULT_CODEL_LIMIT),
@@ -605,17 +611,7 @@ CoDelQueueDisc::CheckConfig (void)
 
   if (GetNInternalQueues () == 0)
     {
-      // create a DropTail queue
-      Ptr<Queue> queue = CreateObjectWithAttributes<DropTailQueue> ("Mode", EnumValue (m_mode));
-      if (m_mode == Queue::QUEUE_MODE_PACKETS)
-        {
-          queue->SetMaxPackets (m_maxPackets);
-        }
-      else
-        {
-          queue->SetMaxBytes (m_maxBytes);
-        }
-      AddInternalQueue (queue);
+      AddDefaultInternalQueue (m_mode, m_mode == Queue::QUEUE_MODE_PACKETS ? m_maxPackets : m_maxBytes, m_minBytes, m_useRingBuffer);
     }
 
   if (GetNInternalQueues () != 1)
@@ -243,6 +243,7 @@ private:
   uint32_t m_states;                      //!< Total number of times we are in state 1, state 2, or state 3
   uint32_t m_dropOverLimit;               //!< The number of packets dropped due to full queue
   Queue::QueueMode     m_mode;                   //!< The operating mode (Bytes or packets)
+  bool                 m_useRingBuffer;          //!< True to use a RingBufferQueue as internal queue
   TracedValue<Time> m_sojourn;            //!< Time in queue
 };
 
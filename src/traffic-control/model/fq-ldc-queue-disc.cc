@@ -0,0 +1,689 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/log.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/double.h"
+#include "ns3/simulator.h"
+#include "fq-ldc-queue-disc.h"
+#include <algorithm>
+#include <cmath>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("FqLdcQueueDisc");
+
+/** Index of no flow or no slot. */
+static const uint32_t FQ_LDC_NONE = 0xffffffff;
+
+/**
+ * Weights of the EWMAs of the sojourn time and of the arrivals, as the
+ * QW and RW defaults of LdcQueueDisc.
+ */
+static const double FQ_LDC_QW = 0.002;
+static const double FQ_LDC_RW = 0.998;
+
+/**
+ * Minimum backlog of a flow in bytes before its departure rate is
+ * measured, as the DequeueThreshold default of LdcQueueDisc.
+ */
+static const uint32_t FQ_LDC_DQ_THRESHOLD = 10000;
+
+/**
+ * Link bandwidth assumed when LinkBandwidth is not set and the device does
+ * not expose its data rate, as in LdcQueueDisc.
+ */
+static const char *FQ_LDC_DEFAULT_LINK_BANDWIDTH = "1.5Mbps";
+
+NS_OBJECT_ENSURE_REGISTERED (FqLdcQueueDisc);
+
+TypeId FqLdcQueueDisc::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::FqLdcQueueDisc")
+    .SetParent<QueueDisc> ()
+    .SetGroupName ("TrafficControl")
+    .AddConstructor<FqLdcQueueDisc> ()
+    .AddAttribute ("PacketLimit",
+                   "The hard limit on the real queue size, measured in packets",
+                   UintegerValue (10 * 1024),
+                   MakeUintegerAccessor (&FqLdcQueueDisc::m_limit),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("Flows",
+                   "The number of queues into which the incoming packets are classified",
+                   UintegerValue (1024),
+                   MakeUintegerAccessor (&FqLdcQueueDisc::m_flows),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("DropBatchSize",
+                   "The maximum number of packets dropped from the fat flow",
+                   UintegerValue (64),
+                   MakeUintegerAccessor (&FqLdcQueueDisc::m_dropBatchSize),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("LinkBandwidth",
+                   "The link bandwidth. If 0, the DataRate of the device is used",
+                   DataRateValue (DataRate ("0b/s")),
+                   MakeDataRateAccessor (&FqLdcQueueDisc::m_linkBandwidth),
+                   MakeDataRateChecker ())
+    .AddAttribute ("MeanPktSize",
+                   "The LDC average packet size for each FqLdc queue",
+                   UintegerValue (500),
+                   MakeUintegerAccessor (&FqLdcQueueDisc::m_meanPktSize),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("TimeInterval",
+                   "The LDC time interval for each FqLdc queue",
+                   StringValue ("2ms"),
+                   MakeStringAccessor (&FqLdcQueueDisc::m_interval),
+                   MakeStringChecker ())
+    .AddAttribute ("TargetQueueingDelay",
+                   "The LDC target queueing delay for each FqLdc queue",
+                   StringValue ("4s"),
+                   MakeStringAccessor (&FqLdcQueueDisc::m_target),
+                   MakeStringChecker ())
+    .AddAttribute ("TargetLoadFactorRatio",
+                   "The LDC target load factor ratio for each FqLdc queue",
+                   DoubleValue (0.95),
+                   MakeDoubleAccessor (&FqLdcQueueDisc::m_rTarget),
+                   MakeDoubleChecker <double> ())
+    .AddAttribute ("WQ",
+                   "The LDC weight for the delay component for each FqLdc queue",
+                   DoubleValue (0.75),
+                   MakeDoubleAccessor (&FqLdcQueueDisc::m_wQ),
+                   MakeDoubleChecker <double> ())
+    .AddAttribute ("LdcExponent",
+                   "The LDC exponent for each FqLdc queue",
+                   UintegerValue (3),
+                   MakeUintegerAccessor (&FqLdcQueueDisc::m_lExp),
+                   MakeUintegerChecker<uint32_t> ())
+  ;
+  return tid;
+}
+
+FqLdcQueueDisc::FqLdcQueueDisc ()
+  : m_quantum (0),
+    m_overlimitDroppedPackets (0),
+    m_ptc (0),
+    m_freeSlot (FQ_LDC_NONE)
+{
+  NS_LOG_FUNCTION (this);
+  m_newFlows.head = m_newFlows.tail = FQ_LDC_NONE;
+  m_oldFlows.head = m_oldFlows.tail = FQ_LDC_NONE;
+  m_uv = CreateObject<UniformRandomVariable> ();
+}
+
+FqLdcQueueDisc::~FqLdcQueueDisc ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+FqLdcQueueDisc::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_flowsByHash.clear ();
+  m_flowStates.clear ();
+  m_heap.clear ();
+  m_slots.clear ();
+  m_freeSlot = FQ_LDC_NONE;
+  m_uv = 0;
+  QueueDisc::DoDispose ();
+}
+
+void
+FqLdcQueueDisc::SetQuantum (uint32_t quantum)
+{
+  NS_LOG_FUNCTION (this << quantum);
+  m_quantum = quantum;
+}
+
+uint32_t
+FqLdcQueueDisc::GetQuantum (void) const
+{
+  return m_quantum;
+}
+
+uint32_t
+FqLdcQueueDisc::GetOverlimitDroppedPackets (void) const
+{
+  return m_overlimitDroppedPackets;
+}
+
+int64_t
+FqLdcQueueDisc::AssignStreams (int64_t stream)
+{
+  NS_LOG_FUNCTION (this << stream);
+  m_uv->SetStream (stream);
+  return 1;
+}
+
+void
+FqLdcQueueDisc::PushBack (FlowList &list, uint32_t index)
+{
+  m_flowStates[index].next = FQ_LDC_NONE;
+  if (list.tail == FQ_LDC_NONE)
+    {
+      list.head = index;
+    }
+  else
+    {
+      m_flowStates[list.tail].next = index;
+    }
+  list.tail = index;
+}
+
+uint32_t
+FqLdcQueueDisc::PopFront (FlowList &list)
+{
+  uint32_t index = list.head;
+  NS_ASSERT (index != FQ_LDC_NONE);
+  list.head = m_flowStates[index].next;
+  if (list.head == FQ_LDC_NONE)
+    {
+      list.tail = FQ_LDC_NONE;
+    }
+  return index;
+}
+
+void
+FqLdcQueueDisc::SwapHeap (uint32_t i, uint32_t j)
+{
+  std::swap (m_heap[i], m_heap[j]);
+  m_flowStates[m_heap[i]].heapIndex = i;
+  m_flowStates[m_heap[j]].heapIndex = j;
+}
+
+void
+FqLdcQueueDisc::UpdateHeap (uint32_t index)
+{
+  Flow &flow = m_flowStates[index];
+  uint32_t i = flow.heapIndex;
+
+  if (flow.nBytes == 0)
+    {
+      // the flow leaves the heap: its position is taken by the last entry,
+      // which is then moved up or down as if its backlog had changed
+      if (i == FQ_LDC_NONE)
+        {
+          return;
+        }
+      flow.heapIndex = FQ_LDC_NONE;
+      uint32_t last = m_heap.back ();
+      m_heap.pop_back ();
+      if (last == index)
+        {
+          return;
+        }
+      m_heap[i] = last;
+      m_flowStates[last].heapIndex = i;
+      index = last;
+    }
+  else if (i == FQ_LDC_NONE)
+    {
+      i = m_heap.size ();
+      flow.heapIndex = i;
+      m_heap.push_back (index);
+    }
+
+  uint32_t bytes = m_flowStates[index].nBytes;
+  while (i > 0 && m_flowStates[m_heap[(i - 1) / 2]].nBytes < bytes)
+    {
+      SwapHeap (i, (i - 1) / 2);
+      i = (i - 1) / 2;
+    }
+  while (true)
+    {
+      uint32_t largest = i;
+      for (uint32_t child = 2 * i + 1; child <= 2 * i + 2 && child < m_heap.size (); child++)
+        {
+          if (m_flowStates[m_heap[child]].nBytes > m_flowStates[m_heap[largest]].nBytes)
+            {
+              largest = child;
+            }
+        }
+      if (largest == i)
+        {
+          break;
+        }
+      SwapHeap (i, largest);
+      i = largest;
+    }
+}
+
+void
+FqLdcQueueDisc::CatchUp (Flow &flow)
+{
+  Time now = Simulator::Now ();
+  if (now < flow.nextTimeout)
+    {
+      return;
+    }
+
+  // number of intervals expired in (nextTimeout - interval, now]
+  uint64_t n = (now - flow.nextTimeout).GetTimeStep () / m_oInterval.GetTimeStep () + 1;
+  Time first = flow.nextTimeout;
+  flow.nextTimeout = TimeStep (flow.nextTimeout.GetTimeStep () + n * m_oInterval.GetTimeStep ());
+
+  // follow the rate at which the scheduler actually serves the flow
+  double ptc = (flow.avgDqRate > 0) ? flow.avgDqRate / m_meanPktSize : m_ptc;
+
+  // the sojourn time of the last departure is only meaningful while
+  // there are packets waiting behind it
+  double sojourn = (flow.nPackets > 0) ? flow.sojourn.GetSeconds () : 0.0;
+
+  uint32_t m = 0;
+  if (flow.idle)
+    {
+      flow.idle = false;
+      m = uint32_t (ptc * (first - flow.idleTime).GetSeconds ());
+    }
+
+  flow.nPkt = ((1.0 - FQ_LDC_RW) * flow.nPkt) + (FQ_LDC_RW * flow.nIncome);
+  flow.nIncome = 0;
+  flow.dAvg = flow.dAvg * std::pow (1.0 - FQ_LDC_QW, m + 1.0) + FQ_LDC_QW * sojourn;
+
+  if (n > 1)
+    {
+      // the remaining intervals see no arrivals and the same sojourn
+      // sample, hence the averages decay geometrically
+      flow.nPkt *= std::pow (1.0 - FQ_LDC_RW, n - 1.0);
+      double decay = std::pow (1.0 - FQ_LDC_QW, n - 1.0);
+      flow.dAvg = flow.dAvg * decay + sojourn * (1.0 - decay);
+    }
+
+  double ratio = flow.nPkt / (m_oInterval.GetSeconds () * ptc);
+  double qRatio = std::min (std::pow (flow.dAvg / m_dTarget.GetSeconds (), (double) m_lExp), 1.0);
+  double rRatio = std::min (std::pow (ratio / m_rTarget, (double) m_lExp), 1.0);
+  flow.prob = (m_wQ * qRatio) + ((1 - m_wQ) * rRatio);
+}
+
+bool
+FqLdcQueueDisc::DoEnqueue (Ptr<QueueDiscItem> item)
+{
+  NS_LOG_FUNCTION (this << item);
+
+  int32_t ret = Classify (item);
+
+  if (ret == PacketFilter::PF_NO_MATCH)
+    {
+      NS_LOG_ERROR ("No filter has been able to classify this packet, drop it.");
+      Drop (item);
+      return false;
+    }
+
+  uint32_t h = ret % m_flows;
+
+  uint32_t index = m_flowsByHash[h];
+  if (index == FQ_LDC_NONE)
+    {
+      NS_LOG_DEBUG ("Creating a new flow queue with index " << h);
+      index = m_flowStates.size ();
+      m_flowsByHash[h] = index;
+      Flow flow;
+      flow.head = flow.tail = FQ_LDC_NONE;
+      flow.nPackets = 0;
+      flow.nBytes = 0;
+      flow.deficit = 0;
+      flow.status = INACTIVE;
+      flow.next = FQ_LDC_NONE;
+      flow.heapIndex = FQ_LDC_NONE;
+      flow.nIncome = 0;
+      flow.idle = true;
+      flow.inMeasurement = false;
+      flow.dqCount = 0;
+      flow.idleTime = Seconds (0);
+      flow.nextTimeout = Simulator::Now () + m_oInterval;
+      flow.sojourn = Seconds (0);
+      flow.dqStart = Seconds (0);
+      flow.nPkt = 0;
+      flow.dAvg = 0;
+      flow.avgDqRate = 0;
+      flow.prob = 0;
+      m_flowStates.push_back (flow);
+    }
+
+  Flow &flow = m_flowStates[index];
+  if (flow.status == INACTIVE)
+    {
+      flow.status = NEW_FLOW;
+      flow.deficit = m_quantum;
+      PushBack (m_newFlows, index);
+    }
+
+  CatchUp (flow);
+  flow.nIncome++;
+
+  if (m_uv->GetValue () <= flow.prob)
+    {
+      NS_LOG_DEBUG ("Early drop from flow " << h << "; probability " << flow.prob);
+      Drop (item);
+      return false;
+    }
+
+  uint32_t slot = m_freeSlot;
+  if (slot == FQ_LDC_NONE)
+    {
+      slot = m_slots.size ();
+      m_slots.push_back (Slot ());
+    }
+  else
+    {
+      m_freeSlot = m_slots[slot].next;
+    }
+  m_slots[slot].item = item;
+  m_slots[slot].arrival = Simulator::Now ();
+  m_slots[slot].next = FQ_LDC_NONE;
+  if (flow.tail == FQ_LDC_NONE)
+    {
+      flow.head = slot;
+    }
+  else
+    {
+      m_slots[flow.tail].next = slot;
+    }
+  flow.tail = slot;
+  flow.nPackets++;
+  flow.nBytes += item->GetPacketSize ();
+  UpdateHeap (index);
+
+  NS_LOG_DEBUG ("Packet enqueued into flow " << h);
+
+  if (GetNPackets () > m_limit)
+    {
+      FqLdcDrop ();
+    }
+
+  return true;
+}
+
+Ptr<QueueDiscItem>
+FqLdcQueueDisc::RemoveHead (uint32_t index)
+{
+  Flow &flow = m_flowStates[index];
+  if (flow.head == FQ_LDC_NONE)
+    {
+      return 0;
+    }
+
+  uint32_t slot = flow.head;
+  Ptr<QueueDiscItem> item = m_slots[slot].item;
+  flow.head = m_slots[slot].next;
+  if (flow.head == FQ_LDC_NONE)
+    {
+      flow.tail = FQ_LDC_NONE;
+    }
+  flow.nPackets--;
+  flow.nBytes -= item->GetPacketSize ();
+  UpdateHeap (index);
+
+  m_slots[slot].item = 0;
+  m_slots[slot].next = m_freeSlot;
+  m_freeSlot = slot;
+  return item;
+}
+
+Ptr<QueueDiscItem>
+FqLdcQueueDisc::DequeueFromFlow (uint32_t index)
+{
+  Flow &flow = m_flowStates[index];
+  CatchUp (flow);
+
+  if (flow.head == FQ_LDC_NONE)
+    {
+      flow.idle = true;
+      flow.idleTime = Simulator::Now ();
+      return 0;
+    }
+
+  flow.idle = false;
+  flow.sojourn = Simulator::Now () - m_slots[flow.head].arrival;
+  Ptr<QueueDiscItem> item = RemoveHead (index);
+  UpdateDepartureRate (flow, item);
+  return item;
+}
+
+void
+FqLdcQueueDisc::UpdateDepartureRate (Flow &flow, Ptr<QueueDiscItem> item)
+{
+  Time now = Simulator::Now ();
+
+  // if not in a measurement cycle and the flow has built up to the
+  // threshold, start a measurement cycle
+  if (!flow.inMeasurement && flow.nBytes >= FQ_LDC_DQ_THRESHOLD)
+    {
+      flow.dqStart = now;
+      flow.dqCount = 0;
+      flow.inMeasurement = true;
+    }
+
+  if (!flow.inMeasurement)
+    {
+      return;
+    }
+
+  flow.dqCount += item->GetPacketSize ();
+
+  // done with a measurement cycle
+  if (flow.dqCount >= FQ_LDC_DQ_THRESHOLD)
+    {
+      double tmp = (now - flow.dqStart).GetSeconds ();
+      if (tmp > 0)
+        {
+          if (flow.avgDqRate == 0)
+            {
+              flow.avgDqRate = flow.dqCount / tmp;
+            }
+          else
+            {
+              flow.avgDqRate = (0.5 * flow.avgDqRate) + (0.5 * (flow.dqCount / tmp));
+            }
+        }
+
+      // restart a measurement cycle if there is enough data
+      flow.dqStart = now;
+      flow.dqCount = 0;
+      flow.inMeasurement = (flow.nBytes >= FQ_LDC_DQ_THRESHOLD);
+    }
+}
+
+Ptr<QueueDiscItem>
+FqLdcQueueDisc::DoDequeue (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  uint32_t index = FQ_LDC_NONE;
+  Ptr<QueueDiscItem> item;
+
+  do
+    {
+      bool found = false;
+
+      while (!found && m_newFlows.head != FQ_LDC_NONE)
+        {
+          index = m_newFlows.head;
+          Flow &flow = m_flowStates[index];
+
+          if (flow.deficit <= 0)
+            {
+              flow.deficit += m_quantum;
+              flow.status = OLD_FLOW;
+              PopFront (m_newFlows);
+              PushBack (m_oldFlows, index);
+            }
+          else
+            {
+              NS_LOG_DEBUG ("Found a new flow with positive deficit");
+              found = true;
+            }
+        }
+
+      while (!found && m_oldFlows.head != FQ_LDC_NONE)
+        {
+          index = m_oldFlows.head;
+          Flow &flow = m_flowStates[index];
+
+          if (flow.deficit <= 0)
+            {
+              flow.deficit += m_quantum;
+              PopFront (m_oldFlows);
+              PushBack (m_oldFlows, index);
+            }
+          else
+            {
+              NS_LOG_DEBUG ("Found an old flow with positive deficit");
+              found = true;
+            }
+        }
+
+      if (!found)
+        {
+          NS_LOG_DEBUG ("No flow found to dequeue a packet");
+          return 0;
+        }
+
+      item = DequeueFromFlow (index);
+
+      if (!item)
+        {
+          NS_LOG_DEBUG ("Could not get a packet from the selected flow queue");
+          if (m_newFlows.head != FQ_LDC_NONE)
+            {
+              m_flowStates[index].status = OLD_FLOW;
+              PopFront (m_newFlows);
+              PushBack (m_oldFlows, index);
+            }
+          else
+            {
+              m_flowStates[index].status = INACTIVE;
+              PopFront (m_oldFlows);
+            }
+        }
+      else
+        {
+          NS_LOG_DEBUG ("Dequeued packet " << item->GetPacket ());
+        }
+    } while (item == 0);
+
+  m_flowStates[index].deficit -= item->GetPacketSize ();
+
+  return item;
+}
+
+Ptr<const QueueDiscItem>
+FqLdcQueueDisc::DoPeek (void) const
+{
+  NS_LOG_FUNCTION (this);
+
+  uint32_t index = (m_newFlows.head != FQ_LDC_NONE) ? m_newFlows.head : m_oldFlows.head;
+  if (index == FQ_LDC_NONE || m_flowStates[index].head == FQ_LDC_NONE)
+    {
+      return 0;
+    }
+
+  return m_slots[m_flowStates[index].head].item;
+}
+
+bool
+FqLdcQueueDisc::CheckConfig (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (GetNQueueDiscClasses () > 0)
+    {
+      NS_LOG_ERROR ("FqLdcQueueDisc cannot have classes");
+      return false;
+    }
+
+  if (GetNPacketFilters () == 0)
+    {
+      NS_LOG_ERROR ("FqLdcQueueDisc needs at least a packet filter");
+      return false;
+    }
+
+  if (GetNInternalQueues () > 0)
+    {
+      NS_LOG_ERROR ("FqLdcQueueDisc cannot have internal queues");
+      return false;
+    }
+
+  return true;
+}
+
+void
+FqLdcQueueDisc::InitializeParams (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  // we are at initialization time. If the user has not set a quantum value,
+  // set the quantum to the MTU of the device
+  if (!m_quantum)
+    {
+      Ptr<NetDevice> device = GetNetDevice ();
+      NS_ASSERT_MSG (device, "Device not set for the queue disc");
+      m_quantum = device->GetMtu ();
+      NS_LOG_DEBUG ("Setting the quantum to the MTU of the device: " << m_quantum);
+    }
+
+  // The link bandwidth is only used by a flow until it has measured the
+  // rate at which it is served
+  DataRate rate = m_linkBandwidth;
+  DataRateValue deviceRate;
+  if (rate.GetBitRate () == 0)
+    {
+      if (GetNetDevice () && GetNetDevice ()->GetAttributeFailSafe ("DataRate", deviceRate)
+          && deviceRate.Get ().GetBitRate () > 0)
+        {
+          rate = deviceRate.Get ();
+          NS_LOG_DEBUG ("Setting the link bandwidth to the data rate of the device: " << rate);
+        }
+      else
+        {
+          NS_LOG_WARN ("The device does not expose its data rate, assuming " << FQ_LDC_DEFAULT_LINK_BANDWIDTH);
+          rate = DataRate (FQ_LDC_DEFAULT_LINK_BANDWIDTH);
+        }
+    }
+  m_ptc = rate.GetBitRate () / (8.0 * m_meanPktSize);
+
+  m_oInterval = Time (m_interval);
+  m_dTarget = Time (m_target);
+  NS_ASSERT_MSG (m_oInterval.IsStrictlyPositive (), "The time interval must be positive");
+
+  m_flowsByHash.assign (m_flows, FQ_LDC_NONE);
+}
+
+uint32_t
+FqLdcQueueDisc::FqLdcDrop (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  /* Queue is full! The fat flow is at the top of the heap */
+  NS_ASSERT (!m_heap.empty ());
+  uint32_t index = m_heap.front ();
+
+  /* Our goal is to drop half of this fat flow backlog */
+  uint32_t len = 0, count = 0, threshold = m_flowStates[index].nBytes >> 1;
+  Ptr<QueueDiscItem> item;
+
+  do
+    {
+      item = RemoveHead (index);
+      len += item->GetPacketSize ();
+      Drop (item);
+    } while (++count < m_dropBatchSize && len < threshold);
+
+  m_overlimitDroppedPackets += count;
+
+  return index;
+}
+
+} // namespace ns3
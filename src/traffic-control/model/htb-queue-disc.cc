@@ -0,0 +1,860 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * The algorithm follows the Linux HTB scheduler (net/sched/sch_htb.c)
+ * by Martin Devera.
+ */
+
+#include "ns3/log.h"
+#include "ns3/uinteger.h"
+#include "ns3/simulator.h"
+#include "ns3/node.h"
+#include "htb-queue-disc.h"
+#include "traffic-control-layer.h"
+#include <algorithm>
+#include <map>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("HtbQueueDisc");
+
+/**
+ * Maximum amount of tokens accumulated while a class is idle, in
+ * nanoseconds (as the mbuffer of Linux HTB)
+ */
+static const int64_t HTB_MAX_BUFFER = 60000000000LL;
+
+NS_OBJECT_ENSURE_REGISTERED (HtbClass);
+
+TypeId HtbClass::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::HtbClass")
+    .SetParent<QueueDiscClass> ()
+    .SetGroupName ("TrafficControl")
+    .AddConstructor<HtbClass> ()
+    .AddAttribute ("Rate",
+                   "The rate guaranteed to the class",
+                   DataRateValue (DataRate ("1Mb/s")),
+                   MakeDataRateAccessor (&HtbClass::m_rate),
+                   MakeDataRateChecker ())
+    .AddAttribute ("Ceil",
+                   "The maximum rate of the class, including the rate borrowed from its ancestors. If 0, the Rate is used",
+                   DataRateValue (DataRate ("0b/s")),
+                   MakeDataRateAccessor (&HtbClass::m_ceil),
+                   MakeDataRateChecker ())
+    .AddAttribute ("Burst",
+                   "The bytes that can be sent at once at more than Rate. If 0, the bytes sent at Rate in 1ms plus the MTU of the device",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&HtbClass::m_burst),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("CBurst",
+                   "The bytes that can be sent at once at more than Ceil. If 0, the bytes sent at Ceil in 1ms plus the MTU of the device",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&HtbClass::m_cburst),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("Quantum",
+                   "The bytes a leaf class sends in a round when borrowing or when competing with leaves of the same priority. If 0, a tenth of the bytes sent at Rate in a second",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&HtbClass::m_quantum),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("Priority",
+                   "The priority of the class, 0 is the highest",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&HtbClass::m_prio),
+                   MakeUintegerChecker<uint32_t> (0, NUM_PRIO - 1))
+  ;
+  return tid;
+}
+
+HtbClass::HtbClass ()
+  : m_id (0),
+    m_level (0),
+    m_isLeaf (false),
+    m_mode (CAN_SEND),
+    m_buffer (0),
+    m_cbuffer (0),
+    m_tokens (0),
+    m_ctokens (0),
+    m_checkpoint (0),
+    m_waitKey (-1),
+    m_activity (0),
+    m_nBorrowed (0)
+{
+  NS_LOG_FUNCTION (this);
+  for (uint32_t level = 0; level < MAX_DEPTH; level++)
+    {
+      m_deficit[level] = 0;
+    }
+  for (uint32_t prio = 0; prio < NUM_PRIO; prio++)
+    {
+      m_feedNext[prio] = 0;
+    }
+}
+
+HtbClass::~HtbClass ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+HtbClass::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_parent = 0;
+  QueueDiscClass::DoDispose ();
+}
+
+void
+HtbClass::SetParentClass (Ptr<HtbClass> parent)
+{
+  NS_LOG_FUNCTION (this << parent);
+  m_parent = parent;
+}
+
+Ptr<HtbClass>
+HtbClass::GetParentClass (void) const
+{
+  return m_parent;
+}
+
+DataRate
+HtbClass::GetRate (void) const
+{
+  return m_rate;
+}
+
+DataRate
+HtbClass::GetCeil (void) const
+{
+  return m_ceil;
+}
+
+HtbClass::Mode
+HtbClass::GetMode (void) const
+{
+  return m_mode;
+}
+
+uint32_t
+HtbClass::GetBorrowedPackets (void) const
+{
+  return m_nBorrowed;
+}
+
+
+NS_OBJECT_ENSURE_REGISTERED (HtbQueueDisc);
+
+TypeId HtbQueueDisc::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::HtbQueueDisc")
+    .SetParent<QueueDisc> ()
+    .SetGroupName ("TrafficControl")
+    .AddConstructor<HtbQueueDisc> ()
+    .AddAttribute ("DefaultClass",
+                   "The index of the leaf class of the packets not classified by the packet filters. "
+                   "If it is not the index of a class, such packets are dropped",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&HtbQueueDisc::m_defaultClass),
+                   MakeUintegerChecker<uint32_t> ())
+  ;
+  return tid;
+}
+
+HtbQueueDisc::HtbQueueDisc ()
+  : m_nLevels (0),
+    m_isChild (false)
+{
+  NS_LOG_FUNCTION (this);
+  for (uint32_t level = 0; level < HtbClass::MAX_DEPTH; level++)
+    {
+      for (uint32_t prio = 0; prio < HtbClass::NUM_PRIO; prio++)
+        {
+          m_rowNext[level][prio] = 0;
+        }
+    }
+}
+
+HtbQueueDisc::~HtbQueueDisc ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+HtbQueueDisc::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  Simulator::Cancel (m_watchdog);
+  // the inner classes are not known to the base class
+  for (uint32_t i = GetNQueueDiscClasses (); i < m_tree.size (); i++)
+    {
+      m_tree[i]->Dispose ();
+    }
+  m_tree.clear ();
+  m_waitQueue.clear ();
+  m_peeked = 0;
+  QueueDisc::DoDispose ();
+}
+
+Ptr<HtbClass>
+HtbQueueDisc::GetClass (uint32_t id) const
+{
+  NS_ASSERT (id < m_tree.size ());
+  return m_tree[id];
+}
+
+bool
+HtbQueueDisc::DoEnqueue (Ptr<QueueDiscItem> item)
+{
+  NS_LOG_FUNCTION (this << item);
+
+  int32_t ret = Classify (item);
+  uint32_t id = m_defaultClass;
+  if (ret != PacketFilter::PF_NO_MATCH)
+    {
+      id = ret;
+    }
+
+  if (id >= GetNQueueDiscClasses ())
+    {
+      NS_LOG_ERROR ("No leaf class " << id << " for this packet, drop it.");
+      Drop (item);
+      return false;
+    }
+
+  Ptr<HtbClass> cl = m_tree[id];
+  bool retval = cl->GetQueueDisc ()->Enqueue (item);
+
+  if (cl->GetQueueDisc ()->GetNPackets () > 0 && !cl->m_activity)
+    {
+      Activate (cl);
+    }
+
+  NS_LOG_DEBUG ("Packet enqueued into class " << id);
+
+  return retval;
+}
+
+Ptr<QueueDiscItem>
+HtbQueueDisc::DoDequeue (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  Ptr<QueueDiscItem> item = m_peeked;
+  if (item)
+    {
+      m_peeked = 0;
+      return item;
+    }
+
+  DoEvents ();
+
+  // leaves sending within their own rate come first, then the classes
+  // borrowing from the lowest levels. Within a level, lower priorities first
+  for (uint32_t level = 0; level < m_nLevels; level++)
+    {
+      for (uint32_t prio = 0; prio < HtbClass::NUM_PRIO; prio++)
+        {
+          if (!m_rows[level][prio].empty ())
+            {
+              item = DequeueTree (level, prio);
+              if (item)
+                {
+                  return item;
+                }
+            }
+        }
+    }
+
+  if (GetNPackets () > 0)
+    {
+      NS_LOG_LOGIC ("No class can send, waiting for tokens");
+      ScheduleWatchdog ();
+    }
+  return 0;
+}
+
+Ptr<const QueueDiscItem>
+HtbQueueDisc::DoPeek (void) const
+{
+  NS_LOG_FUNCTION (this);
+
+  // as Linux does, the next packet is dequeued (and the classes charged)
+  // and then returned by the next call to DoDequeue
+  if (!m_peeked)
+    {
+      m_peeked = const_cast<HtbQueueDisc *> (this)->DoDequeue ();
+    }
+  return m_peeked;
+}
+
+HtbClass::Mode
+HtbQueueDisc::ClassMode (Ptr<HtbClass> cl, int64_t &diff) const
+{
+  int64_t toks = cl->m_ctokens + diff;
+  if (toks < 0)
+    {
+      diff = -toks;
+      return HtbClass::CANT_SEND;
+    }
+
+  toks = cl->m_tokens + diff;
+  if (toks >= 0)
+    {
+      return HtbClass::CAN_SEND;
+    }
+
+  diff = -toks;
+  return HtbClass::MAY_BORROW;
+}
+
+void
+HtbQueueDisc::ChangeClassMode (Ptr<HtbClass> cl, int64_t &diff)
+{
+  NS_LOG_FUNCTION (this << cl->m_id << diff);
+
+  HtbClass::Mode mode = ClassMode (cl, diff);
+  if (mode == cl->m_mode)
+    {
+      return;
+    }
+
+  if (cl->m_activity)
+    {
+      if (cl->m_mode != HtbClass::CANT_SEND)
+        {
+          DeactivatePrios (cl);
+        }
+      cl->m_mode = mode;
+      if (mode != HtbClass::CANT_SEND)
+        {
+          ActivatePrios (cl);
+        }
+    }
+  else
+    {
+      cl->m_mode = mode;
+    }
+}
+
+void
+HtbQueueDisc::ActivatePrios (Ptr<HtbClass> cl)
+{
+  NS_LOG_FUNCTION (this << cl->m_id);
+
+  Ptr<HtbClass> p = cl->m_parent;
+  uint32_t mask = cl->m_activity;
+
+  // a borrowing class joins the feed of its parent; the parent is
+  // activated in turn for the priorities it had no borrowers for
+  while (cl->m_mode == HtbClass::MAY_BORROW && p && mask)
+    {
+      for (uint32_t prio = 0; prio < HtbClass::NUM_PRIO; prio++)
+        {
+          if (mask & (1 << prio))
+            {
+              if (!p->m_feed[prio].empty ())
+                {
+                  mask &= ~(1 << prio);
+                }
+              p->m_feed[prio].insert (cl->m_id);
+            }
+        }
+      p->m_activity |= mask;
+      cl = p;
+      p = cl->m_parent;
+    }
+
+  if (cl->m_mode == HtbClass::CAN_SEND && mask)
+    {
+      for (uint32_t prio = 0; prio < HtbClass::NUM_PRIO; prio++)
+        {
+          if (mask & (1 << prio))
+            {
+              m_rows[cl->m_level][prio].insert (cl->m_id);
+            }
+        }
+    }
+}
+
+void
+HtbQueueDisc::DeactivatePrios (Ptr<HtbClass> cl)
+{
+  NS_LOG_FUNCTION (this << cl->m_id);
+
+  Ptr<HtbClass> p = cl->m_parent;
+  uint32_t mask = cl->m_activity;
+
+  while (cl->m_mode == HtbClass::MAY_BORROW && p && mask)
+    {
+      uint32_t m = mask;
+      mask = 0;
+      for (uint32_t prio = 0; prio < HtbClass::NUM_PRIO; prio++)
+        {
+          if (m & (1 << prio))
+            {
+              p->m_feed[prio].erase (cl->m_id);
+              if (p->m_feed[prio].empty ())
+                {
+                  mask |= (1 << prio);
+                }
+            }
+        }
+      p->m_activity &= ~mask;
+      cl = p;
+      p = cl->m_parent;
+    }
+
+  if (cl->m_mode == HtbClass::CAN_SEND && mask)
+    {
+      for (uint32_t prio = 0; prio < HtbClass::NUM_PRIO; prio++)
+        {
+          if (mask & (1 << prio))
+            {
+              m_rows[cl->m_level][prio].erase (cl->m_id);
+            }
+        }
+    }
+}
+
+void
+HtbQueueDisc::Activate (Ptr<HtbClass> cl)
+{
+  NS_LOG_FUNCTION (this << cl->m_id);
+  NS_ASSERT (cl->m_isLeaf && !cl->m_activity);
+
+  cl->m_activity = (1 << cl->m_prio);
+  ActivatePrios (cl);
+}
+
+void
+HtbQueueDisc::Deactivate (Ptr<HtbClass> cl)
+{
+  NS_LOG_FUNCTION (this << cl->m_id);
+  NS_ASSERT (cl->m_isLeaf && cl->m_activity);
+
+  DeactivatePrios (cl);
+  cl->m_activity = 0;
+}
+
+void
+HtbQueueDisc::AddToWaitQueue (Ptr<HtbClass> cl, int64_t delay)
+{
+  NS_LOG_FUNCTION (this << cl->m_id << delay);
+  NS_ASSERT (cl->m_waitKey < 0);
+
+  cl->m_waitKey = Simulator::Now ().GetNanoSeconds () + std::max (delay, (int64_t) 1);
+  m_waitQueue.insert (std::make_pair (cl->m_waitKey, cl->m_id));
+}
+
+void
+HtbQueueDisc::RemoveFromWaitQueue (Ptr<HtbClass> cl)
+{
+  NS_LOG_FUNCTION (this << cl->m_id);
+
+  if (cl->m_waitKey >= 0)
+    {
+      m_waitQueue.erase (std::make_pair (cl->m_waitKey, cl->m_id));
+      cl->m_waitKey = -1;
+    }
+}
+
+void
+HtbQueueDisc::DoEvents (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  int64_t now = Simulator::Now ().GetNanoSeconds ();
+  while (!m_waitQueue.empty () && m_waitQueue.begin ()->first <= now)
+    {
+      Ptr<HtbClass> cl = GetClass (m_waitQueue.begin ()->second);
+      m_waitQueue.erase (m_waitQueue.begin ());
+      cl->m_waitKey = -1;
+
+      int64_t diff = std::min (now - cl->m_checkpoint, HTB_MAX_BUFFER);
+      ChangeClassMode (cl, diff);
+      if (cl->m_mode != HtbClass::CAN_SEND)
+        {
+          AddToWaitQueue (cl, diff);
+        }
+    }
+}
+
+uint32_t
+HtbQueueDisc::LookupNext (const std::set<uint32_t> &ids, uint32_t next)
+{
+  NS_ASSERT (!ids.empty ());
+
+  std::set<uint32_t>::const_iterator it = ids.lower_bound (next);
+  if (it == ids.end ())
+    {
+      it = ids.begin ();
+    }
+  return *it;
+}
+
+Ptr<HtbClass>
+HtbQueueDisc::LookupLeaf (uint32_t level, uint32_t prio) const
+{
+  NS_LOG_FUNCTION (this << level << prio);
+
+  Ptr<HtbClass> cl = GetClass (LookupNext (m_rows[level][prio], m_rowNext[level][prio]));
+  while (!cl->m_isLeaf)
+    {
+      cl = GetClass (LookupNext (cl->m_feed[prio], cl->m_feedNext[prio]));
+    }
+  return cl;
+}
+
+void
+HtbQueueDisc::NextLeaf (Ptr<HtbClass> cl, uint32_t level, uint32_t prio)
+{
+  NS_LOG_FUNCTION (this << cl->m_id << level << prio);
+
+  // as in Linux, only the pointer of the set the leaf is directly in moves
+  if (level == 0)
+    {
+      m_rowNext[0][prio] = cl->m_id + 1;
+    }
+  else
+    {
+      cl->m_parent->m_feedNext[prio] = cl->m_id + 1;
+    }
+}
+
+Ptr<QueueDiscItem>
+HtbQueueDisc::DequeueTree (uint32_t level, uint32_t prio)
+{
+  NS_LOG_FUNCTION (this << level << prio);
+
+  Ptr<HtbClass> start = LookupLeaf (level, prio);
+  Ptr<HtbClass> cl = start;
+  Ptr<QueueDiscItem> item;
+
+  while (true)
+    {
+      if (cl->GetQueueDisc ()->GetNPackets () == 0)
+        {
+          // the child queue disc dropped its packets
+          Deactivate (cl);
+          if (m_rows[level][prio].empty ())
+            {
+              return 0;
+            }
+          Ptr<HtbClass> next = LookupLeaf (level, prio);
+          if (cl == start)
+            {
+              start = next;
+            }
+          cl = next;
+          continue;
+        }
+
+      item = cl->GetQueueDisc ()->Dequeue ();
+      if (item)
+        {
+          break;
+        }
+      if (cl->GetQueueDisc ()->GetNPackets () == 0)
+        {
+          continue;
+        }
+
+      NS_LOG_WARN ("The child queue disc of class " << cl->m_id << " is backlogged but returned no packet");
+      NextLeaf (cl, level, prio);
+      cl = LookupLeaf (level, prio);
+      if (cl == start)
+        {
+          return 0;
+        }
+    }
+
+  uint32_t bytes = item->GetPacketSize ();
+  cl->m_deficit[level] -= bytes;
+  if (cl->m_deficit[level] < 0)
+    {
+      cl->m_deficit[level] += cl->m_quantum;
+      NextLeaf (cl, level, prio);
+    }
+
+  if (cl->GetQueueDisc ()->GetNPackets () == 0)
+    {
+      Deactivate (cl);
+    }
+  ChargeClass (cl, level, bytes);
+
+  NS_LOG_DEBUG ("Dequeued packet " << item->GetPacket () << " from class " << cl->m_id
+                << " at level " << level);
+  return item;
+}
+
+void
+HtbQueueDisc::ChargeClass (Ptr<HtbClass> cl, uint32_t level, uint32_t bytes)
+{
+  NS_LOG_FUNCTION (this << cl->m_id << level << bytes);
+
+  int64_t now = Simulator::Now ().GetNanoSeconds ();
+  while (cl)
+    {
+      int64_t diff = std::min (now - cl->m_checkpoint, HTB_MAX_BUFFER);
+      if (cl->m_level >= level)
+        {
+          int64_t toks = std::min (cl->m_tokens + diff, cl->m_buffer);
+          toks -= cl->m_rate.CalculateBytesTxTime (bytes).GetNanoSeconds ();
+          cl->m_tokens = std::max (toks, 1 - HTB_MAX_BUFFER);
+        }
+      else
+        {
+          // the class sent with the tokens of an ancestor
+          cl->m_nBorrowed++;
+          cl->m_tokens += diff;
+        }
+      int64_t ctoks = std::min (cl->m_ctokens + diff, cl->m_cbuffer);
+      ctoks -= cl->m_ceil.CalculateBytesTxTime (bytes).GetNanoSeconds ();
+      cl->m_ctokens = std::max (ctoks, 1 - HTB_MAX_BUFFER);
+      cl->m_checkpoint = now;
+
+      HtbClass::Mode oldMode = cl->m_mode;
+      diff = 0;
+      ChangeClassMode (cl, diff);
+      if (oldMode != cl->m_mode)
+        {
+          if (oldMode != HtbClass::CAN_SEND)
+            {
+              RemoveFromWaitQueue (cl);
+            }
+          if (cl->m_mode != HtbClass::CAN_SEND)
+            {
+              AddToWaitQueue (cl, diff);
+            }
+        }
+      cl = cl->m_parent;
+    }
+}
+
+void
+HtbQueueDisc::ScheduleWatchdog (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  if (m_waitQueue.empty () || !GetNetDevice ())
+    {
+      // without a device, there is no queue disc to run
+      return;
+    }
+
+  Time delay = NanoSeconds (m_waitQueue.begin ()->first) - Simulator::Now ();
+  Simulator::Cancel (m_watchdog);
+  m_watchdog = Simulator::Schedule (delay, &HtbQueueDisc::Watchdog, this);
+}
+
+void
+HtbQueueDisc::Watchdog (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  if (!m_isChild)
+    {
+      Run ();
+      return;
+    }
+
+  // as in Linux, a child wakes up the root queue disc, which dequeues from
+  // it through its parent. The children of a root whose wake mode is
+  // WAKE_CHILD (e.g., mq) are instead run by the device, as roots
+  Ptr<Node> node = GetNetDevice ()->GetNode ();
+  Ptr<TrafficControlLayer> tc = node ? node->GetObject<TrafficControlLayer> () : 0;
+  Ptr<QueueDisc> root = tc ? tc->GetRootQueueDiscOnDevice (GetNetDevice ()) : 0;
+  if (!root)
+    {
+      NS_LOG_WARN ("No root queue disc to run on the device");
+      return;
+    }
+  if (root->GetWakeMode () == WAKE_CHILD)
+    {
+      Run ();
+    }
+  else
+    {
+      root->Run ();
+    }
+}
+
+void
+HtbQueueDisc::SetParentDropCallback (ParentDropCallback cb)
+{
+  NS_LOG_FUNCTION (this);
+  m_isChild = !cb.IsNull ();
+  QueueDisc::SetParentDropCallback (cb);
+}
+
+bool
+HtbQueueDisc::CheckConfig (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (GetNInternalQueues () > 0)
+    {
+      NS_LOG_ERROR ("HtbQueueDisc cannot have internal queues");
+      return false;
+    }
+
+  if (GetNQueueDiscClasses () == 0)
+    {
+      NS_LOG_ERROR ("HtbQueueDisc needs at least a class");
+      return false;
+    }
+
+  // the leaves keep their index, the inner classes follow
+  m_tree.clear ();
+  for (uint32_t i = 0; i < GetNQueueDiscClasses (); i++)
+    {
+      Ptr<HtbClass> cl = DynamicCast<HtbClass> (GetQueueDiscClass (i));
+      if (!cl)
+        {
+          NS_LOG_ERROR ("HtbQueueDisc needs classes of type HtbClass");
+          return false;
+        }
+      cl->m_id = i;
+      cl->m_level = 0;
+      cl->m_isLeaf = true;
+      m_tree.push_back (cl);
+    }
+
+  std::map<Ptr<HtbClass>, uint32_t> inner;
+  m_nLevels = 1;
+  for (uint32_t i = 0; i < GetNQueueDiscClasses (); i++)
+    {
+      uint32_t level = 1;
+      for (Ptr<HtbClass> p = m_tree[i]->m_parent; p; p = p->m_parent, level++)
+        {
+          if (p->GetQueueDisc ())
+            {
+              NS_LOG_ERROR ("The parent of an HtbClass cannot have a queue disc");
+              return false;
+            }
+          if (level >= HtbClass::MAX_DEPTH)
+            {
+              NS_LOG_ERROR ("The HtbQueueDisc class tree has more than " << HtbClass::MAX_DEPTH << " levels or a loop");
+              return false;
+            }
+          if (inner.find (p) == inner.end ())
+            {
+              inner[p] = m_tree.size ();
+              p->m_id = m_tree.size ();
+              p->m_level = 0;
+              p->m_isLeaf = false;
+              m_tree.push_back (p);
+            }
+          p->m_level = std::max (p->m_level, level);
+          m_nLevels = std::max (m_nLevels, level + 1);
+        }
+    }
+
+  for (uint32_t i = 0; i < m_tree.size (); i++)
+    {
+      Ptr<HtbClass> cl = m_tree[i];
+      if (cl->m_rate.GetBitRate () == 0)
+        {
+          NS_LOG_ERROR ("The rate of an HtbClass cannot be zero");
+          return false;
+        }
+      if (cl->m_ceil.GetBitRate () != 0 && cl->m_ceil < cl->m_rate)
+        {
+          NS_LOG_ERROR ("The ceil of an HtbClass cannot be lower than its rate");
+          return false;
+        }
+    }
+
+  return true;
+}
+
+void
+HtbQueueDisc::InitializeParams (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  uint32_t mtu = 1500;
+  if (GetNetDevice ())
+    {
+      mtu = GetNetDevice ()->GetMtu ();
+    }
+
+  int64_t now = Simulator::Now ().GetNanoSeconds ();
+  for (uint32_t i = 0; i < m_tree.size (); i++)
+    {
+      Ptr<HtbClass> cl = m_tree[i];
+      if (cl->m_ceil.GetBitRate () == 0)
+        {
+          cl->m_ceil = cl->m_rate;
+        }
+      // as tc does, the bucket holds what is sent at the rate in a
+      // jiffy (1ms) plus a packet
+      if (!cl->m_burst)
+        {
+          cl->m_burst = cl->m_rate.GetBitRate () / 8000 + mtu;
+        }
+      if (!cl->m_cburst)
+        {
+          cl->m_cburst = cl->m_ceil.GetBitRate () / 8000 + mtu;
+        }
+      // as tc does with the default r2q of 10
+      if (!cl->m_quantum)
+        {
+          uint64_t quantum = cl->m_rate.GetBitRate () / 80;
+          cl->m_quantum = std::min (std::max (quantum, (uint64_t) 1000), (uint64_t) 200000);
+        }
+      NS_LOG_DEBUG ("Class " << i << " level " << cl->m_level << " rate " << cl->m_rate
+                    << " ceil " << cl->m_ceil << " quantum " << cl->m_quantum);
+
+      cl->m_buffer = cl->m_rate.CalculateBytesTxTime (cl->m_burst).GetNanoSeconds ();
+      cl->m_cbuffer = cl->m_ceil.CalculateBytesTxTime (cl->m_cburst).GetNanoSeconds ();
+      cl->m_tokens = cl->m_buffer;
+      cl->m_ctokens = cl->m_cbuffer;
+      cl->m_checkpoint = now;
+      cl->m_mode = HtbClass::CAN_SEND;
+      cl->m_waitKey = -1;
+      cl->m_activity = 0;
+      cl->m_nBorrowed = 0;
+      for (uint32_t level = 0; level < HtbClass::MAX_DEPTH; level++)
+        {
+          cl->m_deficit[level] = 0;
+        }
+      for (uint32_t prio = 0; prio < HtbClass::NUM_PRIO; prio++)
+        {
+          cl->m_feed[prio].clear ();
+          cl->m_feedNext[prio] = 0;
+        }
+
+      // a leaf queue disc that needs the rate it is served at (e.g., LDC)
+      // and is not initialized yet gets the rate of the class
+      DataRateValue bandwidth;
+      if (cl->m_isLeaf && cl->GetQueueDisc ()->GetAttributeFailSafe ("LinkBandwidth", bandwidth)
+          && bandwidth.Get ().GetBitRate () == 0)
+        {
+          cl->GetQueueDisc ()->SetAttribute ("LinkBandwidth", DataRateValue (cl->m_rate));
+        }
+    }
+
+  for (uint32_t level = 0; level < HtbClass::MAX_DEPTH; level++)
+    {
+      for (uint32_t prio = 0; prio < HtbClass::NUM_PRIO; prio++)
+        {
+          m_rows[level][prio].clear ();
+          m_rowNext[level][prio] = 0;
+        }
+    }
+  m_waitQueue.clear ();
+}
+
+} // namespace ns3
@@ -60,15 +60,128 @@
 #include "ns3/enum.h"
 #include "ns3/uinteger.h"
 #include "ns3/double.h"
+#include "ns3/string.h"
 #include "ns3/simulator.h"
 #include "ns3/abort.h"
 #include "ldc-queue-disc.h"
 #include "ns3/drop-tail-queue.h"
+#include "ns3/aqm-fixed-point.h"
+#include <algorithm>
 
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("LdcQueueDisc");
 
+/**
+ * Number of values of (1 - qW)^m stored in the table used when FastPow is
+ * enabled. Idle periods are usually short compared to the time needed to
+ * send that many packets, so larger exponents are seldom used.
+ */
+static const uint32_t LDC_DECAY_TABLE_SIZE = 256;
+
+/**
+ * Link bandwidth assumed when LinkBandwidth is not set and the device does
+ * not expose its data rate (the default of ns-2).
+ */
+static const char *LDC_DEFAULT_LINK_BANDWIDTH = "1.5Mbps";
+
+/**
+ * Relative error of the average queueing delay tolerated in adaptive mode
+ * before WQ and the effective target are changed.
+ */
+static const double LDC_ADAPT_TOLERANCE = 0.1;
+
+/**
+ * Bounds of the effective target in adaptive mode, as multiples of
+ * TargetQueueingDelay. The effective target may exceed the target, since
+ * the delay component only reaches 1 when the delay reaches the effective
+ * target, whereas the queue settles where the drop probability balances
+ * the excess load.
+ */
+static const double LDC_ADAPT_MIN_TARGET = 0.1;
+static const double LDC_ADAPT_MAX_TARGET = 4.0;
+
+/**
+ * LDC time stamp, used to compute the sojourn time of the packets when
+ * UseSojournTime is enabled.
+ */
+class LdcTimestampTag : public Tag
+{
+public:
+  LdcTimestampTag ();
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  virtual TypeId GetInstanceTypeId (void) const;
+
+  virtual uint32_t GetSerializedSize (void) const;
+  virtual void Serialize (TagBuffer i) const;
+  virtual void Deserialize (TagBuffer i);
+  virtual void Print (std::ostream &os) const;
+
+  /**
+   * Gets the Tag creation time
+   * @return the time object stored in the tag
+   */
+  Time GetTxTime (void) const;
+private:
+  uint64_t m_creationTime; //!< Tag creation time
+};
+
+LdcTimestampTag::LdcTimestampTag ()
+  : m_creationTime (Simulator::Now ().GetTimeStep ())
+{
+}
+
+TypeId
+LdcTimestampTag::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::LdcTimestampTag")
+    .SetParent<Tag> ()
+    .AddConstructor<LdcTimestampTag> ()
+    .AddAttribute ("CreationTime",
+                   "The time at which the timestamp was created",
+                   StringValue ("0.0s"),
+                   MakeTimeAccessor (&LdcTimestampTag::GetTxTime),
+                   MakeTimeChecker ())
+  ;
+  return tid;
+}
+
+TypeId
+LdcTimestampTag::GetInstanceTypeId (void) const
+{
+  return GetTypeId ();
+}
+
+uint32_t
+LdcTimestampTag::GetSerializedSize (void) const
+{
+  return 8;
+}
+void
+LdcTimestampTag::Serialize (TagBuffer i) const
+{
+  i.WriteU64 (m_creationTime);
+}
+void
+LdcTimestampTag::Deserialize (TagBuffer i)
+{
+  m_creationTime = i.ReadU64 ();
+}
+void
+LdcTimestampTag::Print (std::ostream &os) const
+{
+  os << "CreationTime=" << m_creationTime;
+}
+Time
+LdcTimestampTag::GetTxTime (void) const
+{
+  return TimeStep (m_creationTime);
+}
+
 NS_OBJECT_ENSURE_REGISTERED (LdcQueueDisc);
 
 TypeId LdcQueueDisc::GetTypeId (void)
@@ -83,6 +196,11 @@ TypeId LdcQueueDisc::GetTypeId (void)
                    MakeEnumAccessor (&LdcQueueDisc::SetMode),
                    MakeEnumChecker (Queue::QUEUE_MODE_BYTES, "QUEUE_MODE_BYTES",
                                     Queue::QUEUE_MODE_PACKETS, "QUEUE_MODE_PACKETS"))
+    .AddAttribute ("UseRingBuffer",
+                   "True to use a RingBufferQueue sized from the queue limit as internal queue",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&LdcQueueDisc::m_useRingBuffer),
+                   MakeBooleanChecker ())
     .AddAttribute ("MeanPktSize",
                    "Average of packet size",
                    UintegerValue (500),
@@ -99,8 +217,8 @@ TypeId LdcQueueDisc::GetTypeId (void)
                    MakeDoubleAccessor (&LdcQueueDisc::m_qW),
                    MakeDoubleChecker <double> ())
     .AddAttribute ("LinkBandwidth", 
-                   "The LDC link bandwidth",
-                   DataRateValue (DataRate ("1.5Mbps")),
+                   "The LDC link bandwidth. If 0, the DataRate of the device is used and its changes are tracked",
+                   DataRateValue (DataRate ("0b/s")),
                    MakeDataRateAccessor (&LdcQueueDisc::m_linkBandwidth),
                    MakeDataRateChecker ())
     .AddAttribute ("LinkDelay", 
@@ -108,7 +226,7 @@ TypeId LdcQueueDisc::GetTypeId (void)
                    TimeValue (MilliSeconds (20)),
                    MakeTimeAccessor (&LdcQueueDisc::m_linkDelay),
                    MakeTimeChecker ())
-    .AddAttribute ("Time Interval", 
+    .AddAttribute ("TimeInterval",
                    "The time interval after which LDC calculates queueing delay",
                    TimeValue (Seconds (0.002)),
                    MakeTimeAccessor (&LdcQueueDisc::m_oInterval),
@@ -119,25 +237,108 @@ TypeId LdcQueueDisc::GetTypeId (void)
                    MakeDoubleAccessor (&LdcQueueDisc::m_wt1),
                    MakeDoubleChecker <double> ())
     .AddAttribute ("WQ", 
-                   "Weight for the delay component in drop probability calculation",
+                   "Weight for the delay component in drop probability calculation (initial value in adaptive mode)",
                    DoubleValue (0.75),
                    MakeDoubleAccessor (&LdcQueueDisc::m_wQ),
                    MakeDoubleChecker <double> ())
-    .AddAttribute ("Target Queueing Delay", 
+    .AddAttribute ("TargetQueueingDelay",
                    "The LDC target queueing delay",
                    TimeValue (Seconds (4.0)),
                    MakeTimeAccessor (&LdcQueueDisc:: m_dTarget),
                    MakeTimeChecker ())
-    .AddAttribute ("Target Load Factor Ratio", 
+    .AddAttribute ("TargetLoadFactorRatio",
                    "The LDC target load factor ratio",
                    DoubleValue (0.95),
                    MakeDoubleAccessor (&LdcQueueDisc::m_rTarget),
                    MakeDoubleChecker <double> ())
-    .AddAttribute ("LDC Exponent",
+    .AddAttribute ("LdcExponent",
                    "Exponent value used in drop probability calculation",
                    UintegerValue (3),
                    MakeUintegerAccessor (&LdcQueueDisc::m_lExp),
                    MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("LazyTimeout",
+                   "True to update the drop probability on enqueue/dequeue instead of scheduling a timer",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&LdcQueueDisc::m_isLazy),
+                   MakeBooleanChecker ())
+    .AddAttribute ("UseEcn",
+                   "True to mark ECN capable packets instead of dropping them early",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&LdcQueueDisc::m_useEcn),
+                   MakeBooleanChecker ())
+    .AddAttribute ("FastPow",
+                   "True to compute the powers in the drop probability and in the average queue size without calling pow",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&LdcQueueDisc::m_fastPow),
+                   MakeBooleanChecker ())
+    .AddAttribute ("FixedPoint",
+                   "True to run the control law in fixed point arithmetic (not with UseSojournTime or Adaptive). "
+                   "The DropProbability, AverageQueueSize and LoadFactor trace sources are then not updated",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&LdcQueueDisc::m_fixedPoint),
+                   MakeBooleanChecker ())
+    .AddAttribute ("UseSojournTime",
+                   "True to use the measured sojourn time and departure rate instead of the queue length and LinkBandwidth",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&LdcQueueDisc::m_useSojourn),
+                   MakeBooleanChecker ())
+    .AddAttribute ("DequeueThreshold",
+                   "Minimum queue size in bytes before the departure rate is measured",
+                   UintegerValue (10000),
+                   MakeUintegerAccessor (&LdcQueueDisc::m_dqThreshold),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("MaxBurstAllowance",
+                   "Time after a long idle period during which no packet is dropped early while the queue is below the target. 0 disables the burst allowance",
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&LdcQueueDisc::m_maxBurst),
+                   MakeTimeChecker ())
+    .AddAttribute ("IdleReset",
+                   "True to restart the average queue size and the drop probability after an idle period long enough to drain the target queue size",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&LdcQueueDisc::m_idleReset),
+                   MakeBooleanChecker ())
+    .AddAttribute ("Adaptive",
+                   "True to adapt WQ and the effective target queueing delay to the measured queueing delay",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&LdcQueueDisc::m_isAdaptive),
+                   MakeBooleanChecker ())
+    .AddAttribute ("AdaptInterval",
+                   "Time interval between two adaptations of WQ and of the effective target",
+                   TimeValue (Seconds (0.5)),
+                   MakeTimeAccessor (&LdcQueueDisc::m_adaptInterval),
+                   MakeTimeChecker ())
+    .AddAttribute ("AdaptAlpha",
+                   "Step of WQ in adaptive mode",
+                   DoubleValue (0.02),
+                   MakeDoubleAccessor (&LdcQueueDisc::m_adaptAlpha),
+                   MakeDoubleChecker <double> (0, 1))
+    .AddAttribute ("AdaptBeta",
+                   "Factor by which the effective target is multiplied (delay too high) or divided (delay too low) in adaptive mode",
+                   DoubleValue (0.95),
+                   MakeDoubleAccessor (&LdcQueueDisc::m_adaptBeta),
+                   MakeDoubleChecker <double> (0, 1))
+    .AddAttribute ("WQTop",
+                   "Upper bound for WQ in adaptive mode",
+                   DoubleValue (0.95),
+                   MakeDoubleAccessor (&LdcQueueDisc::m_wQTop),
+                   MakeDoubleChecker <double> (0, 1))
+    .AddAttribute ("WQBottom",
+                   "Lower bound for WQ in adaptive mode",
+                   DoubleValue (0.05),
+                   MakeDoubleAccessor (&LdcQueueDisc::m_wQBottom),
+                   MakeDoubleChecker <double> (0, 1))
+    .AddTraceSource ("DropProbability",
+                     "The drop probability",
+                     MakeTraceSourceAccessor (&LdcQueueDisc::m_vProb),
+                     "ns3::TracedValueCallback::Double")
+    .AddTraceSource ("AverageQueueSize",
+                     "The average queue size",
+                     MakeTraceSourceAccessor (&LdcQueueDisc::m_qAvg),
+                     "ns3::TracedValueCallback::Double")
+    .AddTraceSource ("LoadFactor",
+                     "The ratio of the arrival rate to the link capacity",
+                     MakeTraceSourceAccessor (&LdcQueueDisc::m_ratio),
+                     "ns3::TracedValueCallback::Double")
   ;
 
   return tid;
@@ -162,6 +363,11 @@ LdcQueueDisc::DoDispose (void)
   NS_LOG_FUNCTION (this);
   m_uv = 0;
   Simulator::Remove (m_rtrsEvent);
+  if (m_linkBandwidth.GetBitRate () == 0 && GetNetDevice ())
+    {
+      GetNetDevice ()->TraceDisconnectWithoutContext ("DataRateChange",
+                                                      MakeCallback (&LdcQueueDisc::SetLinkRate, this));
+    }
   QueueDisc::DoDispose ();
 }
 
@@ -194,6 +400,53 @@ LdcQueueDisc::GetStats ()
   return m_stats;
 }
 
+double
+LdcQueueDisc::GetDropProbability (void) const
+{
+  NS_LOG_FUNCTION (this);
+  if (m_fixedPoint)
+    {
+      return AqmFixedPoint::ToDouble (m_vProbFp, AqmFixedPoint::PROB_SHIFT);
+    }
+  return m_vProb;
+}
+
+double
+LdcQueueDisc::GetAverageQueueSize (void) const
+{
+  NS_LOG_FUNCTION (this);
+  if (m_fixedPoint)
+    {
+      return AqmFixedPoint::ToDouble (m_qAvgFp, AqmFixedPoint::QUEUE_SHIFT);
+    }
+  return m_qAvg;
+}
+
+double
+LdcQueueDisc::GetLoadFactor (void) const
+{
+  NS_LOG_FUNCTION (this);
+  if (m_fixedPoint)
+    {
+      return AqmFixedPoint::ToDouble (m_rLoadFp, AqmFixedPoint::PROB_SHIFT) * m_rTarget;
+    }
+  return m_ratio;
+}
+
+double
+LdcQueueDisc::GetCurrentWq (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_curWq;
+}
+
+Time
+LdcQueueDisc::GetEffectiveTarget (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return Seconds (m_effTarget);
+}
+
 int64_t 
 LdcQueueDisc::AssignStreams (int64_t stream)
 {
@@ -207,30 +460,101 @@ LdcQueueDisc::Timeout ()
 {
   NS_LOG_FUNCTION (this);
 
+  UpdateIntervals (Simulator::Now (), 1);
+
+  m_rtrsEvent = Simulator::Schedule (m_oInterval, &LdcQueueDisc::Timeout, this);
+}
+
+void
+LdcQueueDisc::UpdateIntervals (Time first, uint64_t n)
+{
+  NS_LOG_FUNCTION (this << first << n);
+
   uint32_t nQueued = GetQueueSize ();
 
+  if (m_useSojourn && m_avgDqRate > 0)
+    {
+      // follow the rate at which the link actually drains the queue
+      m_ptc = m_avgDqRate / m_meanPktSize;
+    }
+
+  // the sojourn time of the last departure is only meaningful while
+  // there are packets waiting behind it
+  double sojourn = (nQueued > 0) ? m_sojourn.GetSeconds () : 0.0;
+
   uint32_t m = 0;
 
   if (m_idle == 1)
     {
       NS_LOG_DEBUG ("LDC Queue Disc is idle.");
-      Time now = Simulator::Now ();
 
       m_idle = 0;     
-      m = uint32_t (m_ptc * (now - m_idleTime).GetSeconds ());
+      m = uint32_t (m_ptc * (first - m_idleTime).GetSeconds ());
     }
 
-  // overload factor
-  m_nPkt = ((1.0 - m_wt1) * m_nPkt) + (m_wt1 * m_nIncome);
+  if (m_fixedPoint)
+    {
+      UpdateIntervalsFixed (nQueued, m, n);
+      return;
+    }
+
+  // overload factor, in byte mode the arrivals are counted in bytes so that
+  // the load does not depend on the mix of packet sizes
+  double income = (GetMode () == Queue::QUEUE_MODE_BYTES) ? m_bCount : m_nIncome;
+  m_nPkt = ((1.0 - m_wt1) * m_nPkt) + (m_wt1 * income);
   m_nIncome = 0;
+  m_bCount = 0;
+
+  m_qAvg = Estimator (nQueued, m + 1, m_qAvg, m_qW);
+  if (m_useSojourn)
+    {
+      m_dAvg = Estimator (sojourn, m + 1, m_dAvg, m_qW);
+    }
+
+  // The remaining intervals see no arrivals and the same queue size. Both
+  // averages are iterated exactly as Timeout would do, and the loop ends as
+  // soon as they reach a fixed point, after which further intervals are no-ops
+  for (uint64_t i = 1; i < n; i++)
+    {
+      double nPkt = m_nPkt;
+      double qAvg = m_qAvg;
+      double dAvg = m_dAvg;
+
+      m_nPkt = ((1.0 - m_wt1) * m_nPkt) + (m_wt1 * m_nIncome);
+      m_qAvg = Estimator (nQueued, 1, m_qAvg, m_qW);
+      if (m_useSojourn)
+        {
+          m_dAvg = Estimator (sojourn, 1, m_dAvg, m_qW);
+        }
+
+      if (m_nPkt == nPkt && m_qAvg == qAvg && m_dAvg == dAvg)
+        {
+          NS_LOG_LOGIC ("Fixed point reached after " << i << " of " << n << " intervals");
+          break;
+        }
+    }
+
   double mm = m_oInterval.GetSeconds () * m_ptc;
+  if (GetMode () == Queue::QUEUE_MODE_BYTES)
+    {
+      mm *= m_meanPktSize;
+    }
   m_ratio = m_nPkt / mm;
- 
-  m_qAvg = Estimator (nQueued, m + 1, m_qAvg, m_qW);
 
   /* qlen + load */
-  double qRatio = pow ((m_qAvg / m_qTarget), m_lExp);
-  double rRatio = pow ((m_ratio / m_rTarget), m_lExp);
+  double qLoad = m_useSojourn ? m_dAvg / m_effTarget : m_qAvg.Get () / m_qTarget;
+  double qRatio;
+  double rRatio;
+  if (m_fastPow)
+    {
+      qRatio = IntPow (qLoad, m_lExp);
+      rRatio = IntPow (m_ratio.Get () / m_rTarget, m_lExp);
+    }
+  else
+    {
+      qRatio = pow (qLoad, m_lExp);
+      rRatio = pow ((m_ratio.Get () / m_rTarget), m_lExp);
+    }
   
   if (qRatio > 1)
     {
@@ -242,20 +566,164 @@ LdcQueueDisc::Timeout ()
       rRatio = 1;
     }
 
-  m_vProb = (m_wQ * qRatio) + ((1-m_wQ) * rRatio);
+  m_vProb = (m_curWq * qRatio) + ((1-m_curWq) * rRatio);
 
-  m_rtrsEvent = Simulator::Schedule (m_oInterval, &LdcQueueDisc::Timeout, this);
+  if (m_isAdaptive && first >= m_lastSet + m_adaptInterval)
+    {
+      Adapt (first, qRatio, rRatio);
+    }
+}
+
+void
+LdcQueueDisc::UpdateIntervalsFixed (uint32_t nQueued, uint32_t m, uint64_t n)
+{
+  NS_LOG_FUNCTION (this << nQueued << m << n);
+
+  const uint64_t one = AqmFixedPoint::ONE;
+  const uint32_t probShift = AqmFixedPoint::PROB_SHIFT;
+  const uint32_t queueShift = AqmFixedPoint::QUEUE_SHIFT;
+
+  uint64_t income = (GetMode () == Queue::QUEUE_MODE_BYTES) ? m_bCount : m_nIncome;
+  m_nIncome = 0;
+  m_bCount = 0;
+
+  // nPkt = (1 - wt1) * nPkt + wt1 * income
+  m_nPktFp = AqmFixedPoint::MulShift (m_nPktFp, one - m_wt1Fp, probShift)
+    + AqmFixedPoint::MulShift (income, m_wt1Fp, probShift - queueShift);
+  // qAvg = (1 - qW)^(m + 1) * qAvg + qW * nQueued
+  m_qAvgFp = AqmFixedPoint::MulShift (m_qAvgFp, DecayFixed (m + 1), probShift)
+    + AqmFixedPoint::MulShift (nQueued, m_qWFp, probShift - queueShift);
+
+  // The remaining intervals see no arrivals and the same queue size. As in
+  // floating point, both averages are iterated exactly as Timeout would do,
+  // so that the result does not depend on LazyTimeout, and the loop ends as
+  // soon as they reach a fixed point
+  uint64_t queued = AqmFixedPoint::MulShift (nQueued, m_qWFp, probShift - queueShift);
+  for (uint64_t i = 1; i < n; i++)
+    {
+      uint64_t nPkt = m_nPktFp;
+      uint64_t qAvg = m_qAvgFp;
+
+      m_nPktFp = AqmFixedPoint::MulShift (m_nPktFp, one - m_wt1Fp, probShift);
+      m_qAvgFp = AqmFixedPoint::MulShift (m_qAvgFp, one - m_qWFp, probShift) + queued;
+
+      if (m_nPktFp == nPkt && m_qAvgFp == qAvg)
+        {
+          NS_LOG_LOGIC ("Fixed point reached after " << i << " of " << n << " intervals");
+          break;
+        }
+    }
+
+  // the loads are relative to the targets, so that the ratios saturate at one
+  uint64_t qLoad = AqmFixedPoint::MulShift (m_qAvgFp, m_invQTargetFp, queueShift);
+  m_rLoadFp = AqmFixedPoint::MulShift (m_nPktFp, m_invRTargetFp, queueShift);
+  uint64_t qRatio = AqmFixedPoint::Pow (qLoad, m_lExp);
+  uint64_t rRatio = AqmFixedPoint::Pow (m_rLoadFp, m_lExp);
+
+  // the floating point variables (and their trace sources) are not updated,
+  // the accessors convert the fixed point ones when they are called
+  m_vProbFp = AqmFixedPoint::MulShift (m_wQFp, qRatio, probShift)
+    + AqmFixedPoint::MulShift (one - m_wQFp, rRatio, probShift);
+}
+
+void
+LdcQueueDisc::Adapt (Time now, double qRatio, double rRatio)
+{
+  NS_LOG_FUNCTION (this << now << qRatio << rRatio);
+
+  // average queueing delay, estimated from the average queue size unless
+  // the sojourn times are measured
+  double delay = m_dAvg;
+  if (!m_useSojourn)
+    {
+      double rate = m_ptc;
+      if (GetMode () == Queue::QUEUE_MODE_BYTES)
+        {
+          rate *= m_meanPktSize;
+        }
+      delay = m_qAvg.Get () / rate;
+    }
+
+  double target = m_dTarget.GetSeconds ();
+  int direction;
+  if (delay > target * (1 + LDC_ADAPT_TOLERANCE))
+    {
+      // more drops are needed: tighten the effective target
+      direction = 1;
+      m_effTarget = std::max (m_effTarget * m_adaptBeta, target * LDC_ADAPT_MIN_TARGET);
+    }
+  else if (delay < target * (1 - LDC_ADAPT_TOLERANCE))
+    {
+      // fewer drops are needed: relax the effective target
+      direction = -1;
+      m_effTarget = std::min (m_effTarget / m_adaptBeta, target * LDC_ADAPT_MAX_TARGET);
+    }
+  else
+    {
+      return;
+    }
+  m_lastSet = now;
+
+  // The drop probability increases with WQ if the delay component is the
+  // larger one, hence WQ moves towards the component that changes the drop
+  // probability in the needed direction
+  double gradient = direction * (qRatio - rRatio);
+  if (gradient > 0)
+    {
+      m_curWq = std::min (m_curWq + m_adaptAlpha, m_wQTop);
+    }
+  else if (gradient < 0)
+    {
+      m_curWq = std::max (m_curWq - m_adaptAlpha, m_wQBottom);
+    }
+
+  m_qTarget = m_effTarget * m_ptc;
+  if (GetMode () == Queue::QUEUE_MODE_BYTES)
+    {
+      m_qTarget *= m_meanPktSize;
+    }
+  NS_LOG_DEBUG ("Delay " << delay << "; m_curWq " << m_curWq << "; m_effTarget " << m_effTarget);
+}
+
+void
+LdcQueueDisc::CatchUp (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  Time now = Simulator::Now ();
+  if (now < m_nextTimeout)
+    {
+      return;
+    }
+
+  // number of intervals expired in (m_nextTimeout - m_oInterval, now]
+  uint64_t n = (now - m_nextTimeout).GetTimeStep () / m_oInterval.GetTimeStep () + 1;
+
+  UpdateIntervals (m_nextTimeout, n);
+
+  m_nextTimeout = TimeStep (m_nextTimeout.GetTimeStep () + n * m_oInterval.GetTimeStep ());
 }
 
 bool
 LdcQueueDisc::DoEnqueue (Ptr<QueueDiscItem> item)
 {
   NS_LOG_FUNCTION (this << item);
+
+  if (m_isLazy)
+    {
+      CatchUp ();
+    }
    
   m_nIncome++;
+  m_bCount += item->GetPacketSize ();
 
   uint32_t nQueued = GetQueueSize ();
 
+  if (nQueued == 0 && (m_idleReset || m_maxBurst.IsStrictlyPositive ()))
+    {
+      StartBusyPeriod ();
+    }
+
   NS_LOG_DEBUG ("\t bytesInQueue  " << GetInternalQueue (0)->GetNBytes () << "\tQavg " << m_qAvg);
   NS_LOG_DEBUG ("\t packetsInQueue  " << GetInternalQueue (0)->GetNPackets () << "\tQavg " << m_qAvg);
 
@@ -274,7 +742,12 @@ LdcQueueDisc::DoEnqueue (Ptr<QueueDiscItem> item)
       m_stats.qLimDrop++;
     }
 
-  if (dropType == DTYPE_UNFORCED)
+  if (dropType == DTYPE_UNFORCED && m_useEcn && item->Mark ())
+    {
+      NS_LOG_DEBUG ("\t Marking due to Prob Mark " << m_qAvg);
+      m_stats.unforcedMark++;
+    }
+  else if (dropType == DTYPE_UNFORCED)
     {
       NS_LOG_DEBUG ("\t Dropping due to Prob Mark " << m_qAvg);
       m_stats.unforcedDrop++;
@@ -290,6 +763,12 @@ LdcQueueDisc::DoEnqueue (Ptr<QueueDiscItem> item)
       return false;
     }
 
+  if (m_useSojourn)
+    {
+      LdcTimestampTag tag;
+      item->GetPacket ()->AddPacketTag (tag);
+    }
+
   bool retval = GetInternalQueue (0)->Enqueue (item);
 
   // If Queue::Enqueue fails, QueueDisc::Drop is called by the internal queue
@@ -301,56 +780,244 @@ LdcQueueDisc::DoEnqueue (Ptr<QueueDiscItem> item)
   return retval;
 }
 
-/*
- * Note: if the link bandwidth changes in the course of the
- * simulation, the bandwidth-dependent LDC parameters do not change.
- * This should be fixed, but it would require some extra parameters,
- * and didn't seem worth the trouble...
- */
 void
 LdcQueueDisc::InitializeParams (void)
 {
   NS_LOG_FUNCTION (this);
   NS_LOG_INFO ("Initializing LDC params.");
 
-  m_ptc = m_linkBandwidth.GetBitRate () / (8.0 * m_meanPktSize);
+  DataRate rate = m_linkBandwidth;
+  if (rate.GetBitRate () == 0)
+    {
+      Ptr<NetDevice> device = GetNetDevice ();
+      DataRateValue deviceRate;
+      if (device && device->GetAttributeFailSafe ("DataRate", deviceRate) && deviceRate.Get ().GetBitRate () > 0)
+        {
+          rate = deviceRate.Get ();
+          if (!device->TraceConnectWithoutContext ("DataRateChange", MakeCallback (&LdcQueueDisc::SetLinkRate, this)))
+            {
+              NS_LOG_WARN ("The device does not report data rate changes, the link bandwidth is fixed to " << rate);
+            }
+        }
+      else
+        {
+          NS_LOG_WARN ("The device does not expose its data rate, assuming " << LDC_DEFAULT_LINK_BANDWIDTH);
+          rate = DataRate (LDC_DEFAULT_LINK_BANDWIDTH);
+        }
+    }
+  m_ptc = rate.GetBitRate () / (8.0 * m_meanPktSize);
 
   m_stats.forcedDrop = 0;
   m_stats.unforcedDrop = 0;
   m_stats.qLimDrop = 0;
+  m_stats.unforcedMark = 0;
 
   m_qAvg = 0.0;
+  m_vProb = 0.0;
+  m_qAvgFp = 0;
+  m_nPktFp = 0;
+  m_rLoadFp = 0;
+  m_vProbFp = 0;
   m_idle = 1;
 
   m_bCount = 0;
   m_nPkt = 0.0;
   m_ratio = 0.0;
-  m_qTarget = m_dTarget.GetSeconds() * m_ptc; 
+  m_effTarget = m_dTarget.GetSeconds ();
+  m_lastSet = Seconds (0);
+  m_curWq = m_wQ;
+  if (m_isAdaptive)
+    {
+      m_curWq = std::min (std::max (m_curWq, m_wQBottom), m_wQTop);
+    }
+  m_qTarget = m_effTarget * m_ptc;
+  if (GetMode () == Queue::QUEUE_MODE_BYTES)
+    {
+      m_qTarget *= m_meanPktSize;
+    }
   m_nIncome = 0;
 
   m_idleTime = NanoSeconds (0);
 
+  m_sojourn = Seconds (0);
+  m_dAvg = 0.0;
+  m_inMeasurement = false;
+  m_dqStart = Seconds (0);
+  m_dqCount = 0;
+  m_avgDqRate = 0.0;
+  m_lastDeparture = Seconds (0);
+  m_burstEnd = Seconds (0);
+
+  if (m_fastPow)
+    {
+      // The entries of the table are computed by pow, so that the average queue
+      // size is the same as without the table as long as m is within the table
+      m_decay.resize (LDC_DECAY_TABLE_SIZE + 1);
+      for (uint32_t i = 0; i <= LDC_DECAY_TABLE_SIZE; i++)
+        {
+          m_decay[i] = pow (1.0 - m_qW, i);
+        }
+    }
+
+  if (m_fixedPoint)
+    {
+      // The fixed point parameters are rounded once here, the control law
+      // then only uses integer operations
+      m_qWFp = AqmFixedPoint::FromDouble (m_qW, AqmFixedPoint::PROB_SHIFT);
+      m_wt1Fp = AqmFixedPoint::FromDouble (m_wt1, AqmFixedPoint::PROB_SHIFT);
+      m_wQFp = AqmFixedPoint::FromDouble (m_curWq, AqmFixedPoint::PROB_SHIFT);
+      m_decayFp.resize (LDC_DECAY_TABLE_SIZE + 1);
+      m_decayFp[0] = AqmFixedPoint::ONE;
+      for (uint32_t i = 1; i <= LDC_DECAY_TABLE_SIZE; i++)
+        {
+          m_decayFp[i] = AqmFixedPoint::MulShift (m_decayFp[i - 1], AqmFixedPoint::ONE - m_qWFp, AqmFixedPoint::PROB_SHIFT);
+        }
+      SetFixedPointTargets ();
+    }
+
+  if (m_isLazy)
+    {
+      // The Timeout event scheduled by the constructor is replaced by the
+      // bookkeeping done in CatchUp, which expires the intervals at the same times
+      NS_ASSERT_MSG (m_oInterval.IsStrictlyPositive (), "The time interval must be positive in lazy mode");
+      m_nextTimeout = TimeStep (m_rtrsEvent.GetTs ());
+      Simulator::Remove (m_rtrsEvent);
+    }
+
   NS_LOG_DEBUG ("\tm_delay " << m_linkDelay.GetSeconds () << "; m_qW " << m_qW << "; m_ptc " << m_ptc);
 }
 
+void
+LdcQueueDisc::SetLinkRate (DataRate rate)
+{
+  NS_LOG_FUNCTION (this << rate);
+
+  if (rate.GetBitRate () == 0)
+    {
+      NS_LOG_WARN ("Ignoring a data rate of 0");
+      return;
+    }
+
+  if (m_isLazy)
+    {
+      // the intervals expired so far are run with the old rate
+      CatchUp ();
+    }
+
+  m_ptc = rate.GetBitRate () / (8.0 * m_meanPktSize);
+  m_qTarget = m_effTarget * m_ptc;
+  if (GetMode () == Queue::QUEUE_MODE_BYTES)
+    {
+      m_qTarget *= m_meanPktSize;
+    }
+  if (m_fixedPoint)
+    {
+      SetFixedPointTargets ();
+    }
+  NS_LOG_DEBUG ("New link bandwidth " << rate << "; m_ptc " << m_ptc);
+}
+
+void
+LdcQueueDisc::SetFixedPointTargets (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  double mm = m_oInterval.GetSeconds () * m_ptc;
+  if (GetMode () == Queue::QUEUE_MODE_BYTES)
+    {
+      mm *= m_meanPktSize;
+    }
+  m_invQTargetFp = AqmFixedPoint::FromDouble (1.0 / m_qTarget, AqmFixedPoint::PROB_SHIFT);
+  m_invRTargetFp = AqmFixedPoint::FromDouble (1.0 / (mm * m_rTarget), AqmFixedPoint::PROB_SHIFT);
+}
+
 // Compute the average queue size
 double
-LdcQueueDisc::Estimator (uint32_t nQueued, uint32_t m, double qAvg, double qW)
+LdcQueueDisc::Estimator (double nQueued, uint32_t m, double qAvg, double qW)
 {
   NS_LOG_FUNCTION (this << nQueued << m << qAvg << qW);
 
-  double newAve = qAvg * pow(1.0-qW, m);
+  double decay;
+  if (m_fastPow && qW == m_qW)
+    {
+      decay = Decay (m);
+    }
+  else
+    {
+      decay = pow (1.0-qW, m);
+    }
+
+  double newAve = qAvg * decay;
   newAve += qW * nQueued;
 
   return newAve;
 }
 
+uint64_t
+LdcQueueDisc::DecayFixed (uint32_t m) const
+{
+  if (m < LDC_DECAY_TABLE_SIZE)
+    {
+      return m_decayFp[m];
+    }
+  return AqmFixedPoint::MulShift (m_decayFp[m % LDC_DECAY_TABLE_SIZE],
+                                  AqmFixedPoint::Pow (m_decayFp[LDC_DECAY_TABLE_SIZE], m / LDC_DECAY_TABLE_SIZE),
+                                  AqmFixedPoint::PROB_SHIFT);
+}
+
+double
+LdcQueueDisc::IntPow (double x, uint32_t n)
+{
+  double result = 1.0;
+  while (n > 0)
+    {
+      if (n & 1)
+        {
+          result *= x;
+        }
+      x *= x;
+      n >>= 1;
+    }
+  return result;
+}
+
+double
+LdcQueueDisc::Decay (uint32_t m) const
+{
+  if (m < LDC_DECAY_TABLE_SIZE)
+    {
+      return m_decay[m];
+    }
+  // (1 - qW)^m = (1 - qW)^(m mod S) * ((1 - qW)^S)^(m / S)
+  return m_decay[m % LDC_DECAY_TABLE_SIZE] * IntPow (m_decay[LDC_DECAY_TABLE_SIZE], m / LDC_DECAY_TABLE_SIZE);
+}
+
 // Check if packet p needs to be dropped due to probability mark
 uint32_t
 LdcQueueDisc::DropEarly (Ptr<QueueDiscItem> item, uint32_t qSize)
 {
   NS_LOG_FUNCTION (this << item << qSize);
 
+  // within the burst allowance window, the queue may build up to the target
+  if (Simulator::Now () < m_burstEnd && qSize < m_qTarget)
+    {
+      NS_LOG_LOGIC ("Burst allowance, no early drop");
+      return 0;
+    }
+
+  if (m_fixedPoint)
+    {
+      // the random number has the precision of the probability: it is
+      // floor (u * AqmFixedPoint::ONE) for the u that GetValue would return
+      uint32_t u = m_uv->GetInteger (0, AqmFixedPoint::ONE - 1);
+      if (u <= m_vProbFp)
+        {
+          NS_LOG_LOGIC ("u <= m_vProbFp; u " << u << "; m_vProbFp " << m_vProbFp);
+          return 1; // drop
+        }
+      return 0; // no drop/mark
+    }
+
   double u = m_uv->GetValue ();
 
   if (u <= m_vProb)
@@ -386,6 +1053,47 @@ LdcQueueDisc::DoDequeue (void)
 {
   NS_LOG_FUNCTION (this);
 
+  if (m_isLazy)
+    {
+      CatchUp ();
+    }
+
+  return DequeueItem ();
+}
+
+uint32_t
+LdcQueueDisc::DoDequeueBatch (std::vector<Ptr<QueueDiscItem> > &items, uint32_t maxItems, uint32_t maxBytes)
+{
+  NS_LOG_FUNCTION (this << maxItems << maxBytes);
+
+  // the whole batch is dequeued at the same time, hence the control
+  // intervals only need to be caught up once
+  if (m_isLazy)
+    {
+      CatchUp ();
+    }
+
+  uint32_t n = 0;
+  uint32_t bytes = 0;
+  while (n < maxItems && bytes < maxBytes)
+    {
+      Ptr<QueueDiscItem> item = DequeueItem ();
+      if (item == 0)
+        {
+          break;
+        }
+      items.push_back (item);
+      bytes += item->GetPacketSize ();
+      n++;
+    }
+  return n;
+}
+
+Ptr<QueueDiscItem>
+LdcQueueDisc::DequeueItem (void)
+{
+  NS_LOG_FUNCTION (this);
+
   if (GetInternalQueue (0)->IsEmpty ())
     {
       NS_LOG_LOGIC ("Queue empty");
@@ -398,7 +1106,20 @@ LdcQueueDisc::DoDequeue (void)
     {
       m_idle = 0;
       Ptr<QueueDiscItem> item = StaticCast<QueueDiscItem> (GetInternalQueue (0)->Dequeue ());
-      m_bCount -= item->GetPacketSize ();
+      if (m_useSojourn)
+        {
+          LdcTimestampTag tag;
+          bool found = item->GetPacket ()->RemovePacketTag (tag);
+          NS_ASSERT_MSG (found, "found a packet without an input timestamp tag");
+          NS_UNUSED (found);
+          m_sojourn = Simulator::Now () - tag.GetTxTime ();
+          NS_LOG_INFO ("Sojourn time " << m_sojourn.GetSeconds ());
+        }
+      if (m_useSojourn || m_idleReset || m_maxBurst.IsStrictlyPositive ())
+        {
+          UpdateDepartureRate (item);
+        }
+      m_lastDeparture = Simulator::Now ();
 
       NS_LOG_LOGIC ("Popped " << item);
 
@@ -409,6 +1130,90 @@ LdcQueueDisc::DoDequeue (void)
     }
 }
 
+void
+LdcQueueDisc::UpdateDepartureRate (Ptr<QueueDiscItem> item)
+{
+  NS_LOG_FUNCTION (this << item);
+
+  Time now = Simulator::Now ();
+  uint32_t nBytes = GetInternalQueue (0)->GetNBytes ();
+
+  // if not in a measurement cycle and the queue has built up to the
+  // threshold, start a measurement cycle
+  if (!m_inMeasurement && nBytes >= m_dqThreshold)
+    {
+      m_dqStart = now;
+      m_dqCount = 0;
+      m_inMeasurement = true;
+    }
+
+  if (!m_inMeasurement)
+    {
+      return;
+    }
+
+  m_dqCount += item->GetPacketSize ();
+
+  // done with a measurement cycle
+  if (m_dqCount >= m_dqThreshold)
+    {
+      double tmp = (now - m_dqStart).GetSeconds ();
+      if (tmp > 0)
+        {
+          if (m_avgDqRate == 0)
+            {
+              m_avgDqRate = m_dqCount / tmp;
+            }
+          else
+            {
+              m_avgDqRate = (0.5 * m_avgDqRate) + (0.5 * (m_dqCount / tmp));
+            }
+          NS_LOG_DEBUG ("Departure rate " << m_avgDqRate << " bytes/s");
+        }
+
+      // restart a measurement cycle if there is enough data
+      m_dqStart = now;
+      m_dqCount = 0;
+      m_inMeasurement = (nBytes >= m_dqThreshold);
+    }
+}
+
+void
+LdcQueueDisc::StartBusyPeriod (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  Time now = Simulator::Now ();
+  double rate = (m_avgDqRate > 0) ? m_avgDqRate : m_ptc * m_meanPktSize;
+  double target = m_qTarget;
+  if (GetMode () == Queue::QUEUE_MODE_PACKETS)
+    {
+      target *= m_meanPktSize;
+    }
+
+  // the bytes the link could have sent while the queue was empty
+  if ((now - m_lastDeparture).GetSeconds () * rate < target)
+    {
+      return;
+    }
+
+  if (m_idleReset)
+    {
+      NS_LOG_DEBUG ("Restarting the congestion state after an idle period; m_vProb " << m_vProb);
+      m_qAvg = 0.0;
+      m_dAvg = 0.0;
+      m_vProb = 0.0;
+      m_qAvgFp = 0;
+      m_vProbFp = 0;
+    }
+
+  if (m_maxBurst.IsStrictlyPositive ())
+    {
+      NS_LOG_DEBUG ("Burst allowance until " << now + m_maxBurst);
+      m_burstEnd = now + m_maxBurst;
+    }
+}
+
 Ptr<const QueueDiscItem>
 LdcQueueDisc::DoPeek (void) const
 {
@@ -443,19 +1248,15 @@ LdcQueueDisc::CheckConfig (void)
       return false;
     }
 
+  if (m_fixedPoint && (m_useSojourn || m_isAdaptive))
+    {
+      NS_LOG_ERROR ("The fixed point control law does not support UseSojournTime and Adaptive");
+      return false;
+    }
+
   if (GetNInternalQueues () == 0)
     {
-      // create a DropTail queue
-      Ptr<Queue> queue = CreateObjectWithAttributes<DropTailQueue> ("Mode", EnumValue (m_mode));
-      if (m_mode == Queue::QUEUE_MODE_PACKETS)
-        {
-          queue->SetMaxPackets (m_queueLimit);
-        }
-      else
-        {
-          queue->SetMaxBytes (m_queueLimit);
-        }
-      AddInternalQueue (queue);
+      AddDefaultInternalQueue (m_mode, m_queueLimit, m_meanPktSize, m_useRingBuffer);
     }
 
   if (GetNInternalQueues () != 1)
@@ -68,6 +68,7 @@
 #include "ns3/data-rate.h"
 #include "ns3/timer.h"
 #include "ns3/event-id.h"
+#include "ns3/traced-value.h"
 #include "ns3/random-variable-stream.h"
 
 namespace ns3 {
@@ -108,6 +109,7 @@ public:
     uint32_t unforcedDrop;  //!< Early probability drops
     uint32_t forcedDrop;    //!< Forced drops, qavg > max threshold
     uint32_t qLimDrop;      //!< Drops due to queue limits
+    uint32_t unforcedMark;  //!< Early probability marks (ECN)
   } Stats;
 
   /** 
@@ -157,6 +159,45 @@ public:
    */
   Stats GetStats ();
 
+  /**
+   * \brief Get the current drop probability
+   *
+   * In fixed point, this accessor, GetAverageQueueSize and GetLoadFactor
+   * convert the fixed point variables, which the control law does not do.
+   *
+   * \returns The drop (or mark) probability computed at the last interval.
+   */
+  double GetDropProbability (void) const;
+
+  /**
+   * \brief Get the current average queue size
+   *
+   * \returns The average queue size in bytes or packets.
+   */
+  double GetAverageQueueSize (void) const;
+
+  /**
+   * \brief Get the current load factor
+   *
+   * \returns The ratio of the arrival rate to the link capacity.
+   */
+  double GetLoadFactor (void) const;
+
+  /**
+   * \brief Get the current weight of the delay component
+   *
+   * \returns The value of WQ, as adapted so far in adaptive mode.
+   */
+  double GetCurrentWq (void) const;
+
+  /**
+   * \brief Get the current effective target queueing delay
+   *
+   * \returns The target queueing delay used by the delay component, as
+   * adapted so far in adaptive mode.
+   */
+  Time GetEffectiveTarget (void) const;
+
  /**
   * Assign a fixed random variable stream number to the random variables
   * used by this model.  Return the number of streams (possibly zero) that
@@ -176,41 +217,140 @@ protected:
 private:
   virtual bool DoEnqueue (Ptr<QueueDiscItem> item);
   virtual Ptr<QueueDiscItem> DoDequeue (void);
+  virtual uint32_t DoDequeueBatch (std::vector<Ptr<QueueDiscItem> > &items, uint32_t maxItems, uint32_t maxBytes);
   virtual Ptr<const QueueDiscItem> DoPeek (void) const;
   virtual bool CheckConfig (void);
 
   /**
    * \brief Initialize the queue parameters.
    *
-   * Note: if the link bandwidth changes in the course of the
-   * simulation, the bandwidth-dependent LDC parameters do not change.
-   * This should be fixed, but it would require some extra parameters,
-   * and didn't seem worth the trouble...
+   * If LinkBandwidth is not set, the bandwidth is read from the DataRate
+   * attribute of the device and the bandwidth-dependent parameters follow
+   * the changes the device reports through its DataRateChange trace
+   * source. Otherwise, if the link bandwidth changes in the course of the
+   * simulation, they do not change, unless UseSojournTime is enabled, in
+   * which case the service rate is estimated from the departures.
    */
   virtual void InitializeParams (void);
+  /**
+   * \brief Recompute the bandwidth-dependent parameters
+   * \param rate the new link bandwidth
+   */
+  void SetLinkRate (DataRate rate);
   /**
    * \brief Compute the average queue size
-   * \param nQueued number of queued packets
+   * \param nQueued current sample (queue size or sojourn time)
    * \param m simulated number of packets arrival during idle period
    * \param qAvg average queue size
    * \param qW queue weight given to cur q size sample
    * \returns new average queue size
    */
-  double Estimator (uint32_t nQueued, uint32_t m, double qAvg, double qW);
+  double Estimator (double nQueued, uint32_t m, double qAvg, double qW);
+  /**
+   * \brief Compute an integer power by repeated squaring
+   * \param x the base
+   * \param n the exponent
+   * \returns x raised to the power of n
+   */
+  static double IntPow (double x, uint32_t n);
+  /**
+   * \brief Compute (1 - qW)^m from the table built by InitializeParams
+   * \param m the exponent
+   * \returns (1 - qW)^m
+   */
+  double Decay (uint32_t m) const;
+  /**
+   * \brief Compute (1 - qW)^m in fixed point from the table built by InitializeParams
+   * \param m the exponent
+   * \returns (1 - qW)^m, with AqmFixedPoint::PROB_SHIFT fractional bits
+   */
+  uint64_t DecayFixed (uint32_t m) const;
+  /**
+   * \brief Compute the fixed point reciprocals of the targets, which depend on the link rate
+   */
+  void SetFixedPointTargets (void);
   /**
    * \brief Check if a packet needs to be dropped due to probability mark
    * \param item queue item
    * \param qSize queue size
-   * \returns 0 for no drop/mark, 1 for drop
+   * \returns 0 for no drop/mark, 1 for drop/mark
    */
   uint32_t DropEarly (Ptr<QueueDiscItem> item, uint32_t qSize);
-  
+  /**
+   * \brief Periodically update the load factor, the average queue size and
+   * the drop probability (one control interval)
+   */
   void Timeout ();
+  /**
+   * \brief Run a number of consecutive control intervals
+   * \param first time at which the first of the intervals expires
+   * \param n number of intervals to run
+   *
+   * Running n intervals in a row gives the same result as n calls to
+   * Timeout (), provided that the queue is not modified in between.
+   */
+  void UpdateIntervals (Time first, uint64_t n);
+  /**
+   * \brief Fixed point version of the control law run by UpdateIntervals
+   * \param nQueued the current queue size
+   * \param m simulated number of packets arrival during idle period
+   * \param n number of intervals to run
+   */
+  void UpdateIntervalsFixed (uint32_t nQueued, uint32_t m, uint64_t n);
+  /**
+   * \brief Update the departure rate estimate with a dequeued packet
+   * \param item the dequeued item
+   *
+   * The departure rate is measured over cycles of DequeueThreshold bytes,
+   * which are only started when the queue holds at least that many bytes,
+   * so that the estimate reflects the rate at which the link drains a
+   * backlogged queue.
+   */
+  void UpdateDepartureRate (Ptr<QueueDiscItem> item);
+  /**
+   * \brief Handle the arrival of a packet to an empty queue
+   *
+   * If the departure rate (as measured, or the link rate until a
+   * measurement is available) would have drained a backlog as large as the
+   * target queue size during the idle period, the congestion state
+   * computed before the idle period is stale: with IdleReset the average
+   * queue size and the drop probability are restarted from zero, and with
+   * a MaxBurstAllowance a burst allowance window is opened.
+   */
+  void StartBusyPeriod (void);
+  /**
+   * \brief Run the control intervals expired since the last update
+   *
+   * Used in lazy mode, where no Timeout event is scheduled and the
+   * missed intervals are accounted for on enqueue and dequeue.
+   */
+  void CatchUp (void);
+  /**
+   * \brief Dequeue a packet from the internal queue and update the
+   * idle state, the sojourn time and the departure rate
+   * \returns the dequeued item, or 0 if the queue is empty
+   */
+  Ptr<QueueDiscItem> DequeueItem (void);
+  /**
+   * \brief Adapt WQ and the effective target to the measured delay
+   * \param now the current time
+   * \param qRatio the current delay component of the drop probability
+   * \param rRatio the current load component of the drop probability
+   *
+   * Called at most once per AdaptInterval. If the average queueing delay
+   * is above TargetQueueingDelay, the effective target is multiplied by
+   * AdaptBeta; if it is below, the effective target is divided by
+   * AdaptBeta. In both cases, WQ is moved by AdaptAlpha towards the
+   * component of the drop probability that moves it in the needed
+   * direction. The WQ attribute keeps the value set by the user.
+   */
+  void Adapt (Time now, double qRatio, double rRatio);
 
   Stats m_stats; //!< LDC statistics
 
   // ** Variables supplied by user
   Queue::QueueMode m_mode;  //!< Mode (Bytes or packets)
+  bool m_useRingBuffer;     //!< True to use a RingBufferQueue as internal queue
   uint32_t m_meanPktSize;   //!< Avg pkt size
   uint32_t m_queueLimit;    //!< Queue limit in bytes / packets
   double m_qW;              //!< Queue weight given to cur queue size sample
@@ -218,22 +358,61 @@ private:
   Time m_linkDelay;         //!< Link delay
   Time m_oInterval;         //!< The time interval after which LDC calculates queueing delay
   double m_wt1;             //!< Input rate weight given to current input rate
-  double m_wQ;              //!< Weight for the delay component in drop probability calculation
+  double m_wQ;              //!< Weight for the delay component in drop probability calculation (initial value in adaptive mode)
   Time m_dTarget;           //!< Target queueing delay
   double m_rTarget;         //!< Target load factor ratio
   uint32_t m_lExp;          //!< Exponent value used in drop probability calculation
+  bool m_isLazy;            //!< True to update the control state on enqueue/dequeue instead of with a timer
+  bool m_fastPow;           //!< True to replace the calls to pow by table lookups and multiplications
+  bool m_fixedPoint;        //!< True to run the control law in fixed point arithmetic
+  bool m_useEcn;            //!< True to mark ECN capable packets instead of dropping them early
+  bool m_useSojourn;        //!< True to use the measured sojourn time and departure rate
+  uint32_t m_dqThreshold;   //!< Minimum queue size in bytes before the departure rate is measured
+  Time m_maxBurst;          //!< Time after a long idle period during which no packet is dropped early
+  bool m_idleReset;         //!< True to restart the congestion state after a long idle period
+  bool m_isAdaptive;        //!< True to adapt WQ and the effective target to the measured delay
+  Time m_adaptInterval;     //!< Time interval between two adaptations
+  double m_adaptAlpha;      //!< Step of WQ in adaptive mode
+  double m_adaptBeta;       //!< Adaptation factor of the effective target
+  double m_wQTop;           //!< Upper bound for WQ in adaptive mode
+  double m_wQBottom;        //!< Lower bound for WQ in adaptive mode
 
   // ** Variables maintained by LDC
-  double m_vProb;           //!< Prob. of packet drop before "count"
+  TracedValue<double> m_vProb; //!< Prob. of packet drop before "count"
+  double m_curWq;           //!< Current weight for the delay component, adapted in adaptive mode
   uint32_t m_idle;          //!< 0/1 idle status
   double m_ptc;             //!< packet time constant in packets/second
-  double m_qAvg;            //!< Average queue length
-  uint32_t m_bCount;
-  double m_nPkt;
-  double m_ratio;
-  double m_qTarget; 
-  uint32_t m_nIncome;
+  TracedValue<double> m_qAvg; //!< Average queue length
+  uint32_t m_bCount;        //!< Bytes arrived in the current interval
+  double m_nPkt;            //!< Average arrivals per interval (packets, or bytes in byte mode)
+  TracedValue<double> m_ratio; //!< Load factor
+  double m_qTarget;         //!< Target queue size (packets, or bytes in byte mode)
+  uint32_t m_nIncome;       //!< Packets arrived in the current interval
   Time m_idleTime;          //!< Start of current idle period
+  Time m_nextTimeout;       //!< Expiration time of the next control interval (lazy mode)
+  Time m_sojourn;           //!< Sojourn time of the last dequeued packet
+  double m_dAvg;            //!< Average sojourn time in seconds
+  bool m_inMeasurement;     //!< Whether a departure rate measurement cycle is in progress
+  Time m_dqStart;           //!< Start of the current measurement cycle
+  uint32_t m_dqCount;       //!< Bytes departed since the start of the current measurement cycle
+  double m_avgDqRate;       //!< Average departure rate in bytes/second, 0 until measured
+  Time m_lastDeparture;     //!< Time of the last departure
+  Time m_burstEnd;          //!< End of the current burst allowance window
+  double m_effTarget;       //!< Effective target queueing delay in seconds
+  Time m_lastSet;           //!< Last time WQ and the effective target were adapted
+  std::vector<double> m_decay; //!< (1 - qW)^i for the first values of i, the last entry is the step used beyond the table
+
+  // ** Fixed point versions of the variables above (see AqmFixedPoint)
+  uint64_t m_qAvgFp;        //!< Average queue length
+  uint64_t m_nPktFp;        //!< Average arrivals per interval
+  uint64_t m_vProbFp;       //!< Prob. of packet drop
+  uint64_t m_rLoadFp;       //!< Load factor relative to the target load factor
+  uint64_t m_qWFp;          //!< Queue weight
+  uint64_t m_wt1Fp;         //!< Input rate weight
+  uint64_t m_wQFp;          //!< Weight for the delay component
+  uint64_t m_invQTargetFp;  //!< 1 / m_qTarget
+  uint64_t m_invRTargetFp;  //!< 1 / (m_rTarget * arrivals per interval at the link rate)
+  std::vector<uint64_t> m_decayFp; //!< (1 - qW)^i, as m_decay
 
   EventId m_rtrsEvent;
   Ptr<UniformRandomVariable> m_uv;  //!< rng stream
@@ -0,0 +1,235 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/log.h"
+#include "ns3/assert.h"
+#include "ns3/abort.h"
+#include "log-linear-histogram.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LogLinearHistogram");
+
+/**
+ * \brief Get the position of the most significant bit set
+ * \param value a non zero value
+ * \return the position of the most significant bit, from 0 to 63
+ */
+static uint32_t
+MostSignificantBit (uint64_t value)
+{
+  uint32_t msb = 0;
+  for (uint32_t shift = 32; shift > 0; shift >>= 1)
+    {
+      if (value >> shift)
+        {
+          value >>= shift;
+          msb += shift;
+        }
+    }
+  return msb;
+}
+
+LogLinearHistogram::LogLinearHistogram (uint32_t precision)
+  : m_precision (precision),
+    m_count (0),
+    m_min (std::numeric_limits<uint64_t>::max ()),
+    m_max (0),
+    m_sum (0)
+{
+  NS_LOG_FUNCTION (this << precision);
+  NS_ABORT_MSG_IF (precision > 16, "The precision of a LogLinearHistogram cannot exceed 16 bits");
+
+  if (precision > 0)
+    {
+      // the values below 2^precision have a bucket each, each of the
+      // 64 - precision power of two ranges above has 2^(precision-1) buckets
+      uint32_t subBuckets = 1 << precision;
+      m_buckets.assign ((64 - precision) * (subBuckets / 2) + subBuckets, 0);
+    }
+}
+
+uint32_t
+LogLinearHistogram::GetPrecision (void) const
+{
+  return m_precision;
+}
+
+uint32_t
+LogLinearHistogram::GetIndex (uint64_t value) const
+{
+  if (value < (1ULL << m_precision))
+    {
+      return value;
+    }
+  uint32_t shift = MostSignificantBit (value) - m_precision + 1;
+  return shift * (1 << (m_precision - 1)) + (value >> shift);
+}
+
+void
+LogLinearHistogram::Record (uint64_t value)
+{
+  NS_ASSERT_MSG (m_precision > 0, "The histogram has no buckets");
+
+  m_buckets[GetIndex (value)]++;
+  m_count++;
+  m_sum += value;
+  if (value < m_min)
+    {
+      m_min = value;
+    }
+  if (value > m_max)
+    {
+      m_max = value;
+    }
+}
+
+void
+LogLinearHistogram::Merge (const LogLinearHistogram &other)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ABORT_MSG_IF (other.m_precision != m_precision,
+                   "Cannot merge histograms with different precisions");
+
+  for (uint32_t i = 0; i < m_buckets.size (); i++)
+    {
+      m_buckets[i] += other.m_buckets[i];
+    }
+  m_count += other.m_count;
+  m_sum += other.m_sum;
+  m_min = std::min (m_min, other.m_min);
+  m_max = std::max (m_max, other.m_max);
+}
+
+void
+LogLinearHistogram::Reset (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_buckets.assign (m_buckets.size (), 0);
+  m_count = 0;
+  m_min = std::numeric_limits<uint64_t>::max ();
+  m_max = 0;
+  m_sum = 0;
+}
+
+uint64_t
+LogLinearHistogram::GetCount (void) const
+{
+  return m_count;
+}
+
+uint64_t
+LogLinearHistogram::GetMin (void) const
+{
+  return m_count ? m_min : 0;
+}
+
+uint64_t
+LogLinearHistogram::GetMax (void) const
+{
+  return m_max;
+}
+
+double
+LogLinearHistogram::GetMean (void) const
+{
+  return m_count ? static_cast<double> (m_sum) / m_count : 0;
+}
+
+uint64_t
+LogLinearHistogram::GetPercentile (double percentile) const
+{
+  NS_LOG_FUNCTION (this << percentile);
+  NS_ASSERT_MSG (percentile >= 0 && percentile <= 100, "The percentile must be between 0 and 100");
+
+  if (m_count == 0)
+    {
+      return 0;
+    }
+
+  // the rank of the value, from 1 to m_count
+  uint64_t rank = std::ceil (percentile / 100 * m_count);
+  if (rank == 0)
+    {
+      return m_min;
+    }
+
+  uint64_t seen = 0;
+  for (uint32_t i = 0; i < m_buckets.size (); i++)
+    {
+      seen += m_buckets[i];
+      if (seen >= rank)
+        {
+          return std::min (GetBucketUpperBound (i), m_max);
+        }
+    }
+  return m_max;
+}
+
+uint32_t
+LogLinearHistogram::GetNBuckets (void) const
+{
+  return m_buckets.size ();
+}
+
+uint64_t
+LogLinearHistogram::GetBucketCount (uint32_t index) const
+{
+  NS_ASSERT (index < m_buckets.size ());
+  return m_buckets[index];
+}
+
+uint64_t
+LogLinearHistogram::GetBucketLowerBound (uint32_t index) const
+{
+  NS_ASSERT (index < m_buckets.size ());
+  if (index < (1U << m_precision))
+    {
+      return index;
+    }
+  uint32_t half = 1 << (m_precision - 1);
+  uint32_t shift = index / half - 1;
+  return (uint64_t) (index - shift * half) << shift;
+}
+
+uint64_t
+LogLinearHistogram::GetBucketUpperBound (uint32_t index) const
+{
+  NS_ASSERT (index < m_buckets.size ());
+  if (index < (1U << m_precision))
+    {
+      return index;
+    }
+  uint32_t shift = index / (1 << (m_precision - 1)) - 1;
+  return GetBucketLowerBound (index) + ((1ULL << shift) - 1);
+}
+
+void
+LogLinearHistogram::Print (std::ostream &os) const
+{
+  for (uint32_t i = 0; i < m_buckets.size (); i++)
+    {
+      if (m_buckets[i])
+        {
+          os << GetBucketLowerBound (i) << " " << GetBucketUpperBound (i) << " " << m_buckets[i] << std::endl;
+        }
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,159 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LOG_LINEAR_HISTOGRAM_H
+#define LOG_LINEAR_HISTOGRAM_H
+
+#include <stdint.h>
+#include <vector>
+#include <ostream>
+
+namespace ns3 {
+
+/**
+ * \ingroup traffic-control
+ *
+ * \brief A histogram of unsigned 64 bit values with log-linear buckets
+ *
+ * As in HDR histograms, the values below 2^precision have a bucket each,
+ * while each power of two range above is split into 2^(precision-1)
+ * buckets of the same width. Hence, the memory used only depends on the
+ * precision, any value is recorded in constant time and the width of the
+ * bucket of a value is at most a 2^(1-precision) fraction of the value.
+ * Histograms with the same precision can be merged.
+ */
+class LogLinearHistogram
+{
+public:
+  /**
+   * \brief Create an empty histogram
+   * \param precision the number of bits of the values kept exactly, between 1 and 16,
+   *        or 0 for a histogram with no buckets, which cannot record values
+   */
+  LogLinearHistogram (uint32_t precision = 0);
+
+  /**
+   * \brief Get the precision of the histogram
+   * \return the precision
+   */
+  uint32_t GetPrecision (void) const;
+
+  /**
+   * \brief Record a value
+   * \param value the value
+   */
+  void Record (uint64_t value);
+
+  /**
+   * \brief Add the values recorded by another histogram with the same precision
+   * \param other the other histogram
+   */
+  void Merge (const LogLinearHistogram &other);
+
+  /**
+   * \brief Remove all the recorded values
+   */
+  void Reset (void);
+
+  /**
+   * \brief Get the number of recorded values
+   * \return the number of recorded values
+   */
+  uint64_t GetCount (void) const;
+
+  /**
+   * \brief Get the smallest recorded value
+   * \return the smallest recorded value, or 0 if no value was recorded
+   */
+  uint64_t GetMin (void) const;
+
+  /**
+   * \brief Get the largest recorded value
+   * \return the largest recorded value, or 0 if no value was recorded
+   */
+  uint64_t GetMax (void) const;
+
+  /**
+   * \brief Get the mean of the recorded values
+   * \return the mean of the recorded values, or 0 if no value was recorded
+   */
+  double GetMean (void) const;
+
+  /**
+   * \brief Get a percentile of the recorded values
+   *
+   * The returned value is the largest value of the bucket holding the
+   * percentile (but not larger than the largest recorded value), hence
+   * it is at most a 2^(1-precision) fraction larger than the percentile.
+   *
+   * \param percentile the percentile, between 0 and 100
+   * \return the value below which the given percentage of the values lie,
+   *         or 0 if no value was recorded
+   */
+  uint64_t GetPercentile (double percentile) const;
+
+  /**
+   * \brief Get the number of buckets
+   * \return the number of buckets
+   */
+  uint32_t GetNBuckets (void) const;
+
+  /**
+   * \brief Get the number of values recorded in a bucket
+   * \param index the index of the bucket
+   * \return the number of values in the bucket
+   */
+  uint64_t GetBucketCount (uint32_t index) const;
+
+  /**
+   * \brief Get the smallest value of a bucket
+   * \param index the index of the bucket
+   * \return the smallest value of the bucket
+   */
+  uint64_t GetBucketLowerBound (uint32_t index) const;
+
+  /**
+   * \brief Get the largest value of a bucket
+   * \param index the index of the bucket
+   * \return the largest value of the bucket
+   */
+  uint64_t GetBucketUpperBound (uint32_t index) const;
+
+  /**
+   * \brief Print the non empty buckets, one per line, as "lower upper count"
+   * \param os the output stream
+   */
+  void Print (std::ostream &os) const;
+
+private:
+  /**
+   * \brief Get the index of the bucket of a value
+   * \param value the value
+   * \return the index of the bucket
+   */
+  uint32_t GetIndex (uint64_t value) const;
+
+  uint32_t m_precision;            //!< Number of bits of the values kept exactly
+  std::vector<uint64_t> m_buckets; //!< Number of values in each bucket
+  uint64_t m_count;                //!< Number of recorded values
+  uint64_t m_min;                  //!< Smallest recorded value
+  uint64_t m_max;                  //!< Largest recorded value
+  uint64_t m_sum;                  //!< Sum of the recorded values
+};
+
+} // namespace ns3
+
+#endif /* LOG_LINEAR_HISTOGRAM_H */
@@ -0,0 +1,116 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * The queue disc follows the Linux mq scheduler (net/sched/sch_mq.c).
+ */
+
+#include "ns3/log.h"
+#include "ns3/net-device.h"
+#include "mq-queue-disc.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("MqQueueDisc");
+
+NS_OBJECT_ENSURE_REGISTERED (MqQueueDisc);
+
+TypeId MqQueueDisc::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::MqQueueDisc")
+    .SetParent<QueueDisc> ()
+    .SetGroupName ("TrafficControl")
+    .AddConstructor<MqQueueDisc> ()
+  ;
+  return tid;
+}
+
+MqQueueDisc::MqQueueDisc ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+MqQueueDisc::~MqQueueDisc ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+QueueDisc::WakeMode
+MqQueueDisc::GetWakeMode (void)
+{
+  return WAKE_CHILD;
+}
+
+bool
+MqQueueDisc::DoEnqueue (Ptr<QueueDiscItem> item)
+{
+  NS_FATAL_ERROR ("MqQueueDisc: DoEnqueue should never be called");
+  return false;
+}
+
+Ptr<QueueDiscItem>
+MqQueueDisc::DoDequeue (void)
+{
+  NS_FATAL_ERROR ("MqQueueDisc: DoDequeue should never be called");
+  return 0;
+}
+
+Ptr<const QueueDiscItem>
+MqQueueDisc::DoPeek (void) const
+{
+  NS_FATAL_ERROR ("MqQueueDisc: DoPeek should never be called");
+  return 0;
+}
+
+bool
+MqQueueDisc::CheckConfig (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  if (GetNPacketFilters () > 0)
+    {
+      NS_LOG_ERROR ("MqQueueDisc cannot have packet filters");
+      return false;
+    }
+
+  if (GetNInternalQueues () > 0)
+    {
+      NS_LOG_ERROR ("MqQueueDisc cannot have internal queues");
+      return false;
+    }
+
+  Ptr<NetDevice> device = GetNetDevice ();
+  Ptr<NetDeviceQueueInterface> ndqi = device ? device->GetObject<NetDeviceQueueInterface> () : 0;
+  if (ndqi == 0)
+    {
+      NS_LOG_ERROR ("MqQueueDisc must be installed on a device");
+      return false;
+    }
+
+  if (GetNQueueDiscClasses () != ndqi->GetNTxQueues ())
+    {
+      NS_LOG_ERROR ("MqQueueDisc needs as many classes as the device transmission queues");
+      return false;
+    }
+
+  return true;
+}
+
+void
+MqQueueDisc::InitializeParams (void)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+} // namespace ns3
@@ -52,6 +52,11 @@ TypeId PieQueueDisc::GetTypeId (void)
                    MakeEnumAccessor (&PieQueueDisc::SetMode),
                    MakeEnumChecker (Queue::QUEUE_MODE_BYTES, "QUEUE_MODE_BYTES",
                                     Queue::QUEUE_MODE_PACKETS, "QUEUE_MODE_PACKETS"))
+    .AddAttribute ("UseRingBuffer",
+                   "True to use a RingBufferQueue sized from the queue limit as internal queue",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&PieQueueDisc::m_useRingBuffer),
+                   MakeBooleanChecker ())
     .AddAttribute ("MeanPktSize",
                    "Average of packet size",
                    UintegerValue (1000),
@@ -497,17 +502,7 @@ PieQueueDisc::CheckConfig (void)
 
   if (GetNInternalQueues () == 0)
     {
-      // create a DropTail queue
-      Ptr<Queue> queue = CreateObjectWithAttributes<DropTailQueue> ("Mode", EnumValue (m_mode));
-      if (m_mode == Queue::QUEUE_MODE_PACKETS)
-        {
-          queue->SetMaxPackets (m_queueLimit);
-        }
-      else
-        {
-          queue->SetMaxBytes (m_queueLimit);
-        }
-      AddInternalQueue (queue);
+      AddDefaultInternalQueue (m_mode, m_queueLimit, m_meanPktSize, m_useRingBuffer);
     }
 
   if (GetNInternalQueues () != 1)
@@ -174,6 +174,7 @@ private:
 
   // ** Variables supplied by user
   Queue::QueueMode m_mode;                      //!< Mode (bytes or packets)
+  bool m_useRingBuffer;                         //!< True to use a RingBufferQueue as internal queue
   uint32_t m_queueLimit;                        //!< Queue limit in bytes / packets
   Time m_sUpdate;                               //!< Start time of the update timer
   Time m_tUpdate;                               //!< Time period after which CalculateP () is called
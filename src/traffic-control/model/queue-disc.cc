@@ -25,6 +25,13 @@
 #include "ns3/packet.h"
 #include "ns3/socket.h"
 #include "ns3/unused.h"
+#include "ns3/queue-limits.h"
+#include "ns3/simulator.h"
+#include "ns3/enum.h"
+#include "ns3/drop-tail-queue.h"
+#include "ns3/ring-buffer-queue.h"
+#include <algorithm>
+#include <limits>
 #include "queue-disc.h"
 
 namespace ns3 {
@@ -68,6 +75,25 @@ QueueDiscItem::SetTxQueueIndex (uint8_t txq)
   m_txq = txq;
 }
 
+Time
+QueueDiscItem::GetTimeStamp (void) const
+{
+  return m_tstamp;
+}
+
+void
+QueueDiscItem::SetTimeStamp (Time t)
+{
+  m_tstamp = t;
+}
+
+bool
+QueueDiscItem::Mark (void)
+{
+  NS_LOG_FUNCTION (this);
+  return false;
+}
+
 void
 QueueDiscItem::Print (std::ostream& os) const
 {
@@ -136,6 +162,17 @@ TypeId QueueDisc::GetTypeId (void)
                    MakeUintegerAccessor (&QueueDisc::SetQuota,
                                          &QueueDisc::GetQuota),
                    MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("BatchSize", "The maximum number of packets dequeued and passed to a single-queue device at once",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&QueueDisc::SetBatchSize,
+                                         &QueueDisc::GetBatchSize),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("SojournHistogramPrecision",
+                   "The precision in bits of the histogram of the sojourn times, 0 to not record them",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&QueueDisc::SetSojournHistogramPrecision,
+                                         &QueueDisc::GetSojournHistogramPrecision),
+                   MakeUintegerChecker<uint32_t> (0, 16))
     .AddAttribute ("InternalQueueList", "The list of internal queues.",
                    ObjectVectorValue (),
                    MakeObjectVectorAccessor (&QueueDisc::m_queues),
@@ -195,7 +232,9 @@ QueueDisc::DoDispose (void)
   m_classes.clear ();
   m_device = 0;
   m_devQueueIface = 0;
-  m_requeued = 0;
+  m_requeued.clear ();
+  m_batch.clear ();
+  m_txBatch.clear ();
   Object::DoDispose ();
 }
 
@@ -310,6 +349,48 @@ QueueDisc::GetQuota (void) const
   return m_quota;
 }
 
+void
+QueueDisc::SetBatchSize (uint32_t batchSize)
+{
+  NS_LOG_FUNCTION (this << batchSize);
+  m_batchSize = batchSize;
+}
+
+uint32_t
+QueueDisc::GetBatchSize (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_batchSize;
+}
+
+void
+QueueDisc::SetSojournHistogramPrecision (uint32_t precision)
+{
+  NS_LOG_FUNCTION (this << precision);
+  m_sojourn = LogLinearHistogram (precision);
+}
+
+uint32_t
+QueueDisc::GetSojournHistogramPrecision (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_sojourn.GetPrecision ();
+}
+
+const LogLinearHistogram &
+QueueDisc::GetSojournHistogram (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_sojourn;
+}
+
+void
+QueueDisc::ResetSojournHistogram (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_sojourn.Reset ();
+}
+
 void
 QueueDisc::AddInternalQueue (Ptr<Queue> queue)
 {
@@ -320,6 +401,42 @@ QueueDisc::AddInternalQueue (Ptr<Queue> queue)
   m_queues.push_back (queue);
 }
 
+void
+QueueDisc::AddDefaultInternalQueue (Queue::QueueMode mode, uint32_t limit, uint32_t meanPktSize, bool useRingBuffer)
+{
+  NS_LOG_FUNCTION (this << mode << limit << meanPktSize << useRingBuffer);
+
+  // create a DropTail queue, or a RingBuffer queue that does not allocate
+  // memory in steady state if requested
+  Ptr<Queue> queue;
+  if (useRingBuffer)
+    {
+      Ptr<RingBufferQueue> ring = CreateObjectWithAttributes<RingBufferQueue> ("Mode", EnumValue (mode));
+      if (mode == Queue::QUEUE_MODE_PACKETS)
+        {
+          ring->SetCapacity (limit);
+        }
+      else if (meanPktSize > 0)
+        {
+          ring->SetCapacity (limit / meanPktSize + 1);
+        }
+      queue = ring;
+    }
+  else
+    {
+      queue = CreateObjectWithAttributes<DropTailQueue> ("Mode", EnumValue (mode));
+    }
+  if (mode == Queue::QUEUE_MODE_PACKETS)
+    {
+      queue->SetMaxPackets (limit);
+    }
+  else
+    {
+      queue->SetMaxBytes (limit);
+    }
+  AddInternalQueue (queue);
+}
+
 Ptr<Queue>
 QueueDisc::GetInternalQueue (uint32_t i) const
 {
@@ -460,6 +577,11 @@ QueueDisc::Enqueue (Ptr<QueueDiscItem> item)
   NS_LOG_LOGIC ("m_traceEnqueue (p)");
   m_traceEnqueue (item);
 
+  if (m_sojourn.GetPrecision ())
+    {
+      item->SetTimeStamp (Simulator::Now ());
+    }
+
   return DoEnqueue (item);
 }
 
@@ -476,6 +598,11 @@ QueueDisc::Dequeue (void)
       m_nPackets--;
       m_nBytes -= item->GetPacketSize ();
 
+      if (m_sojourn.GetPrecision ())
+        {
+          m_sojourn.Record ((Simulator::Now () - item->GetTimeStamp ()).GetNanoSeconds ());
+        }
+
       NS_LOG_LOGIC ("m_traceDequeue (p)");
       m_traceDequeue (item);
     }
@@ -483,6 +610,53 @@ QueueDisc::Dequeue (void)
   return item;
 }
 
+uint32_t
+QueueDisc::DequeueBatch (std::vector<Ptr<QueueDiscItem> > &items, uint32_t maxItems, uint32_t maxBytes)
+{
+  NS_LOG_FUNCTION (this << maxItems << maxBytes);
+
+  uint32_t first = items.size ();
+  uint32_t n = DoDequeueBatch (items, maxItems, maxBytes);
+  NS_ASSERT (items.size () == first + n);
+
+  for (uint32_t i = first; i < items.size (); i++)
+    {
+      m_nPackets--;
+      m_nBytes -= items[i]->GetPacketSize ();
+
+      if (m_sojourn.GetPrecision ())
+        {
+          m_sojourn.Record ((Simulator::Now () - items[i]->GetTimeStamp ()).GetNanoSeconds ());
+        }
+
+      NS_LOG_LOGIC ("m_traceDequeue (p)");
+      m_traceDequeue (items[i]);
+    }
+
+  return n;
+}
+
+uint32_t
+QueueDisc::DoDequeueBatch (std::vector<Ptr<QueueDiscItem> > &items, uint32_t maxItems, uint32_t maxBytes)
+{
+  NS_LOG_FUNCTION (this << maxItems << maxBytes);
+
+  uint32_t n = 0;
+  uint32_t bytes = 0;
+  while (n < maxItems && bytes < maxBytes)
+    {
+      Ptr<QueueDiscItem> item = DoDequeue ();
+      if (item == 0)
+        {
+          break;
+        }
+      items.push_back (item);
+      bytes += item->GetPacketSize ();
+      n++;
+    }
+  return n;
+}
+
 Ptr<const QueueDiscItem>
 QueueDisc::Peek (void) const
 {
@@ -498,13 +672,28 @@ QueueDisc::Run (void)
   if (RunBegin ())
     {
       uint32_t quota = m_quota;
-      while (Restart ())
+      // batches are only passed to single-queue devices, so that all the
+      // packets of a batch go to the same device queue
+      if (m_batchSize > 1 && m_devQueueIface && m_devQueueIface->GetNTxQueues () == 1)
+        {
+          while (RestartBatch (quota))
+            {
+              if (quota <= 0)
+                {
+                  break;
+                }
+            }
+        }
+      else
         {
-          quota -= 1;
-          if (quota <= 0)
+          while (Restart ())
             {
-              /// \todo netif_schedule (q);
-              break;
+              quota -= 1;
+              if (quota <= 0)
+                {
+                  /// \todo netif_schedule (q);
+                  break;
+                }
             }
         }
       RunEnd ();
@@ -545,6 +734,21 @@ QueueDisc::Restart (void)
   return Transmit (item);
 }
 
+bool
+QueueDisc::RestartBatch (uint32_t &quota)
+{
+  NS_LOG_FUNCTION (this << quota);
+  uint32_t n = DequeuePacketBatch (std::min (quota, m_batchSize));
+  if (n == 0)
+    {
+      NS_LOG_LOGIC ("No packet to send");
+      return false;
+    }
+
+  quota -= n;
+  return TransmitBatch ();
+}
+
 Ptr<QueueDiscItem>
 QueueDisc::DequeuePacket ()
 {
@@ -553,15 +757,15 @@ QueueDisc::DequeuePacket ()
   Ptr<QueueDiscItem> item;
 
   // First check if there is a requeued packet
-  if (m_requeued != 0)
+  if (!m_requeued.empty ())
     {
         // If the queue where the requeued packet is destined to is not stopped, return
         // the requeued packet; otherwise, return an empty packet.
         // If the device does not support flow control, the device queue is never stopped
-        if (!m_devQueueIface->GetTxQueue (m_requeued->GetTxQueueIndex ())->IsStopped ())
+        if (!m_devQueueIface->GetTxQueue (m_requeued.front ()->GetTxQueueIndex ())->IsStopped ())
           {
-            item = m_requeued;
-            m_requeued = 0;
+            item = m_requeued.front ();
+            m_requeued.pop_front ();
 
             m_nPackets--;
             m_nBytes -= item->GetPacketSize ();
@@ -591,11 +795,59 @@ QueueDisc::DequeuePacket ()
   return item;
 }
 
+uint32_t
+QueueDisc::DequeuePacketBatch (uint32_t maxItems)
+{
+  NS_LOG_FUNCTION (this << maxItems);
+  NS_ASSERT (m_devQueueIface && m_devQueueIface->GetNTxQueues () == 1);
+  NS_ASSERT (m_batch.empty ());
+
+  Ptr<NetDeviceQueue> txq = m_devQueueIface->GetTxQueue (0);
+  if (txq->IsStopped ())
+    {
+      return 0;
+    }
+
+  // the requeued packets are sent first, in order
+  while (!m_requeued.empty () && m_batch.size () < maxItems)
+    {
+      Ptr<QueueDiscItem> item = m_requeued.front ();
+      m_requeued.pop_front ();
+
+      m_nPackets--;
+      m_nBytes -= item->GetPacketSize ();
+
+      NS_LOG_LOGIC ("m_traceDequeue (p)");
+      m_traceDequeue (item);
+      m_batch.push_back (item);
+    }
+  if (!m_batch.empty ())
+    {
+      return m_batch.size ();
+    }
+
+  // As Linux does, the batch does not exceed the bytes that the queue limits
+  // of the device queue (if any) allow to send, but includes at least one packet
+  uint32_t maxBytes = std::numeric_limits<uint32_t>::max ();
+  Ptr<QueueLimits> ql = txq->GetQueueLimits ();
+  if (ql)
+    {
+      maxBytes = std::max (ql->Available (), 1);
+    }
+
+  DequeueBatch (m_batch, maxItems, maxBytes);
+  for (std::vector<Ptr<QueueDiscItem> >::iterator it = m_batch.begin (); it != m_batch.end (); it++)
+    {
+      (*it)->AddHeader ();
+    }
+  return m_batch.size ();
+}
+
 void
 QueueDisc::Requeue (Ptr<QueueDiscItem> item)
 {
   NS_LOG_FUNCTION (this << item);
-  m_requeued = item;
+  m_requeued.push_back (item);
   /// \todo netif_schedule (q);
 
   m_nPackets++;       // it's still part of the queue
@@ -654,4 +906,44 @@ QueueDisc::Transmit (Ptr<QueueDiscItem> item)
   return true;
 }
 
+bool
+QueueDisc::TransmitBatch (void)
+{
+  NS_LOG_FUNCTION (this << m_batch.size ());
+  NS_ASSERT (m_devQueueIface && m_devQueueIface->GetNTxQueues () == 1);
+
+  m_txBatch.resize (m_batch.size ());
+  for (uint32_t i = 0; i < m_batch.size (); i++)
+    {
+      // a single queue device makes no use of the priority tag
+      SocketPriorityTag priorityTag;
+      m_batch[i]->GetPacket ()->RemovePacketTag (priorityTag);
+
+      m_txBatch[i].packet = m_batch[i]->GetPacket ();
+      m_txBatch[i].dest = m_batch[i]->GetAddress ();
+      m_txBatch[i].protocolNumber = m_batch[i]->GetProtocol ();
+    }
+
+  // as in Transmit, the packets taken by the device are consumed. The
+  // device stops taking packets when its queue is stopped, and the
+  // remaining ones are requeued in order
+  uint32_t sent = m_device->SendBatch (m_txBatch);
+  NS_ASSERT (sent <= m_batch.size ());
+  for (uint32_t i = sent; i < m_batch.size (); i++)
+    {
+      Requeue (m_batch[i]);
+    }
+  bool allSent = (sent == m_batch.size ());
+
+  m_batch.clear ();
+  m_txBatch.clear ();
+
+  if (!allSent || GetNPackets () == 0 || m_devQueueIface->GetTxQueue (0)->IsStopped ())
+    {
+      return false;
+    }
+
+  return true;
+}
+
 } // namespace ns3
@@ -24,8 +24,11 @@
 #include "ns3/traced-value.h"
 #include <ns3/queue.h>
 #include "ns3/net-device.h"
+#include "ns3/nstime.h"
 #include <vector>
+#include <list>
 #include "packet-filter.h"
+#include "log-linear-histogram.h"
 
 namespace ns3 {
 
@@ -76,6 +79,18 @@ public:
    */
   void SetTxQueueIndex (uint8_t txq);
 
+  /**
+   * \brief Get the time the item was enqueued in a queue disc recording sojourn times
+   * \return the time the item was enqueued
+   */
+  Time GetTimeStamp (void) const;
+
+  /**
+   * \brief Set the time the item was enqueued
+   * \param t the time the item was enqueued
+   */
+  void SetTimeStamp (Time t);
+
   /**
    * \brief Add the header to the packet
    *
@@ -85,6 +100,17 @@ public:
    */
   virtual void AddHeader (void) = 0;
 
+  /**
+   * \brief Mark the packet as having experienced congestion, if possible
+   * \return true if the packet has been marked, false otherwise
+   *
+   * Subclasses storing packets of a protocol supporting Explicit Congestion
+   * Notification may set the congestion experienced codepoint in the header,
+   * provided that the packet is ECN capable. The implementation of this method
+   * for the base class does not mark the packet and returns false.
+   */
+  virtual bool Mark (void);
+
   /**
    * \brief Print the item contents.
    * \param os output stream in which the data should be printed.
@@ -115,6 +141,7 @@ private:
   Address m_address;      //!< MAC destination address
   uint16_t m_protocol;    //!< L3 Protocol number
   uint8_t m_txq;          //!< Transmission queue index
+  Time m_tstamp;          //!< Time the item was enqueued
 };
 
 
@@ -298,6 +325,50 @@ public:
    */
   virtual uint32_t GetQuota (void) const;
 
+  /**
+   * \brief Set the maximum number of packets dequeued and passed to the device at once
+   * \param batchSize the maximum number of packets in a batch, 1 to disable batching
+   */
+  void SetBatchSize (uint32_t batchSize);
+
+  /**
+   * \brief Get the maximum number of packets dequeued and passed to the device at once
+   * \return the maximum number of packets in a batch
+   */
+  uint32_t GetBatchSize (void) const;
+
+  /**
+   * \brief Set the precision of the histogram of the sojourn times
+   *
+   * The histogram is reset. With a positive precision, the time spent by
+   * every packet in the queue disc, from its enqueue to its dequeue, is
+   * recorded in nanoseconds in a log-linear histogram with the given
+   * precision (see LogLinearHistogram).
+   *
+   * \param precision the precision in bits, 0 to not record the sojourn times
+   */
+  void SetSojournHistogramPrecision (uint32_t precision);
+
+  /**
+   * \brief Get the precision of the histogram of the sojourn times
+   * \return the precision in bits, 0 if the sojourn times are not recorded
+   */
+  uint32_t GetSojournHistogramPrecision (void) const;
+
+  /**
+   * \brief Get the histogram of the sojourn times, in nanoseconds
+   *
+   * Histograms of distinct queue discs with the same precision can be merged.
+   *
+   * \return the histogram of the sojourn times of the dequeued packets
+   */
+  const LogLinearHistogram & GetSojournHistogram (void) const;
+
+  /**
+   * \brief Remove the sojourn times recorded so far
+   */
+  void ResetSojournHistogram (void);
+
   /**
    * Pass a packet to store to the queue discipline. This function only updates
    * the statistics and calls the (private) DoEnqueue function, which must be
@@ -315,6 +386,17 @@ public:
    */
   Ptr<QueueDiscItem> Dequeue (void);
 
+  /**
+   * Request the queue discipline to extract multiple packets. This function
+   * only updates the statistics and calls the (private) DoDequeueBatch
+   * function, which derived classes may override.
+   * \param items the vector the extracted items are appended to
+   * \param maxItems the maximum number of items to extract
+   * \param maxBytes no item is extracted once the extracted items amount to this many bytes
+   * \return the number of extracted items
+   */
+  uint32_t DequeueBatch (std::vector<Ptr<QueueDiscItem> > &items, uint32_t maxItems, uint32_t maxBytes);
+
   /**
    * Get a copy of the next packet the queue discipline will extract, without
    * actually extracting the packet. This function only calls the (private)
@@ -419,7 +501,7 @@ public:
    *
    * \return the wake mode adopted by this queue disc.
    */
-  WakeMode GetWakeMode (void);
+  virtual WakeMode GetWakeMode (void);
 
   /// Callback invoked by a child queue disc to notify the parent of a packet drop
   typedef Callback<void, Ptr<QueueItem> > ParentDropCallback;
@@ -451,6 +533,23 @@ protected:
    */
   void Drop (Ptr<QueueItem> item);
 
+  /**
+   * \brief Add the internal queue of a queue disc that uses a single queue
+   *
+   * Called by the CheckConfig method of the queue discs that create their
+   * internal queue if none is provided. A RingBufferQueue is used if
+   * requested, a DropTailQueue otherwise. The capacity of the ring buffer is
+   * the limit in packet mode, and the limit divided by the mean packet size
+   * in byte mode. If the mean packet size is zero, the ring buffer keeps its
+   * default capacity and grows as needed.
+   *
+   * \param mode the mode of the queue
+   * \param limit the limit of the queue, in packets or bytes depending on the mode
+   * \param meanPktSize the mean packet size in bytes, used to size the ring buffer in byte mode
+   * \param useRingBuffer true to use a RingBufferQueue
+   */
+  void AddDefaultInternalQueue (Queue::QueueMode mode, uint32_t limit, uint32_t meanPktSize, bool useRingBuffer);
+
 private:
   /**
    *  \brief Notify the parent queue disc of a packet drop
@@ -471,6 +570,17 @@ private:
    */
   virtual Ptr<QueueDiscItem> DoDequeue (void) = 0;
 
+  /**
+   * This function actually extracts multiple packets from the queue disc.
+   * The default implementation calls DoDequeue until it returns no item,
+   * maxItems items are extracted or they amount to maxBytes bytes.
+   * \param items the vector the extracted items are appended to
+   * \param maxItems the maximum number of items to extract
+   * \param maxBytes no item is extracted once the extracted items amount to this many bytes
+   * \return the number of extracted items
+   */
+  virtual uint32_t DoDequeueBatch (std::vector<Ptr<QueueDiscItem> > &items, uint32_t maxItems, uint32_t maxBytes);
+
   /**
    * This function returns a copy of the next packet the queue disc will extract.
    * \return 0 if the operation was not successful; the packet otherwise.
@@ -509,12 +619,30 @@ private:
    */
   bool Restart (void);
 
+  /**
+   * Dequeue a batch of packets (by calling DequeuePacketBatch) and send them
+   * to the device (by calling TransmitBatch).
+   * \param quota the remaining quota, decreased by the number of dequeued packets
+   * \return true if the packets are successfully sent to the device.
+   */
+  bool RestartBatch (uint32_t &quota);
+
   /**
    * Modelled after the Linux function dequeue_skb (net/sched/sch_generic.c)
    * \return the requeued packet, if any, or the packet dequeued by the queue disc, otherwise.
    */
   Ptr<QueueDiscItem> DequeuePacket (void);
 
+  /**
+   * Modelled after the bulk dequeue of the Linux function dequeue_skb
+   * (net/sched/sch_generic.c). The batch is limited by the bytes available
+   * according to the queue limits of the device queue, if any.
+   * \param maxItems the maximum number of packets to dequeue
+   * \return the number of packets stored in m_batch, either requeued packets
+   * or packets dequeued by the queue disc
+   */
+  uint32_t DequeuePacketBatch (uint32_t maxItems);
+
   /**
    * Modelled after the Linux function dev_requeue_skb (net/sched/sch_generic.c)
    * Requeues a packet whose transmission failed.
@@ -531,6 +659,15 @@ private:
    */
   bool Transmit (Ptr<QueueDiscItem> item);
 
+  /**
+   * Sends the packets in m_batch to the device at once, like Linux does with
+   * xmit_more, and requeues those the device did not take because its queue
+   * was stopped.
+   * \return true if all the packets were taken, the device queue is not
+   * stopped and the queue disc is not empty
+   */
+  bool TransmitBatch (void);
+
   static const uint32_t DEFAULT_QUOTA = 64; //!< Default quota (as in /proc/sys/net/core/dev_weight)
 
   std::vector<Ptr<Queue> > m_queues;            //!< Internal queues
@@ -547,10 +684,14 @@ private:
   uint32_t m_nTotalRequeuedPackets; //!< Total requeued packets
   uint32_t m_nTotalRequeuedBytes;   //!< Total requeued bytes
   uint32_t m_quota;                 //!< Maximum number of packets dequeued in a qdisc run
+  uint32_t m_batchSize;             //!< Maximum number of packets passed to the device at once
+  LogLinearHistogram m_sojourn;     //!< Histogram of the sojourn times, in nanoseconds
   Ptr<NetDevice> m_device;          //!< The NetDevice on which this queue discipline is installed
   Ptr<NetDeviceQueueInterface> m_devQueueIface;   //!< NetDevice queue interface
   bool m_running;                   //!< The queue disc is performing multiple dequeue operations
-  Ptr<QueueDiscItem> m_requeued;    //!< The last packet that failed to be transmitted
+  std::list<Ptr<QueueDiscItem> > m_requeued;  //!< The packets that failed to be transmitted, in order
+  std::vector<Ptr<QueueDiscItem> > m_batch;   //!< The batch being transmitted
+  std::vector<NetDevice::TxItem> m_txBatch;   //!< The packets of the batch passed to the device
   ParentDropCallback m_parentDropCallback;   //!< Parent drop callback
 
   /// Traced callback: fired when a packet is enqueued
@@ -64,6 +64,7 @@
 #include "ns3/abort.h"
 #include "red-queue-disc.h"
 #include "ns3/drop-tail-queue.h"
+#include "ns3/aqm-fixed-point.h"
 
 namespace ns3 {
 
@@ -83,6 +84,16 @@ TypeId RedQueueDisc::GetTypeId (void)
                    MakeEnumAccessor (&RedQueueDisc::SetMode),
                    MakeEnumChecker (Queue::QUEUE_MODE_BYTES, "QUEUE_MODE_BYTES",
                                     Queue::QUEUE_MODE_PACKETS, "QUEUE_MODE_PACKETS"))
+    .AddAttribute ("UseRingBuffer",
+                   "True to use a RingBufferQueue sized from the queue limit as internal queue",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&RedQueueDisc::m_useRingBuffer),
+                   MakeBooleanChecker ())
+    .AddAttribute ("FixedPoint",
+                   "True to compute the average queue size and the drop probability in fixed point arithmetic",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&RedQueueDisc::m_fixedPoint),
+                   MakeBooleanChecker ())
     .AddAttribute ("MeanPktSize",
                    "Average of packet size",
                    UintegerValue (500),
@@ -340,7 +351,24 @@ RedQueueDisc::DoEnqueue (Ptr<QueueDiscItem> item)
       m_idle = 0;
     }
 
-  m_qAvg = Estimator (nQueued, m + 1, m_qAvg, m_qW);
+  bool aboveMinTh;
+  bool aboveMaxTh;
+  bool aboveGentleMaxTh;
+  if (m_fixedPoint)
+    {
+      m_qAvgFp = EstimatorFixed (nQueued, m + 1);
+      m_qAvg = AqmFixedPoint::ToDouble (m_qAvgFp, AqmFixedPoint::QUEUE_SHIFT);
+      aboveMinTh = (m_qAvgFp >= m_minThFp);
+      aboveMaxTh = (m_qAvgFp >= m_maxThFp);
+      aboveGentleMaxTh = (m_qAvgFp >= 2 * m_maxThFp);
+    }
+  else
+    {
+      m_qAvg = Estimator (nQueued, m + 1, m_qAvg, m_qW);
+      aboveMinTh = (m_qAvg >= m_minTh);
+      aboveMaxTh = (m_qAvg >= m_maxTh);
+      aboveGentleMaxTh = (m_qAvg >= 2 * m_maxTh);
+    }
 
   NS_LOG_DEBUG ("\t bytesInQueue  " << GetInternalQueue (0)->GetNBytes () << "\tQavg " << m_qAvg);
   NS_LOG_DEBUG ("\t packetsInQueue  " << GetInternalQueue (0)->GetNPackets () << "\tQavg " << m_qAvg);
@@ -349,10 +377,10 @@ RedQueueDisc::DoEnqueue (Ptr<QueueDiscItem> item)
   m_countBytes += item->GetPacketSize ();
 
   uint32_t dropType = DTYPE_NONE;
-  if (m_qAvg >= m_minTh && nQueued > 1)
+  if (aboveMinTh && nQueued > 1)
     {
-      if ((!m_isGentle && m_qAvg >= m_maxTh) ||
-          (m_isGentle && m_qAvg >= 2 * m_maxTh))
+      if ((!m_isGentle && aboveMaxTh) ||
+          (m_isGentle && aboveGentleMaxTh))
         {
           NS_LOG_DEBUG ("adding DROP FORCED MARK");
           dropType = DTYPE_FORCED;
@@ -379,6 +407,7 @@ RedQueueDisc::DoEnqueue (Ptr<QueueDiscItem> item)
     {
       // No packets are being dropped
       m_vProb = 0.0;
+      m_vProbFp = 0;
       m_old = 0;
     }
 
@@ -473,6 +502,8 @@ RedQueueDisc::InitializeParams (void)
   m_stats.qLimDrop = 0;
 
   m_qAvg = 0.0;
+  m_qAvgFp = 0;
+  m_vProbFp = 0;
   m_count = 0;
   m_countBytes = 0;
   m_old = 0;
@@ -539,6 +570,19 @@ RedQueueDisc::InitializeParams (void)
         }
     }
 
+  // The fixed point parameters are rounded once here, the control law
+  // then only uses integer operations
+  m_qWFp = AqmFixedPoint::FromDouble (m_qW, AqmFixedPoint::PROB_SHIFT);
+  m_minThFp = AqmFixedPoint::FromDouble (m_minTh, AqmFixedPoint::QUEUE_SHIFT);
+  m_maxThFp = AqmFixedPoint::FromDouble (m_maxTh, AqmFixedPoint::QUEUE_SHIFT);
+  m_vAFp = AqmFixedPoint::FromDouble (m_vA, AqmFixedPoint::PROB_SHIFT);
+  m_curMaxPFp = AqmFixedPoint::FromDouble (m_curMaxP, AqmFixedPoint::PROB_SHIFT);
+  if (m_isGentle)
+    {
+      m_vCFp = AqmFixedPoint::FromDouble (m_vC, AqmFixedPoint::PROB_SHIFT);
+      m_gentleBaseFp = AqmFixedPoint::FromDouble (m_vC * m_maxTh + m_vD, AqmFixedPoint::PROB_SHIFT);
+    }
+
   NS_LOG_DEBUG ("\tm_delay " << m_linkDelay.GetSeconds () << "; m_isWait " 
                              << m_isWait << "; m_qW " << m_qW << "; m_ptc " << m_ptc
                              << "; m_minTh " << m_minTh << "; m_maxTh " << m_maxTh
@@ -591,13 +635,47 @@ RedQueueDisc::Estimator (uint32_t nQueued, uint32_t m, double qAvg, double qW)
   return newAve;
 }
 
+// Compute the average queue size in fixed point
+uint64_t
+RedQueueDisc::EstimatorFixed (uint32_t nQueued, uint32_t m)
+{
+  NS_LOG_FUNCTION (this << nQueued << m);
+
+  uint64_t decay = AqmFixedPoint::ONE - m_qWFp;
+  if (m > 1)
+    {
+      decay = AqmFixedPoint::Pow (decay, m);
+    }
+  uint64_t newAve = AqmFixedPoint::MulShift (m_qAvgFp, decay, AqmFixedPoint::PROB_SHIFT);
+  newAve += AqmFixedPoint::MulShift (nQueued, m_qWFp, AqmFixedPoint::PROB_SHIFT - AqmFixedPoint::QUEUE_SHIFT);
+
+  Time now = Simulator::Now ();
+  if (m_isAdaptMaxP && now > m_lastSet + m_interval)
+    {
+      UpdateMaxP (AqmFixedPoint::ToDouble (newAve, AqmFixedPoint::QUEUE_SHIFT), now);
+      m_curMaxPFp = AqmFixedPoint::FromDouble (m_curMaxP, AqmFixedPoint::PROB_SHIFT);
+    }
+
+  return newAve;
+}
+
 // Check if packet p needs to be dropped due to probability mark
 uint32_t
 RedQueueDisc::DropEarly (Ptr<QueueDiscItem> item, uint32_t qSize)
 {
   NS_LOG_FUNCTION (this << item << qSize);
-  m_vProb1 = CalculatePNew (m_qAvg, m_maxTh, m_isGentle, m_vA, m_vB, m_vC, m_vD, m_curMaxP);
-  m_vProb = ModifyP (m_vProb1, m_count, m_countBytes, m_meanPktSize, m_isWait, item->GetPacketSize ());
+  if (m_fixedPoint)
+    {
+      uint64_t p = CalculatePNewFixed ();
+      m_vProbFp = ModifyPFixed (p, m_count, m_countBytes, item->GetPacketSize ());
+      m_vProb1 = AqmFixedPoint::ToDouble (p, AqmFixedPoint::PROB_SHIFT);
+      m_vProb = AqmFixedPoint::ToDouble (m_vProbFp, AqmFixedPoint::PROB_SHIFT);
+    }
+  else
+    {
+      m_vProb1 = CalculatePNew (m_qAvg, m_maxTh, m_isGentle, m_vA, m_vB, m_vC, m_vD, m_curMaxP);
+      m_vProb = ModifyP (m_vProb1, m_count, m_countBytes, m_meanPktSize, m_isWait, item->GetPacketSize ());
+    }
 
   // Drop probability is computed, pick random number and act
   if (m_cautious == 1)
@@ -637,7 +715,8 @@ RedQueueDisc::DropEarly (Ptr<QueueDiscItem> item, uint32_t qSize)
         }
     }
 
-  if (u <= m_vProb)
+  // in fixed point, the random number is truncated to the precision of the probability
+  if (m_fixedPoint ? (uint64_t) (u * AqmFixedPoint::ONE) <= m_vProbFp : u <= m_vProb)
     {
       NS_LOG_LOGIC ("u <= m_vProb; u " << u << "; m_vProb " << m_vProb);
 
@@ -746,6 +825,95 @@ RedQueueDisc::ModifyP (double p, uint32_t count, uint32_t countBytes,
   return p;
 }
 
+uint64_t
+RedQueueDisc::CalculatePNewFixed (void)
+{
+  NS_LOG_FUNCTION (this);
+  uint64_t p;
+
+  if (m_isGentle && m_qAvgFp >= m_maxThFp)
+    {
+      // p = vC * qAvg + vD = (vC * maxTh + vD) + vC * (qAvg - maxTh)
+      p = m_gentleBaseFp + AqmFixedPoint::MulShift (m_qAvgFp - m_maxThFp, m_vCFp, AqmFixedPoint::QUEUE_SHIFT);
+    }
+  else if (!m_isGentle && m_qAvgFp >= m_maxThFp)
+    {
+      p = AqmFixedPoint::ONE;
+    }
+  else
+    {
+      // p = (vA * qAvg + vB) * maxP = vA * (qAvg - minTh) * maxP
+      uint64_t excess = (m_qAvgFp > m_minThFp) ? m_qAvgFp - m_minThFp : 0;
+      p = AqmFixedPoint::MulShift (excess, m_vAFp, AqmFixedPoint::QUEUE_SHIFT);
+      p = AqmFixedPoint::MulShift (p, m_curMaxPFp, AqmFixedPoint::PROB_SHIFT);
+    }
+
+  if (p > AqmFixedPoint::ONE)
+    {
+      p = AqmFixedPoint::ONE;
+    }
+
+  return p;
+}
+
+uint64_t
+RedQueueDisc::ModifyPFixed (uint64_t p, uint32_t count, uint32_t countBytes, uint32_t size)
+{
+  NS_LOG_FUNCTION (this << p << count << countBytes << size);
+  const uint64_t one = AqmFixedPoint::ONE;
+  uint64_t count1 = count;
+
+  if (GetMode () == Queue::QUEUE_MODE_BYTES)
+    {
+      count1 = countBytes / m_meanPktSize;
+    }
+
+  uint64_t cp = AqmFixedPoint::MulShift (count1, p, 0);
+
+  if (p >= one)
+    {
+      p = (m_isWait && cp < one) ? 0 : one;
+    }
+  else if (m_isWait)
+    {
+      if (cp < one)
+        {
+          p = 0;
+        }
+      else if (cp < 2 * one)
+        {
+          p = (p << AqmFixedPoint::PROB_SHIFT) / (2 * one - cp);
+        }
+      else
+        {
+          p = one;
+        }
+    }
+  else
+    {
+      if (cp < one)
+        {
+          p = (p << AqmFixedPoint::PROB_SHIFT) / (one - cp);
+        }
+      else
+        {
+          p = one;
+        }
+    }
+
+  if ((GetMode () == Queue::QUEUE_MODE_BYTES) && (p < one))
+    {
+      p = (p * size) / m_meanPktSize;
+    }
+
+  if (p > one)
+    {
+      p = one;
+    }
+
+  return p;
+}
+
 uint32_t
 RedQueueDisc::GetQueueSize (void)
 {
@@ -827,17 +995,7 @@ RedQueueDisc::CheckConfig (void)
 
   if (GetNInternalQueues () == 0)
     {
-      // create a DropTail queue
-      Ptr<Queue> queue = CreateObjectWithAttributes<DropTailQueue> ("Mode", EnumValue (m_mode));
-      if (m_mode == Queue::QUEUE_MODE_PACKETS)
-        {
-          queue->SetMaxPackets (m_queueLimit);
-        }
-      else
-        {
-          queue->SetMaxBytes (m_queueLimit);
-        }
-      AddInternalQueue (queue);
+      AddDefaultInternalQueue (m_mode, m_queueLimit, m_meanPktSize, m_useRingBuffer);
     }
 
   if (GetNInternalQueues () != 1)
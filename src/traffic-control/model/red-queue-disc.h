@@ -272,11 +272,34 @@ private:
    */
   double ModifyP (double p, uint32_t count, uint32_t countBytes,
                   uint32_t meanPktSize, bool wait, uint32_t size);
+  /**
+   * \brief Compute the average queue size in fixed point
+   * \param nQueued number of queued packets
+   * \param m simulated number of packets arrival during idle period
+   * \returns new average queue size, with AqmFixedPoint::QUEUE_SHIFT fractional bits
+   */
+  uint64_t EstimatorFixed (uint32_t nQueued, uint32_t m);
+  /**
+   * \brief Fixed point version of CalculatePNew, using the current parameters
+   * \returns Prob. of packet drop before "count", with AqmFixedPoint::PROB_SHIFT fractional bits
+   */
+  uint64_t CalculatePNewFixed (void);
+  /**
+   * \brief Fixed point version of ModifyP
+   * \param p Prob. of packet drop before "count", with AqmFixedPoint::PROB_SHIFT fractional bits
+   * \param count number of packets since last random number generation
+   * \param countBytes number of bytes since last drop
+   * \param size packet size
+   * \returns Prob. of packet drop, with AqmFixedPoint::PROB_SHIFT fractional bits
+   */
+  uint64_t ModifyPFixed (uint64_t p, uint32_t count, uint32_t countBytes, uint32_t size);
 
   Stats m_stats; //!< RED statistics
 
   // ** Variables supplied by user
   Queue::QueueMode m_mode;  //!< Mode (Bytes or packets)
+  bool m_useRingBuffer;     //!< True to use a RingBufferQueue as internal queue
+  bool m_fixedPoint;        //!< True to run the control law in fixed point arithmetic
   uint32_t m_meanPktSize;   //!< Avg pkt size
   uint32_t m_idlePktSize;   //!< Avg pkt size used during idle times
   bool m_isWait;            //!< True for waiting between dropped packets
@@ -323,6 +346,17 @@ private:
   uint32_t m_cautious;
   Time m_idleTime;          //!< Start of current idle period
 
+  // ** Fixed point versions of the variables above (see AqmFixedPoint)
+  uint64_t m_qAvgFp;        //!< Average queue length
+  uint64_t m_qWFp;          //!< Queue weight
+  uint64_t m_minThFp;       //!< Min avg length threshold
+  uint64_t m_maxThFp;       //!< Max avg length threshold
+  uint64_t m_vAFp;          //!< 1.0 / (m_maxTh - m_minTh)
+  uint64_t m_vCFp;          //!< (1.0 - m_curMaxP) / m_maxTh - used in "gentle" mode
+  uint64_t m_gentleBaseFp;  //!< Prob. of packet drop at m_maxTh in "gentle" mode (m_vC * m_maxTh + m_vD)
+  uint64_t m_curMaxPFp;     //!< Current max_p
+  uint64_t m_vProbFp;       //!< Prob. of packet drop
+
   Ptr<UniformRandomVariable> m_uv;  //!< rng stream
 };
 
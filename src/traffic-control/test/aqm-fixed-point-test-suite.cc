@@ -0,0 +1,438 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/test.h"
+#include "ns3/aqm-fixed-point.h"
+#include "ns3/red-queue-disc.h"
+#include "ns3/ldc-queue-disc.h"
+#include "ns3/uinteger.h"
+#include "ns3/double.h"
+#include "ns3/string.h"
+#include "ns3/boolean.h"
+#include "ns3/data-rate.h"
+#include "ns3/simulator.h"
+#include <cmath>
+#include <cstdlib>
+
+using namespace ns3;
+
+class AqmFixedPointTestItem : public QueueDiscItem {
+public:
+  AqmFixedPointTestItem (Ptr<Packet> p, const Address & addr, uint16_t protocol);
+  virtual ~AqmFixedPointTestItem ();
+  virtual void AddHeader (void);
+
+private:
+  AqmFixedPointTestItem ();
+  AqmFixedPointTestItem (const AqmFixedPointTestItem &);
+  AqmFixedPointTestItem &operator = (const AqmFixedPointTestItem &);
+};
+
+AqmFixedPointTestItem::AqmFixedPointTestItem (Ptr<Packet> p, const Address & addr, uint16_t protocol)
+  : QueueDiscItem (p, addr, protocol)
+{
+}
+
+AqmFixedPointTestItem::~AqmFixedPointTestItem ()
+{
+}
+
+void
+AqmFixedPointTestItem::AddHeader (void)
+{
+}
+
+/**
+ * Check the fixed point operations against the floating point ones
+ */
+class AqmFixedPointArithmeticTestCase : public TestCase
+{
+public:
+  AqmFixedPointArithmeticTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+AqmFixedPointArithmeticTestCase::AqmFixedPointArithmeticTestCase ()
+  : TestCase ("Check the fixed point arithmetic")
+{
+}
+
+void
+AqmFixedPointArithmeticTestCase::DoRun (void)
+{
+  const uint64_t one = AqmFixedPoint::ONE;
+
+  NS_TEST_EXPECT_MSG_EQ (AqmFixedPoint::FromDouble (0.5, 32), one / 2, "Wrong conversion of 0.5");
+  NS_TEST_EXPECT_MSG_EQ (AqmFixedPoint::FromDouble (-1, 32), 0, "Negative numbers must be converted to 0");
+  NS_TEST_EXPECT_MSG_EQ (AqmFixedPoint::FromDouble (1e30, 32), std::numeric_limits<uint64_t>::max (),
+                         "Large numbers must saturate");
+  NS_TEST_EXPECT_MSG_EQ_TOL (AqmFixedPoint::ToDouble (AqmFixedPoint::FromDouble (123.456, 24), 24),
+                             123.456, 1e-6, "Wrong round trip conversion");
+
+  // the 128 bit product does not lose the high bits
+  NS_TEST_EXPECT_MSG_EQ (AqmFixedPoint::MulShift (1ULL << 63, 1ULL << 40, 64), 1ULL << 39, "Wrong product");
+  NS_TEST_EXPECT_MSG_EQ (AqmFixedPoint::MulShift (0xffffffffffffffffULL, 0xffffffffffffffffULL, 64),
+                         0xfffffffffffffffeULL, "Wrong product");
+  NS_TEST_EXPECT_MSG_EQ (AqmFixedPoint::MulShift (1000, 3 * one / 4, 32), 750, "Wrong product");
+  NS_TEST_EXPECT_MSG_EQ (AqmFixedPoint::MulShift (1ULL << 40, 1ULL << 40, 0), std::numeric_limits<uint64_t>::max (),
+                         "Overflowing products must saturate");
+
+  for (uint32_t n = 0; n < 2000; n += 37)
+    {
+      double x = 0.998;
+      uint64_t xFp = AqmFixedPoint::FromDouble (x, 32);
+      NS_TEST_EXPECT_MSG_EQ_TOL (AqmFixedPoint::ToDouble (AqmFixedPoint::Pow (xFp, n), 32), std::pow (x, n), 1e-6,
+                                 "Wrong power " << n);
+    }
+  NS_TEST_EXPECT_MSG_EQ (AqmFixedPoint::Pow (3 * one / 2, 3), one, "Powers of numbers above one must saturate");
+}
+
+/**
+ * Feed the same packets to two queue discs (e.g., one of which computes in
+ * fixed point) and dequeue them at a lower rate with idle periods
+ */
+class AqmFixedPointDriver
+{
+public:
+  /**
+   * \param first the first queue disc
+   * \param second the second queue disc
+   * \param pktSize the size of the packets
+   */
+  AqmFixedPointDriver (Ptr<QueueDisc> first, Ptr<QueueDisc> second, uint32_t pktSize);
+  /**
+   * Run the scenario
+   * \param nSteps number of steps, one per millisecond
+   */
+  void Run (uint32_t nSteps);
+
+private:
+  /**
+   * Run a step
+   * \param step the index of the step
+   * \param nSteps number of steps
+   */
+  void Step (uint32_t step, uint32_t nSteps);
+
+  Ptr<QueueDisc> m_first;     //!< First queue disc
+  Ptr<QueueDisc> m_second;    //!< Second queue disc
+  uint32_t m_pktSize;         //!< Size of the packets
+};
+
+AqmFixedPointDriver::AqmFixedPointDriver (Ptr<QueueDisc> first, Ptr<QueueDisc> second, uint32_t pktSize)
+  : m_first (first),
+    m_second (second),
+    m_pktSize (pktSize)
+{
+}
+
+void
+AqmFixedPointDriver::Run (uint32_t nSteps)
+{
+  Simulator::Schedule (MilliSeconds (1), &AqmFixedPointDriver::Step, this, 0, nSteps);
+  // the periodic timer of LDC would keep the simulation running
+  Simulator::Stop (MilliSeconds (nSteps + 1));
+  Simulator::Run ();
+}
+
+void
+AqmFixedPointDriver::Step (uint32_t step, uint32_t nSteps)
+{
+  Address dest;
+  // 5 packets arrive every 3 ms, except in the last 100 ms of every second
+  bool idle = (step % 1000 >= 900);
+  if (!idle)
+    {
+      uint32_t nArrivals = (step % 3 == 0) ? 3 : 1;
+      for (uint32_t i = 0; i < nArrivals; i++)
+        {
+          m_first->Enqueue (Create<AqmFixedPointTestItem> (Create<Packet> (m_pktSize), dest, 0));
+          m_second->Enqueue (Create<AqmFixedPointTestItem> (Create<Packet> (m_pktSize), dest, 0));
+        }
+    }
+  m_first->Dequeue ();
+  m_second->Dequeue ();
+  if (idle)
+    {
+      // drain the queues
+      while (m_first->Dequeue ())
+        {
+        }
+      while (m_second->Dequeue ())
+        {
+        }
+    }
+
+  if (step + 1 < nSteps)
+    {
+      Simulator::Schedule (MilliSeconds (1), &AqmFixedPointDriver::Step, this, step + 1, nSteps);
+    }
+}
+
+/**
+ * \brief Check that two drop counts are within 3% (or 3 drops) of each other
+ * \param a the first count
+ * \param b the second count
+ * \return true if the counts are close
+ */
+static bool
+CloseCounts (uint32_t a, uint32_t b)
+{
+  uint32_t diff = (a > b) ? a - b : b - a;
+  return diff <= std::max<uint32_t> (3, 0.03 * std::max (a, b));
+}
+
+/**
+ * Check that RED gives close results in floating and fixed point, which
+ * round differently and hence do not always drop the same packets
+ */
+class RedFixedPointTestCase : public TestCase
+{
+public:
+  RedFixedPointTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Compare the two arithmetics with the given configuration
+   * \param mode the queue disc mode
+   * \param gentle whether the gentle mode is enabled
+   * \param wait whether to wait between drops
+   */
+  void Compare (std::string mode, bool gentle, bool wait);
+};
+
+RedFixedPointTestCase::RedFixedPointTestCase ()
+  : TestCase ("Check that RED drops about as many packets in floating and fixed point")
+{
+}
+
+void
+RedFixedPointTestCase::Compare (std::string mode, bool gentle, bool wait)
+{
+  uint32_t pktSize = 1000;
+  uint32_t modeSize = (mode == "QUEUE_MODE_BYTES") ? pktSize : 1;
+
+  Ptr<RedQueueDisc> queue[2];
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      queue[i] = CreateObject<RedQueueDisc> ();
+      queue[i]->SetAttribute ("Mode", StringValue (mode));
+      queue[i]->SetAttribute ("MeanPktSize", UintegerValue (pktSize));
+      queue[i]->SetAttribute ("MinTh", DoubleValue (5 * modeSize));
+      queue[i]->SetAttribute ("MaxTh", DoubleValue (15 * modeSize));
+      queue[i]->SetAttribute ("QueueLimit", UintegerValue (40 * modeSize));
+      queue[i]->SetAttribute ("QW", DoubleValue (0.02));
+      queue[i]->SetAttribute ("LInterm", DoubleValue (10));
+      queue[i]->SetAttribute ("Gentle", BooleanValue (gentle));
+      queue[i]->SetAttribute ("Wait", BooleanValue (wait));
+      queue[i]->SetAttribute ("LinkBandwidth", DataRateValue (DataRate ("8Mbps")));
+      queue[i]->SetAttribute ("FixedPoint", BooleanValue (i == 1));
+      queue[i]->AssignStreams (1);
+      queue[i]->Initialize ();
+    }
+
+  AqmFixedPointDriver driver (queue[0], queue[1], pktSize);
+  driver.Run (3000);
+
+  RedQueueDisc::Stats st0 = queue[0]->GetStats ();
+  RedQueueDisc::Stats st1 = queue[1]->GetStats ();
+  NS_TEST_EXPECT_MSG_GT (st0.unforcedDrop, 0, "The scenario should cause early drops (" << mode << ")");
+  NS_TEST_EXPECT_MSG_EQ (CloseCounts (st0.unforcedDrop, st1.unforcedDrop), true,
+                         "Early drops differ: " << st0.unforcedDrop << " " << st1.unforcedDrop
+                         << " (" << mode << ", gentle " << gentle << ", wait " << wait << ")");
+  NS_TEST_EXPECT_MSG_EQ (CloseCounts (st0.forcedDrop, st1.forcedDrop), true,
+                         "Forced drops differ: " << st0.forcedDrop << " " << st1.forcedDrop
+                         << " (" << mode << ", gentle " << gentle << ", wait " << wait << ")");
+
+  Simulator::Destroy ();
+}
+
+void
+RedFixedPointTestCase::DoRun (void)
+{
+  Compare ("QUEUE_MODE_PACKETS", true, true);
+  Compare ("QUEUE_MODE_PACKETS", false, false);
+  Compare ("QUEUE_MODE_BYTES", true, true);
+  Compare ("QUEUE_MODE_BYTES", false, true);
+}
+
+/**
+ * Check that LDC gives close results in floating and fixed point, which
+ * round differently and hence do not always drop the same packets
+ */
+class LdcFixedPointTestCase : public TestCase
+{
+public:
+  LdcFixedPointTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Compare the two arithmetics with the given configuration
+   * \param mode the queue disc mode
+   * \param lazy whether the control intervals are run lazily
+   */
+  void Compare (std::string mode, bool lazy);
+};
+
+LdcFixedPointTestCase::LdcFixedPointTestCase ()
+  : TestCase ("Check that LDC drops about as many packets in floating and fixed point")
+{
+}
+
+void
+LdcFixedPointTestCase::Compare (std::string mode, bool lazy)
+{
+  uint32_t pktSize = 1000;
+  uint32_t modeSize = (mode == "QUEUE_MODE_BYTES") ? pktSize : 1;
+
+  Ptr<LdcQueueDisc> queue[2];
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      queue[i] = CreateObject<LdcQueueDisc> ();
+      queue[i]->SetAttribute ("Mode", StringValue (mode));
+      queue[i]->SetAttribute ("MeanPktSize", UintegerValue (pktSize));
+      queue[i]->SetAttribute ("QueueLimit", UintegerValue (60 * modeSize));
+      queue[i]->SetAttribute ("LinkBandwidth", DataRateValue (DataRate ("8Mbps")));
+      queue[i]->SetAttribute ("TargetQueueingDelay", TimeValue (MilliSeconds (20)));
+      queue[i]->SetAttribute ("LazyTimeout", BooleanValue (lazy));
+      queue[i]->SetAttribute ("FixedPoint", BooleanValue (i == 1));
+      queue[i]->AssignStreams (1);
+      queue[i]->Initialize ();
+    }
+
+  AqmFixedPointDriver driver (queue[0], queue[1], pktSize);
+  driver.Run (2950);
+
+  LdcQueueDisc::Stats st0 = queue[0]->GetStats ();
+  LdcQueueDisc::Stats st1 = queue[1]->GetStats ();
+  NS_TEST_EXPECT_MSG_GT (st0.unforcedDrop, 0, "The scenario should cause early drops (" << mode << ")");
+  NS_TEST_EXPECT_MSG_EQ (CloseCounts (st0.unforcedDrop, st1.unforcedDrop), true,
+                         "Early drops differ: " << st0.unforcedDrop << " " << st1.unforcedDrop
+                         << " (" << mode << ", lazy " << lazy << ")");
+  NS_TEST_EXPECT_MSG_EQ (CloseCounts (st0.forcedDrop, st1.forcedDrop), true,
+                         "Forced drops differ: " << st0.forcedDrop << " " << st1.forcedDrop
+                         << " (" << mode << ", lazy " << lazy << ")");
+  NS_TEST_EXPECT_MSG_EQ_TOL (queue[1]->GetAverageQueueSize (), queue[0]->GetAverageQueueSize (),
+                             0.01 * modeSize, "Average queue sizes differ (" << mode << ", lazy " << lazy << ")");
+  NS_TEST_EXPECT_MSG_EQ_TOL (queue[1]->GetDropProbability (), queue[0]->GetDropProbability (), 1e-4,
+                             "Drop probabilities differ (" << mode << ", lazy " << lazy << ")");
+  NS_TEST_EXPECT_MSG_EQ_TOL (queue[1]->GetLoadFactor (), queue[0]->GetLoadFactor (), 1e-4,
+                             "Load factors differ (" << mode << ", lazy " << lazy << ")");
+
+  // the timer events of LDC must be removed before the simulator is destroyed
+  queue[0]->Dispose ();
+  queue[1]->Dispose ();
+  Simulator::Destroy ();
+}
+
+void
+LdcFixedPointTestCase::DoRun (void)
+{
+  Compare ("QUEUE_MODE_PACKETS", false);
+  Compare ("QUEUE_MODE_PACKETS", true);
+  Compare ("QUEUE_MODE_BYTES", false);
+}
+
+/**
+ * Check that LDC in fixed point gives exactly the same results whether the
+ * control intervals are run periodically or lazily
+ */
+class LdcFixedPointLazyTestCase : public TestCase
+{
+public:
+  LdcFixedPointLazyTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Compare the two timer modes with the given configuration
+   * \param mode the queue disc mode
+   */
+  void Compare (std::string mode);
+};
+
+LdcFixedPointLazyTestCase::LdcFixedPointLazyTestCase ()
+  : TestCase ("Check that LDC in fixed point drops the same packets with periodic and lazy intervals")
+{
+}
+
+void
+LdcFixedPointLazyTestCase::Compare (std::string mode)
+{
+  uint32_t pktSize = 1000;
+  uint32_t modeSize = (mode == "QUEUE_MODE_BYTES") ? pktSize : 1;
+
+  Ptr<LdcQueueDisc> queue[2];
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      queue[i] = CreateObject<LdcQueueDisc> ();
+      queue[i]->SetAttribute ("Mode", StringValue (mode));
+      queue[i]->SetAttribute ("MeanPktSize", UintegerValue (pktSize));
+      queue[i]->SetAttribute ("QueueLimit", UintegerValue (60 * modeSize));
+      queue[i]->SetAttribute ("LinkBandwidth", DataRateValue (DataRate ("8Mbps")));
+      queue[i]->SetAttribute ("TargetQueueingDelay", TimeValue (MilliSeconds (20)));
+      queue[i]->SetAttribute ("LazyTimeout", BooleanValue (i == 1));
+      queue[i]->SetAttribute ("FixedPoint", BooleanValue (true));
+      queue[i]->AssignStreams (1);
+      queue[i]->Initialize ();
+    }
+
+  AqmFixedPointDriver driver (queue[0], queue[1], pktSize);
+  driver.Run (2950);
+
+  LdcQueueDisc::Stats st0 = queue[0]->GetStats ();
+  LdcQueueDisc::Stats st1 = queue[1]->GetStats ();
+  NS_TEST_EXPECT_MSG_GT (st0.unforcedDrop, 0, "The scenario should cause early drops (" << mode << ")");
+  NS_TEST_EXPECT_MSG_EQ (st1.unforcedDrop, st0.unforcedDrop, "Early drops differ (" << mode << ")");
+  NS_TEST_EXPECT_MSG_EQ (st1.forcedDrop, st0.forcedDrop, "Forced drops differ (" << mode << ")");
+  NS_TEST_EXPECT_MSG_EQ (st1.qLimDrop, st0.qLimDrop, "Drops due to queue limit differ (" << mode << ")");
+  NS_TEST_EXPECT_MSG_EQ (queue[1]->GetAverageQueueSize (), queue[0]->GetAverageQueueSize (),
+                         "Average queue sizes differ (" << mode << ")");
+  NS_TEST_EXPECT_MSG_EQ (queue[1]->GetDropProbability (), queue[0]->GetDropProbability (),
+                         "Drop probabilities differ (" << mode << ")");
+  NS_TEST_EXPECT_MSG_EQ (queue[1]->GetLoadFactor (), queue[0]->GetLoadFactor (),
+                         "Load factors differ (" << mode << ")");
+
+  // the timer events of LDC must be removed before the simulator is destroyed
+  queue[0]->Dispose ();
+  queue[1]->Dispose ();
+  Simulator::Destroy ();
+}
+
+void
+LdcFixedPointLazyTestCase::DoRun (void)
+{
+  Compare ("QUEUE_MODE_PACKETS");
+  Compare ("QUEUE_MODE_BYTES");
+}
+
+static class AqmFixedPointTestSuite : public TestSuite
+{
+public:
+  AqmFixedPointTestSuite ()
+    : TestSuite ("aqm-fixed-point", UNIT)
+  {
+    AddTestCase (new AqmFixedPointArithmeticTestCase (), TestCase::QUICK);
+    AddTestCase (new RedFixedPointTestCase (), TestCase::QUICK);
+    AddTestCase (new LdcFixedPointTestCase (), TestCase::QUICK);
+    AddTestCase (new LdcFixedPointLazyTestCase (), TestCase::QUICK);
+  }
+} g_aqmFixedPointTestSuite;
@@ -25,6 +25,7 @@
 #include "ns3/uinteger.h"
 #include "ns3/string.h"
 #include "ns3/double.h"
+#include "ns3/boolean.h"
 #include "ns3/log.h"
 #include "ns3/simulator.h"
 
@@ -536,6 +537,61 @@ CoDelQueueDiscBasicDrop::Dequeue (Ptr<CoDelQueueDisc> queue, uint32_t modeSize)
     }
 }
 
+// Test 6: ring buffer internal queue
+class CoDelQueueDiscRingBuffer : public TestCase
+{
+public:
+  CoDelQueueDiscRingBuffer ();
+  virtual void DoRun (void);
+};
+
+CoDelQueueDiscRingBuffer::CoDelQueueDiscRingBuffer ()
+  : TestCase ("Ring buffer internal queue in byte mode, also with a zero MinBytes")
+{
+}
+
+void
+CoDelQueueDiscRingBuffer::DoRun (void)
+{
+  uint32_t pktSize = 1000;
+  uint32_t minBytes[] = { 1500, 0 };
+  Address dest;
+
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      Ptr<CoDelQueueDisc> queue = CreateObject<CoDelQueueDisc> ();
+      queue->SetAttribute ("Mode", StringValue ("QUEUE_MODE_BYTES"));
+      queue->SetAttribute ("MaxBytes", UintegerValue (pktSize * 10));
+      queue->SetAttribute ("MinBytes", UintegerValue (minBytes[i]));
+      queue->SetAttribute ("UseRingBuffer", BooleanValue (true));
+      queue->Initialize ();
+
+      NS_TEST_EXPECT_MSG_EQ (queue->GetInternalQueue (0)->GetInstanceTypeId ().GetName (), "ns3::RingBufferQueue",
+                             "The internal queue should be a ring buffer");
+
+      std::vector<uint64_t> uids;
+      for (uint32_t j = 0; j < 12; j++)
+        {
+          Ptr<Packet> p = Create<Packet> (pktSize);
+          uids.push_back (p->GetUid ());
+          queue->Enqueue (Create<CodelQueueDiscTestItem> (p, dest, 0));
+        }
+      NS_TEST_EXPECT_MSG_EQ (queue->GetNBytes (), pktSize * 10, "The queue should hold ten packets");
+      NS_TEST_EXPECT_MSG_EQ (queue->GetDropOverLimit (), 2, "Two packets should be dropped due to full queue");
+
+      for (uint32_t j = 0; j < 10; j++)
+        {
+          Ptr<QueueDiscItem> item = queue->Dequeue ();
+          NS_TEST_EXPECT_MSG_EQ ((item != 0), true, "There should be a packet to dequeue");
+          if (item)
+            {
+              NS_TEST_EXPECT_MSG_EQ (item->GetPacket ()->GetUid (), uids[j], "The packets should leave in order");
+            }
+        }
+      NS_TEST_EXPECT_MSG_EQ (queue->GetNBytes (), 0, "The queue should be empty");
+    }
+}
+
 static class CoDelQueueDiscTestSuite : public TestSuite
 {
 public:
@@ -555,5 +611,7 @@ public:
     // Test 5: enqueue/dequeue with drops according to CoDel algorithm
     AddTestCase (new CoDelQueueDiscBasicDrop ("QUEUE_MODE_PACKETS"), TestCase::QUICK);
     AddTestCase (new CoDelQueueDiscBasicDrop ("QUEUE_MODE_BYTES"), TestCase::QUICK);
+    // Test 6: ring buffer internal queue
+    AddTestCase (new CoDelQueueDiscRingBuffer (), TestCase::QUICK);
   }
 } g_coDelQueueTestSuite;
@@ -0,0 +1,302 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/test.h"
+#include "ns3/fq-ldc-queue-disc.h"
+#include "ns3/ldc-queue-disc.h"
+#include "ns3/packet-filter.h"
+#include "ns3/uinteger.h"
+#include "ns3/string.h"
+#include "ns3/double.h"
+#include "ns3/simulator.h"
+
+using namespace ns3;
+
+class FqLdcQueueDiscTestItem : public QueueDiscItem {
+public:
+  FqLdcQueueDiscTestItem (Ptr<Packet> p, const Address & addr, uint16_t protocol);
+  virtual ~FqLdcQueueDiscTestItem ();
+  virtual void AddHeader (void);
+
+private:
+  FqLdcQueueDiscTestItem ();
+  FqLdcQueueDiscTestItem (const FqLdcQueueDiscTestItem &);
+  FqLdcQueueDiscTestItem &operator = (const FqLdcQueueDiscTestItem &);
+};
+
+FqLdcQueueDiscTestItem::FqLdcQueueDiscTestItem (Ptr<Packet> p, const Address & addr, uint16_t protocol)
+  : QueueDiscItem (p, addr, protocol)
+{
+}
+
+FqLdcQueueDiscTestItem::~FqLdcQueueDiscTestItem ()
+{
+}
+
+void
+FqLdcQueueDiscTestItem::AddHeader (void)
+{
+}
+
+/**
+ * Packet filter that uses the protocol number of the items as flow hash
+ */
+class FqLdcTestPacketFilter : public PacketFilter {
+public:
+  static TypeId GetTypeId (void);
+  FqLdcTestPacketFilter ();
+  virtual ~FqLdcTestPacketFilter ();
+
+private:
+  virtual bool CheckProtocol (Ptr<QueueDiscItem> item) const;
+  virtual int32_t DoClassify (Ptr<QueueDiscItem> item) const;
+};
+
+TypeId
+FqLdcTestPacketFilter::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::FqLdcTestPacketFilter")
+    .SetParent<PacketFilter> ()
+    .SetGroupName ("TrafficControl")
+    .AddConstructor<FqLdcTestPacketFilter> ()
+  ;
+  return tid;
+}
+
+FqLdcTestPacketFilter::FqLdcTestPacketFilter ()
+{
+}
+
+FqLdcTestPacketFilter::~FqLdcTestPacketFilter ()
+{
+}
+
+bool
+FqLdcTestPacketFilter::CheckProtocol (Ptr<QueueDiscItem> item) const
+{
+  return true;
+}
+
+int32_t
+FqLdcTestPacketFilter::DoClassify (Ptr<QueueDiscItem> item) const
+{
+  return item->GetProtocol ();
+}
+
+class FqLdcQueueDiscFairnessTestCase : public TestCase
+{
+public:
+  FqLdcQueueDiscFairnessTestCase ();
+  virtual void DoRun (void);
+private:
+  /**
+   * Run an elephant flow (protocol 1) that sends twice the link bandwidth
+   * and a thin flow (protocol 2) that sends a tenth of it
+   * \param queue the queue disc under test
+   */
+  void RunTraffic (Ptr<QueueDisc> queue);
+  /**
+   * Enqueue a packet of the given flow
+   * \param queue the queue disc under test
+   * \param flow the flow of the packet
+   */
+  void Enqueue (Ptr<QueueDisc> queue, uint16_t flow);
+  /**
+   * Count the dropped packets of each flow
+   * \param item the dropped item
+   */
+  void Drop (Ptr<const QueueItem> item);
+
+  uint32_t m_drops[3];  //!< number of dropped packets of each flow
+};
+
+FqLdcQueueDiscFairnessTestCase::FqLdcQueueDiscFairnessTestCase ()
+  : TestCase ("Check that fq-ldc protects a thin flow from an elephant flow")
+{
+}
+
+void
+FqLdcQueueDiscFairnessTestCase::Enqueue (Ptr<QueueDisc> queue, uint16_t flow)
+{
+  Address dest;
+  queue->Enqueue (Create<FqLdcQueueDiscTestItem> (Create<Packet> (1000), dest, flow));
+}
+
+void
+FqLdcQueueDiscFairnessTestCase::Drop (Ptr<const QueueItem> item)
+{
+  m_drops[StaticCast<const QueueDiscItem> (item)->GetProtocol ()]++;
+}
+
+void
+FqLdcQueueDiscFairnessTestCase::RunTraffic (Ptr<QueueDisc> queue)
+{
+  m_drops[1] = 0;
+  m_drops[2] = 0;
+
+  // 1000B packets on an 8Mbps link: one departure per millisecond
+  queue->SetAttribute ("LinkBandwidth", StringValue ("8Mbps"));
+  queue->SetAttribute ("MeanPktSize", UintegerValue (1000));
+  queue->SetAttribute ("TimeInterval", StringValue ("10ms"));
+  queue->SetAttribute ("TargetQueueingDelay", StringValue ("100ms"));
+  queue->SetAttribute ("TargetLoadFactorRatio", DoubleValue (1.0));
+  queue->SetAttribute ("WQ", DoubleValue (0.5));
+  queue->SetAttribute ("LdcExponent", UintegerValue (3));
+  queue->TraceConnectWithoutContext ("Drop", MakeCallback (&FqLdcQueueDiscFairnessTestCase::Drop, this));
+  queue->Initialize ();
+
+  for (uint32_t i = 0; i < 1000; i++)
+    {
+      Time t = MicroSeconds (1000 * i);
+      Simulator::Schedule (t + MicroSeconds (100), &FqLdcQueueDiscFairnessTestCase::Enqueue, this, queue, 1);
+      Simulator::Schedule (t + MicroSeconds (600), &FqLdcQueueDiscFairnessTestCase::Enqueue, this, queue, 1);
+      if (i % 10 == 0)
+        {
+          Simulator::Schedule (t + MicroSeconds (300), &FqLdcQueueDiscFairnessTestCase::Enqueue, this, queue, 2);
+        }
+      Simulator::Schedule (t + MicroSeconds (900), &QueueDisc::Dequeue, queue);
+    }
+
+  Simulator::Stop (Seconds (1));
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+void
+FqLdcQueueDiscFairnessTestCase::DoRun (void)
+{
+  // with a single LDC, the load factor of the elephant flow is shared and
+  // the thin flow suffers the same drop probability
+  Ptr<LdcQueueDisc> ldc = CreateObject<LdcQueueDisc> ();
+  ldc->SetAttribute ("QueueLimit", UintegerValue (1000));
+  RunTraffic (ldc);
+  NS_TEST_EXPECT_MSG_GT (m_drops[1], 500, "The elephant flow should be dropped");
+  NS_TEST_EXPECT_MSG_GT (m_drops[2], 25, "The thin flow should be dropped with a single LDC");
+
+  Ptr<FqLdcQueueDisc> fqLdc = CreateObject<FqLdcQueueDisc> ();
+  fqLdc->SetAttribute ("PacketLimit", UintegerValue (1000));
+  fqLdc->SetQuantum (1000);
+  fqLdc->AddPacketFilter (CreateObject<FqLdcTestPacketFilter> ());
+  RunTraffic (fqLdc);
+  NS_TEST_EXPECT_MSG_GT (m_drops[1], 500, "The elephant flow should be dropped");
+  NS_TEST_EXPECT_MSG_LT (m_drops[2], 5, "The thin flow should be protected by fq-ldc");
+}
+
+class FqLdcQueueDiscOverlimitTestCase : public TestCase
+{
+public:
+  FqLdcQueueDiscOverlimitTestCase ();
+  virtual void DoRun (void);
+private:
+  /**
+   * Enqueue a packet of the given flow
+   * \param queue the queue disc under test
+   * \param flow the flow of the packet
+   */
+  void Enqueue (Ptr<QueueDisc> queue, uint16_t flow);
+  /**
+   * Count the dropped packets of each flow
+   * \param item the dropped item
+   */
+  void Drop (Ptr<const QueueItem> item);
+
+  uint32_t m_drops[4];  //!< number of dropped packets of each flow
+};
+
+FqLdcQueueDiscOverlimitTestCase::FqLdcQueueDiscOverlimitTestCase ()
+  : TestCase ("Check that fq-ldc drops from the fattest flow when it is full")
+{
+}
+
+void
+FqLdcQueueDiscOverlimitTestCase::Enqueue (Ptr<QueueDisc> queue, uint16_t flow)
+{
+  Address dest;
+  queue->Enqueue (Create<FqLdcQueueDiscTestItem> (Create<Packet> (1000), dest, flow));
+}
+
+void
+FqLdcQueueDiscOverlimitTestCase::Drop (Ptr<const QueueItem> item)
+{
+  m_drops[StaticCast<const QueueDiscItem> (item)->GetProtocol ()]++;
+}
+
+void
+FqLdcQueueDiscOverlimitTestCase::DoRun (void)
+{
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      m_drops[i] = 0;
+    }
+
+  Ptr<FqLdcQueueDisc> queue = CreateObject<FqLdcQueueDisc> ();
+  queue->SetAttribute ("PacketLimit", UintegerValue (20));
+  queue->SetAttribute ("LinkBandwidth", StringValue ("8Mbps"));
+  queue->SetQuantum (1000);
+  queue->AddPacketFilter (CreateObject<FqLdcTestPacketFilter> ());
+  queue->TraceConnectWithoutContext ("Drop", MakeCallback (&FqLdcQueueDiscOverlimitTestCase::Drop, this));
+  queue->Initialize ();
+
+  // flow 2 becomes the fattest flow, then flow 1 overtakes it, so that
+  // the heap of backlogged flows is reordered
+  for (uint32_t i = 0; i < 6; i++)
+    {
+      Enqueue (queue, 1);
+    }
+  for (uint32_t i = 0; i < 10; i++)
+    {
+      Enqueue (queue, 2);
+    }
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      Enqueue (queue, 3);
+    }
+  NS_TEST_EXPECT_MSG_EQ (queue->GetNPackets (), 19, "No packet should have been dropped");
+
+  // the new flows are served in order, one quantum each, then flow 1 again
+  for (uint32_t i = 0; i < 6; i++)
+    {
+      queue->Dequeue ();
+    }
+  NS_TEST_EXPECT_MSG_EQ (queue->GetNPackets (), 13, "Six packets should have been dequeued");
+
+  // flows 1, 2 and 3 now hold 4, 8 and 1 packets: filling the queue
+  // disc with flow 1 makes it the fattest flow, with 12 packets when the
+  // limit is exceeded
+  for (uint32_t i = 0; i < 8; i++)
+    {
+      Enqueue (queue, 1);
+    }
+  NS_TEST_EXPECT_MSG_EQ (m_drops[2], 0, "The thin flows should not be dropped");
+  NS_TEST_EXPECT_MSG_EQ (m_drops[3], 0, "The thin flows should not be dropped");
+  NS_TEST_EXPECT_MSG_EQ (m_drops[1], 6, "Half of the backlog of the fattest flow should be dropped");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetOverlimitDroppedPackets (), 6, "Wrong number of overlimit drops");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetNPackets (), 15, "Wrong number of packets");
+
+  Simulator::Destroy ();
+}
+
+static class FqLdcQueueDiscTestSuite : public TestSuite
+{
+public:
+  FqLdcQueueDiscTestSuite ()
+    : TestSuite ("fq-ldc-queue-disc", UNIT)
+  {
+    AddTestCase (new FqLdcQueueDiscFairnessTestCase (), TestCase::QUICK);
+    AddTestCase (new FqLdcQueueDiscOverlimitTestCase (), TestCase::QUICK);
+  }
+} g_fqLdcQueueTestSuite;
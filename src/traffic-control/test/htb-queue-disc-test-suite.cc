@@ -0,0 +1,457 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/test.h"
+#include "ns3/htb-queue-disc.h"
+#include "ns3/ldc-queue-disc.h"
+#include "ns3/pfifo-fast-queue-disc.h"
+#include "ns3/traffic-control-layer.h"
+#include "ns3/packet-filter.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/simple-channel.h"
+#include "ns3/node.h"
+#include "ns3/error-model.h"
+#include "ns3/uinteger.h"
+#include "ns3/simulator.h"
+
+using namespace ns3;
+
+class HtbQueueDiscTestItem : public QueueDiscItem {
+public:
+  HtbQueueDiscTestItem (Ptr<Packet> p, const Address & addr, uint16_t protocol);
+  virtual ~HtbQueueDiscTestItem ();
+  virtual void AddHeader (void);
+
+private:
+  HtbQueueDiscTestItem ();
+  HtbQueueDiscTestItem (const HtbQueueDiscTestItem &);
+  HtbQueueDiscTestItem &operator = (const HtbQueueDiscTestItem &);
+};
+
+HtbQueueDiscTestItem::HtbQueueDiscTestItem (Ptr<Packet> p, const Address & addr, uint16_t protocol)
+  : QueueDiscItem (p, addr, protocol)
+{
+}
+
+HtbQueueDiscTestItem::~HtbQueueDiscTestItem ()
+{
+}
+
+void
+HtbQueueDiscTestItem::AddHeader (void)
+{
+}
+
+/**
+ * Packet filter that uses the protocol number of the items as class index
+ */
+class HtbTestPacketFilter : public PacketFilter {
+public:
+  static TypeId GetTypeId (void);
+  HtbTestPacketFilter ();
+  virtual ~HtbTestPacketFilter ();
+
+private:
+  virtual bool CheckProtocol (Ptr<QueueDiscItem> item) const;
+  virtual int32_t DoClassify (Ptr<QueueDiscItem> item) const;
+};
+
+TypeId
+HtbTestPacketFilter::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::HtbTestPacketFilter")
+    .SetParent<PacketFilter> ()
+    .SetGroupName ("TrafficControl")
+    .AddConstructor<HtbTestPacketFilter> ()
+  ;
+  return tid;
+}
+
+HtbTestPacketFilter::HtbTestPacketFilter ()
+{
+}
+
+HtbTestPacketFilter::~HtbTestPacketFilter ()
+{
+}
+
+bool
+HtbTestPacketFilter::CheckProtocol (Ptr<QueueDiscItem> item) const
+{
+  return true;
+}
+
+int32_t
+HtbTestPacketFilter::DoClassify (Ptr<QueueDiscItem> item) const
+{
+  return item->GetProtocol ();
+}
+
+/**
+ * Create an HTB class
+ * \param rate the rate of the class
+ * \param ceil the ceil of the class
+ * \param parent the parent of the class
+ * \param qd the queue disc of a leaf class
+ * \return the class
+ */
+static Ptr<HtbClass>
+CreateHtbClass (std::string rate, std::string ceil, Ptr<HtbClass> parent, Ptr<QueueDisc> qd)
+{
+  Ptr<HtbClass> cl = CreateObject<HtbClass> ();
+  cl->SetAttribute ("Rate", DataRateValue (DataRate (rate)));
+  cl->SetAttribute ("Ceil", DataRateValue (DataRate (ceil)));
+  cl->SetParentClass (parent);
+  cl->SetQueueDisc (qd);
+  return cl;
+}
+
+/**
+ * Check that the classes get their rate, borrow up to their ceil and
+ * share the excess bandwidth, with LDC leaves
+ */
+class HtbQueueDiscSharingTestCase : public TestCase
+{
+public:
+  HtbQueueDiscSharingTestCase ();
+  virtual void DoRun (void);
+private:
+  /**
+   * Keep the active classes backlogged and dequeue a packet
+   * \param qdisc the queue disc
+   * \param nActive the number of classes, starting from the first, to keep backlogged
+   */
+  void Tick (Ptr<QueueDisc> qdisc, uint32_t nActive);
+
+  static const uint32_t N_CLASSES = 3;  //!< Number of leaf classes
+  static const uint32_t PKT_SIZE = 1000;  //!< Size of the packets
+  uint64_t m_bytes[N_CLASSES];  //!< Bytes dequeued from each class in the measurement period
+};
+
+HtbQueueDiscSharingTestCase::HtbQueueDiscSharingTestCase ()
+  : TestCase ("Check the rate, ceil and borrowing of the HTB classes")
+{
+}
+
+void
+HtbQueueDiscSharingTestCase::Tick (Ptr<QueueDisc> qdisc, uint32_t nActive)
+{
+  Address dest;
+  for (uint32_t i = 0; i < nActive; i++)
+    {
+      while (qdisc->GetQueueDiscClass (i)->GetQueueDisc ()->GetNPackets () < 20)
+        {
+          qdisc->Enqueue (Create<HtbQueueDiscTestItem> (Create<Packet> (PKT_SIZE), dest, i));
+        }
+    }
+
+  Ptr<QueueDiscItem> item = qdisc->Dequeue ();
+  if (item)
+    {
+      m_bytes[item->GetProtocol ()] += item->GetPacketSize ();
+    }
+  // the line rate (40Mbps) is higher than any rate of the classes
+  Simulator::Schedule (MicroSeconds (200), &HtbQueueDiscSharingTestCase::Tick, this, qdisc, nActive);
+}
+
+void
+HtbQueueDiscSharingTestCase::DoRun (void)
+{
+  // root (12Mbps) -> A (2Mbps, ceil 10Mbps), B (6Mbps, ceil 10Mbps),
+  // C (2Mbps, ceil 2Mbps)
+  Ptr<HtbQueueDisc> qdisc = CreateObject<HtbQueueDisc> ();
+  Ptr<HtbClass> root = CreateHtbClass ("12Mbps", "12Mbps", 0, 0);
+  Ptr<HtbClass> leaves[N_CLASSES];
+  leaves[0] = CreateHtbClass ("2Mbps", "10Mbps", root, CreateObject<LdcQueueDisc> ());
+  leaves[1] = CreateHtbClass ("6Mbps", "10Mbps", root, CreateObject<LdcQueueDisc> ());
+  leaves[2] = CreateHtbClass ("2Mbps", "2Mbps", root, CreateObject<LdcQueueDisc> ());
+  for (uint32_t i = 0; i < N_CLASSES; i++)
+    {
+      qdisc->AddQueueDiscClass (leaves[i]);
+    }
+  qdisc->AddPacketFilter (CreateObject<HtbTestPacketFilter> ());
+  qdisc->Initialize ();
+
+  DataRateValue bandwidth;
+  leaves[1]->GetQueueDisc ()->GetAttribute ("LinkBandwidth", bandwidth);
+  NS_TEST_EXPECT_MSG_EQ (bandwidth.Get (), DataRate ("6Mbps"), "The LDC leaves should get the rate of their class");
+
+  // all the classes are backlogged
+  for (uint32_t i = 0; i < N_CLASSES; i++)
+    {
+      m_bytes[i] = 0;
+    }
+  Simulator::Schedule (Seconds (0.0), &HtbQueueDiscSharingTestCase::Tick, this, qdisc, N_CLASSES);
+  Simulator::Stop (Seconds (0.5));
+  Simulator::Run ();
+  for (uint32_t i = 0; i < N_CLASSES; i++)
+    {
+      m_bytes[i] = 0;
+    }
+  Simulator::Stop (Seconds (2.0));
+  Simulator::Run ();
+
+  double rates[N_CLASSES];
+  for (uint32_t i = 0; i < N_CLASSES; i++)
+    {
+      rates[i] = m_bytes[i] * 8 / 2.0e6;
+    }
+  NS_TEST_EXPECT_MSG_EQ_TOL (rates[2], 2.0, 0.1, "C should not exceed its ceil");
+  NS_TEST_EXPECT_MSG_EQ_TOL (rates[0] + rates[1] + rates[2], 12.0, 0.6, "The classes should use the rate of the root");
+  NS_TEST_EXPECT_MSG_GT (rates[0], 2.0 * 0.95, "A should get its rate");
+  NS_TEST_EXPECT_MSG_GT (rates[1], 6.0 * 0.95, "B should get its rate");
+  NS_TEST_EXPECT_MSG_GT (rates[1], rates[0] * 2, "B should get the larger share of the excess bandwidth");
+  NS_TEST_EXPECT_MSG_GT (leaves[0]->GetBorrowedPackets (), 0, "A should borrow from the root");
+  NS_TEST_EXPECT_MSG_EQ (leaves[2]->GetBorrowedPackets (), 0, "C should not borrow from the root");
+  // the LDC queue discs cancel their events when disposed
+  for (uint32_t i = 0; i < N_CLASSES; i++)
+    {
+      leaves[i]->GetQueueDisc ()->Dispose ();
+    }
+  Simulator::Destroy ();
+
+  // only A is backlogged, it borrows up to its ceil
+  qdisc = CreateObject<HtbQueueDisc> ();
+  root = CreateHtbClass ("12Mbps", "12Mbps", 0, 0);
+  leaves[0] = CreateHtbClass ("2Mbps", "10Mbps", root, CreateObject<LdcQueueDisc> ());
+  leaves[1] = CreateHtbClass ("6Mbps", "10Mbps", root, CreateObject<LdcQueueDisc> ());
+  qdisc->AddQueueDiscClass (leaves[0]);
+  qdisc->AddQueueDiscClass (leaves[1]);
+  qdisc->AddPacketFilter (CreateObject<HtbTestPacketFilter> ());
+  qdisc->Initialize ();
+
+  m_bytes[0] = 0;
+  Simulator::Schedule (Seconds (0.0), &HtbQueueDiscSharingTestCase::Tick, this, qdisc, 1);
+  Simulator::Stop (Seconds (0.5));
+  Simulator::Run ();
+  m_bytes[0] = 0;
+  Simulator::Stop (Seconds (2.0));
+  Simulator::Run ();
+  NS_TEST_EXPECT_MSG_EQ_TOL (m_bytes[0] * 8 / 2.0e6, 10.0, 0.5, "A should send at its ceil");
+  leaves[0]->GetQueueDisc ()->Dispose ();
+  leaves[1]->GetQueueDisc ()->Dispose ();
+  Simulator::Destroy ();
+}
+
+/**
+ * A device that records the time the packets are sent
+ */
+class HtbTestDevice : public SimpleNetDevice
+{
+public:
+  virtual bool Send (Ptr<Packet> packet, const Address& dest, uint16_t protocolNumber);
+
+  std::vector<Time> m_sendTimes;  //!< times the packets were sent
+};
+
+bool
+HtbTestDevice::Send (Ptr<Packet> packet, const Address& dest, uint16_t protocolNumber)
+{
+  m_sendTimes.push_back (Simulator::Now ());
+  return true;
+}
+
+/**
+ * Check that a backlogged root queue disc is run again when the classes
+ * get their tokens back
+ */
+class HtbQueueDiscWatchdogTestCase : public TestCase
+{
+public:
+  HtbQueueDiscWatchdogTestCase ();
+  virtual void DoRun (void);
+};
+
+HtbQueueDiscWatchdogTestCase::HtbQueueDiscWatchdogTestCase ()
+  : TestCase ("Check that the HTB queue disc is run again when tokens are available")
+{
+}
+
+void
+HtbQueueDiscWatchdogTestCase::DoRun (void)
+{
+  Ptr<HtbTestDevice> device = CreateObject<HtbTestDevice> ();
+  device->SetMtu (1500);
+  Ptr<NetDeviceQueueInterface> ndqi = CreateObject<NetDeviceQueueInterface> ();
+  device->AggregateObject (ndqi);
+  ndqi->CreateTxQueues ();
+
+  Ptr<HtbQueueDisc> qdisc = CreateObject<HtbQueueDisc> ();
+  qdisc->SetNetDevice (device);
+  qdisc->AddQueueDiscClass (CreateHtbClass ("1Mbps", "1Mbps", 0, CreateObject<PfifoFastQueueDisc> ()));
+  qdisc->Initialize ();
+
+  Address dest;
+  for (uint32_t i = 0; i < 100; i++)
+    {
+      qdisc->Enqueue (Create<HtbQueueDiscTestItem> (Create<Packet> (1000), dest, 0));
+    }
+  qdisc->Run ();
+  Simulator::Run ();
+
+  NS_TEST_EXPECT_MSG_EQ (device->m_sendTimes.size (), 100, "All the packets should be sent");
+  NS_TEST_EXPECT_MSG_EQ (qdisc->GetNPackets (), 0, "The queue disc should be empty");
+  // the bucket (125 bytes sent at 1Mbps in 1ms plus the MTU) lets the first
+  // packets go at once, the others are sent at 1Mbps
+  NS_TEST_EXPECT_MSG_EQ_TOL (device->m_sendTimes.back ().GetSeconds (), (99 * 1000 - 1625) * 8 / 1.0e6,
+                             0.01, "The packets should be sent at the rate of the class");
+  Simulator::Destroy ();
+}
+
+/**
+ * Check that a backlogged HTB queue disc that is the child of another HTB
+ * queue disc wakes up the root when its classes get their tokens back
+ */
+class HtbQueueDiscChildWatchdogTestCase : public TestCase
+{
+public:
+  HtbQueueDiscChildWatchdogTestCase ();
+  virtual void DoRun (void);
+};
+
+HtbQueueDiscChildWatchdogTestCase::HtbQueueDiscChildWatchdogTestCase ()
+  : TestCase ("Check that a child HTB queue disc runs the root when tokens are available")
+{
+}
+
+void
+HtbQueueDiscChildWatchdogTestCase::DoRun (void)
+{
+  Ptr<Node> node = CreateObject<Node> ();
+  Ptr<TrafficControlLayer> tc = CreateObject<TrafficControlLayer> ();
+  node->AggregateObject (tc);
+  Ptr<HtbTestDevice> device = CreateObject<HtbTestDevice> ();
+  device->SetMtu (1500);
+  node->AddDevice (device);
+
+  // the child limits the rate, the root does not. As the traffic control
+  // helper does, both queue discs are given the device
+  Ptr<HtbQueueDisc> child = CreateObject<HtbQueueDisc> ();
+  child->AddQueueDiscClass (CreateHtbClass ("1Mbps", "1Mbps", 0, CreateObject<PfifoFastQueueDisc> ()));
+  Ptr<HtbQueueDisc> root = CreateObject<HtbQueueDisc> ();
+  root->AddQueueDiscClass (CreateHtbClass ("10Mbps", "10Mbps", 0, child));
+  tc->SetRootQueueDiscOnDevice (device, root);
+  root->SetNetDevice (device);
+  child->SetNetDevice (device);
+  node->Initialize ();
+
+  Address dest;
+  for (uint32_t i = 0; i < 100; i++)
+    {
+      root->Enqueue (Create<HtbQueueDiscTestItem> (Create<Packet> (1000), dest, 0));
+    }
+  root->Run ();
+  Simulator::Run ();
+
+  NS_TEST_EXPECT_MSG_EQ (device->m_sendTimes.size (), 100, "All the packets should be sent");
+  NS_TEST_EXPECT_MSG_EQ (child->GetNPackets (), 0, "The child queue disc should be empty");
+  NS_TEST_EXPECT_MSG_EQ (root->GetNPackets (), 0, "The packets should be dequeued through the root");
+  NS_TEST_EXPECT_MSG_EQ_TOL (device->m_sendTimes.back ().GetSeconds (), (99 * 1000 - 1625) * 8 / 1.0e6,
+                             0.01, "The packets should be sent at the rate of the child class");
+  Simulator::Destroy ();
+}
+
+/**
+ * Check that the packets of thousands of leaf classes are all served
+ */
+class HtbQueueDiscManyClassesTestCase : public TestCase
+{
+public:
+  HtbQueueDiscManyClassesTestCase ();
+  virtual void DoRun (void);
+private:
+  /**
+   * Dequeue a packet
+   * \param qdisc the queue disc
+   */
+  void Tick (Ptr<QueueDisc> qdisc);
+
+  std::vector<uint32_t> m_packets;  //!< Packets dequeued from each leaf class
+};
+
+HtbQueueDiscManyClassesTestCase::HtbQueueDiscManyClassesTestCase ()
+  : TestCase ("Check an HTB queue disc with thousands of classes")
+{
+}
+
+void
+HtbQueueDiscManyClassesTestCase::Tick (Ptr<QueueDisc> qdisc)
+{
+  Ptr<QueueDiscItem> item = qdisc->Dequeue ();
+  if (item)
+    {
+      m_packets[item->GetProtocol ()]++;
+    }
+  if (qdisc->GetNPackets () > 0)
+    {
+      Simulator::Schedule (MicroSeconds (80), &HtbQueueDiscManyClassesTestCase::Tick, this, qdisc);
+    }
+}
+
+void
+HtbQueueDiscManyClassesTestCase::DoRun (void)
+{
+  // root (80Mbps) -> 20 inner classes (2Mbps, ceil 80Mbps) -> 100 leaves each (10kbps, ceil 80Mbps)
+  const uint32_t nInner = 20;
+  const uint32_t nLeaves = 100;
+  Ptr<HtbQueueDisc> qdisc = CreateObject<HtbQueueDisc> ();
+  Ptr<HtbClass> root = CreateHtbClass ("80Mbps", "80Mbps", 0, 0);
+  for (uint32_t i = 0; i < nInner; i++)
+    {
+      Ptr<HtbClass> inner = CreateHtbClass ("2Mbps", "80Mbps", root, 0);
+      for (uint32_t j = 0; j < nLeaves; j++)
+        {
+          qdisc->AddQueueDiscClass (CreateHtbClass ("10kbps", "80Mbps", inner, CreateObject<PfifoFastQueueDisc> ()));
+        }
+    }
+  qdisc->AddPacketFilter (CreateObject<HtbTestPacketFilter> ());
+  qdisc->Initialize ();
+
+  Address dest;
+  m_packets.assign (nInner * nLeaves, 0);
+  for (uint32_t k = 0; k < 5; k++)
+    {
+      for (uint32_t i = 0; i < nInner * nLeaves; i++)
+        {
+          qdisc->Enqueue (Create<HtbQueueDiscTestItem> (Create<Packet> (1000), dest, i));
+        }
+    }
+
+  Simulator::Schedule (Seconds (0.0), &HtbQueueDiscManyClassesTestCase::Tick, this, qdisc);
+  Simulator::Run ();
+
+  // 80Mbit at 80Mbps (plus the initial buckets)
+  NS_TEST_EXPECT_MSG_EQ_TOL (Simulator::Now ().GetSeconds (), 1.0, 0.05, "The packets should be sent at the rate of the root");
+  for (uint32_t i = 0; i < nInner * nLeaves; i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (m_packets[i], 5, "All the packets of the class should be dequeued");
+    }
+  Simulator::Destroy ();
+}
+
+static class HtbQueueDiscTestSuite : public TestSuite
+{
+public:
+  HtbQueueDiscTestSuite ()
+    : TestSuite ("htb-queue-disc", UNIT)
+  {
+    AddTestCase (new HtbQueueDiscSharingTestCase (), TestCase::QUICK);
+    AddTestCase (new HtbQueueDiscWatchdogTestCase (), TestCase::QUICK);
+    AddTestCase (new HtbQueueDiscChildWatchdogTestCase (), TestCase::QUICK);
+    AddTestCase (new HtbQueueDiscManyClassesTestCase (), TestCase::QUICK);
+  }
+} g_htbQueueDiscTestSuite;
@@ -0,0 +1,960 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/test.h"
+#include "ns3/ldc-queue-disc.h"
+#include "ns3/uinteger.h"
+#include "ns3/string.h"
+#include "ns3/double.h"
+#include "ns3/boolean.h"
+#include "ns3/enum.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/simple-net-device.h"
+#include <cmath>
+
+using namespace ns3;
+
+// The following code follows the control law of ns-2 queue/ldc.cc (one
+// run of LDC::timeout), for unit testing
+static double _ldc_drop_prob (double qAvg, double qTarget, double ratio, double rTarget,
+                              double wQ, uint32_t lExp)
+{
+  double qRatio = std::min (1.0, std::pow (qAvg / qTarget, (double) lExp));
+  double rRatio = std::min (1.0, std::pow (ratio / rTarget, (double) lExp));
+  return wQ * qRatio + (1 - wQ) * rRatio;
+}
+// End ns-2 borrow
+
+
+class LdcQueueDiscTestItem : public QueueDiscItem {
+public:
+  LdcQueueDiscTestItem (Ptr<Packet> p, const Address & addr, uint16_t protocol, bool ecnCapable);
+  virtual ~LdcQueueDiscTestItem ();
+  virtual void AddHeader (void);
+  virtual bool Mark (void);
+
+private:
+  LdcQueueDiscTestItem ();
+  LdcQueueDiscTestItem (const LdcQueueDiscTestItem &);
+  LdcQueueDiscTestItem &operator = (const LdcQueueDiscTestItem &);
+  bool m_ecnCapable;
+};
+
+LdcQueueDiscTestItem::LdcQueueDiscTestItem (Ptr<Packet> p, const Address & addr, uint16_t protocol,
+                                            bool ecnCapable)
+  : QueueDiscItem (p, addr, protocol),
+    m_ecnCapable (ecnCapable)
+{
+}
+
+LdcQueueDiscTestItem::~LdcQueueDiscTestItem ()
+{
+}
+
+void
+LdcQueueDiscTestItem::AddHeader (void)
+{
+}
+
+bool
+LdcQueueDiscTestItem::Mark (void)
+{
+  return m_ecnCapable;
+}
+
+static void
+EnqueuePackets (Ptr<LdcQueueDisc> queue, uint32_t size, uint32_t nPkt, bool ecnCapable)
+{
+  Address dest;
+  for (uint32_t i = 0; i < nPkt; i++)
+    {
+      queue->Enqueue (Create<LdcQueueDiscTestItem> (Create<Packet> (size), dest, 0, ecnCapable));
+    }
+}
+
+static void
+DequeuePackets (Ptr<LdcQueueDisc> queue, uint32_t nPkt)
+{
+  for (uint32_t i = 0; i < nPkt; i++)
+    {
+      queue->Dequeue ();
+    }
+}
+
+
+class LdcQueueDiscBasicTestCase : public TestCase
+{
+public:
+  LdcQueueDiscBasicTestCase ();
+  virtual void DoRun (void);
+private:
+  void RunBasicTest (StringValue mode);
+};
+
+LdcQueueDiscBasicTestCase::LdcQueueDiscBasicTestCase ()
+  : TestCase ("Sanity check on the ldc queue implementation")
+{
+}
+
+void
+LdcQueueDiscBasicTestCase::RunBasicTest (StringValue mode)
+{
+  uint32_t pktSize = 0;
+  // 1 for packets; pktSize for bytes
+  uint32_t modeSize = 1;
+  uint32_t qSize = 4;
+  Ptr<LdcQueueDisc> queue = CreateObject<LdcQueueDisc> ();
+
+  NS_TEST_EXPECT_MSG_EQ (queue->SetAttributeFailSafe ("Mode", mode), true,
+                         "Verify that we can actually set the attribute Mode");
+  NS_TEST_EXPECT_MSG_EQ (queue->SetAttributeFailSafe ("QueueLimit", UintegerValue (qSize)), true,
+                         "Verify that we can actually set the attribute QueueLimit");
+
+  Address dest;
+
+  if (queue->GetMode () == Queue::QUEUE_MODE_BYTES)
+    {
+      pktSize = 1000;
+      modeSize = pktSize;
+      queue->SetQueueLimit (qSize * modeSize);
+    }
+
+  Ptr<Packet> p1, p2, p3, p4, p5;
+  p1 = Create<Packet> (pktSize);
+  p2 = Create<Packet> (pktSize);
+  p3 = Create<Packet> (pktSize);
+  p4 = Create<Packet> (pktSize);
+  p5 = Create<Packet> (pktSize);
+
+  // the drop probability is zero until the first control interval expires
+  queue->Initialize ();
+  NS_TEST_EXPECT_MSG_EQ (queue->GetQueueSize (), 0 * modeSize, "There should be no packets in there");
+  queue->Enqueue (Create<LdcQueueDiscTestItem> (p1, dest, 0, false));
+  NS_TEST_EXPECT_MSG_EQ (queue->GetQueueSize (), 1 * modeSize, "There should be one packet in there");
+  queue->Enqueue (Create<LdcQueueDiscTestItem> (p2, dest, 0, false));
+  queue->Enqueue (Create<LdcQueueDiscTestItem> (p3, dest, 0, false));
+  queue->Enqueue (Create<LdcQueueDiscTestItem> (p4, dest, 0, false));
+  NS_TEST_EXPECT_MSG_EQ (queue->GetQueueSize (), 4 * modeSize, "There should be four packets in there");
+  queue->Enqueue (Create<LdcQueueDiscTestItem> (p5, dest, 0, false));
+  NS_TEST_EXPECT_MSG_EQ (queue->GetQueueSize (), 4 * modeSize, "There should still be four packets in there");
+
+  LdcQueueDisc::Stats st = queue->GetStats ();
+  NS_TEST_EXPECT_MSG_EQ (st.qLimDrop, 1, "There should be one drop due to queue full");
+
+  Ptr<QueueDiscItem> item;
+
+  item = queue->Dequeue ();
+  NS_TEST_EXPECT_MSG_EQ ((item != 0), true, "I want to remove the first packet");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetQueueSize (), 3 * modeSize, "There should be three packets in there");
+  NS_TEST_EXPECT_MSG_EQ (item->GetPacket ()->GetUid (), p1->GetUid (), "was this the first packet ?");
+
+  item = queue->Dequeue ();
+  NS_TEST_EXPECT_MSG_EQ ((item != 0), true, "I want to remove the second packet");
+  NS_TEST_EXPECT_MSG_EQ (item->GetPacket ()->GetUid (), p2->GetUid (), "Was this the second packet ?");
+
+  item = queue->Dequeue ();
+  item = queue->Dequeue ();
+  NS_TEST_EXPECT_MSG_EQ (item->GetPacket ()->GetUid (), p4->GetUid (), "Was this the fourth packet ?");
+
+  item = queue->Dequeue ();
+  NS_TEST_EXPECT_MSG_EQ ((item == 0), true, "There are really no packets in there");
+}
+
+void
+LdcQueueDiscBasicTestCase::DoRun (void)
+{
+  RunBasicTest (StringValue ("QUEUE_MODE_PACKETS"));
+  RunBasicTest (StringValue ("QUEUE_MODE_BYTES"));
+  Simulator::Destroy ();
+}
+
+
+/**
+ * Check the drop probability computed at the end of a control interval
+ * against the value given by the ns-2 control law.
+ *
+ * With a link of 8 Mbps and 1000 byte packets, 1000 packets can be sent
+ * per second, i.e., 10 packets per 10 ms interval, and the 20 ms target
+ * delay corresponds to 20 packets. 20 packets are enqueued in the first
+ * interval and none is dequeued, hence at the end of the second interval
+ * the average queue size is 0.5 * 20 = 10 and the load factor is
+ * 0.5 * 20 / 10 = 1. A burst of packets is then enqueued and the fraction of
+ * unforced drops has to match the drop probability. In the next interval
+ * the queue and the load are way above their targets and every packet is
+ * dropped.
+ */
+class LdcQueueDiscDropProbabilityTestCase : public TestCase
+{
+public:
+  /**
+   * \param lazy whether to use the lazy timeout
+   * \param fastPow whether to avoid the calls to pow
+   * \param wQ weight for the delay component
+   * \param rTarget target load factor ratio
+   * \param lExp exponent
+   */
+  LdcQueueDiscDropProbabilityTestCase (bool lazy, bool fastPow, double wQ, double rTarget, uint32_t lExp);
+  virtual void DoRun (void);
+private:
+  bool m_lazy;
+  bool m_fastPow;
+  double m_wQ;
+  double m_rTarget;
+  uint32_t m_lExp;
+};
+
+LdcQueueDiscDropProbabilityTestCase::LdcQueueDiscDropProbabilityTestCase (bool lazy, bool fastPow, double wQ,
+                                                                          double rTarget, uint32_t lExp)
+  : TestCase ("Check the ldc drop probability against the ns-2 control law"),
+    m_lazy (lazy),
+    m_fastPow (fastPow),
+    m_wQ (wQ),
+    m_rTarget (rTarget),
+    m_lExp (lExp)
+{
+}
+
+void
+LdcQueueDiscDropProbabilityTestCase::DoRun (void)
+{
+  uint32_t pktSize = 1000;
+  uint32_t burst = 10000;
+
+  Ptr<LdcQueueDisc> queue = CreateObject<LdcQueueDisc> ();
+  queue->SetAttribute ("QueueLimit", UintegerValue (2 * burst));
+  queue->SetAttribute ("MeanPktSize", UintegerValue (pktSize));
+  queue->SetAttribute ("LinkBandwidth", StringValue ("8Mbps"));
+  queue->SetAttribute ("TimeInterval", StringValue ("10ms"));
+  queue->SetAttribute ("TargetQueueingDelay", StringValue ("20ms"));
+  queue->SetAttribute ("QW", DoubleValue (0.5));
+  queue->SetAttribute ("RW", DoubleValue (0.5));
+  queue->SetAttribute ("WQ", DoubleValue (m_wQ));
+  queue->SetAttribute ("TargetLoadFactorRatio", DoubleValue (m_rTarget));
+  queue->SetAttribute ("LdcExponent", UintegerValue (m_lExp));
+  queue->SetAttribute ("LazyTimeout", BooleanValue (m_lazy));
+  queue->SetAttribute ("FastPow", BooleanValue (m_fastPow));
+  queue->AssignStreams (1);
+  queue->Initialize ();
+
+  Simulator::Schedule (MilliSeconds (1), &EnqueuePackets, queue, pktSize, 20, false);
+  Simulator::Schedule (MilliSeconds (11), &EnqueuePackets, queue, pktSize, burst, false);
+  Simulator::Schedule (MilliSeconds (21), &EnqueuePackets, queue, pktSize, 100, false);
+
+  Simulator::Stop (MilliSeconds (15));
+  Simulator::Run ();
+
+  LdcQueueDisc::Stats st = queue->GetStats ();
+  NS_TEST_EXPECT_MSG_EQ (st.forcedDrop, 0, "There should be no forced drops");
+  double prob = _ldc_drop_prob (10, 20, 1, m_rTarget, m_wQ, m_lExp);
+  NS_TEST_EXPECT_MSG_EQ_TOL (st.unforcedDrop / (double) burst, prob, 0.02,
+                             "The fraction of unforced drops does not match the drop probability");
+
+  uint32_t drops = st.unforcedDrop;
+  Simulator::Stop (MilliSeconds (10));
+  Simulator::Run ();
+
+  st = queue->GetStats ();
+  NS_TEST_EXPECT_MSG_EQ (st.unforcedDrop - drops, 100, "Every packet should have been dropped");
+  Simulator::Destroy ();
+}
+
+
+/**
+ * Check that the lazy timeout gives exactly the same drops as the periodic
+ * timeout, for a traffic pattern including bursts and idle periods, and that
+ * it leaves no event in the scheduler.
+ */
+class LdcQueueDiscLazyTimeoutTestCase : public TestCase
+{
+public:
+  LdcQueueDiscLazyTimeoutTestCase ();
+  virtual void DoRun (void);
+private:
+  /**
+   * Run the traffic pattern
+   * \param lazy whether to use the lazy timeout
+   * \return the queue disc statistics
+   */
+  LdcQueueDisc::Stats RunTraffic (bool lazy);
+};
+
+LdcQueueDiscLazyTimeoutTestCase::LdcQueueDiscLazyTimeoutTestCase ()
+  : TestCase ("Check that the lazy ldc timeout matches the periodic one")
+{
+}
+
+LdcQueueDisc::Stats
+LdcQueueDiscLazyTimeoutTestCase::RunTraffic (bool lazy)
+{
+  Ptr<LdcQueueDisc> queue = CreateObject<LdcQueueDisc> ();
+  queue->SetAttribute ("QueueLimit", UintegerValue (100));
+  queue->SetAttribute ("TargetQueueingDelay", StringValue ("50ms"));
+  queue->SetAttribute ("LazyTimeout", BooleanValue (lazy));
+  queue->AssignStreams (1);
+  queue->Initialize ();
+
+  // Times are odd numbers of nanoseconds, so that no event is simultaneous
+  // with the expiration of a (2 ms) control interval
+  for (uint32_t k = 0; k < 3000; k++)
+    {
+      Time t = NanoSeconds (1 + k * 370000);
+      if (t > Seconds (0.4) && t < Seconds (0.8))
+        {
+          continue;
+        }
+      Simulator::Schedule (t, &EnqueuePackets, queue, 500, 1 + k % 3, false);
+    }
+  for (uint32_t k = 0; k < 2000; k++)
+    {
+      Simulator::Schedule (NanoSeconds (3 + k * 500000), &DequeuePackets, queue, 1);
+    }
+
+  // In lazy mode, the simulation ends by itself after the last packet event
+  if (!lazy)
+    {
+      Simulator::Stop (Seconds (1.2));
+    }
+  Simulator::Run ();
+
+  if (lazy)
+    {
+      NS_TEST_EXPECT_MSG_LT (Simulator::Now (), Seconds (1.2), "No event should be left after the last packet event");
+    }
+
+  LdcQueueDisc::Stats st = queue->GetStats ();
+  Simulator::Destroy ();
+  return st;
+}
+
+void
+LdcQueueDiscLazyTimeoutTestCase::DoRun (void)
+{
+  LdcQueueDisc::Stats periodic = RunTraffic (false);
+  LdcQueueDisc::Stats lazy = RunTraffic (true);
+
+  NS_TEST_EXPECT_MSG_NE (periodic.unforcedDrop, 0, "There should be some unforced drops");
+  NS_TEST_EXPECT_MSG_EQ (lazy.unforcedDrop, periodic.unforcedDrop, "Unforced drops do not match");
+  NS_TEST_EXPECT_MSG_EQ (lazy.forcedDrop, periodic.forcedDrop, "Forced drops do not match");
+  NS_TEST_EXPECT_MSG_EQ (lazy.qLimDrop, periodic.qLimDrop, "Drops due to queue full do not match");
+}
+
+/**
+ * Check that, in ECN mode, early drops are replaced by marks for ECN capable
+ * packets, in the same scenario as the drop probability test. Packets that
+ * are not ECN capable are still dropped.
+ */
+class LdcQueueDiscEcnTestCase : public TestCase
+{
+public:
+  LdcQueueDiscEcnTestCase ();
+  virtual void DoRun (void);
+};
+
+LdcQueueDiscEcnTestCase::LdcQueueDiscEcnTestCase ()
+  : TestCase ("Check that ldc marks ECN capable packets instead of dropping them")
+{
+}
+
+void
+LdcQueueDiscEcnTestCase::DoRun (void)
+{
+  uint32_t pktSize = 1000;
+  uint32_t burst = 10000;
+
+  Ptr<LdcQueueDisc> queue = CreateObject<LdcQueueDisc> ();
+  queue->SetAttribute ("QueueLimit", UintegerValue (2 * burst));
+  queue->SetAttribute ("MeanPktSize", UintegerValue (pktSize));
+  queue->SetAttribute ("LinkBandwidth", StringValue ("8Mbps"));
+  queue->SetAttribute ("TimeInterval", StringValue ("10ms"));
+  queue->SetAttribute ("TargetQueueingDelay", StringValue ("20ms"));
+  queue->SetAttribute ("QW", DoubleValue (0.5));
+  queue->SetAttribute ("RW", DoubleValue (0.5));
+  queue->SetAttribute ("WQ", DoubleValue (0.5));
+  queue->SetAttribute ("TargetLoadFactorRatio", DoubleValue (1.0));
+  queue->SetAttribute ("LdcExponent", UintegerValue (2));
+  queue->SetAttribute ("UseEcn", BooleanValue (true));
+  queue->AssignStreams (1);
+  queue->Initialize ();
+
+  Simulator::Schedule (MilliSeconds (1), &EnqueuePackets, queue, pktSize, 20, true);
+  Simulator::Schedule (MilliSeconds (11), &EnqueuePackets, queue, pktSize, burst, true);
+  Simulator::Schedule (MilliSeconds (21), &EnqueuePackets, queue, pktSize, 100, false);
+
+  Simulator::Stop (MilliSeconds (15));
+  Simulator::Run ();
+
+  LdcQueueDisc::Stats st = queue->GetStats ();
+  NS_TEST_EXPECT_MSG_EQ (st.unforcedDrop, 0, "ECN capable packets should not be dropped early");
+  double prob = _ldc_drop_prob (10, 20, 1, 1.0, 0.5, 2);
+  NS_TEST_EXPECT_MSG_EQ_TOL (st.unforcedMark / (double) burst, prob, 0.02,
+                             "The fraction of marks does not match the drop probability");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetNPackets (), 20 + burst, "Marked packets should have been enqueued");
+
+  Simulator::Stop (MilliSeconds (10));
+  Simulator::Run ();
+
+  st = queue->GetStats ();
+  NS_TEST_EXPECT_MSG_EQ (st.unforcedDrop, 100, "Packets that are not ECN capable should be dropped");
+  Simulator::Destroy ();
+}
+
+class LdcQueueDiscSojournTestCase : public TestCase
+{
+public:
+  LdcQueueDiscSojournTestCase ();
+  virtual void DoRun (void);
+private:
+  /**
+   * Run a queue drained ten times faster than its LinkBandwidth attribute
+   * \param useSojourn whether to enable UseSojournTime
+   * \returns the number of arrivals dropped early
+   */
+  uint32_t RunTraffic (bool useSojourn);
+};
+
+LdcQueueDiscSojournTestCase::LdcQueueDiscSojournTestCase ()
+  : TestCase ("Check that the sojourn time based ldc follows the actual departure rate")
+{
+}
+
+uint32_t
+LdcQueueDiscSojournTestCase::RunTraffic (bool useSojourn)
+{
+  uint32_t pktSize = 1000;
+
+  Ptr<LdcQueueDisc> queue = CreateObject<LdcQueueDisc> ();
+  queue->SetAttribute ("QueueLimit", UintegerValue (1000));
+  queue->SetAttribute ("MeanPktSize", UintegerValue (pktSize));
+  queue->SetAttribute ("LinkBandwidth", StringValue ("0.8Mbps"));
+  queue->SetAttribute ("TimeInterval", StringValue ("10ms"));
+  queue->SetAttribute ("TargetQueueingDelay", StringValue ("100ms"));
+  queue->SetAttribute ("QW", DoubleValue (0.5));
+  queue->SetAttribute ("RW", DoubleValue (0.5));
+  queue->SetAttribute ("WQ", DoubleValue (0.5));
+  queue->SetAttribute ("TargetLoadFactorRatio", DoubleValue (2.0));
+  queue->SetAttribute ("LdcExponent", UintegerValue (2));
+  queue->SetAttribute ("UseSojournTime", BooleanValue (useSojourn));
+  queue->SetAttribute ("DequeueThreshold", UintegerValue (10 * pktSize));
+  queue->AssignStreams (1);
+  queue->Initialize ();
+
+  // a standing queue of 20 packets, then one arrival and one departure per
+  // millisecond, i.e., the link actually sends 8Mbps. None of the events
+  // coincides with the expiration of a control interval
+  Simulator::Schedule (MicroSeconds (100), &EnqueuePackets, queue, pktSize, 20, false);
+  for (uint32_t i = 0; i < 500; i++)
+    {
+      Simulator::Schedule (MicroSeconds (1000 * i + 300), &EnqueuePackets, queue, pktSize, 1, false);
+      Simulator::Schedule (MicroSeconds (1000 * i + 800), &DequeuePackets, queue, 1);
+    }
+
+  Simulator::Stop (MilliSeconds (500));
+  Simulator::Run ();
+  uint32_t drops = queue->GetStats ().unforcedDrop;
+  Simulator::Destroy ();
+  return drops;
+}
+
+void
+LdcQueueDiscSojournTestCase::DoRun (void)
+{
+  // with the configured bandwidth, the load factor is ten times the actual one,
+  // so that the load component alone drops half of the arrivals
+  uint32_t drops = RunTraffic (false);
+  NS_TEST_EXPECT_MSG_GT (drops, 200, "Half of the arrivals should be dropped with the configured bandwidth");
+
+  // with the measured departure rate the load factor is close to 1 and the
+  // sojourn time is a fraction of the target: p ~ 0.5 * (1/2)^2 + small
+  drops = RunTraffic (true);
+  NS_TEST_EXPECT_MSG_LT (drops, 100, "Few arrivals should be dropped with the measured departure rate");
+}
+
+class LdcQueueDiscDeviceRateTestCase : public TestCase
+{
+public:
+  /**
+   * Constructor
+   * \param changeRate whether to halve the data rate of the device before
+   *        the first control interval expires
+   */
+  LdcQueueDiscDeviceRateTestCase (bool changeRate);
+  virtual void DoRun (void);
+private:
+  bool m_changeRate; //!< whether the data rate of the device is changed
+};
+
+LdcQueueDiscDeviceRateTestCase::LdcQueueDiscDeviceRateTestCase (bool changeRate)
+  : TestCase ("Check that ldc takes the link bandwidth from the device and follows its changes"),
+    m_changeRate (changeRate)
+{
+}
+
+void
+LdcQueueDiscDeviceRateTestCase::DoRun (void)
+{
+  uint32_t pktSize = 1000;
+  uint32_t burst = 10000;
+
+  Ptr<SimpleNetDevice> device = CreateObject<SimpleNetDevice> ();
+  device->SetAttribute ("DataRate", StringValue ("8Mbps"));
+
+  // LinkBandwidth is not set
+  Ptr<LdcQueueDisc> queue = CreateObject<LdcQueueDisc> ();
+  queue->SetNetDevice (device);
+  queue->SetAttribute ("QueueLimit", UintegerValue (2 * burst));
+  queue->SetAttribute ("MeanPktSize", UintegerValue (pktSize));
+  queue->SetAttribute ("TimeInterval", StringValue ("10ms"));
+  queue->SetAttribute ("TargetQueueingDelay", StringValue ("20ms"));
+  queue->SetAttribute ("QW", DoubleValue (0.5));
+  queue->SetAttribute ("RW", DoubleValue (0.5));
+  queue->SetAttribute ("WQ", DoubleValue (0.5));
+  queue->SetAttribute ("TargetLoadFactorRatio", DoubleValue (4.0));
+  queue->SetAttribute ("LdcExponent", UintegerValue (2));
+  queue->AssignStreams (1);
+  queue->Initialize ();
+
+  Simulator::Schedule (MilliSeconds (1), &EnqueuePackets, queue, pktSize, 20, false);
+  if (m_changeRate)
+    {
+      Simulator::Schedule (MilliSeconds (5), &SimpleNetDevice::SetDataRate, device, DataRate ("4Mbps"));
+    }
+  Simulator::Schedule (MilliSeconds (11), &EnqueuePackets, queue, pktSize, burst, false);
+
+  Simulator::Stop (MilliSeconds (15));
+  Simulator::Run ();
+
+  // 8Mbps: 10 packets per interval and a target queue of 20 packets;
+  // 4Mbps: 5 packets per interval and a target queue of 10 packets
+  double prob = m_changeRate ? _ldc_drop_prob (10, 10, 2, 4.0, 0.5, 2) : _ldc_drop_prob (10, 20, 1, 4.0, 0.5, 2);
+  LdcQueueDisc::Stats st = queue->GetStats ();
+  NS_TEST_EXPECT_MSG_EQ_TOL (st.unforcedDrop / (double) burst, prob, 0.02,
+                             "The fraction of unforced drops does not match the drop probability");
+  Simulator::Destroy ();
+}
+
+class LdcQueueDiscByteModeTestCase : public TestCase
+{
+public:
+  LdcQueueDiscByteModeTestCase ();
+  virtual void DoRun (void);
+};
+
+LdcQueueDiscByteModeTestCase::LdcQueueDiscByteModeTestCase ()
+  : TestCase ("Check that ldc counts the load in bytes in byte mode")
+{
+}
+
+void
+LdcQueueDiscByteModeTestCase::DoRun (void)
+{
+  uint32_t burst = 10000;
+
+  // MeanPktSize does not match any of the packet sizes
+  Ptr<LdcQueueDisc> queue = CreateObject<LdcQueueDisc> ();
+  queue->SetAttribute ("Mode", StringValue ("QUEUE_MODE_BYTES"));
+  queue->SetAttribute ("QueueLimit", UintegerValue (2 * 64 * burst));
+  queue->SetAttribute ("MeanPktSize", UintegerValue (500));
+  queue->SetAttribute ("LinkBandwidth", StringValue ("8Mbps"));
+  queue->SetAttribute ("TimeInterval", StringValue ("10ms"));
+  queue->SetAttribute ("TargetQueueingDelay", StringValue ("20ms"));
+  queue->SetAttribute ("QW", DoubleValue (0.5));
+  queue->SetAttribute ("RW", DoubleValue (0.5));
+  queue->SetAttribute ("WQ", DoubleValue (0.5));
+  queue->SetAttribute ("TargetLoadFactorRatio", DoubleValue (1.0));
+  queue->SetAttribute ("LdcExponent", UintegerValue (2));
+  queue->AssignStreams (1);
+  queue->Initialize ();
+
+  // 15640 bytes arrive in the first interval, which can carry 10000 bytes
+  Simulator::Schedule (MilliSeconds (1), &EnqueuePackets, queue, 1500, 10, false);
+  Simulator::Schedule (MilliSeconds (1), &EnqueuePackets, queue, 64, 10, false);
+  Simulator::Schedule (MilliSeconds (11), &EnqueuePackets, queue, 64, burst, false);
+
+  Simulator::Stop (MilliSeconds (15));
+  Simulator::Run ();
+
+  // average arrivals and queue size: 7820 bytes; target queue: 20000 bytes
+  double prob = _ldc_drop_prob (7820, 20000, 0.782, 1.0, 0.5, 2);
+  LdcQueueDisc::Stats st = queue->GetStats ();
+  NS_TEST_EXPECT_MSG_EQ (st.forcedDrop, 0, "There should be no forced drops");
+  NS_TEST_EXPECT_MSG_EQ_TOL (st.unforcedDrop / (double) burst, prob, 0.02,
+                             "The fraction of unforced drops does not match the drop probability");
+  Simulator::Destroy ();
+}
+
+class LdcQueueDiscTraceTestCase : public TestCase
+{
+public:
+  LdcQueueDiscTraceTestCase ();
+  virtual void DoRun (void);
+private:
+  /**
+   * Store the new value of a trace source
+   * \param value where to store the value
+   * \param oldValue the old value
+   * \param newValue the new value
+   */
+  static void Store (double *value, double oldValue, double newValue);
+};
+
+LdcQueueDiscTraceTestCase::LdcQueueDiscTraceTestCase ()
+  : TestCase ("Check the ldc trace sources")
+{
+}
+
+void
+LdcQueueDiscTraceTestCase::Store (double *value, double oldValue, double newValue)
+{
+  *value = newValue;
+}
+
+void
+LdcQueueDiscTraceTestCase::DoRun (void)
+{
+  Ptr<LdcQueueDisc> queue = CreateObject<LdcQueueDisc> ();
+  queue->SetAttribute ("QueueLimit", UintegerValue (100));
+  queue->SetAttribute ("MeanPktSize", UintegerValue (1000));
+  queue->SetAttribute ("LinkBandwidth", StringValue ("8Mbps"));
+  queue->SetAttribute ("TimeInterval", StringValue ("10ms"));
+  queue->SetAttribute ("TargetQueueingDelay", StringValue ("20ms"));
+  queue->SetAttribute ("QW", DoubleValue (0.5));
+  queue->SetAttribute ("RW", DoubleValue (0.5));
+  queue->SetAttribute ("WQ", DoubleValue (0.5));
+  queue->SetAttribute ("TargetLoadFactorRatio", DoubleValue (2.0));
+  queue->SetAttribute ("LdcExponent", UintegerValue (2));
+  queue->Initialize ();
+
+  double prob = -1;
+  double qAvg = -1;
+  double ratio = -1;
+  queue->TraceConnectWithoutContext ("DropProbability", MakeBoundCallback (&LdcQueueDiscTraceTestCase::Store, &prob));
+  queue->TraceConnectWithoutContext ("AverageQueueSize", MakeBoundCallback (&LdcQueueDiscTraceTestCase::Store, &qAvg));
+  queue->TraceConnectWithoutContext ("LoadFactor", MakeBoundCallback (&LdcQueueDiscTraceTestCase::Store, &ratio));
+
+  Simulator::Schedule (MilliSeconds (1), &EnqueuePackets, queue, 1000, 20, false);
+  Simulator::Stop (MilliSeconds (15));
+  Simulator::Run ();
+
+  NS_TEST_EXPECT_MSG_EQ_TOL (qAvg, 10, 1e-9, "Wrong traced average queue size");
+  NS_TEST_EXPECT_MSG_EQ_TOL (ratio, 1, 1e-9, "Wrong traced load factor");
+  NS_TEST_EXPECT_MSG_EQ_TOL (prob, _ldc_drop_prob (10, 20, 1, 2.0, 0.5, 2), 1e-9, "Wrong traced drop probability");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetAverageQueueSize (), qAvg, "The accessor does not match the trace");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetLoadFactor (), ratio, "The accessor does not match the trace");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetDropProbability (), prob, "The accessor does not match the trace");
+  Simulator::Destroy ();
+}
+
+class LdcQueueDiscAdaptiveTestCase : public TestCase
+{
+public:
+  LdcQueueDiscAdaptiveTestCase ();
+  virtual void DoRun (void);
+private:
+  /**
+   * Run a constant bit rate source that sends 20% more than the link bandwidth
+   * \param bandwidth the link bandwidth
+   * \param adaptive whether to enable Adaptive
+   * \returns the average queueing delay in the last 5 seconds, in seconds
+   */
+  double RunTraffic (std::string bandwidth, bool adaptive);
+  /**
+   * Enqueue a packet and schedule the next arrival
+   * \param queue the queue disc under test
+   * \param gap the time between two arrivals
+   */
+  void Arrive (Ptr<LdcQueueDisc> queue, Time gap);
+  /**
+   * Dequeue a packet, sample the queueing delay and schedule the next departure
+   * \param queue the queue disc under test
+   * \param txTime the transmission time of a packet
+   */
+  void Depart (Ptr<LdcQueueDisc> queue, Time txTime);
+
+  double m_delaySum;    //!< Sum of the sampled queueing delays
+  uint32_t m_nSamples;  //!< Number of sampled queueing delays
+};
+
+LdcQueueDiscAdaptiveTestCase::LdcQueueDiscAdaptiveTestCase ()
+  : TestCase ("Check that the adaptive ldc holds the target delay at different bandwidths")
+{
+}
+
+void
+LdcQueueDiscAdaptiveTestCase::Arrive (Ptr<LdcQueueDisc> queue, Time gap)
+{
+  EnqueuePackets (queue, 1000, 1, false);
+  Simulator::Schedule (gap, &LdcQueueDiscAdaptiveTestCase::Arrive, this, queue, gap);
+}
+
+void
+LdcQueueDiscAdaptiveTestCase::Depart (Ptr<LdcQueueDisc> queue, Time txTime)
+{
+  queue->Dequeue ();
+  if (Simulator::Now () > Seconds (15))
+    {
+      m_delaySum += queue->GetQueueSize () * txTime.GetSeconds ();
+      m_nSamples++;
+    }
+  Simulator::Schedule (txTime, &LdcQueueDiscAdaptiveTestCase::Depart, this, queue, txTime);
+}
+
+double
+LdcQueueDiscAdaptiveTestCase::RunTraffic (std::string bandwidth, bool adaptive)
+{
+  m_delaySum = 0;
+  m_nSamples = 0;
+
+  Ptr<LdcQueueDisc> queue = CreateObject<LdcQueueDisc> ();
+  queue->SetAttribute ("QueueLimit", UintegerValue (100000));
+  queue->SetAttribute ("MeanPktSize", UintegerValue (1000));
+  queue->SetAttribute ("LinkBandwidth", StringValue (bandwidth));
+  queue->SetAttribute ("TargetQueueingDelay", StringValue ("20ms"));
+  queue->SetAttribute ("Adaptive", BooleanValue (adaptive));
+  queue->SetAttribute ("LazyTimeout", BooleanValue (true));
+  queue->AssignStreams (1);
+  queue->Initialize ();
+
+  Time txTime = DataRate (bandwidth).CalculateBytesTxTime (1000);
+  Simulator::Schedule (MicroSeconds (10), &LdcQueueDiscAdaptiveTestCase::Arrive, this, queue,
+                       TimeStep (txTime.GetTimeStep () * 5 / 6));
+  Simulator::Schedule (MicroSeconds (20), &LdcQueueDiscAdaptiveTestCase::Depart, this, queue, txTime);
+
+  Simulator::Stop (Seconds (20));
+  Simulator::Run ();
+
+  // the adaptation does not change the attribute set by the user
+  DoubleValue wQ;
+  queue->GetAttribute ("WQ", wQ);
+  NS_TEST_EXPECT_MSG_EQ (wQ.Get (), 0.75, "The WQ attribute should keep its value");
+  if (adaptive)
+    {
+      NS_TEST_EXPECT_MSG_NE (queue->GetCurrentWq (), 0.75, "WQ should have been adapted");
+    }
+
+  Simulator::Destroy ();
+  return m_delaySum / m_nSamples;
+}
+
+void
+LdcQueueDiscAdaptiveTestCase::DoRun (void)
+{
+  // With the default weights, the load component alone drops at least 25%
+  // of the arrivals, more than the 1/6 excess, and the queue stays empty
+  double delay = RunTraffic ("8Mbps", false);
+  NS_TEST_EXPECT_MSG_LT (delay, 0.005, "The queue should be drained by the load component");
+
+  // The adaptive ldc moves the weight to the delay component and tunes the
+  // effective target until the delay is close to the target, whatever the bandwidth
+  delay = RunTraffic ("8Mbps", true);
+  NS_TEST_EXPECT_MSG_EQ_TOL (delay, 0.020, 0.005, "The delay should be close to the target at 8Mbps");
+  delay = RunTraffic ("80Mbps", true);
+  NS_TEST_EXPECT_MSG_EQ_TOL (delay, 0.020, 0.005, "The delay should be close to the target at 80Mbps");
+}
+
+class LdcQueueDiscRingBufferTestCase : public TestCase
+{
+public:
+  LdcQueueDiscRingBufferTestCase ();
+  virtual void DoRun (void);
+private:
+  /**
+   * Run an overloaded queue and record the order of the departures
+   * \param mode the queue mode
+   * \param useRingBuffer whether to enable UseRingBuffer
+   * \param uids where to store the uids of the dequeued packets
+   * \returns the LDC statistics
+   */
+  LdcQueueDisc::Stats RunTraffic (Queue::QueueMode mode, bool useRingBuffer, std::vector<uint64_t> &uids);
+};
+
+LdcQueueDiscRingBufferTestCase::LdcQueueDiscRingBufferTestCase ()
+  : TestCase ("Check that ldc behaves the same with a ring buffer internal queue")
+{
+}
+
+LdcQueueDisc::Stats
+LdcQueueDiscRingBufferTestCase::RunTraffic (Queue::QueueMode mode, bool useRingBuffer, std::vector<uint64_t> &uids)
+{
+  uint32_t pktSize = 1000;
+  uint32_t limit = (mode == Queue::QUEUE_MODE_PACKETS) ? 50 : 50 * pktSize;
+
+  Ptr<LdcQueueDisc> queue = CreateObject<LdcQueueDisc> ();
+  queue->SetAttribute ("Mode", EnumValue (mode));
+  queue->SetAttribute ("QueueLimit", UintegerValue (limit));
+  queue->SetAttribute ("MeanPktSize", UintegerValue (pktSize));
+  queue->SetAttribute ("LinkBandwidth", StringValue ("8Mbps"));
+  queue->SetAttribute ("TimeInterval", StringValue ("10ms"));
+  queue->SetAttribute ("TargetQueueingDelay", StringValue ("1s"));
+  queue->SetAttribute ("TargetLoadFactorRatio", DoubleValue (4.0));
+  queue->SetAttribute ("QW", DoubleValue (0.5));
+  queue->SetAttribute ("UseRingBuffer", BooleanValue (useRingBuffer));
+  queue->AssignStreams (1);
+  queue->Initialize ();
+
+  // two arrivals per departure, with bursts: both the early drops and the
+  // queue limit drop packets
+  for (uint32_t i = 0; i < 1000; i++)
+    {
+      Simulator::Schedule (MicroSeconds (500 * i + 100), &EnqueuePackets, queue, pktSize, (i % 50 == 0) ? 40 : 1, false);
+      if (i % 2 == 0)
+        {
+          Simulator::Schedule (MicroSeconds (500 * i + 300), &DequeuePackets, queue, 1);
+        }
+    }
+
+  Simulator::Stop (MilliSeconds (500));
+  Simulator::Run ();
+  while (queue->GetQueueSize () > 0)
+    {
+      uids.push_back (queue->Dequeue ()->GetPacket ()->GetUid ());
+    }
+  LdcQueueDisc::Stats st = queue->GetStats ();
+  Simulator::Destroy ();
+  return st;
+}
+
+void
+LdcQueueDiscRingBufferTestCase::DoRun (void)
+{
+  Queue::QueueMode modes[] = { Queue::QUEUE_MODE_PACKETS, Queue::QUEUE_MODE_BYTES };
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      std::vector<uint64_t> dropTailUids;
+      std::vector<uint64_t> ringUids;
+      LdcQueueDisc::Stats dropTail = RunTraffic (modes[i], false, dropTailUids);
+      LdcQueueDisc::Stats ring = RunTraffic (modes[i], true, ringUids);
+      NS_TEST_EXPECT_MSG_GT (dropTail.forcedDrop, 0, "The queue limit should be reached");
+      NS_TEST_EXPECT_MSG_GT (dropTail.unforcedDrop, 0, "Some packets should be dropped early");
+      NS_TEST_EXPECT_MSG_EQ (ring.forcedDrop, dropTail.forcedDrop, "Different number of forced drops");
+      NS_TEST_EXPECT_MSG_EQ (ring.unforcedDrop, dropTail.unforcedDrop, "Different number of unforced drops");
+      NS_TEST_EXPECT_MSG_EQ (ringUids.size (), dropTailUids.size (), "Different number of queued packets");
+      for (uint32_t j = 0; j < ringUids.size () && j < dropTailUids.size (); j++)
+        {
+          NS_TEST_EXPECT_MSG_EQ (ringUids[j] - ringUids[0], dropTailUids[j] - dropTailUids[0], "Different order of the packets");
+        }
+    }
+}
+
+class LdcQueueDiscIdleBurstTestCase : public TestCase
+{
+public:
+  LdcQueueDiscIdleBurstTestCase ();
+  virtual void DoRun (void);
+private:
+  /**
+   * Congest the queue, let it idle and send a burst
+   * \param idleReset whether to enable IdleReset
+   * \param maxBurst the MaxBurstAllowance
+   * \param idle the duration of the idle period
+   * \param burst the number of packets of the burst
+   * \returns the number of packets of the burst dropped early
+   */
+  uint32_t RunTraffic (bool idleReset, Time maxBurst, Time idle, uint32_t burst);
+};
+
+LdcQueueDiscIdleBurstTestCase::LdcQueueDiscIdleBurstTestCase ()
+  : TestCase ("Check that ldc admits bursts after an idle period with IdleReset and MaxBurstAllowance")
+{
+}
+
+uint32_t
+LdcQueueDiscIdleBurstTestCase::RunTraffic (bool idleReset, Time maxBurst, Time idle, uint32_t burst)
+{
+  uint32_t pktSize = 1000;
+
+  Ptr<LdcQueueDisc> queue = CreateObject<LdcQueueDisc> ();
+  queue->SetAttribute ("QueueLimit", UintegerValue (200));
+  queue->SetAttribute ("MeanPktSize", UintegerValue (pktSize));
+  queue->SetAttribute ("LinkBandwidth", StringValue ("8Mbps"));
+  queue->SetAttribute ("TimeInterval", StringValue ("10ms"));
+  queue->SetAttribute ("TargetQueueingDelay", StringValue ("20ms"));
+  queue->SetAttribute ("QW", DoubleValue (0.01));
+  queue->SetAttribute ("WQ", DoubleValue (1.0));
+  queue->SetAttribute ("IdleReset", BooleanValue (idleReset));
+  queue->SetAttribute ("MaxBurstAllowance", TimeValue (maxBurst));
+  queue->AssignStreams (1);
+  queue->Initialize ();
+
+  // two arrivals per departure for a second, then the queue is drained
+  for (uint32_t i = 0; i < 1000; i++)
+    {
+      Simulator::Schedule (MicroSeconds (1000 * i + 100), &EnqueuePackets, queue, pktSize, 2, false);
+      Simulator::Schedule (MicroSeconds (1000 * i + 300), &DequeuePackets, queue, 1);
+    }
+  Simulator::Schedule (MilliSeconds (1000), &DequeuePackets, queue, 200);
+
+  Time burstTime = MilliSeconds (1000) + idle;
+  Simulator::Stop (burstTime);
+  Simulator::Run ();
+  uint32_t drops = queue->GetStats ().unforcedDrop;
+  NS_TEST_EXPECT_MSG_EQ (queue->GetQueueSize (), 0, "The queue should be idle");
+
+  Simulator::Schedule (MicroSeconds (50), &EnqueuePackets, queue, pktSize, burst, false);
+  Simulator::Stop (MilliSeconds (1));
+  Simulator::Run ();
+  drops = queue->GetStats ().unforcedDrop - drops;
+  Simulator::Destroy ();
+  return drops;
+}
+
+void
+LdcQueueDiscIdleBurstTestCase::DoRun (void)
+{
+  // the average queue size is still close to the target after 50ms of idle,
+  // hence a burst smaller than the target is dropped early
+  uint32_t drops = RunTraffic (false, Seconds (0), MilliSeconds (50), 15);
+  NS_TEST_EXPECT_MSG_GT (drops, 0, "The stale drop probability should drop part of the burst");
+
+  // the link drains 50 packets in 50ms, more than the target of 20 packets
+  drops = RunTraffic (true, Seconds (0), MilliSeconds (50), 15);
+  NS_TEST_EXPECT_MSG_EQ (drops, 0, "The congestion state should be restarted after the idle period");
+  drops = RunTraffic (false, MilliSeconds (100), MilliSeconds (50), 15);
+  NS_TEST_EXPECT_MSG_EQ (drops, 0, "The burst should be within the burst allowance");
+
+  // the burst allowance does not extend beyond the target queue size
+  drops = RunTraffic (false, MilliSeconds (100), MilliSeconds (50), 60);
+  NS_TEST_EXPECT_MSG_GT (drops, 0, "The packets beyond the target should be dropped early");
+
+  // 10ms of idle drain less than the target, the state is not restarted
+  drops = RunTraffic (true, MilliSeconds (100), MilliSeconds (10), 15);
+  NS_TEST_EXPECT_MSG_GT (drops, 0, "A short idle period should not restart the congestion state");
+}
+
+static class LdcQueueDiscTestSuite : public TestSuite
+{
+public:
+  LdcQueueDiscTestSuite ()
+    : TestSuite ("ldc-queue-disc", UNIT)
+  {
+    AddTestCase (new LdcQueueDiscBasicTestCase (), TestCase::QUICK);
+    AddTestCase (new LdcQueueDiscDropProbabilityTestCase (false, false, 0.5, 1.0, 2), TestCase::QUICK);
+    AddTestCase (new LdcQueueDiscDropProbabilityTestCase (false, false, 0.75, 2.0, 3), TestCase::QUICK);
+    AddTestCase (new LdcQueueDiscDropProbabilityTestCase (true, false, 0.5, 1.0, 2), TestCase::QUICK);
+    AddTestCase (new LdcQueueDiscDropProbabilityTestCase (false, true, 0.75, 2.0, 3), TestCase::QUICK);
+    AddTestCase (new LdcQueueDiscLazyTimeoutTestCase (), TestCase::QUICK);
+    AddTestCase (new LdcQueueDiscEcnTestCase (), TestCase::QUICK);
+    AddTestCase (new LdcQueueDiscSojournTestCase (), TestCase::QUICK);
+    AddTestCase (new LdcQueueDiscDeviceRateTestCase (false), TestCase::QUICK);
+    AddTestCase (new LdcQueueDiscDeviceRateTestCase (true), TestCase::QUICK);
+    AddTestCase (new LdcQueueDiscByteModeTestCase (), TestCase::QUICK);
+    AddTestCase (new LdcQueueDiscTraceTestCase (), TestCase::QUICK);
+    AddTestCase (new LdcQueueDiscAdaptiveTestCase (), TestCase::EXTENSIVE);
+    AddTestCase (new LdcQueueDiscRingBufferTestCase (), TestCase::QUICK);
+    AddTestCase (new LdcQueueDiscIdleBurstTestCase (), TestCase::QUICK);
+  }
+} g_ldcQueueTestSuite;
@@ -0,0 +1,229 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/test.h"
+#include "ns3/mq-queue-disc.h"
+#include "ns3/ldc-queue-disc.h"
+#include "ns3/traffic-control-layer.h"
+#include "ns3/traffic-control-helper.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/simple-channel.h"
+#include "ns3/error-model.h"
+#include "ns3/node.h"
+#include "ns3/boolean.h"
+#include "ns3/data-rate.h"
+#include "ns3/simulator.h"
+
+using namespace ns3;
+
+class MqQueueDiscTestItem : public QueueDiscItem {
+public:
+  MqQueueDiscTestItem (Ptr<Packet> p, const Address & addr, uint16_t protocol);
+  virtual ~MqQueueDiscTestItem ();
+  virtual void AddHeader (void);
+
+private:
+  MqQueueDiscTestItem ();
+  MqQueueDiscTestItem (const MqQueueDiscTestItem &);
+  MqQueueDiscTestItem &operator = (const MqQueueDiscTestItem &);
+};
+
+MqQueueDiscTestItem::MqQueueDiscTestItem (Ptr<Packet> p, const Address & addr, uint16_t protocol)
+  : QueueDiscItem (p, addr, protocol)
+{
+}
+
+MqQueueDiscTestItem::~MqQueueDiscTestItem ()
+{
+}
+
+void
+MqQueueDiscTestItem::AddHeader (void)
+{
+}
+
+/**
+ * A device with two transmission queues: packets larger than 150 bytes are
+ * sent through the second one
+ */
+class MqQueueDiscTestDevice : public SimpleNetDevice
+{
+public:
+  static TypeId GetTypeId (void);
+  MqQueueDiscTestDevice ();
+
+  virtual bool Send (Ptr<Packet> packet, const Address& dest, uint16_t protocolNumber);
+
+  /**
+   * Select the transmission queue of a packet
+   * \param item the packet
+   * \return the index of the transmission queue
+   */
+  uint8_t SelectQueue (Ptr<QueueItem> item);
+
+  std::vector<uint32_t> m_sizes;  //!< sizes of the sent packets
+
+protected:
+  virtual void NotifyNewAggregate (void);
+
+private:
+  bool m_queuesSet;  //!< whether the transmission queues have been set up
+};
+
+TypeId
+MqQueueDiscTestDevice::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::MqQueueDiscTestDevice")
+    .SetParent<SimpleNetDevice> ()
+    .SetGroupName ("TrafficControl")
+    .AddConstructor<MqQueueDiscTestDevice> ()
+  ;
+  return tid;
+}
+
+MqQueueDiscTestDevice::MqQueueDiscTestDevice ()
+  : m_queuesSet (false)
+{
+}
+
+bool
+MqQueueDiscTestDevice::Send (Ptr<Packet> packet, const Address& dest, uint16_t protocolNumber)
+{
+  m_sizes.push_back (packet->GetSize ());
+  return true;
+}
+
+uint8_t
+MqQueueDiscTestDevice::SelectQueue (Ptr<QueueItem> item)
+{
+  return item->GetPacket ()->GetSize () > 150 ? 1 : 0;
+}
+
+void
+MqQueueDiscTestDevice::NotifyNewAggregate (void)
+{
+  Ptr<NetDeviceQueueInterface> ndqi = GetObject<NetDeviceQueueInterface> ();
+  if (ndqi && !m_queuesSet)
+    {
+      ndqi->SetTxQueuesN (2);
+      ndqi->SetSelectQueueCallback (MakeCallback (&MqQueueDiscTestDevice::SelectQueue, this));
+      m_queuesSet = true;
+    }
+  SimpleNetDevice::NotifyNewAggregate ();
+}
+
+/**
+ * Check that mq creates an independent LDC instance per transmission queue
+ * and that a stopped transmission queue does not block the other one
+ */
+class MqQueueDiscTestCase : public TestCase
+{
+public:
+  MqQueueDiscTestCase ();
+  virtual void DoRun (void);
+private:
+  /**
+   * Send a packet through the traffic control layer
+   * \param tc the traffic control layer
+   * \param device the device
+   * \param size the size of the packet
+   */
+  void Send (Ptr<TrafficControlLayer> tc, Ptr<NetDevice> device, uint32_t size);
+};
+
+MqQueueDiscTestCase::MqQueueDiscTestCase ()
+  : TestCase ("Check that mq runs a child queue disc per transmission queue")
+{
+}
+
+void
+MqQueueDiscTestCase::Send (Ptr<TrafficControlLayer> tc, Ptr<NetDevice> device, uint32_t size)
+{
+  Address dest;
+  tc->Send (device, Create<MqQueueDiscTestItem> (Create<Packet> (size), dest, 0));
+}
+
+void
+MqQueueDiscTestCase::DoRun (void)
+{
+  Ptr<Node> node = CreateObject<Node> ();
+  Ptr<TrafficControlLayer> tc = CreateObject<TrafficControlLayer> ();
+  node->AggregateObject (tc);
+  Ptr<MqQueueDiscTestDevice> device = CreateObject<MqQueueDiscTestDevice> ();
+  node->AddDevice (device);
+
+  TrafficControlHelper tch;
+  uint16_t handle = tch.SetRootQueueDisc ("ns3::MqQueueDisc");
+  TrafficControlHelper::ClassIdList cls = tch.AddQueueDiscClasses (handle, 2, "ns3::QueueDiscClass");
+  tch.AddChildQueueDiscs (handle, cls, "ns3::LdcQueueDisc",
+                          "LinkBandwidth", DataRateValue (DataRate ("10Mbps")),
+                          "LazyTimeout", BooleanValue (true));
+  QueueDiscContainer qdiscs = tch.Install (device);
+  tc->Initialize ();
+
+  Ptr<QueueDisc> root = tc->GetRootQueueDiscOnDevice (device);
+  NS_TEST_ASSERT_MSG_NE (DynamicCast<MqQueueDisc> (root), 0, "The root queue disc should be mq");
+  NS_TEST_EXPECT_MSG_EQ (root->GetWakeMode (), QueueDisc::WAKE_CHILD, "mq should wake the child queue discs");
+  NS_TEST_ASSERT_MSG_EQ (root->GetNQueueDiscClasses (), 2, "mq should have a class per transmission queue");
+  Ptr<QueueDisc> child0 = root->GetQueueDiscClass (0)->GetQueueDisc ();
+  Ptr<QueueDisc> child1 = root->GetQueueDiscClass (1)->GetQueueDisc ();
+  NS_TEST_EXPECT_MSG_NE (DynamicCast<LdcQueueDisc> (child0), 0, "The child queue discs should be LDC");
+  NS_TEST_EXPECT_MSG_NE (DynamicCast<LdcQueueDisc> (child1), 0, "The child queue discs should be LDC");
+  NS_TEST_EXPECT_MSG_NE (child0, child1, "Each transmission queue should have its own queue disc");
+
+  // with the first transmission queue stopped, its packets wait in the first
+  // child while those of the second queue are sent
+  Ptr<NetDeviceQueueInterface> ndqi = device->GetObject<NetDeviceQueueInterface> ();
+  ndqi->GetTxQueue (0)->Stop ();
+  for (uint32_t i = 0; i < 10; i++)
+    {
+      Send (tc, device, 100);
+      Send (tc, device, 200);
+    }
+  NS_TEST_EXPECT_MSG_EQ (device->m_sizes.size (), 10, "The packets of the second queue should be sent");
+  for (uint32_t i = 0; i < device->m_sizes.size (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (device->m_sizes[i], 200, "Only the packets of the second queue should be sent");
+    }
+  NS_TEST_EXPECT_MSG_EQ (child0->GetNPackets (), 10, "The packets of the stopped queue should be queued");
+  NS_TEST_EXPECT_MSG_EQ (child1->GetNPackets (), 0, "The second child should be empty");
+  NS_TEST_EXPECT_MSG_EQ (root->GetNPackets (), 0, "mq should not store packets");
+
+  // waking the first transmission queue restarts the first child only
+  ndqi->GetTxQueue (0)->Wake ();
+  NS_TEST_EXPECT_MSG_EQ (device->m_sizes.size (), 20, "The queued packets should be sent after the wake up");
+  NS_TEST_EXPECT_MSG_EQ (child0->GetNPackets (), 0, "The first child should be empty");
+  NS_TEST_EXPECT_MSG_EQ (child0->GetTotalReceivedPackets (), 10, "Each child should only see its packets");
+  NS_TEST_EXPECT_MSG_EQ (child1->GetTotalReceivedPackets (), 10, "Each child should only see its packets");
+
+  for (uint32_t i = 0; i < qdiscs.GetN (); i++)
+    {
+      qdiscs.Get (i)->Dispose ();
+    }
+  node->Dispose ();
+  Simulator::Destroy ();
+}
+
+static class MqQueueDiscTestSuite : public TestSuite
+{
+public:
+  MqQueueDiscTestSuite ()
+    : TestSuite ("mq-queue-disc", UNIT)
+  {
+    AddTestCase (new MqQueueDiscTestCase (), TestCase::QUICK);
+  }
+} g_mqQueueDiscTestSuite;
@@ -0,0 +1,343 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/test.h"
+#include "ns3/pfifo-fast-queue-disc.h"
+#include "ns3/ldc-queue-disc.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/simple-channel.h"
+#include "ns3/node.h"
+#include "ns3/error-model.h"
+#include "ns3/uinteger.h"
+#include "ns3/double.h"
+#include "ns3/boolean.h"
+#include "ns3/string.h"
+#include "ns3/simulator.h"
+#include <limits>
+
+using namespace ns3;
+
+class QueueDiscBatchTestItem : public QueueDiscItem {
+public:
+  QueueDiscBatchTestItem (Ptr<Packet> p, const Address & addr, uint16_t protocol);
+  virtual ~QueueDiscBatchTestItem ();
+  virtual void AddHeader (void);
+
+private:
+  QueueDiscBatchTestItem ();
+  QueueDiscBatchTestItem (const QueueDiscBatchTestItem &);
+  QueueDiscBatchTestItem &operator = (const QueueDiscBatchTestItem &);
+};
+
+QueueDiscBatchTestItem::QueueDiscBatchTestItem (Ptr<Packet> p, const Address & addr, uint16_t protocol)
+  : QueueDiscItem (p, addr, protocol)
+{
+}
+
+QueueDiscBatchTestItem::~QueueDiscBatchTestItem ()
+{
+}
+
+void
+QueueDiscBatchTestItem::AddHeader (void)
+{
+}
+
+/**
+ * A device with a transmission queue of a few packets, which is drained
+ * at once a millisecond after it fills up
+ */
+class QueueDiscBatchTestDevice : public SimpleNetDevice
+{
+public:
+  static TypeId GetTypeId (void);
+  QueueDiscBatchTestDevice ();
+
+  virtual bool Send (Ptr<Packet> packet, const Address& dest, uint16_t protocolNumber);
+  virtual uint32_t SendBatch (const std::vector<TxItem> &items);
+
+  std::vector<uint64_t> m_uids;  //!< uids of the sent packets
+  uint32_t m_nBatches;           //!< number of calls to SendBatch
+  uint32_t m_capacity;           //!< number of packets that stop the transmission queue
+
+private:
+  /**
+   * Empty the transmission queue and wake it up
+   */
+  void Drain (void);
+
+  uint32_t m_nQueued;  //!< number of packets in the transmission queue
+};
+
+TypeId
+QueueDiscBatchTestDevice::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::QueueDiscBatchTestDevice")
+    .SetParent<SimpleNetDevice> ()
+    .SetGroupName ("TrafficControl")
+    .AddConstructor<QueueDiscBatchTestDevice> ()
+  ;
+  return tid;
+}
+
+QueueDiscBatchTestDevice::QueueDiscBatchTestDevice ()
+  : m_nBatches (0),
+    m_capacity (5),
+    m_nQueued (0)
+{
+}
+
+bool
+QueueDiscBatchTestDevice::Send (Ptr<Packet> packet, const Address& dest, uint16_t protocolNumber)
+{
+  Ptr<NetDeviceQueue> txq = GetObject<NetDeviceQueueInterface> ()->GetTxQueue (0);
+  NS_ASSERT_MSG (!txq->IsStopped (), "Send should not be called when the device is stopped");
+
+  m_uids.push_back (packet->GetUid ());
+  if (++m_nQueued == m_capacity)
+    {
+      txq->Stop ();
+      Simulator::Schedule (MilliSeconds (1), &QueueDiscBatchTestDevice::Drain, this);
+    }
+  return true;
+}
+
+uint32_t
+QueueDiscBatchTestDevice::SendBatch (const std::vector<TxItem> &items)
+{
+  m_nBatches++;
+  return NetDevice::SendBatch (items);
+}
+
+void
+QueueDiscBatchTestDevice::Drain (void)
+{
+  m_nQueued = 0;
+  GetObject<NetDeviceQueueInterface> ()->GetTxQueue (0)->Wake ();
+}
+
+class QueueDiscBatchTestCase : public TestCase
+{
+public:
+  QueueDiscBatchTestCase ();
+  virtual void DoRun (void);
+private:
+  /**
+   * Send packets through a queue disc and a flow controlled device
+   * \param batchSize the BatchSize of the queue disc
+   * \param device the device
+   * \return the queue disc
+   */
+  Ptr<QueueDisc> RunTraffic (uint32_t batchSize, Ptr<QueueDiscBatchTestDevice> device);
+};
+
+QueueDiscBatchTestCase::QueueDiscBatchTestCase ()
+  : TestCase ("Check that the batched dequeue sends all the packets in order")
+{
+}
+
+Ptr<QueueDisc>
+QueueDiscBatchTestCase::RunTraffic (uint32_t batchSize, Ptr<QueueDiscBatchTestDevice> device)
+{
+  Ptr<NetDeviceQueueInterface> ndqi = CreateObject<NetDeviceQueueInterface> ();
+  device->AggregateObject (ndqi);
+  ndqi->CreateTxQueues ();
+
+  Ptr<QueueDisc> qdisc = CreateObject<PfifoFastQueueDisc> ();
+  qdisc->SetNetDevice (device);
+  qdisc->SetAttribute ("BatchSize", UintegerValue (batchSize));
+  qdisc->Initialize ();
+  ndqi->GetTxQueue (0)->SetWakeCallback (MakeCallback (&QueueDisc::Run, qdisc));
+
+  Address dest;
+  for (uint32_t i = 0; i < 50; i++)
+    {
+      qdisc->Enqueue (Create<QueueDiscBatchTestItem> (Create<Packet> (100), dest, 0));
+    }
+  qdisc->Run ();
+  Simulator::Run ();
+  Simulator::Destroy ();
+  return qdisc;
+}
+
+void
+QueueDiscBatchTestCase::DoRun (void)
+{
+  Ptr<QueueDiscBatchTestDevice> single = CreateObject<QueueDiscBatchTestDevice> ();
+  Ptr<QueueDisc> qdisc = RunTraffic (1, single);
+  NS_TEST_EXPECT_MSG_EQ (single->m_uids.size (), 50, "All the packets should be sent");
+  NS_TEST_EXPECT_MSG_EQ (single->m_nBatches, 0, "No batch should be passed to the device");
+  NS_TEST_EXPECT_MSG_EQ (qdisc->GetTotalRequeuedPackets (), 0, "No packet should be requeued");
+
+  // batches of 8 packets do not fit the device queue of 5 packets, hence
+  // the packets the device does not take are requeued
+  Ptr<QueueDiscBatchTestDevice> batch = CreateObject<QueueDiscBatchTestDevice> ();
+  qdisc = RunTraffic (8, batch);
+  NS_TEST_EXPECT_MSG_EQ (batch->m_uids.size (), 50, "All the packets should be sent");
+  NS_TEST_EXPECT_MSG_LT (batch->m_nBatches, 50, "The packets should be passed to the device in batches");
+  NS_TEST_EXPECT_MSG_GT (qdisc->GetTotalRequeuedPackets (), 0, "Some packets should be requeued");
+  NS_TEST_EXPECT_MSG_EQ (qdisc->GetNPackets (), 0, "The queue disc should be empty");
+  for (uint32_t i = 1; i < batch->m_uids.size (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (batch->m_uids[i], batch->m_uids[i - 1] + 1, "The packets should be sent in order");
+    }
+}
+
+/**
+ * Check that LdcQueueDisc::DoDequeueBatch extracts the same packets as
+ * repeated calls to Dequeue, both with lazy and with periodic updates of
+ * the drop probability
+ */
+class LdcDequeueBatchTestCase : public TestCase
+{
+public:
+  LdcDequeueBatchTestCase ();
+  virtual void DoRun (void);
+private:
+  /**
+   * Run an overloaded LDC queue disc
+   * \param lazy the LazyTimeout attribute
+   * \param batch true to dequeue with DequeueBatch, false with Dequeue
+   * \param uids where to store the uids of the dequeued packets
+   * \return the LDC statistics
+   */
+  LdcQueueDisc::Stats RunTraffic (bool lazy, bool batch, std::vector<uint64_t> &uids);
+  /**
+   * Enqueue packets
+   * \param qdisc the queue disc
+   * \param n the number of packets
+   */
+  static void Enqueue (Ptr<QueueDisc> qdisc, uint32_t n);
+  /**
+   * Dequeue packets, at once or one at a time
+   * \param qdisc the queue disc
+   * \param n the number of packets
+   * \param batch true to dequeue with DequeueBatch, false with Dequeue
+   * \param uids where to store the uids of the dequeued packets
+   */
+  static void Dequeue (Ptr<QueueDisc> qdisc, uint32_t n, bool batch, std::vector<uint64_t> *uids);
+};
+
+LdcDequeueBatchTestCase::LdcDequeueBatchTestCase ()
+  : TestCase ("Check that the batched dequeue of LDC extracts the same packets as single dequeues")
+{
+}
+
+void
+LdcDequeueBatchTestCase::Enqueue (Ptr<QueueDisc> qdisc, uint32_t n)
+{
+  Address dest;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      qdisc->Enqueue (Create<QueueDiscBatchTestItem> (Create<Packet> (1000), dest, 0));
+    }
+}
+
+void
+LdcDequeueBatchTestCase::Dequeue (Ptr<QueueDisc> qdisc, uint32_t n, bool batch, std::vector<uint64_t> *uids)
+{
+  std::vector<Ptr<QueueDiscItem> > items;
+  if (batch)
+    {
+      qdisc->DequeueBatch (items, n, std::numeric_limits<uint32_t>::max ());
+    }
+  else
+    {
+      for (uint32_t i = 0; i < n; i++)
+        {
+          Ptr<QueueDiscItem> item = qdisc->Dequeue ();
+          if (item == 0)
+            {
+              break;
+            }
+          items.push_back (item);
+        }
+    }
+  for (uint32_t i = 0; i < items.size (); i++)
+    {
+      uids->push_back (items[i]->GetPacket ()->GetUid ());
+    }
+}
+
+LdcQueueDisc::Stats
+LdcDequeueBatchTestCase::RunTraffic (bool lazy, bool batch, std::vector<uint64_t> &uids)
+{
+  Ptr<LdcQueueDisc> qdisc = CreateObject<LdcQueueDisc> ();
+  qdisc->SetAttribute ("QueueLimit", UintegerValue (50));
+  qdisc->SetAttribute ("MeanPktSize", UintegerValue (1000));
+  qdisc->SetAttribute ("LinkBandwidth", StringValue ("8Mbps"));
+  qdisc->SetAttribute ("TimeInterval", StringValue ("10ms"));
+  qdisc->SetAttribute ("TargetLoadFactorRatio", DoubleValue (2.0));
+  qdisc->SetAttribute ("LazyTimeout", BooleanValue (lazy));
+  qdisc->AssignStreams (1);
+  qdisc->Initialize ();
+
+  // five arrivals for each four departures, in batches of four
+  for (uint32_t i = 0; i < 200; i++)
+    {
+      Simulator::Schedule (MicroSeconds (4000 * i + 100), &LdcDequeueBatchTestCase::Enqueue, qdisc, 5);
+      Simulator::Schedule (MicroSeconds (4000 * i + 300), &LdcDequeueBatchTestCase::Dequeue, qdisc, 4, batch, &uids);
+    }
+  Simulator::Stop (Seconds (1));
+  Simulator::Run ();
+  Simulator::Destroy ();
+  return qdisc->GetStats ();
+}
+
+void
+LdcDequeueBatchTestCase::DoRun (void)
+{
+  bool lazy[] = { true, false };
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      std::vector<uint64_t> single;
+      std::vector<uint64_t> batch;
+      LdcQueueDisc::Stats singleStats = RunTraffic (lazy[i], false, single);
+      LdcQueueDisc::Stats batchStats = RunTraffic (lazy[i], true, batch);
+      NS_TEST_EXPECT_MSG_GT (singleStats.unforcedDrop + singleStats.qLimDrop, 0, "Some packets should be dropped");
+      NS_TEST_EXPECT_MSG_EQ (batchStats.unforcedDrop, singleStats.unforcedDrop, "Different number of early drops");
+      NS_TEST_EXPECT_MSG_EQ (batchStats.qLimDrop, singleStats.qLimDrop, "Different number of drops due to the queue limit");
+      NS_TEST_EXPECT_MSG_EQ (batch.size (), single.size (), "Different number of dequeued packets");
+      for (uint32_t j = 0; j < batch.size () && j < single.size (); j++)
+        {
+          NS_TEST_EXPECT_MSG_EQ (batch[j] - batch[0], single[j] - single[0], "Different packets dequeued");
+        }
+    }
+
+  // the batch stops once the extracted packets amount to the given bytes
+  Ptr<LdcQueueDisc> qdisc = CreateObject<LdcQueueDisc> ();
+  qdisc->SetAttribute ("LinkBandwidth", StringValue ("8Mbps"));
+  qdisc->Initialize ();
+  Enqueue (qdisc, 10);
+  std::vector<Ptr<QueueDiscItem> > items;
+  NS_TEST_EXPECT_MSG_EQ (qdisc->DequeueBatch (items, 8, 2500), 3, "Three packets should amount to 2500 bytes");
+  NS_TEST_EXPECT_MSG_EQ (qdisc->DequeueBatch (items, 2, 100000), 2, "Two packets should be extracted");
+  NS_TEST_EXPECT_MSG_EQ (items.size (), 5, "The extracted packets should be appended");
+  NS_TEST_EXPECT_MSG_EQ (qdisc->GetNPackets (), 5, "Five packets should be left");
+  Simulator::Destroy ();
+}
+
+static class QueueDiscBatchTestSuite : public TestSuite
+{
+public:
+  QueueDiscBatchTestSuite ()
+    : TestSuite ("queue-disc-batch", UNIT)
+  {
+    AddTestCase (new QueueDiscBatchTestCase (), TestCase::QUICK);
+    AddTestCase (new LdcDequeueBatchTestCase (), TestCase::QUICK);
+  }
+} g_queueDiscBatchTestSuite;
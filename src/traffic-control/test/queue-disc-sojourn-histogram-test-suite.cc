@@ -0,0 +1,219 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/test.h"
+#include "ns3/log-linear-histogram.h"
+#include "ns3/pfifo-fast-queue-disc.h"
+#include "ns3/uinteger.h"
+#include "ns3/simulator.h"
+#include <limits>
+
+using namespace ns3;
+
+class SojournHistogramTestItem : public QueueDiscItem {
+public:
+  SojournHistogramTestItem (Ptr<Packet> p, const Address & addr, uint16_t protocol);
+  virtual ~SojournHistogramTestItem ();
+  virtual void AddHeader (void);
+
+private:
+  SojournHistogramTestItem ();
+  SojournHistogramTestItem (const SojournHistogramTestItem &);
+  SojournHistogramTestItem &operator = (const SojournHistogramTestItem &);
+};
+
+SojournHistogramTestItem::SojournHistogramTestItem (Ptr<Packet> p, const Address & addr, uint16_t protocol)
+  : QueueDiscItem (p, addr, protocol)
+{
+}
+
+SojournHistogramTestItem::~SojournHistogramTestItem ()
+{
+}
+
+void
+SojournHistogramTestItem::AddHeader (void)
+{
+}
+
+/**
+ * Check the buckets, the percentiles, merge and reset of LogLinearHistogram
+ */
+class LogLinearHistogramTestCase : public TestCase
+{
+public:
+  LogLinearHistogramTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+LogLinearHistogramTestCase::LogLinearHistogramTestCase ()
+  : TestCase ("Check the buckets, the percentiles, merge and reset of a log-linear histogram")
+{
+}
+
+void
+LogLinearHistogramTestCase::DoRun (void)
+{
+  LogLinearHistogram h (3);
+
+  NS_TEST_EXPECT_MSG_EQ (h.GetNBuckets (), 61 * 4 + 8, "Unexpected number of buckets");
+
+  // the buckets cover all the values, without gaps or overlaps
+  NS_TEST_EXPECT_MSG_EQ (h.GetBucketLowerBound (0), 0, "The first bucket must start at 0");
+  for (uint32_t i = 0; i + 1 < h.GetNBuckets (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (h.GetBucketUpperBound (i) + 1, h.GetBucketLowerBound (i + 1),
+                             "Buckets " << i << " and " << i + 1 << " are not contiguous");
+    }
+  NS_TEST_EXPECT_MSG_EQ (h.GetBucketUpperBound (h.GetNBuckets () - 1), std::numeric_limits<uint64_t>::max (),
+                         "The last bucket must end at the largest value");
+
+  // values are recorded in the bucket whose bounds hold them
+  uint64_t values[] = {0, 7, 8, 9, 15, 16, 1000, 123456789, std::numeric_limits<uint64_t>::max ()};
+  uint32_t nValues = sizeof (values) / sizeof (values[0]);
+  for (uint32_t v = 0; v < nValues; v++)
+    {
+      h.Reset ();
+      h.Record (values[v]);
+      uint32_t found = 0;
+      for (uint32_t i = 0; i < h.GetNBuckets (); i++)
+        {
+          if (h.GetBucketCount (i))
+            {
+              found++;
+              NS_TEST_EXPECT_MSG_EQ ((h.GetBucketLowerBound (i) <= values[v] && values[v] <= h.GetBucketUpperBound (i)),
+                                     true, "Value " << values[v] << " recorded in the wrong bucket");
+            }
+        }
+      NS_TEST_EXPECT_MSG_EQ (found, 1, "Value " << values[v] << " not recorded in exactly one bucket");
+    }
+
+  // percentiles are within a 2^(1-precision) fraction of the exact ones
+  LogLinearHistogram a (7);
+  LogLinearHistogram b (7);
+  for (uint64_t v = 1; v <= 1000; v++)
+    {
+      (v % 2 ? a : b).Record (v);
+    }
+  a.Merge (b);
+  NS_TEST_EXPECT_MSG_EQ (a.GetCount (), 1000, "Unexpected number of values after merge");
+  NS_TEST_EXPECT_MSG_EQ (a.GetMin (), 1, "Unexpected minimum after merge");
+  NS_TEST_EXPECT_MSG_EQ (a.GetMax (), 1000, "Unexpected maximum after merge");
+  NS_TEST_EXPECT_MSG_EQ_TOL (a.GetMean (), 500.5, 1e-9, "Unexpected mean after merge");
+  NS_TEST_EXPECT_MSG_EQ (a.GetPercentile (0), 1, "The 0th percentile is the minimum");
+  NS_TEST_EXPECT_MSG_EQ (a.GetPercentile (100), 1000, "The 100th percentile is the maximum");
+  uint64_t p50 = a.GetPercentile (50);
+  NS_TEST_EXPECT_MSG_EQ ((p50 >= 500 && p50 <= 500 + 500 / 64), true, "Inaccurate median " << p50);
+  uint64_t p99 = a.GetPercentile (99);
+  NS_TEST_EXPECT_MSG_EQ ((p99 >= 990 && p99 <= 990 + 990 / 64), true, "Inaccurate 99th percentile " << p99);
+
+  // the mean is not truncated to an integer
+  LogLinearHistogram c (7);
+  c.Record (1);
+  c.Record (2);
+  c.Record (2);
+  NS_TEST_EXPECT_MSG_EQ_TOL (c.GetMean (), 5.0 / 3, 1e-12, "Unexpected non-integer mean");
+
+  a.Reset ();
+  NS_TEST_EXPECT_MSG_EQ (a.GetCount (), 0, "Values left after reset");
+  NS_TEST_EXPECT_MSG_EQ (a.GetMean (), 0, "Mean of an empty histogram must be 0");
+  NS_TEST_EXPECT_MSG_EQ (a.GetPercentile (50), 0, "Percentile of an empty histogram must be 0");
+  for (uint32_t i = 0; i < a.GetNBuckets (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (a.GetBucketCount (i), 0, "Bucket " << i << " not empty after reset");
+    }
+}
+
+/**
+ * Enqueue ten packets at once and dequeue one per millisecond, then check
+ * the sojourn times recorded by the queue disc
+ */
+class QueueDiscSojournHistogramTestCase : public TestCase
+{
+public:
+  QueueDiscSojournHistogramTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Dequeue a packet from a queue disc
+   * \param qdisc the queue disc
+   */
+  void Dequeue (Ptr<QueueDisc> qdisc);
+};
+
+QueueDiscSojournHistogramTestCase::QueueDiscSojournHistogramTestCase ()
+  : TestCase ("Check the sojourn time histogram of a queue disc")
+{
+}
+
+void
+QueueDiscSojournHistogramTestCase::Dequeue (Ptr<QueueDisc> qdisc)
+{
+  qdisc->Dequeue ();
+}
+
+void
+QueueDiscSojournHistogramTestCase::DoRun (void)
+{
+  Ptr<PfifoFastQueueDisc> qdisc = CreateObject<PfifoFastQueueDisc> ();
+  Ptr<PfifoFastQueueDisc> disabled = CreateObject<PfifoFastQueueDisc> ();
+  NS_TEST_EXPECT_MSG_EQ (qdisc->SetAttributeFailSafe ("SojournHistogramPrecision", UintegerValue (8)), true,
+                         "Verify that we can actually set the attribute SojournHistogramPrecision");
+  qdisc->Initialize ();
+  disabled->Initialize ();
+
+  Address dest;
+  for (uint32_t i = 0; i < 10; i++)
+    {
+      qdisc->Enqueue (Create<SojournHistogramTestItem> (Create<Packet> (100), dest, 0));
+      disabled->Enqueue (Create<SojournHistogramTestItem> (Create<Packet> (100), dest, 0));
+      Simulator::Schedule (MilliSeconds (i + 1), &QueueDiscSojournHistogramTestCase::Dequeue, this, qdisc);
+      Simulator::Schedule (MilliSeconds (i + 1), &QueueDiscSojournHistogramTestCase::Dequeue, this, disabled);
+    }
+  Simulator::Run ();
+
+  const LogLinearHistogram &h = qdisc->GetSojournHistogram ();
+  NS_TEST_EXPECT_MSG_EQ (h.GetCount (), 10, "Every dequeued packet must be recorded");
+  NS_TEST_EXPECT_MSG_EQ (h.GetMin (), 1000000, "The first packet waited 1 ms");
+  NS_TEST_EXPECT_MSG_EQ (h.GetMax (), 10000000, "The last packet waited 10 ms");
+  NS_TEST_EXPECT_MSG_EQ_TOL (h.GetMean (), 5500000, 1, "The mean sojourn time is 5.5 ms");
+  uint64_t p50 = h.GetPercentile (50);
+  NS_TEST_EXPECT_MSG_EQ ((p50 >= 5000000 && p50 <= 5000000 + 5000000 / 128), true,
+                         "Inaccurate median sojourn time " << p50);
+
+  NS_TEST_EXPECT_MSG_EQ (disabled->GetSojournHistogram ().GetCount (), 0,
+                         "Sojourn times must not be recorded when the histogram is disabled");
+
+  qdisc->ResetSojournHistogram ();
+  NS_TEST_EXPECT_MSG_EQ (qdisc->GetSojournHistogram ().GetCount (), 0, "Values left after reset");
+
+  Simulator::Destroy ();
+}
+
+static class QueueDiscSojournHistogramTestSuite : public TestSuite
+{
+public:
+  QueueDiscSojournHistogramTestSuite ()
+    : TestSuite ("queue-disc-sojourn-histogram", UNIT)
+  {
+    AddTestCase (new LogLinearHistogramTestCase (), TestCase::QUICK);
+    AddTestCase (new QueueDiscSojournHistogramTestCase (), TestCase::QUICK);
+  }
+} g_queueDiscSojournHistogramTestSuite;
@@ -0,0 +1,204 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Benchmark of the LDC queue disc.
+//
+// Synthetic items are pushed through LdcQueueDisc::Enqueue/Dequeue by a
+// single event that fires every tick and enqueues and dequeues a batch of
+// items, so that the queue disc sees a steady load while the simulation
+// time advances. The following are reported:
+//   - wall clock time per packet
+//   - memory allocations (operator new calls) per packet
+//   - events scheduled by the queue disc (other than the ticks themselves)
+
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <cstdlib>
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/traffic-control-module.h"
+
+using namespace ns3;
+
+static bool g_countAllocs = false;
+static uint64_t g_allocs = 0;
+
+// The global allocation functions are replaced to count the allocations.
+// They are not inlined, so that the compiler does not match the malloc and
+// free calls against new and delete expressions.
+void * operator new (std::size_t size) __attribute__ ((noinline));
+void operator delete (void *p) throw () __attribute__ ((noinline));
+
+void *
+operator new (std::size_t size)
+{
+  if (g_countAllocs)
+    {
+      g_allocs++;
+    }
+  void *p = std::malloc (size == 0 ? 1 : size);
+  if (p == 0)
+    {
+      throw std::bad_alloc ();
+    }
+  return p;
+}
+
+void
+operator delete (void *p) throw ()
+{
+  std::free (p);
+}
+
+class BenchItem : public QueueDiscItem {
+public:
+  BenchItem (Ptr<Packet> p, const Address & addr, uint16_t protocol)
+    : QueueDiscItem (p, addr, protocol)
+  {
+  }
+  virtual void AddHeader (void)
+  {
+  }
+};
+
+class Bench
+{
+public:
+  Bench (Ptr<LdcQueueDisc> queue, uint32_t pktSize, uint32_t batch, Time tick, uint64_t total)
+    : m_queue (queue),
+      m_pktSize (pktSize),
+      m_batch (batch),
+      m_tick (tick),
+      m_total (total),
+      m_count (0),
+      m_ticks (0)
+  {
+  }
+
+  void RunBench (void);
+private:
+  void Tick (void);
+
+  Ptr<LdcQueueDisc> m_queue;
+  uint32_t m_pktSize;
+  uint32_t m_batch;
+  Time m_tick;
+  uint64_t m_total;
+  uint64_t m_count;
+  uint64_t m_ticks;
+};
+
+void
+Bench::Tick (void)
+{
+  if (m_count >= m_total)
+    {
+      // the periodic timeout of the queue disc would keep the simulation running
+      Simulator::Stop ();
+      return;
+    }
+  m_ticks++;
+  Simulator::Schedule (m_tick, &Bench::Tick, this);
+
+  Address dest;
+  for (uint32_t i = 0; i < m_batch; i++)
+    {
+      m_queue->Enqueue (Create<BenchItem> (Create<Packet> (m_pktSize), dest, 0));
+    }
+  for (uint32_t i = 0; i < m_batch; i++)
+    {
+      m_queue->Dequeue ();
+    }
+  m_count += m_batch;
+}
+
+void
+Bench::RunBench (void)
+{
+  SystemWallClockMs time;
+
+  // Event uids are allocated sequentially, so the difference between the
+  // uids of two events tells how many events were scheduled in between
+  EventId first = Simulator::Schedule (Seconds (0), &Bench::Tick, this);
+
+  g_allocs = 0;
+  g_countAllocs = true;
+  time.Start ();
+  Simulator::Run ();
+  int64_t ms = time.End ();
+  g_countAllocs = false;
+
+  EventId last = Simulator::ScheduleNow (&Bench::Tick, this);
+  Simulator::Cancel (last);
+  uint64_t events = last.GetUid () - first.GetUid () - 1 - m_ticks;
+
+  std::cout << "packets:            " << m_count << std::endl
+            << "simulated time (s): " << Simulator::Now ().GetSeconds () << std::endl
+            << "wall clock (ms):    " << ms << std::endl
+            << "ns/packet:          " << ms * 1e6 / m_count << std::endl
+            << "allocs/packet:      " << (double) g_allocs / m_count << std::endl
+            << "ldc events:         " << events << std::endl
+            << "ldc events/s:       " << events / Simulator::Now ().GetSeconds () << std::endl;
+
+  LdcQueueDisc::Stats st = m_queue->GetStats ();
+  std::cout << "unforced drops:     " << st.unforcedDrop << std::endl
+            << "forced drops:       " << st.forcedDrop << std::endl;
+}
+
+
+int main (int argc, char *argv[])
+{
+  uint64_t total = 1000000;
+  uint32_t batch = 10;
+  uint32_t pktSize = 500;
+  std::string tick = "100us";
+  bool lazy = false;
+  bool fastPow = false;
+  bool fixedPoint = false;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark the LDC queue disc.\n"
+             "\n"
+             "Every tick, a batch of items is enqueued and the same number\n"
+             "of items is dequeued.");
+  cmd.AddValue ("total", "total number of packets to enqueue (default 1E6)", total);
+  cmd.AddValue ("batch", "number of packets enqueued per tick (default 10)", batch);
+  cmd.AddValue ("size",  "packet size in bytes (default 500)", pktSize);
+  cmd.AddValue ("tick",  "simulated time between two batches (default 100us)", tick);
+  cmd.AddValue ("lazy",  "use the lazy timeout of the queue disc", lazy);
+  cmd.AddValue ("fastPow", "avoid the calls to pow in the queue disc", fastPow);
+  cmd.AddValue ("fixedPoint", "run the control law of the queue disc in fixed point", fixedPoint);
+  cmd.Parse (argc, argv);
+
+  Ptr<LdcQueueDisc> queue = CreateObject<LdcQueueDisc> ();
+  queue->SetAttribute ("QueueLimit", UintegerValue (1000));
+  queue->SetAttribute ("LazyTimeout", BooleanValue (lazy));
+  queue->SetAttribute ("FastPow", BooleanValue (fastPow));
+  queue->SetAttribute ("FixedPoint", BooleanValue (fixedPoint));
+  queue->Initialize ();
+
+  std::cout << cmd.GetName () << ": lazy timeout " << (lazy ? "on" : "off")
+            << ", fast pow " << (fastPow ? "on" : "off")
+            << ", fixed point " << (fixedPoint ? "on" : "off") << std::endl;
+
+  Bench bench (queue, pktSize, batch, Time (tick), total);
+  bench.RunBench ();
+
+  Simulator::Destroy ();
+  return 0;
+}
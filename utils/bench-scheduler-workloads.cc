@@ -0,0 +1,449 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Benchmark of the schedulers with workloads modeled after ns-3 models.
+//
+// Each scheduler is driven directly, without the simulator, by the
+// following workloads, where pop is the number of event sources:
+//   - timers: periodic timers, such as LdcQueueDisc::Timeout (2 ms),
+//     with periods of 2 ms, 100 ms or 1 s and random phases;
+//   - poisson: sources with exponential inter-arrival times (mean 1 ms);
+//   - tcp-remove: TCP connections receiving acks with exponential
+//     inter-arrival times (mean 10 ms), each ack moving the retransmission
+//     timeout (200 ms) by removing the pending timer from the scheduler,
+//     as Simulator::Remove does;
+//   - tcp-cancel: the same connections, but the pending timer is left in
+//     the scheduler and skipped when it expires, as EventId::Cancel does.
+// Each workload processes the same number of events with every scheduler.
+// The random numbers are drawn before the measurements and the operations
+// are timed one by one, minus the cost of reading the clock. Each run
+// takes place in a child process, so that its peak resident set size is
+// not inflated by the previous runs. One CSV line is printed per run:
+//   - the mean time of Insert, RemoveNext and Remove, in ns, and their counts
+//   - the peak resident set size of the run, in kB
+//   - a checksum of the uids of the events returned by RemoveNext, which
+//     must be the same for every scheduler.
+//
+//     ./waf --run "bench-scheduler-workloads --pop=1000" > results.csv
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+#include "ns3/core-module.h"
+
+using namespace ns3;
+
+/**
+ * Read the monotonic clock.
+ * \returns The time in ns.
+ */
+static inline uint64_t
+GetNs (void)
+{
+  struct timespec ts;
+  clock_gettime (CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/**
+ * A scheduler whose operations are timed.
+ */
+class TimedScheduler
+{
+public:
+  /**
+   * Constructor.
+   * \param scheduler the scheduler
+   * \param overhead the cost of reading the clock, in ns
+   */
+  TimedScheduler (Ptr<Scheduler> scheduler, uint64_t overhead)
+    : m_scheduler (scheduler),
+      m_overhead (overhead),
+      m_uid (0),
+      m_checksum (0)
+  {
+    for (uint32_t i = 0; i < 3; i++)
+      {
+        m_n[i] = 0;
+        m_ns[i] = 0;
+      }
+  }
+
+  /**
+   * Insert an event.
+   * \param ts the time of the event, in ns
+   * \param context the context of the event, which identifies its source
+   * \return the event
+   */
+  Scheduler::Event Insert (uint64_t ts, uint32_t context)
+  {
+    Scheduler::Event ev;
+    ev.impl = 0;  // never dereferenced by the schedulers
+    ev.key.m_ts = ts;
+    ev.key.m_uid = m_uid++;
+    ev.key.m_context = context;
+    uint64_t start = GetNs ();
+    m_scheduler->Insert (ev);
+    Account (INSERT, start);
+    return ev;
+  }
+
+  /**
+   * Remove the next event.
+   * \return the event
+   */
+  Scheduler::Event RemoveNext (void)
+  {
+    uint64_t start = GetNs ();
+    Scheduler::Event ev = m_scheduler->RemoveNext ();
+    Account (REMOVE_NEXT, start);
+    m_checksum = m_checksum * 31 + ev.key.m_uid;
+    return ev;
+  }
+
+  /**
+   * Remove an event.
+   * \param ev the event
+   */
+  void Remove (const Scheduler::Event &ev)
+  {
+    uint64_t start = GetNs ();
+    m_scheduler->Remove (ev);
+    Account (REMOVE, start);
+  }
+
+  /**
+   * Print the results as a CSV line.
+   * \param workload the name of the workload
+   * \param type the name of the scheduler
+   */
+  void Print (std::string workload, std::string type) const
+  {
+    struct rusage usage;
+    getrusage (RUSAGE_SELF, &usage);
+    std::cout << workload << "," << type;
+    for (uint32_t i = 0; i < 3; i++)
+      {
+        double mean = 0;
+        if (m_n[i] > 0 && m_ns[i] > m_n[i] * m_overhead)
+          {
+            mean = (m_ns[i] - m_n[i] * m_overhead) / (double) m_n[i];
+          }
+        std::cout << "," << m_n[i] << "," << mean;
+      }
+    std::cout << "," << usage.ru_maxrss << "," << m_checksum << std::endl;
+  }
+
+private:
+  /** The timed operations */
+  enum Operation
+  {
+    INSERT = 0,
+    REMOVE_NEXT,
+    REMOVE
+  };
+
+  /**
+   * Account for an operation.
+   * \param op the operation
+   * \param start the time at which the operation started
+   */
+  void Account (Operation op, uint64_t start)
+  {
+    m_ns[op] += GetNs () - start;
+    m_n[op]++;
+  }
+
+  Ptr<Scheduler> m_scheduler;  //!< the scheduler
+  uint64_t m_overhead;         //!< the cost of reading the clock
+  uint32_t m_uid;              //!< the uid of the next event
+  uint64_t m_checksum;         //!< the checksum of the removed uids
+  uint64_t m_n[3];             //!< the number of operations, by type
+  uint64_t m_ns[3];            //!< the time spent in the operations, by type
+};
+
+/**
+ * Draws of a random variable, made before the measurements and replayed
+ * in a loop.
+ */
+class Draws
+{
+public:
+  /**
+   * Constructor.
+   * \param rv the random variable
+   */
+  Draws (Ptr<RandomVariableStream> rv)
+    : m_values (1 << 16),
+      m_next (0)
+  {
+    for (uint32_t i = 0; i < m_values.size (); i++)
+      {
+        m_values[i] = (uint64_t) rv->GetValue ();
+      }
+  }
+
+  /**
+   * Get the next value.
+   * \return the value
+   */
+  uint64_t Next (void)
+  {
+    uint64_t value = m_values[m_next];
+    m_next = (m_next + 1) % m_values.size ();
+    return value;
+  }
+
+private:
+  std::vector<uint64_t> m_values;  //!< the values
+  uint32_t m_next;                 //!< the index of the next value
+};
+
+/**
+ * Create the draws of an exponential random variable.
+ * \param mean the mean, in ns
+ * \param stream the stream of the random variable
+ * \return the draws
+ */
+static Draws
+Exponential (double mean, int64_t stream)
+{
+  Ptr<ExponentialRandomVariable> rv = CreateObject<ExponentialRandomVariable> ();
+  rv->SetAttribute ("Mean", DoubleValue (mean));
+  rv->SetStream (stream);
+  return Draws (rv);
+}
+
+/**
+ * Create the draws of a uniform random variable.
+ * \param max the upper bound
+ * \param stream the stream of the random variable
+ * \return the draws
+ */
+static Draws
+Uniform (double max, int64_t stream)
+{
+  Ptr<UniformRandomVariable> rv = CreateObject<UniformRandomVariable> ();
+  rv->SetAttribute ("Max", DoubleValue (max));
+  rv->SetStream (stream);
+  return Draws (rv);
+}
+
+/**
+ * Periodic timers.
+ * \param s the scheduler
+ * \param pop the number of timers
+ * \param events the number of events to process
+ */
+static void
+Timers (TimedScheduler &s, uint32_t pop, uint32_t events)
+{
+  const uint64_t periods[] = { 2000000, 100000000, 1000000000 };
+  Draws kind = Uniform (3, 1);
+  Draws phase = Uniform (1000000, 2);
+  std::vector<uint64_t> period (pop);
+  for (uint32_t i = 0; i < pop; i++)
+    {
+      period[i] = periods[kind.Next ()];
+      s.Insert (period[i] * phase.Next () / 1000000, i);
+    }
+  for (uint32_t i = 0; i < events; i++)
+    {
+      Scheduler::Event ev = s.RemoveNext ();
+      s.Insert (ev.key.m_ts + period[ev.key.m_context], ev.key.m_context);
+    }
+}
+
+/**
+ * Sources with exponential inter-arrival times.
+ * \param s the scheduler
+ * \param pop the number of sources
+ * \param events the number of events to process
+ */
+static void
+Poisson (TimedScheduler &s, uint32_t pop, uint32_t events)
+{
+  Draws interval = Exponential (1000000, 3);
+  for (uint32_t i = 0; i < pop; i++)
+    {
+      s.Insert (interval.Next (), i);
+    }
+  for (uint32_t i = 0; i < events; i++)
+    {
+      Scheduler::Event ev = s.RemoveNext ();
+      s.Insert (ev.key.m_ts + interval.Next (), ev.key.m_context);
+    }
+}
+
+/**
+ * TCP connections moving their retransmission timeout at each ack.
+ * The context of the acks of connection i is 2 * i and the context of its
+ * timeouts is 2 * i + 1.
+ * \param s the scheduler
+ * \param pop the number of connections
+ * \param events the number of events to process
+ * \param remove whether the timeouts are removed or left in the scheduler
+ */
+static void
+Tcp (TimedScheduler &s, uint32_t pop, uint32_t events, bool remove)
+{
+  const uint64_t rto = 200000000;
+  Draws interval = Exponential (10000000, 4);
+  std::vector<Scheduler::Event> timeout (pop);
+  for (uint32_t i = 0; i < pop; i++)
+    {
+      uint64_t ack = interval.Next ();
+      s.Insert (ack, 2 * i);
+      timeout[i] = s.Insert (ack + rto, 2 * i + 1);
+    }
+  for (uint32_t i = 0; i < events; i++)
+    {
+      Scheduler::Event ev = s.RemoveNext ();
+      uint32_t connection = ev.key.m_context / 2;
+      if (ev.key.m_context % 2 == 1)
+        {
+          if (ev.key.m_uid == timeout[connection].key.m_uid)
+            {
+              // the retransmission timeout expires
+              timeout[connection] = s.Insert (ev.key.m_ts + 2 * rto, ev.key.m_context);
+            }
+          // else the timeout was cancelled
+          continue;
+        }
+      if (remove)
+        {
+          s.Remove (timeout[connection]);
+        }
+      timeout[connection] = s.Insert (ev.key.m_ts + rto, 2 * connection + 1);
+      s.Insert (ev.key.m_ts + interval.Next (), ev.key.m_context);
+    }
+}
+
+/**
+ * Run a workload on a scheduler and print the results.
+ * \param workload the name of the workload
+ * \param type the TypeId name of the scheduler
+ * \param pop the number of event sources
+ * \param events the number of events to process
+ * \param overhead the cost of reading the clock, in ns
+ */
+static void
+Run (std::string workload, std::string type, uint32_t pop, uint32_t events, uint64_t overhead)
+{
+  ObjectFactory factory (type);
+  TimedScheduler s (factory.Create<Scheduler> (), overhead);
+  if (workload == "timers")
+    {
+      Timers (s, pop, events);
+    }
+  else if (workload == "poisson")
+    {
+      Poisson (s, pop, events);
+    }
+  else if (workload == "tcp-remove")
+    {
+      Tcp (s, pop, events, true);
+    }
+  else if (workload == "tcp-cancel")
+    {
+      Tcp (s, pop, events, false);
+    }
+  else
+    {
+      NS_FATAL_ERROR ("Unknown workload " << workload);
+    }
+  s.Print (workload, type);
+}
+
+/**
+ * Get the TypeId names of all the schedulers.
+ * \return the names, separated by commas
+ */
+static std::string
+GetSchedulers (void)
+{
+  std::string types;
+  for (uint32_t i = 0; i < TypeId::GetRegisteredN (); i++)
+    {
+      TypeId tid = TypeId::GetRegistered (i);
+      if (tid != Scheduler::GetTypeId () && tid.IsChildOf (Scheduler::GetTypeId ())
+          && tid.HasConstructor ())
+        {
+          types += (types.empty () ? "" : ",") + tid.GetName ();
+        }
+    }
+  return types;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t pop = 1000;
+  uint32_t events = 200000;
+  std::string workloads = "timers,poisson,tcp-remove,tcp-cancel";
+  std::string schedulers = GetSchedulers ();
+
+  CommandLine cmd;
+  cmd.AddValue ("pop", "number of event sources (timers, connections)", pop);
+  cmd.AddValue ("events", "number of events processed by each run", events);
+  cmd.AddValue ("workloads", "comma separated list of workloads", workloads);
+  cmd.AddValue ("schedulers", "comma separated list of scheduler TypeIds", schedulers);
+  cmd.Parse (argc, argv);
+
+  uint64_t overhead = GetNs ();
+  for (uint32_t i = 0; i < 1000000; i++)
+    {
+      GetNs ();
+    }
+  overhead = (GetNs () - overhead) / 1000000;
+
+  std::cout << "workload,scheduler,"
+            << "inserts,insert_ns,remove_nexts,remove_next_ns,removes,remove_ns,"
+            << "peak_rss_kb,checksum" << std::endl;
+
+  std::istringstream wss (workloads);
+  std::string workload;
+  while (std::getline (wss, workload, ','))
+    {
+      std::istringstream sss (schedulers);
+      std::string type;
+      while (std::getline (sss, type, ','))
+        {
+          pid_t pid = fork ();
+          if (pid == 0)
+            {
+              Run (workload, type, pop, events, overhead);
+              _exit (0);
+            }
+          else if (pid > 0)
+            {
+              waitpid (pid, 0, 0);
+            }
+          else
+            {
+              // no child process: the peak RSS accumulates over the runs
+              Run (workload, type, pop, events, overhead);
+            }
+        }
+    }
+
+  return 0;
+}
@@ -78,11 +78,13 @@ Bench::RunBench (void)
 {
   SystemWallClockMs time;
   double init, simu;
+  uint64_t initAllocs, simuAllocs;
 
   DEB ("initializing");
   m_count = 0;
 
 
+  initAllocs = EventImpl::GetNAllocations ();
   time.Start ();
   for (uint32_t i = 0; i < m_population; ++i)
     {
@@ -91,21 +93,26 @@ Bench::RunBench (void)
     }
   init = time.End ();
   init /= 1000;
+  initAllocs = EventImpl::GetNAllocations () - initAllocs;
   DEB ("initialization took " << init << "s");
 
   DEB ("running");
+  simuAllocs = EventImpl::GetNAllocations ();
   time.Start ();
   Simulator::Run ();
   simu = time.End ();
   simu /= 1000;
+  simuAllocs = EventImpl::GetNAllocations () - simuAllocs;
   DEB ("run took " << simu << "s");
 
   LOG (std::setw (g_fwidth) << init <<
        std::setw (g_fwidth) << (m_population / init) <<
        std::setw (g_fwidth) << (init / m_population) <<
+       std::setw (g_fwidth) << initAllocs <<
        std::setw (g_fwidth) << simu <<
        std::setw (g_fwidth) << (m_count / simu) <<
-       std::setw (g_fwidth) << (simu / m_count));
+       std::setw (g_fwidth) << (simu / m_count) <<
+       std::setw (g_fwidth) << simuAllocs);
 
 }
 
@@ -184,6 +191,7 @@ int main (int argc, char *argv[])
 
   bool schedCal  = false;
   bool schedHeap = false;
+  bool schedLadder = false;
   bool schedList = false;
   bool schedMap  = true;
 
@@ -200,9 +208,13 @@ int main (int argc, char *argv[])
              "  an ascii file, given by the --file=\"<filename>\" argument,\n"
              "  or standard input, by the argument --file=\"-\"\n"
              "In the case of either --file form, the input is expected\n"
-             "to be ascii, giving the relative event times in ns.");
+             "to be ascii, giving the relative event times in ns.\n"
+             "\n"
+             "The Allocs columns count the events which could not be\n"
+             "taken from the event freelists.");
   cmd.AddValue ("cal",   "use CalendarSheduler",          schedCal);
   cmd.AddValue ("heap",  "use HeapScheduler",             schedHeap);
+  cmd.AddValue ("ladder", "use LadderScheduler",          schedLadder);
   cmd.AddValue ("list",  "use ListSheduler",              schedList);
   cmd.AddValue ("map",   "use MapScheduler (default)",    schedMap);
   cmd.AddValue ("debug", "enable debugging output",       g_debug);
@@ -218,6 +230,7 @@ int main (int argc, char *argv[])
   ObjectFactory factory ("ns3::MapScheduler");
   if (schedCal)  { factory.SetTypeId ("ns3::CalendarScheduler"); }
   if (schedHeap) { factory.SetTypeId ("ns3::HeapScheduler");     }
+  if (schedLadder) { factory.SetTypeId ("ns3::LadderScheduler"); }
   if (schedList) { factory.SetTypeId ("ns3::ListScheduler");     }  
   Simulator::SetScheduler (factory);
 
@@ -235,16 +248,20 @@ int main (int argc, char *argv[])
   // table header
   LOG ("");
   LOG (std::left << std::setw (g_fwidth) << "Run #" <<
-       std::left << std::setw (3 * g_fwidth) << "Inititialization:" <<
-       std::left << std::setw (3 * g_fwidth) << "Simulation:");
+       std::left << std::setw (4 * g_fwidth) << "Inititialization:" <<
+       std::left << std::setw (4 * g_fwidth) << "Simulation:");
   LOG (std::left << std::setw (g_fwidth) << "" <<
        std::left << std::setw (g_fwidth) << "Time (s)" <<
        std::left << std::setw (g_fwidth) << "Rate (ev/s)" <<
        std::left << std::setw (g_fwidth) << "Per (s/ev)" <<
+       std::left << std::setw (g_fwidth) << "Allocs" <<
        std::left << std::setw (g_fwidth) << "Time (s)" <<
        std::left << std::setw (g_fwidth) << "Rate (ev/s)" <<
-       std::left << std::setw (g_fwidth) << "Per (s/ev)" );
+       std::left << std::setw (g_fwidth) << "Per (s/ev)" <<
+       std::left << std::setw (g_fwidth) << "Allocs" );
   LOG (std::setfill ('-') <<
+       std::right << std::setw (g_fwidth) << " " <<
+       std::right << std::setw (g_fwidth) << " " <<
        std::right << std::setw (g_fwidth) << " " <<
        std::right << std::setw (g_fwidth) << " " <<       
        std::right << std::setw (g_fwidth) << " " <<       
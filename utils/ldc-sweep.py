@@ -0,0 +1,190 @@
+#!/usr/bin/env python
+#
+# Run a parameter sweep of the queue-discs-benchmark example in parallel.
+#
+# Every point of the grid (the cartesian product of the values given with
+# --param) is run --runs times, each time with its own RngRun, by a separate
+# process of the prebuilt example binary in batch mode, so that neither waf
+# nor the build is involved once the sweep has started. Up to --jobs
+# processes run at the same time. The CSV line written by each run is
+# prefixed with the values of the swept parameters and with the RngRun, and
+# all the lines are merged into a single CSV file.
+#
+# Example (from the top level directory, after ./waf build):
+#
+#   ./utils/ldc-sweep.py --param ldcWq=0.25,0.5,0.75 --param ldcExponent=2,3 \
+#       --param bandwidth=1Mbps,10Mbps --runs 3 -- --queueDiscType=LDC --simDuration=10
+#
+# The parameter names are the command line options of the example (see
+# ./waf --run "queue-discs-benchmark --help"); the arguments after -- are
+# passed unchanged to every run.
+
+import os
+import sys
+import glob
+import shutil
+import optparse
+import tempfile
+import itertools
+import threading
+import subprocess
+import multiprocessing
+
+# In batch mode, the example runs every combination of these lists, hence
+# the bandwidth and the number of flows are swept through them
+LIST_OPTIONS = {'bandwidth': 'bandwidthList', 'nFlows': 'flowsList'}
+
+
+def find_binary(top):
+    candidates = glob.glob(os.path.join(top, 'build', 'examples', 'traffic-control',
+                                        'ns3*-queue-discs-benchmark*'))
+    candidates = [c for c in candidates if os.access(c, os.X_OK) and not c.endswith('.o')]
+    if not candidates:
+        return None
+    # prefer the optimized build, if any
+    candidates.sort(key=lambda c: ('optimized' not in c, c))
+    return candidates[0]
+
+
+def parse_param(text):
+    if '=' not in text:
+        raise ValueError('parameter "%s" is not in the form name=value1,value2,...' % text)
+    name, values = text.split('=', 1)
+    values = [v for v in values.split(',') if v]
+    if not name or not values:
+        raise ValueError('parameter "%s" has no name or no values' % text)
+    return name, values
+
+
+def run_point(binary, env, point, rng_run, extra_args):
+    """Run the example for a point of the grid and return its CSV lines."""
+    workdir = tempfile.mkdtemp(prefix='ldc-sweep-')
+    try:
+        csv_file = os.path.join(workdir, 'run.csv')
+        args = [binary, '--batch=1', '--csvFile=%s' % csv_file, '--RngRun=%d' % rng_run]
+        lists = {'bandwidthList': '10Mbps', 'flowsList': '1'}
+        for name, value in point:
+            if name in LIST_OPTIONS:
+                lists[LIST_OPTIONS[name]] = value
+            else:
+                args.append('--%s=%s' % (name, value))
+        for name, value in lists.items():
+            args.append('--%s=%s' % (name, value))
+        args.extend(extra_args)
+
+        proc = subprocess.Popen(args, cwd=workdir, env=env,
+                                stdout=subprocess.PIPE, stderr=subprocess.STDOUT)
+        output = proc.communicate()[0]
+        if proc.returncode != 0 or not os.path.exists(csv_file):
+            return None, None, output.decode('utf-8', 'replace')
+        f = open(csv_file)
+        lines = [l.strip() for l in f if l.strip()]
+        f.close()
+        return lines[0], lines[1:], None
+    finally:
+        shutil.rmtree(workdir, ignore_errors=True)
+
+
+def main(argv):
+    parser = optparse.OptionParser(usage='%prog [options] [-- example arguments]')
+    parser.add_option('--param', action='append', default=[], metavar='NAME=V1,V2,...',
+                      help='example option to sweep and its values (may be repeated)')
+    parser.add_option('--runs', type='int', default=1,
+                      help='number of runs of every point, with different RngRun [%default]')
+    parser.add_option('--rng-run', type='int', default=1,
+                      help='RngRun of the first run [%default]')
+    parser.add_option('--jobs', '-j', type='int', default=multiprocessing.cpu_count(),
+                      help='number of runs executed in parallel [%default]')
+    parser.add_option('--binary', default=None,
+                      help='queue-discs-benchmark binary [found in build/]')
+    parser.add_option('--output', '-o', default='ldc-sweep.csv',
+                      help='merged CSV file [%default]')
+    options, extra_args = parser.parse_args(argv)
+
+    try:
+        params = [parse_param(p) for p in options.param]
+    except ValueError as e:
+        parser.error(str(e))
+    if options.runs < 1 or options.jobs < 1:
+        parser.error('--runs and --jobs must be positive')
+
+    top = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+    binary = options.binary or find_binary(top)
+    if binary is None or not os.path.exists(binary):
+        parser.error('queue-discs-benchmark binary not found, build the examples or use --binary')
+    binary = os.path.abspath(binary)
+
+    env = dict(os.environ)
+    libdirs = [os.path.join(top, 'build'), os.path.join(top, 'build', 'lib')]
+    if env.get('LD_LIBRARY_PATH'):
+        libdirs.append(env['LD_LIBRARY_PATH'])
+    env['LD_LIBRARY_PATH'] = os.pathsep.join(libdirs)
+
+    names = [name for name, values in params]
+    grid = list(itertools.product(*[values for name, values in params]))
+    jobs = []
+    for i, values in enumerate(grid):
+        for r in range(options.runs):
+            jobs.append((list(zip(names, values)), options.rng_run + i * options.runs + r))
+
+    print('%d points, %d runs, %d parallel jobs, binary %s'
+          % (len(grid), len(jobs), options.jobs, binary))
+
+    results = [None] * len(jobs)
+    header = [None]
+    failures = []
+    lock = threading.Lock()
+    pending = list(range(len(jobs)))
+    pending.reverse()
+
+    # each thread waits on one child process at a time
+    def worker():
+        while True:
+            lock.acquire()
+            if not pending:
+                lock.release()
+                return
+            index = pending.pop()
+            lock.release()
+
+            point, rng_run = jobs[index]
+            run_header, lines, error = run_point(binary, env, point, rng_run, extra_args)
+
+            lock.acquire()
+            if error is None:
+                header[0] = run_header
+                results[index] = lines
+            else:
+                failures.append((point, rng_run, error))
+            done = len(jobs) - len(pending)
+            lock.release()
+            sys.stdout.write('\r%d/%d' % (done, len(jobs)))
+            sys.stdout.flush()
+
+    threads = [threading.Thread(target=worker) for i in range(min(options.jobs, len(jobs)))]
+    for t in threads:
+        t.start()
+    for t in threads:
+        t.join()
+    sys.stdout.write('\n')
+
+    if header[0] is not None:
+        out = open(options.output, 'w')
+        # the bandwidth and the number of flows are already in the output of the example
+        columns = [n for n in names if n not in LIST_OPTIONS]
+        out.write(','.join(columns + ['RngRun', header[0]]) + '\n')
+        for (point, rng_run), lines in zip(jobs, results):
+            for line in lines or []:
+                values = [v for n, v in point if n not in LIST_OPTIONS]
+                out.write(','.join(values + [str(rng_run), line]) + '\n')
+        out.close()
+        print('results written to %s' % options.output)
+
+    for point, rng_run, error in failures:
+        sys.stderr.write('run %s RngRun=%d failed:\n%s\n'
+                         % (' '.join('%s=%s' % nv for nv in point), rng_run, error))
+    return 1 if failures else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv[1:]))